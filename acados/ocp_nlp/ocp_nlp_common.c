@@ -1050,6 +1050,8 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     #endif
 #endif
     // printf("\nocp_nlp: openmp threads = %d\n", opts->num_threads);
+    opts->stage_schedule = STAGE_SCHEDULE_DYNAMIC;
+    opts->fused_linearization = 0;
 
     opts->globalization = FIXED_STEP;
     opts->print_level = 0;
@@ -1176,6 +1178,33 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             int* num_threads = (int *) value;
             opts->num_threads = *num_threads;
         }
+        else if (!strcmp(field, "stage_schedule"))
+        {
+            char* stage_schedule = (char *) value;
+            if (!strcmp(stage_schedule, "serial"))
+            {
+                opts->stage_schedule = STAGE_SCHEDULE_SERIAL;
+            }
+            else if (!strcmp(stage_schedule, "static"))
+            {
+                opts->stage_schedule = STAGE_SCHEDULE_STATIC;
+            }
+            else if (!strcmp(stage_schedule, "dynamic"))
+            {
+                opts->stage_schedule = STAGE_SCHEDULE_DYNAMIC;
+            }
+            else
+            {
+                printf("\nerror: ocp_nlp_opts_set: not supported value for stage_schedule, got: %s\n",
+                       stage_schedule);
+                exit(1);
+            }
+        }
+        else if (!strcmp(field, "fused_linearization"))
+        {
+            int* fused_linearization = (int *) value;
+            opts->fused_linearization = *fused_linearization;
+        }
         else if (!strcmp(field, "step_length"))
         {
             double* step_length = (double *) value;
@@ -1403,7 +1432,7 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
     size += (N+1)*sizeof(bool); // set_sim_guess
 
     size += (N+1)*sizeof(struct blasfeo_dmat); // dzduxt
-    size += 6*(N+1)*sizeof(struct blasfeo_dvec);  // cost_grad ineq_fun ineq_adj dyn_adj sim_guess z_alg
+    size += 8*(N+1)*sizeof(struct blasfeo_dvec);  // cost_grad(_own) ineq_fun ineq_adj(_own) dyn_adj sim_guess z_alg
     size += 1*N*sizeof(struct blasfeo_dvec);        // dyn_fun
 
     for (int i = 0; i < N; i++)
@@ -1535,6 +1564,10 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->ineq_fun, &c_ptr);
     // ineq_adj
     assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->ineq_adj, &c_ptr);
+    // cost_grad_own
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->cost_grad_own, &c_ptr);
+    // ineq_adj_own
+    assign_and_advance_blasfeo_dvec_structs(N + 1, &mem->ineq_adj_own, &c_ptr);
     // dyn_fun
     assign_and_advance_blasfeo_dvec_structs(N, &mem->dyn_fun, &c_ptr);
     // dyn_adj
@@ -1579,6 +1612,12 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     {
         assign_and_advance_blasfeo_dvec_mem(nv[i], mem->ineq_adj + i, &c_ptr);
     }
+    // keep the own buffers of cost_grad and ineq_adj, these are aliased with fused_linearization
+    for (int i = 0; i <= N; i++)
+    {
+        mem->cost_grad_own[i] = mem->cost_grad[i];
+        mem->ineq_adj_own[i] = mem->ineq_adj[i];
+    }
     // dyn_fun
     for (int i = 0; i < N; i++)
     {
@@ -1916,14 +1955,55 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
  * functions
  ************************************************/
 
-void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
-         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
+#if defined(ACADOS_WITH_OPENMP)
+static int ocp_nlp_stage_num_threads(ocp_nlp_opts *opts)
+{
+    if (opts->stage_schedule == STAGE_SCHEDULE_SERIAL || opts->num_threads < 1)
+        return 1;
+    return opts->num_threads;
+}
+#endif
+
+
+
+void ocp_nlp_loop_stages(ocp_nlp_stage_task task, int num_stages, ocp_nlp_config *config,
+            ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+            ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel
-    { // beginning of parallel region
+    int num_threads = ocp_nlp_stage_num_threads(opts);
+
+    if (num_threads > 1 && opts->stage_schedule == STAGE_SCHEDULE_DYNAMIC)
+    {
+        // stages have very different cost (e.g. integrator vs. terminal stage):
+        // hand them out one at a time, such that idle threads pick up the remaining ones
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (int i = 0; i < num_stages; i++)
+            task(config, dims, in, out, opts, mem, work, i);
+    }
+    else if (num_threads > 1)
+    {
+        // fixed stage-to-thread mapping: every thread keeps working on the memory of its stages
+        #pragma omp parallel for num_threads(num_threads) schedule(static)
+        for (int i = 0; i < num_stages; i++)
+            task(config, dims, in, out, opts, mem, work, i);
+    }
+    else
 #endif
+    {
+        for (int i = 0; i < num_stages; i++)
+            task(config, dims, in, out, opts, mem, work, i);
+    }
+
+    return;
+}
+
+
 
+static void ocp_nlp_alias_memory_to_submodules_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+         ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem,
+         ocp_nlp_workspace *nlp_work, int i)
+{
     int N = dims->N;
     // TODO: For z, why dont we use nlp_out->z+i instead of nlp_mem->z_alg+i? as is done for ux.
     //  - z_alg contains values from integrator, used in cost and constraint linearization.
@@ -1931,12 +2011,8 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
     // Probably, this can also be achieved without mem->z_alg.
     // Would it work to initialize integrator always with z_out? Probably no, e.g. for lifted IRK.
 
-
     // alias to dynamics_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
-    for (int i = 0; i < N; i++)
+    if (i < N)
     {
         config->dynamics[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->dynamics[i]);
         config->dynamics[i]->memory_set_tmp_ux_ptr(nlp_work->tmp_nlp_out->ux+i, nlp_mem->dynamics[i]);
@@ -1949,40 +2025,60 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
         config->dynamics[i]->memory_set_dzduxt_ptr(nlp_mem->dzduxt+i, nlp_mem->dynamics[i]);
         config->dynamics[i]->memory_set_sim_guess_ptr(nlp_mem->sim_guess+i, nlp_mem->set_sim_guess+i, nlp_mem->dynamics[i]);
         config->dynamics[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->dynamics[i]);
+
+        // copy sampling times into dynamics model
+        // NOTE(oj): this will lead in an error for irk_gnsf, T must be set in precompute;
+        //    -> remove here and make sure precompute is called everywhere (e.g. Python interface).
+        config->dynamics[i]->model_set(config->dynamics[i], dims->dynamics[i],
+                                         nlp_in->dynamics[i], "T", nlp_in->Ts+i);
     }
 
     // alias to cost_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_tmp_ux_ptr(nlp_work->tmp_nlp_out->ux+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->cost[i]);
-        config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, nlp_mem->cost[i]);
-    }
+    config->cost[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_tmp_ux_ptr(nlp_work->tmp_nlp_out->ux+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->cost[i]);
+    config->cost[i]->memory_set_Z_ptr(nlp_mem->qp_in->Z+i, nlp_mem->cost[i]);
 
     // alias to constraints_memory
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
-    for (int i = 0; i <= N; i++)
+    config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_tmp_ux_ptr(nlp_work->tmp_nlp_out->ux+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_tmp_lam_ptr(nlp_work->tmp_nlp_out->lam+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], nlp_mem->constraints[i]);
+    config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], nlp_mem->constraints[i]);
+
+    // fused linearization: nlp memory vectors are views on the submodule memory
+    // NOTE: these are not overwritten by compute_fun, i.e. stay valid during globalization
+    if (opts->fused_linearization)
+    {
+        nlp_mem->cost_grad[i] = *config->cost[i]->memory_get_grad_ptr(nlp_mem->cost[i]);
+        nlp_mem->ineq_adj[i] = *config->constraints[i]->memory_get_adj_ptr(nlp_mem->constraints[i]);
+    }
+    else
     {
-        config->constraints[i]->memory_set_ux_ptr(nlp_out->ux+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_tmp_ux_ptr(nlp_work->tmp_nlp_out->ux+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_lam_ptr(nlp_out->lam+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_tmp_lam_ptr(nlp_work->tmp_nlp_out->lam+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_z_alg_ptr(nlp_mem->z_alg+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_dzdux_tran_ptr(nlp_mem->dzduxt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_DCt_ptr(nlp_mem->qp_in->DCt+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_RSQrq_ptr(nlp_mem->qp_in->RSQrq+i, nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxb_ptr(nlp_mem->qp_in->idxb[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxs_rev_ptr(nlp_mem->qp_in->idxs_rev[i], nlp_mem->constraints[i]);
-        config->constraints[i]->memory_set_idxe_ptr(nlp_mem->qp_in->idxe[i], nlp_mem->constraints[i]);
+        // restore own buffers, the option might have been switched off after a fused call
+        nlp_mem->cost_grad[i] = nlp_mem->cost_grad_own[i];
+        nlp_mem->ineq_adj[i] = nlp_mem->ineq_adj_own[i];
     }
+}
+
+
+
+void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+         ocp_nlp_out *nlp_out, ocp_nlp_opts *opts, ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work)
+{
+    int N = dims->N;
+
+    // alias to dynamics, cost and constraints memory
+    ocp_nlp_loop_stages(&ocp_nlp_alias_memory_to_submodules_stage, N+1, config, dims, nlp_in,
+                        nlp_out, opts, nlp_mem, nlp_work);
 
     // alias to regularize memory
     config->regularize->memory_set_RSQrq_ptr(dims->regularize, nlp_mem->qp_in->RSQrq, nlp_mem->regularize_mem);
@@ -1995,102 +2091,95 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
     config->regularize->memory_set_pi_ptr(dims->regularize, nlp_mem->qp_out->pi, nlp_mem->regularize_mem);
     config->regularize->memory_set_lam_ptr(dims->regularize, nlp_mem->qp_out->lam, nlp_mem->regularize_mem);
 
-    // copy sampling times into dynamics model
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp for nowait
-#endif
-    // NOTE(oj): this will lead in an error for irk_gnsf, T must be set in precompute;
-    //    -> remove here and make sure precompute is called everywhere (e.g. Python interface).
-    for (int i = 0; i < N; i++)
-    {
-        config->dynamics[i]->model_set(config->dynamics[i], dims->dynamics[i],
-                                         nlp_in->dynamics[i], "T", nlp_in->Ts+i);
-    }
+    return;
+}
 
-#if defined(ACADOS_WITH_OPENMP)
-    } // end of parallel region
-#endif
 
-    return;
+
+static void ocp_nlp_initialize_submodules_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+         ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+         ocp_nlp_workspace *work, int i)
+{
+    // cost
+    config->cost[i]->initialize(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
+    // dynamics
+    if (i < dims->N)
+        config->dynamics[i]->initialize(config->dynamics[i], dims->dynamics[i],
+                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    // constraints
+    config->constraints[i]->initialize(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
 }
 
 
+
 void ocp_nlp_initialize_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
          ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
-    int N = dims->N;
-
     // NOTE: initialize is called at the start of every NLP solver call.
     // It computes things in submodules based on stuff that can be changed by the user between
     // subsequent solver calls, e.g. factorization of weight matrix.
     // IN CONTRAST: precompute is only called once after solver creation
     //  -> computes things that are not expected to change between subsequent solver calls
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // cost
-        config->cost[i]->initialize(config->cost[i], dims->cost[i], in->cost[i],
-                opts->cost[i], mem->cost[i], work->cost[i]);
-        // dynamics
-        if (i < N)
-            config->dynamics[i]->initialize(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        // constraints
-        config->constraints[i]->initialize(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
-    }
+    ocp_nlp_loop_stages(&ocp_nlp_initialize_submodules_stage, dims->N+1, config, dims, in, out,
+                        opts, mem, work);
 
     return;
 }
 
 
-void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
-         ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+
+static void ocp_nlp_initialize_t_slacks_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+         ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+         ocp_nlp_workspace *work, int i)
 {
     struct blasfeo_dvec *ineq_fun;
-    int N = dims->N;
     int *ni = dims->ni;
     int *ns = dims->ns;
     int *nx = dims->nx;
     int *nu = dims->nu;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // copy out->ux to tmp_nlp_out->ux, since this is used in compute_fun
-        blasfeo_dveccp(nx[i]+nu[i]+2*ns[i], out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
+    // copy out->ux to tmp_nlp_out->ux, since this is used in compute_fun
+    blasfeo_dveccp(nx[i]+nu[i]+2*ns[i], out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
+
+    // evaluate inequalities
+    config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
+                                         in->constraints[i], opts->constraints[i],
+                                         mem->constraints[i], work->constraints[i]);
+    ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    // t = -ineq_fun
+    blasfeo_dveccpsc(2 * ni[i], -1.0, ineq_fun, 0, out->t + i, 0);
+}
+
 
-        // evaluate inequalities
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                             in->constraints[i], opts->constraints[i],
-                                             mem->constraints[i], work->constraints[i]);
-        ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        // t = -ineq_fun
-        blasfeo_dveccpsc(2 * ni[i], -1.0, ineq_fun, 0, out->t + i, 0);
-    }
+
+void ocp_nlp_initialize_t_slacks(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+         ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    ocp_nlp_loop_stages(&ocp_nlp_initialize_t_slacks_stage, dims->N+1, config, dims, in, out,
+                        opts, mem, work);
 
     return;
 }
 
 
 
-void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+static void ocp_nlp_approximate_qp_matrices_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
     ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work)
+    ocp_nlp_workspace *work, int i)
 {
     int N = dims->N;
-    int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
 
-    /* prepare memory */
-    int cost_integration;
-    for (int i = 0; i < N; i++)
+    // init Hessian to 0
+    blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+
+    if (i < N)
     {
+        // prepare memory
+        int cost_integration;
         config->dynamics[i]->opts_get(config->dynamics[i], opts->dynamics[i],
                                         "cost_computation", &cost_integration);
         if (cost_integration)
@@ -2106,92 +2195,121 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
             config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], mem->dynamics[i], "y_ref", y_ref);
             config->dynamics[i]->memory_set(config->dynamics[i], dims->dynamics[i], mem->dynamics[i], "W_chol", W_chol);
         }
-    }
 
-    /* stage-wise multiple shooting lagrangian evaluation */
+        // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+        // dynamics
+        config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+
+        // nlp mem: dyn_fun
+        // NOTE: copy needed, the dynamics residual is overwritten during globalization
+        if (opts->fused_linearization)
+        {
+            struct blasfeo_dvec *dyn_fun
+                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+        }
+    }
+    else
     {
-        // init Hessian to 0
-        blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+        // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
+        if (opts->levenberg_marquardt > 0.0)
+            blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
+                           mem->qp_in->RSQrq+i, 0, 0);
+    }
 
+    // cost
+    config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
 
-        if (i < N)
-        {
-            // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
+    // constraints
+    config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+}
 
-            // dynamics
-            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        }
-        else
-        {
-            // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
-            if (opts->levenberg_marquardt > 0.0)
-                blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
-                               mem->qp_in->RSQrq+i, 0, 0);
-        }
 
-        // cost
-        config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
-                opts->cost[i], mem->cost[i], work->cost[i]);
 
-        // constraints
-        config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+// nlp mem: dyn_adj[i] = [adj of dynamics i; 0] + [0; adj of dynamics i-1 w.r.t. x_i]
+static void ocp_nlp_collect_dyn_adj(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_memory *mem, int i)
+{
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
     }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+    }
+    if (i > 0)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+        blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+            mem->dyn_adj+i, nu[i]);
+    }
+}
 
-    /* collect stage-wise evaluations */
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i <= N; i++)
+
+static void ocp_nlp_collect_stage_evaluations(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work, int i)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+
+    // nlp mem: cost_grad
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+
+    // nlp mem: dyn_fun
+    if (i < N)
     {
+        struct blasfeo_dvec *dyn_fun
+            = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+    }
 
-        // nlp mem: cost_grad
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+    // nlp mem: dyn_adj
+    ocp_nlp_collect_dyn_adj(config, dims, mem, i);
 
-        // nlp mem: dyn_fun
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_fun
-                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
-        }
+    // nlp mem: ineq_adj
+    struct blasfeo_dvec *ineq_adj =
+        config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
+    blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+}
 
-        // nlp mem: dyn_adj
-        if (i < N)
-        {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
-        }
-        else
-        {
-            blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
-        }
-        if (i > 0)
-        {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
-            blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
-                mem->dyn_adj+i, nu[i]);
-        }
 
-        // nlp mem: ineq_adj
-        struct blasfeo_dvec *ineq_adj =
-            config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
-        blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
 
-    }
+void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+    int N = dims->N;
+
+    /* stage-wise multiple shooting lagrangian evaluation */
+    ocp_nlp_loop_stages(&ocp_nlp_approximate_qp_matrices_stage, N+1, config, dims, in, out,
+                        opts, mem, work);
+
+    /* collect stage-wise evaluations */
+    // NOTE: has to be a separate loop, stage i needs the adjoint of dynamics i-1
+    // fused linearization: cost_grad, ineq_adj are aliased, dyn_fun is copied in the loop above,
+    //     dyn_adj is assembled in ocp_nlp_approximate_qp_vectors_sqp
+    if (!opts->fused_linearization)
+        ocp_nlp_loop_stages(&ocp_nlp_collect_stage_evaluations, N+1, config, dims, in, out,
+                            opts, mem, work);
 
     // TODO(rien) where should the update happen??? move to qp update ???
     // for (int i = 0; i <= N; i++)
@@ -2214,42 +2332,48 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
-// update QP rhs for SQP (step prim var, abs dual var)
-// evaluate constraints wrt bounds -> allows to update all bounds between preparation and feedback phase.
-void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
+static void ocp_nlp_approximate_qp_vectors_sqp_stage(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
-    ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
 {
     int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
-    // int *nu = dims->nu;
     int *ni = dims->ni;
 
+    // g
+    blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // g
-        blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+    // b
+    if (i < N)
+        blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
 
-        // b
-        if (i < N)
-            blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
+    // evaluate constraint residuals
+    config->constraints[i]->update_qp_vectors(config->constraints[i], dims->constraints[i],
+        in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
 
-        // evaluate constraint residuals
-        config->constraints[i]->update_qp_vectors(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    // copy ineq function value into nlp mem, then into QP
+    struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
 
-        // copy ineq function value into nlp mem, then into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+    // d
+    blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
 
-        // d
-        blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
-    }
+    // fused linearization: collect dyn_adj here, all dynamics adjoints are available
+    if (opts->fused_linearization)
+        ocp_nlp_collect_dyn_adj(config, dims, mem, i);
+}
+
+
+
+// update QP rhs for SQP (step prim var, abs dual var)
+// evaluate constraints wrt bounds -> allows to update all bounds between preparation and feedback phase.
+void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    ocp_nlp_loop_stages(&ocp_nlp_approximate_qp_vectors_sqp_stage, dims->N+1, config, dims, in,
+                        out, opts, mem, work);
 }
 
 
@@ -2436,6 +2560,25 @@ static double ocp_nlp_get_violation(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
+static void ocp_nlp_evaluate_merit_fun_stage(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                  ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+                                  ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i)
+{
+    // dynamics: Note has to be first, because cost_integration might be used.
+    if (i < dims->N)
+        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    // cost
+    config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
+                                mem->cost[i], work->cost[i]);
+    // constr
+    config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
+                                        in->constraints[i], opts->constraints[i],
+                                        mem->constraints[i], work->constraints[i]);
+}
+
+
+
 double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                   ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
                                   ocp_nlp_memory *mem, ocp_nlp_workspace *work)
@@ -2450,34 +2593,8 @@ double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
     double merit_fun = 0.0;
 
     // compute fun value
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<N; i++)
-    {
-        // dynamics: Note has to be first, because cost_integration might be used.
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
-    {
-        // cost
-        config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
-                                    mem->cost[i], work->cost[i]);
-    }
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
-    {
-        // constr
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                            in->constraints[i], opts->constraints[i],
-                                            mem->constraints[i], work->constraints[i]);
-    }
+    ocp_nlp_loop_stages(&ocp_nlp_evaluate_merit_fun_stage, N+1, config, dims, in, out, opts,
+                        mem, work);
 
     double *tmp_fun;
     double tmp;
@@ -2737,7 +2854,7 @@ void ocp_nlp_update_variables_sqp(ocp_nlp_config *config, ocp_nlp_dims *dims, oc
 
 
 #if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
+    #pragma omp parallel for num_threads(ocp_nlp_stage_num_threads(opts))
 #endif
     for (int i = 0; i <= N; i++)
     {
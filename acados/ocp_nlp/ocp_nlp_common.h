@@ -257,6 +257,14 @@ typedef enum
     MERIT_BACKTRACKING,
 } ocp_nlp_globalization_t;
 
+/// Scheduling of the stage-wise loops (linearization, initialization, merit function, ...)
+typedef enum
+{
+    STAGE_SCHEDULE_SERIAL,   // all stages on the calling thread
+    STAGE_SCHEDULE_STATIC,   // OpenMP: contiguous blocks of stages, fixed stage-to-thread mapping
+    STAGE_SCHEDULE_DYNAMIC,  // OpenMP: stages are handed out one by one to idle threads
+} ocp_nlp_stage_schedule_t;
+
 typedef struct ocp_nlp_opts
 {
     ocp_qp_xcond_solver_opts *qp_solver_opts; // xcond solver opts instead ???
@@ -268,6 +276,8 @@ typedef struct ocp_nlp_opts
     double levenberg_marquardt;  // LM factor to be added to the hessian before regularization
     int reuse_workspace;
     int num_threads;
+    ocp_nlp_stage_schedule_t stage_schedule;
+    int fused_linearization;  // nlp memory aliases gradients and adjoints of submodules instead of copying them
     int print_level;
 
     // TODO: move to separate struct?
@@ -347,6 +357,9 @@ typedef struct ocp_nlp_memory
     struct blasfeo_dvec *ineq_adj;
     struct blasfeo_dvec *dyn_fun;
     struct blasfeo_dvec *dyn_adj;
+    // own buffers of cost_grad and ineq_adj (these alias submodule memory with fused_linearization)
+    struct blasfeo_dvec *cost_grad_own;
+    struct blasfeo_dvec *ineq_adj_own;
 
     double cost_value;
 
@@ -396,6 +409,18 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
  * function
  ************************************************/
 
+/// Task operating on a single stage of the multiple shooting discretization.
+typedef void (*ocp_nlp_stage_task)(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work,
+            int stage);
+
+/// Runs task for stages 0, ..., num_stages-1 according to opts->stage_schedule.
+/// With OpenMP, all loops use a team of opts->num_threads threads, such that the thread pool
+/// of the OpenMP runtime is kept alive and reused across loops, SQP iterations and solver calls.
+void ocp_nlp_loop_stages(ocp_nlp_stage_task task, int num_stages, ocp_nlp_config *config,
+            ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+            ocp_nlp_memory *mem, ocp_nlp_workspace *work);
+//
 void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
 //
@@ -40,6 +40,7 @@
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 
 
@@ -799,6 +800,79 @@ int ocp_nlp_constraints_bgh_model_set(void *config_, void *dims_,
 
 
 
+int ocp_nlp_constraints_bgh_model_set_by_id(void *config_, void *dims_,
+                         void *model_, int field_id, void *value)
+{
+    ocp_nlp_constraints_bgh_dims *dims = (ocp_nlp_constraints_bgh_dims *) dims_;
+    ocp_nlp_constraints_bgh_model *model = (ocp_nlp_constraints_bgh_model *) model_;
+
+    int nb = dims->nb;
+    int ng = dims->ng;
+    int nh = dims->nh;
+    int nbx = dims->nbx;
+    int nbu = dims->nbu;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_LBX:
+            blasfeo_pack_dvec(nbx, value, 1, &model->d, nbu);
+            break;
+        case ACADOS_FIELD_UBX:
+            blasfeo_pack_dvec(nbx, value, 1, &model->d, nb + ng + nh + nbu);
+            break;
+        case ACADOS_FIELD_LBU:
+            blasfeo_pack_dvec(nbu, value, 1, &model->d, 0);
+            break;
+        case ACADOS_FIELD_UBU:
+            blasfeo_pack_dvec(nbu, value, 1, &model->d, nb + ng + nh);
+            break;
+        case ACADOS_FIELD_LG:
+            blasfeo_pack_dvec(ng, value, 1, &model->d, nb);
+            break;
+        case ACADOS_FIELD_UG:
+            blasfeo_pack_dvec(ng, value, 1, &model->d, 2*nb+ng+nh);
+            break;
+        case ACADOS_FIELD_LH:
+            blasfeo_pack_dvec(nh, value, 1, &model->d, nb+ng);
+            break;
+        case ACADOS_FIELD_UH:
+            blasfeo_pack_dvec(nh, value, 1, &model->d, 2*nb+2*ng+nh);
+            break;
+        default:
+            return ocp_nlp_constraints_bgh_model_set(config_, dims_, model_,
+                                         acados_field_name(field_id), value);
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+int ocp_nlp_constraints_bgh_model_field_dim(void *config_, void *dims_, int field_id)
+{
+    ocp_nlp_constraints_bgh_dims *dims = dims_;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_LBX:
+        case ACADOS_FIELD_UBX:
+            return dims->nbx;
+        case ACADOS_FIELD_LBU:
+        case ACADOS_FIELD_UBU:
+            return dims->nbu;
+        case ACADOS_FIELD_LG:
+        case ACADOS_FIELD_UG:
+            return dims->ng;
+        case ACADOS_FIELD_LH:
+        case ACADOS_FIELD_UH:
+            return dims->nh;
+        default:
+            return -1;
+    }
+}
+
+
+
 void ocp_nlp_constraints_bgh_model_get(void *config_, void *dims_,
                          void *model_, const char *field, void *value)
 {
@@ -1650,6 +1724,8 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_constraints_bgh_model_calculate_size;
     config->model_assign = &ocp_nlp_constraints_bgh_model_assign;
     config->model_set = &ocp_nlp_constraints_bgh_model_set;
+    config->model_set_by_id = &ocp_nlp_constraints_bgh_model_set_by_id;
+    config->model_field_dim = &ocp_nlp_constraints_bgh_model_field_dim;
     config->model_get = &ocp_nlp_constraints_bgh_model_get;
     config->opts_calculate_size = &ocp_nlp_constraints_bgh_opts_calculate_size;
     config->opts_assign = &ocp_nlp_constraints_bgh_opts_assign;
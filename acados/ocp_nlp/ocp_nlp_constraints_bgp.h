@@ -104,6 +104,11 @@ void *ocp_nlp_constraints_bgp_assign(void *config, void *dims, void *raw_memory)
 int ocp_nlp_constraints_bgp_model_set(void *config_, void *dims_,
                          void *model_, const char *field, void *value);
 //
+int ocp_nlp_constraints_bgp_model_set_by_id(void *config_, void *dims_,
+                         void *model_, int field_id, void *value);
+//
+int ocp_nlp_constraints_bgp_model_field_dim(void *config_, void *dims_, int field_id);
+//
 void ocp_nlp_constraints_bgp_model_get(void *config_, void *dims_,
                          void *model_, const char *field, void *value);
 
@@ -64,6 +64,9 @@ typedef struct
     acados_size_t (*model_calculate_size)(void *config, void *dims);
     void *(*model_assign)(void *config, void *dims, void *raw_memory);
     int (*model_set)(void *config_, void *dims_, void *model_, const char *field, void *value_);
+    int (*model_set_by_id)(void *config_, void *dims_, void *model_, int field_id, void *value_);
+    // dimension of a vector field of the model, -1 if the module has no such field
+    int (*model_field_dim)(void *config_, void *dims_, int field_id);
     acados_size_t (*opts_calculate_size)(void *config, void *dims);
     void *(*opts_assign)(void *config, void *dims, void *raw_memory);
     void (*opts_initialize_default)(void *config, void *dims, void *opts);
@@ -47,6 +47,7 @@
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 
 
@@ -378,6 +379,63 @@ int ocp_nlp_cost_ls_model_set(void *config_, void *dims_, void *model_,
 
 
 
+int ocp_nlp_cost_ls_model_set_by_id(void *config_, void *dims_, void *model_,
+                                         int field_id, void *value_)
+{
+    ocp_nlp_cost_ls_dims *dims = dims_;
+    ocp_nlp_cost_ls_model *model = model_;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_YREF:
+            blasfeo_pack_dvec(dims->ny, value_, 1, &model->y_ref, 0);
+            break;
+        case ACADOS_FIELD_W:
+            blasfeo_pack_dmat(dims->ny, dims->ny, value_, dims->ny, &model->W, 0, 0);
+            model->W_changed = 1;
+            break;
+        case ACADOS_FIELD_ZL_MAT:
+            blasfeo_pack_dvec(dims->ns, value_, 1, &model->Z, 0);
+            break;
+        case ACADOS_FIELD_ZU_MAT:
+            blasfeo_pack_dvec(dims->ns, value_, 1, &model->Z, dims->ns);
+            break;
+        case ACADOS_FIELD_ZL:
+            blasfeo_pack_dvec(dims->ns, value_, 1, &model->z, 0);
+            break;
+        case ACADOS_FIELD_ZU:
+            blasfeo_pack_dvec(dims->ns, value_, 1, &model->z, dims->ns);
+            break;
+        default:
+            return ocp_nlp_cost_ls_model_set(config_, dims_, model_,
+                                         acados_field_name(field_id), value_);
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+int ocp_nlp_cost_ls_model_field_dim(void *config_, void *dims_, int field_id)
+{
+    ocp_nlp_cost_ls_dims *dims = dims_;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_YREF:
+            return dims->ny;
+        case ACADOS_FIELD_ZL_MAT:
+        case ACADOS_FIELD_ZU_MAT:
+        case ACADOS_FIELD_ZL:
+        case ACADOS_FIELD_ZU:
+            return dims->ns;
+        default:
+            return -1;
+    }
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                   options                                  //
 ////////////////////////////////////////////////////////////////////////////////
@@ -927,6 +985,8 @@ void ocp_nlp_cost_ls_config_initialize_default(void *config_)
     config->model_calculate_size = &ocp_nlp_cost_ls_model_calculate_size;
     config->model_assign = &ocp_nlp_cost_ls_model_assign;
     config->model_set = &ocp_nlp_cost_ls_model_set;
+    config->model_set_by_id = &ocp_nlp_cost_ls_model_set_by_id;
+    config->model_field_dim = &ocp_nlp_cost_ls_model_field_dim;
     config->opts_calculate_size = &ocp_nlp_cost_ls_opts_calculate_size;
     config->opts_assign = &ocp_nlp_cost_ls_opts_assign;
     config->opts_initialize_default = &ocp_nlp_cost_ls_opts_initialize_default;
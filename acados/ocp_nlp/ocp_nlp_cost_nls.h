@@ -104,6 +104,11 @@ acados_size_t ocp_nlp_cost_nls_model_calculate_size(void *config, void *dims);
 void *ocp_nlp_cost_nls_model_assign(void *config, void *dims, void *raw_memory);
 //
 int ocp_nlp_cost_nls_model_set(void *config_, void *dims_, void *model_, const char *field, void *value_);
+//
+int ocp_nlp_cost_nls_model_set_by_id(void *config_, void *dims_, void *model_,
+                                         int field_id, void *value_);
+//
+int ocp_nlp_cost_nls_model_field_dim(void *config_, void *dims_, int field_id);
 
 
 
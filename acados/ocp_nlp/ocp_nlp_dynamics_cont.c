@@ -40,6 +40,7 @@
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 
 
@@ -347,6 +348,20 @@ void ocp_nlp_dynamics_cont_opts_get(void *config_, void *opts_, const char *fiel
  * memory
  ************************************************/
 
+// set the sens_adj option of the integrator and return its previous value;
+// memory and workspace of the integrator are always sized with adjoints,
+// since compute_fun_and_adj switches them on for a single call
+static void ocp_nlp_dynamics_cont_swap_sim_sens_adj(ocp_nlp_dynamics_config *config,
+    ocp_nlp_dynamics_cont_opts *opts, bool *sens_adj)
+{
+    bool sens_adj_bkp;
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", sens_adj);
+    *sens_adj = sens_adj_bkp;
+}
+
+
+
 acados_size_t ocp_nlp_dynamics_cont_memory_calculate_size(void *config_, void *dims_, void *opts_)
 {
     ocp_nlp_dynamics_config *config = config_;
@@ -366,8 +381,11 @@ acados_size_t ocp_nlp_dynamics_cont_memory_calculate_size(void *config_, void *d
     size += 1 * blasfeo_memsize_dvec(nu + nx + nx1);  // adj
     size += 1 * blasfeo_memsize_dvec(nx1);            // fun
 
+    bool sens_adj = true;
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
     size +=
         config->sim_solver->memory_calculate_size(config->sim_solver, dims->sim, opts->sim_solver);
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
 
     size += 1*64;  // blasfeo_mem align
 
@@ -397,10 +415,13 @@ void *ocp_nlp_dynamics_cont_memory_assign(void *config_, void *dims_, void *opts
     c_ptr += sizeof(ocp_nlp_dynamics_cont_memory);
 
     // sim_solver
+    bool sens_adj = true;
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
     memory->sim_solver =
         config->sim_solver->memory_assign(config->sim_solver, dims->sim, opts->sim_solver, c_ptr);
     c_ptr +=
         config->sim_solver->memory_calculate_size(config->sim_solver, dims->sim, opts->sim_solver);
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
 
     // blasfeo_mem align
     align_char_to(64, &c_ptr);
@@ -411,6 +432,10 @@ void *ocp_nlp_dynamics_cont_memory_assign(void *config_, void *dims_, void *opts
     // fun
     assign_and_advance_blasfeo_dvec_mem(nx1, &memory->fun, &c_ptr);
 
+    memory->time_sim = 0.0;
+    memory->time_sim_ad = 0.0;
+    memory->time_sim_la = 0.0;
+
     assert((char *) raw_memory +
                ocp_nlp_dynamics_cont_memory_calculate_size(config_, dims, opts_) >=
            c_ptr);
@@ -602,6 +627,40 @@ void ocp_nlp_dynamics_cont_memory_get(void *config_, void *dims_, void *mem_, co
 
 
 
+void ocp_nlp_dynamics_cont_memory_get_by_id(void *config_, void *dims_, void *mem_, int field_id, void* value)
+{
+    ocp_nlp_dynamics_cont_memory *mem = mem_;
+
+    double *ptr = value;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_TIME_SIM:
+            *ptr = mem->time_sim;
+            break;
+        case ACADOS_FIELD_TIME_SIM_AD:
+            *ptr = mem->time_sim_ad;
+            break;
+        case ACADOS_FIELD_TIME_SIM_LA:
+            *ptr = mem->time_sim_la;
+            break;
+        default:
+            ocp_nlp_dynamics_cont_memory_get(config_, dims_, mem_, acados_field_name(field_id), value);
+    }
+
+}
+
+
+
+static void ocp_nlp_dynamics_cont_store_timings(ocp_nlp_dynamics_cont_memory *mem, sim_out *out)
+{
+    mem->time_sim = out->info->CPUtime;
+    mem->time_sim_ad = out->info->ADtime;
+    mem->time_sim_la = out->info->LAtime;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -622,7 +681,10 @@ acados_size_t ocp_nlp_dynamics_cont_workspace_calculate_size(void *config_, void
 
     size += sim_in_calculate_size(config->sim_solver, dims->sim);
     size += sim_out_calculate_size(config->sim_solver, dims->sim);
+    bool sens_adj = true;
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
     size += config->sim_solver->workspace_calculate_size(config->sim_solver, dims->sim, opts->sim_solver);
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
 
     size += 1 * blasfeo_memsize_dmat(nu+nx, nu+nx);   // hess
 
@@ -657,7 +719,10 @@ static void ocp_nlp_dynamics_cont_cast_workspace(void *config_, void *dims_, voi
     c_ptr += sim_out_calculate_size(config->sim_solver, dims->sim);
     // workspace
     work->sim_solver = c_ptr;
+    bool sens_adj = true;
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
     c_ptr += config->sim_solver->workspace_calculate_size(config->sim_solver, dims->sim, opts->sim_solver);
+    ocp_nlp_dynamics_cont_swap_sim_sens_adj(config, opts, &sens_adj);
 
     // blasfeo_mem align
     align_char_to(64, &c_ptr);
@@ -802,13 +867,17 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
 
     // initialize seeds
     // TODO fix dims if nx!=nx1 !!!!!!!!!!!!!!!!!
-    // set S_forw = [eye(nx), zeros(nx x nu)]
-    for(jj = 0; jj < nx1 * (nx + nu); jj++)
-        work->sim_in->S_forw[jj] = 0.0;
-    for(jj = 0; jj < nx1; jj++)
-        work->sim_in->S_forw[jj * (nx + 1)] = 1.0;
+    // S_forw = [eye(nx), zeros(nx x nu)], set up by the integrator from the flag
     work->sim_in->identity_seed = true;
 
+    // let the integrator write the sensitivities directly into the QP matrices
+    bool direct_sens = nx1 == nx;
+    if (direct_sens)
+    {
+        work->sim_out->BAbt = mem->BAbt;
+        work->sim_out->dzduxt = mem->dzduxt;
+    }
+
     // adjoint seed
     for(jj = 0; jj < nx + nu; jj++)
         work->sim_in->S_adj[jj] = 0.0;
@@ -817,16 +886,20 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
     // call integrator
     config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
             mem->sim_solver, work->sim_solver);
+    ocp_nlp_dynamics_cont_store_timings(mem, work->sim_out);
 
     // TODO transition functions for changing dimensions not yet implemented!
 
-    // B
-    blasfeo_pack_tran_dmat(nx1, nu, work->sim_out->S_forw + nx1 * nx, nx1, mem->BAbt, 0, 0);
-    // A
-    blasfeo_pack_tran_dmat(nx1, nx, work->sim_out->S_forw + 0, nx1, mem->BAbt, nu, 0);
-    // dzduxt
-    blasfeo_pack_tran_dmat(nz, nu, work->sim_out->S_algebraic + nx*nz, nz, mem->dzduxt, 0, 0);
-    blasfeo_pack_tran_dmat(nz, nx, work->sim_out->S_algebraic + 0, nz, mem->dzduxt, nu, 0);
+    if (!direct_sens)
+    {
+        // B
+        blasfeo_pack_tran_dmat(nx1, nu, work->sim_out->S_forw + nx1 * nx, nx1, mem->BAbt, 0, 0);
+        // A
+        blasfeo_pack_tran_dmat(nx1, nx, work->sim_out->S_forw + 0, nx1, mem->BAbt, nu, 0);
+        // dzduxt
+        blasfeo_pack_tran_dmat(nz, nu, work->sim_out->S_algebraic + nx*nz, nz, mem->dzduxt, 0, 0);
+        blasfeo_pack_tran_dmat(nz, nx, work->sim_out->S_algebraic + 0, nz, mem->dzduxt, nu, 0);
+    }
     // blasfeo_print_dmat(nx + nu, nz, mem->dzduxt, 0, 0);
 
     // function
@@ -946,6 +1019,7 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
     // call integrator
     config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
             mem->sim_solver, work->sim_solver);
+    ocp_nlp_dynamics_cont_store_timings(mem, work->sim_out);
 
 	// restore sens options
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
@@ -966,6 +1040,80 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
 
 
 
+void ocp_nlp_dynamics_cont_compute_fun_and_adj(void *config_, void *dims_, void *model_, void *opts_, void *mem_, void *work_)
+{
+    ocp_nlp_dynamics_cont_cast_workspace(config_, dims_, opts_, work_);
+
+    ocp_nlp_dynamics_config *config = config_;
+    ocp_nlp_dynamics_cont_dims *dims = dims_;
+    ocp_nlp_dynamics_cont_opts *opts = opts_;
+    ocp_nlp_dynamics_cont_workspace *work = work_;
+    ocp_nlp_dynamics_cont_memory *mem = mem_;
+    ocp_nlp_dynamics_cont_model *model = model_;
+
+    int jj;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nx1 = dims->nx1;
+    int nu1 = dims->nu1;
+
+    // setup model
+    work->sim_in->model = model->sim_model;
+    work->sim_in->T = model->T;
+
+    // pass state and control to integrator
+    blasfeo_unpack_dvec(nu, mem->ux, 0, work->sim_in->u, 1);
+    blasfeo_unpack_dvec(nx, mem->ux, nu, work->sim_in->x, 1);
+
+    // adjoint seed
+    for(jj = 0; jj < nx + nu; jj++)
+        work->sim_in->S_adj[jj] = 0.0;
+    blasfeo_unpack_dvec(nx1, mem->pi, 0, work->sim_in->S_adj, 1);
+
+    // do not touch the QP matrices
+    work->sim_out->BAbt = NULL;
+    work->sim_out->dzduxt = NULL;
+
+    // backup sens options
+    bool sens_forw_bkp, sens_adj_bkp, sens_hess_bkp;
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+
+    // adjoint sensitivities only
+    bool sens_true = true;
+    bool sens_false = false;
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_false);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_true);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_false);
+
+    // call integrator
+    config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
+            mem->sim_solver, work->sim_solver);
+    ocp_nlp_dynamics_cont_store_timings(mem, work->sim_out);
+
+    // restore sens options
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+
+    // function
+    blasfeo_pack_dvec(nx1, work->sim_out->xn, 1, &mem->fun, 0);
+    blasfeo_daxpy(nx1, -1.0, mem->ux1, nu1, &mem->fun, 0, &mem->fun, 0);
+
+    // adjoint
+    blasfeo_pack_dvec(nu, work->sim_out->S_adj+nx, 1, &mem->adj, 0);
+    blasfeo_pack_dvec(nx, work->sim_out->S_adj+0, 1, &mem->adj, nu);
+    blasfeo_dvecsc(nu+nx, -1.0, &mem->adj, 0);
+    blasfeo_dveccp(nx1, mem->pi, 0, &mem->adj, nu+nx);
+
+    return;
+
+}
+
+
+
 int ocp_nlp_dynamics_cont_precompute(void *config_, void *dims_, void *model_, void *opts_,
                                         void *mem_, void *work_)
 {
@@ -1026,10 +1174,12 @@ void ocp_nlp_dynamics_cont_config_initialize_default(void *config_)
     config->memory_set_sim_guess_ptr = &ocp_nlp_dynamics_cont_memory_set_sim_guess_ptr;
     config->memory_set_z_alg_ptr = &ocp_nlp_dynamics_cont_memory_set_z_alg_ptr;
     config->memory_get = &ocp_nlp_dynamics_cont_memory_get;
+    config->memory_get_by_id = &ocp_nlp_dynamics_cont_memory_get_by_id;
     config->workspace_calculate_size = &ocp_nlp_dynamics_cont_workspace_calculate_size;
     config->initialize = &ocp_nlp_dynamics_cont_initialize;
     config->update_qp_matrices = &ocp_nlp_dynamics_cont_update_qp_matrices;
     config->compute_fun = &ocp_nlp_dynamics_cont_compute_fun;
+    config->compute_fun_and_adj = &ocp_nlp_dynamics_cont_compute_fun_and_adj;
     config->precompute = &ocp_nlp_dynamics_cont_precompute;
     config->config_initialize_default = &ocp_nlp_dynamics_cont_config_initialize_default;
 
@@ -121,6 +121,9 @@ typedef struct
     // struct blasfeo_dvec *z;             // pointer to (input) z in nlp_out at current stage
     struct blasfeo_dmat *dzduxt;        // pointer to dzdux transposed
     void *sim_solver;                   // sim solver memory
+    double time_sim;                    // timings of the last integrator call
+    double time_sim_ad;
+    double time_sim_la;
 } ocp_nlp_dynamics_cont_memory;
 
 //
@@ -197,6 +200,8 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims, void *m
 //
 void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
 //
+void ocp_nlp_dynamics_cont_compute_fun_and_adj(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
+//
 int ocp_nlp_dynamics_cont_precompute(void *config_, void *dims, void *model_, void *opts_, void *mem_, void *work_);
 
 
@@ -39,6 +39,7 @@
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 // acados
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 
 
@@ -484,6 +485,23 @@ void ocp_nlp_dynamics_disc_memory_get(void *config_, void *dims_, void *mem_, co
 
 
 
+void ocp_nlp_dynamics_disc_memory_get_by_id(void *config_, void *dims_, void *mem_, int field_id, void* value)
+{
+    switch (field_id)
+    {
+        case ACADOS_FIELD_TIME_SIM:
+        case ACADOS_FIELD_TIME_SIM_AD:
+        case ACADOS_FIELD_TIME_SIM_LA:
+            *((double *) value) = 0;
+            break;
+        default:
+            ocp_nlp_dynamics_disc_memory_get(config_, dims_, mem_, acados_field_name(field_id), value);
+    }
+
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -496,7 +514,7 @@ acados_size_t ocp_nlp_dynamics_disc_workspace_calculate_size(void *config_, void
 
     int nx = dims->nx;
     int nu = dims->nu;
-    // int nx1 = dims->nx1;
+    int nx1 = dims->nx1;
 
     acados_size_t size = 0;
 
@@ -505,10 +523,11 @@ acados_size_t ocp_nlp_dynamics_disc_workspace_calculate_size(void *config_, void
     if (opts->compute_hess!=0)
     {
         size += 1 * blasfeo_memsize_dmat(nu+nx, nu+nx);   // tmp_nv_nv
+    }
 
-        size += 1*64;  // blasfeo_mem align
+    size += 1 * blasfeo_memsize_dmat(nu+nx, nx1);   // tmp_jac
 
-    }
+    size += 1*64;  // blasfeo_mem align
 
     return size;
 }
@@ -525,21 +544,23 @@ static void ocp_nlp_dynamics_disc_cast_workspace(void *config_, void *dims_, voi
 
     int nx = dims->nx;
     int nu = dims->nu;
-    // int nx1 = dims->nx1;
+    int nx1 = dims->nx1;
 
     char *c_ptr = (char *) work_;
     c_ptr += sizeof(ocp_nlp_dynamics_disc_workspace);
 
+    // blasfeo_mem align
+    align_char_to(64, &c_ptr);
+
     if (opts->compute_hess!=0)
     {
-        // blasfeo_mem align
-        align_char_to(64, &c_ptr);
-
         // tmp_nv_nv
         assign_and_advance_blasfeo_dmat_mem(nu+nx, nu+nx, &work->tmp_nv_nv, &c_ptr);
-
     }
 
+    // tmp_jac
+    assign_and_advance_blasfeo_dmat_mem(nu+nx, nx1, &work->tmp_jac, &c_ptr);
+
     assert((char *) work + ocp_nlp_dynamics_disc_workspace_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return;
@@ -794,6 +815,72 @@ void ocp_nlp_dynamics_disc_compute_fun(void *config_, void *dims_, void *model_,
 
 
 
+void ocp_nlp_dynamics_disc_compute_fun_and_adj(void *config_, void *dims_, void *model_, void *opts_,
+                                              void *mem_, void *work_)
+{
+    ocp_nlp_dynamics_disc_cast_workspace(config_, dims_, opts_, work_);
+
+    // ocp_nlp_dynamics_config *config = config_;
+    ocp_nlp_dynamics_disc_dims *dims = dims_;
+    // ocp_nlp_dynamics_disc_opts *opts = opts_;
+    ocp_nlp_dynamics_disc_workspace *work = work_;
+    ocp_nlp_dynamics_disc_memory *memory = mem_;
+    ocp_nlp_dynamics_disc_model *model = model_;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nx1 = dims->nx1;
+    int nu1 = dims->nu1;
+
+    ext_fun_arg_t ext_fun_type_in[2];
+    void *ext_fun_in[2];
+    ext_fun_arg_t ext_fun_type_out[2];
+    void *ext_fun_out[2];
+
+    // pass state and control to integrator
+    struct blasfeo_dvec_args x_in;  // input x of external fun;
+    x_in.x = memory->ux;
+    x_in.xi = nu;
+
+    struct blasfeo_dvec_args u_in;  // input u of external fun;
+    u_in.x = memory->ux;
+    u_in.xi = 0;
+
+    struct blasfeo_dvec_args fun_out;
+    fun_out.x = &memory->fun;
+    fun_out.xi = 0;
+
+    // Jacobian goes to workspace, the QP matrices are not touched
+    struct blasfeo_dmat_args jac_out;
+    jac_out.A = &work->tmp_jac;
+    jac_out.ai = 0;
+    jac_out.aj = 0;
+
+    ext_fun_type_in[0] = BLASFEO_DVEC_ARGS;
+    ext_fun_in[0] = &x_in;
+    ext_fun_type_in[1] = BLASFEO_DVEC_ARGS;
+    ext_fun_in[1] = &u_in;
+
+    ext_fun_type_out[0] = BLASFEO_DVEC_ARGS;
+    ext_fun_out[0] = &fun_out;  // fun: nx1
+    ext_fun_type_out[1] = BLASFEO_DMAT_ARGS;
+    ext_fun_out[1] = &jac_out;  // jac': (nu+nx) * nx1
+
+    // call external function
+    model->disc_dyn_fun_jac->evaluate(model->disc_dyn_fun_jac, ext_fun_type_in, ext_fun_in, ext_fun_type_out, ext_fun_out);
+
+    // fun
+    blasfeo_daxpy(nx1, -1.0, memory->ux1, nu1, &memory->fun, 0, &memory->fun, 0);
+
+    // adj
+    blasfeo_dgemv_n(nu+nx, nx1, -1.0, &work->tmp_jac, 0, 0, memory->pi, 0, 0.0, &memory->adj, 0, &memory->adj, 0);
+    blasfeo_dveccp(nx1, memory->pi, 0, &memory->adj, nu + nx);
+
+    return;
+}
+
+
+
 int ocp_nlp_dynamics_disc_precompute(void *config_, void *dims, void *model_, void *opts_,
                                         void *mem_, void *work_)
 {
@@ -835,10 +922,12 @@ void ocp_nlp_dynamics_disc_config_initialize_default(void *config_)
     config->memory_set_sim_guess_ptr = &ocp_nlp_dynamics_disc_memory_set_sim_guess_ptr;
     config->memory_set_z_alg_ptr = &ocp_nlp_dynamics_disc_memory_set_z_alg_ptr;
     config->memory_get = &ocp_nlp_dynamics_disc_memory_get;
+    config->memory_get_by_id = &ocp_nlp_dynamics_disc_memory_get_by_id;
     config->workspace_calculate_size = &ocp_nlp_dynamics_disc_workspace_calculate_size;
     config->initialize = &ocp_nlp_dynamics_disc_initialize;
     config->update_qp_matrices = &ocp_nlp_dynamics_disc_update_qp_matrices;
     config->compute_fun = &ocp_nlp_dynamics_disc_compute_fun;
+    config->compute_fun_and_adj = &ocp_nlp_dynamics_disc_compute_fun_and_adj;
     config->precompute = &ocp_nlp_dynamics_disc_precompute;
     config->config_initialize_default = &ocp_nlp_dynamics_disc_config_initialize_default;
 
@@ -143,6 +143,7 @@ void ocp_nlp_dynamics_disc_memory_set_BAbt_ptr(struct blasfeo_dmat *BAbt, void *
 typedef struct
 {
     struct blasfeo_dmat tmp_nv_nv;
+    struct blasfeo_dmat tmp_jac;  // (nu+nx) x nx1, Jacobian in compute_fun_and_adj
 } ocp_nlp_dynamics_disc_workspace;
 
 acados_size_t ocp_nlp_dynamics_disc_workspace_calculate_size(void *config, void *dims, void *opts);
@@ -181,6 +182,8 @@ void ocp_nlp_dynamics_disc_initialize(void *config_, void *dims, void *model_, v
 void ocp_nlp_dynamics_disc_update_qp_matrices(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
 //
 void ocp_nlp_dynamics_disc_compute_fun(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
+//
+void ocp_nlp_dynamics_disc_compute_fun_and_adj(void *config_, void *dims, void *model_, void *opts, void *mem, void *work_);
 
 
 
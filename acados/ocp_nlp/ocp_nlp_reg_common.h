@@ -96,7 +96,13 @@ typedef struct
     void (*memory_set_lam_ptr)(ocp_nlp_reg_dims *dims, struct blasfeo_dvec *vec, void *memory);
     /* functions */
     void (*regularize_hessian)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
+    // matrix-only part of regularize_hessian (can be done before the QP vectors are known)
+    void (*regularize_lhs)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
+    // remaining part of regularize_hessian, to be called after regularize_lhs
+    void (*regularize_rhs)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
     void (*correct_dual_sol)(void *config, ocp_nlp_reg_dims *dims, void *opts, void *memory);
+    // 1 if regularize_rhs modifies the Hessian, i.e. the QP matrices are final only after regularize_rhs
+    int rhs_modifies_hessian;
 } ocp_nlp_reg_config;
 
 //
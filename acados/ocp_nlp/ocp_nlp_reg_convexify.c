@@ -541,6 +541,14 @@ void ocp_nlp_reg_convexify_memory_set(void *config_, ocp_nlp_reg_dims *dims, voi
  * functions
  ************************************************/
 
+void ocp_nlp_reg_convexify_regularize_lhs(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
+{
+    // convexification also modifies the gradient and is done in regularize_rhs
+    return;
+}
+
+
+
 // NOTE this only considers the case of (dynamcs) equality constraints (no inequality constraints)
 // TODO inequality constraints case
 void ocp_nlp_reg_convexify_regularize_hessian(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
@@ -792,5 +800,8 @@ void ocp_nlp_reg_convexify_config_initialize_default(ocp_nlp_reg_config *config)
     config->memory_set_lam_ptr = &ocp_nlp_reg_convexify_memory_set_lam_ptr;
     // functions
     config->regularize_hessian = &ocp_nlp_reg_convexify_regularize_hessian;
+    config->regularize_lhs = &ocp_nlp_reg_convexify_regularize_lhs;
+    config->regularize_rhs = &ocp_nlp_reg_convexify_regularize_hessian;
     config->correct_dual_sol = &ocp_nlp_reg_convexify_correct_dual_sol;
+    config->rhs_modifies_hessian = 1;
 }
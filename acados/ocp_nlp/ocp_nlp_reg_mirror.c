@@ -292,6 +292,14 @@ void ocp_nlp_reg_mirror_regularize_hessian(void *config, ocp_nlp_reg_dims *dims,
 
 
 
+void ocp_nlp_reg_mirror_regularize_rhs(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
+{
+    // regularization only modifies the Hessian
+    return;
+}
+
+
+
 void ocp_nlp_reg_mirror_correct_dual_sol(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
 {
     return;
@@ -325,5 +333,8 @@ void ocp_nlp_reg_mirror_config_initialize_default(ocp_nlp_reg_config *config)
     config->memory_set_lam_ptr = &ocp_nlp_reg_mirror_memory_set_lam_ptr;
     // functions
     config->regularize_hessian = &ocp_nlp_reg_mirror_regularize_hessian;
+    config->regularize_lhs = &ocp_nlp_reg_mirror_regularize_hessian;
+    config->regularize_rhs = &ocp_nlp_reg_mirror_regularize_rhs;
     config->correct_dual_sol = &ocp_nlp_reg_mirror_correct_dual_sol;
+    config->rhs_modifies_hessian = 0;
 }
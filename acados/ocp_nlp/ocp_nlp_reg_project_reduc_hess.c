@@ -522,6 +522,14 @@ void ocp_nlp_reg_project_reduc_hess_regularize_hessian(void *config, ocp_nlp_reg
 
 
 
+void ocp_nlp_reg_project_reduc_hess_regularize_rhs(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
+{
+    // regularization only modifies the Hessian
+    return;
+}
+
+
+
 void ocp_nlp_reg_project_reduc_hess_correct_dual_sol(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
 {
     return;
@@ -555,6 +563,9 @@ void ocp_nlp_reg_project_reduc_hess_config_initialize_default(ocp_nlp_reg_config
     config->memory_set_lam_ptr = &ocp_nlp_reg_project_reduc_hess_memory_set_lam_ptr;
     // functions
     config->regularize_hessian = &ocp_nlp_reg_project_reduc_hess_regularize_hessian;
+    config->regularize_lhs = &ocp_nlp_reg_project_reduc_hess_regularize_hessian;
+    config->regularize_rhs = &ocp_nlp_reg_project_reduc_hess_regularize_rhs;
     config->correct_dual_sol = &ocp_nlp_reg_project_reduc_hess_correct_dual_sol;
+    config->rhs_modifies_hessian = 0;
 }
 
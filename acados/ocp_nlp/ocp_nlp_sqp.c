@@ -37,9 +37,6 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#if defined(ACADOS_WITH_OPENMP)
-#include <omp.h>
-#endif
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_aux.h"
@@ -50,6 +47,7 @@
 #include "acados/ocp_nlp/ocp_nlp_dynamics_cont.h"
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
@@ -125,6 +123,7 @@ void ocp_nlp_sqp_opts_initialize_default(void *config_, void *dims_, void *opts_
     opts->warm_start_first_qp = false;
     opts->rti_phase = 0;
     opts->initialize_t_slacks = 0;
+    opts->reuse_qp_lhs = 0;
 
     // overwrite default submodules opts
 
@@ -252,6 +251,16 @@ void ocp_nlp_sqp_opts_set(void *config_, void *opts_, const char *field, void* v
             }
             opts->initialize_t_slacks = *initialize_t_slacks;
         }
+        else if (!strcmp(field, "reuse_qp_lhs"))
+        {
+            int* reuse_qp_lhs = (int *) value;
+            if (*reuse_qp_lhs != 0 && *reuse_qp_lhs != 1)
+            {
+                printf("\nerror: ocp_nlp_sqp_opts_set: invalid value for reuse_qp_lhs field, need int 0 or 1, got %d.", *reuse_qp_lhs);
+                exit(1);
+            }
+            opts->reuse_qp_lhs = *reuse_qp_lhs;
+        }
         else
         {
             ocp_nlp_opts_set(config, nlp_opts, field, value);
@@ -308,6 +317,9 @@ acados_size_t ocp_nlp_sqp_memory_calculate_size(void *config_, void *dims_, void
         stat_n += 4;
     size += stat_n*stat_m*sizeof(double);
 
+    // qp lhs, also if reuse_qp_lhs is off: the option can be set after the memory is created
+    size += ocp_qp_in_calculate_size(dims->qp_solver->orig_dims);
+
     size += 3*8;  // align
 
     make_int_multiple_of(8, &size);
@@ -356,6 +368,14 @@ void *ocp_nlp_sqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
         mem->stat_n += 4;
     c_ptr += mem->stat_m*mem->stat_n*sizeof(double);
 
+    align_char_to(8, &c_ptr);
+
+    // qp lhs
+    mem->qp_lhs = ocp_qp_in_assign(dims->qp_solver->orig_dims, c_ptr);
+    c_ptr += ocp_qp_in_calculate_size(dims->qp_solver->orig_dims);
+    mem->qp_lhs_valid = 0;
+    mem->qp_lhs_reuse_count = 0;
+
     mem->status = ACADOS_READY;
 
     align_char_to(8, &c_ptr);
@@ -450,6 +470,144 @@ static void ocp_nlp_sqp_cast_workspace(ocp_nlp_config *config, ocp_nlp_dims *dim
  * functions
  ************************************************/
 
+// checks if the QP matrices (Hessian, dynamics and constraint Jacobians, slack Hessian)
+// or the bound and slack indices differ from the ones stored in qp_lhs
+static bool ocp_nlp_sqp_qp_lhs_changed(ocp_qp_in *qp_in, ocp_qp_in *qp_lhs)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+    int *ns = qp_in->dim->ns;
+
+    int ii, jj, kk;
+
+    for (ii = 0; ii <= N; ii++)
+    {
+        // Hessian (lower triangular part)
+        for (jj = 0; jj < nu[ii]+nx[ii]; jj++)
+        {
+            for (kk = 0; kk <= jj; kk++)
+            {
+                if (BLASFEO_DMATEL(qp_in->RSQrq+ii, jj, kk) != BLASFEO_DMATEL(qp_lhs->RSQrq+ii, jj, kk))
+                    return true;
+            }
+        }
+
+        // dynamics
+        if (ii < N)
+        {
+            for (jj = 0; jj < nu[ii]+nx[ii]; jj++)
+            {
+                for (kk = 0; kk < nx[ii+1]; kk++)
+                {
+                    if (BLASFEO_DMATEL(qp_in->BAbt+ii, jj, kk) != BLASFEO_DMATEL(qp_lhs->BAbt+ii, jj, kk))
+                        return true;
+                }
+            }
+        }
+
+        // general constraints
+        for (jj = 0; jj < nu[ii]+nx[ii]; jj++)
+        {
+            for (kk = 0; kk < ng[ii]; kk++)
+            {
+                if (BLASFEO_DMATEL(qp_in->DCt+ii, jj, kk) != BLASFEO_DMATEL(qp_lhs->DCt+ii, jj, kk))
+                    return true;
+            }
+        }
+
+        // slacks
+        for (jj = 0; jj < 2*ns[ii]; jj++)
+        {
+            if (BLASFEO_DVECEL(qp_in->Z+ii, jj) != BLASFEO_DVECEL(qp_lhs->Z+ii, jj))
+                return true;
+        }
+
+        // bound and slack indices
+        for (jj = 0; jj < nb[ii]; jj++)
+        {
+            if (qp_in->idxb[ii][jj] != qp_lhs->idxb[ii][jj])
+                return true;
+        }
+        for (jj = 0; jj < nb[ii]+ng[ii]; jj++)
+        {
+            if (qp_in->idxs_rev[ii][jj] != qp_lhs->idxs_rev[ii][jj])
+                return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+static void ocp_nlp_sqp_qp_lhs_copy(ocp_qp_in *qp_in, ocp_qp_in *qp_lhs)
+{
+    int N = qp_in->dim->N;
+    int *nx = qp_in->dim->nx;
+    int *nu = qp_in->dim->nu;
+    int *nb = qp_in->dim->nb;
+    int *ng = qp_in->dim->ng;
+    int *ns = qp_in->dim->ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < nb[ii]; jj++)
+            qp_lhs->idxb[ii][jj] = qp_in->idxb[ii][jj];
+        for (int jj = 0; jj < nb[ii]+ng[ii]; jj++)
+            qp_lhs->idxs_rev[ii][jj] = qp_in->idxs_rev[ii][jj];
+        blasfeo_dgecp(nu[ii]+nx[ii], nu[ii]+nx[ii], qp_in->RSQrq+ii, 0, 0, qp_lhs->RSQrq+ii, 0, 0);
+        if (ii < N)
+            blasfeo_dgecp(nu[ii]+nx[ii], nx[ii+1], qp_in->BAbt+ii, 0, 0, qp_lhs->BAbt+ii, 0, 0);
+        blasfeo_dgecp(nu[ii]+nx[ii], ng[ii], qp_in->DCt+ii, 0, 0, qp_lhs->DCt+ii, 0, 0);
+        blasfeo_dveccp(2*ns[ii], qp_in->Z+ii, 0, qp_lhs->Z+ii, 0);
+    }
+
+    return;
+}
+
+
+
+// solves the QP; with reuse_qp_lhs, the condensing of the matrices is only redone if they changed
+static int ocp_nlp_sqp_solve_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_sqp_opts *opts,
+            ocp_nlp_sqp_memory *mem, ocp_nlp_workspace *nlp_work)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+
+    if (!opts->reuse_qp_lhs)
+    {
+        // the condensed matrices no longer match qp_lhs
+        mem->qp_lhs_valid = 0;
+        return qp_solver->evaluate(qp_solver, dims->qp_solver, nlp_mem->qp_in, nlp_mem->qp_out,
+                    opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+    }
+
+    double tmp_time;
+
+    if (!mem->qp_lhs_valid || ocp_nlp_sqp_qp_lhs_changed(nlp_mem->qp_in, mem->qp_lhs))
+    {
+        qp_solver->condense_lhs(qp_solver, dims->qp_solver, nlp_mem->qp_in, nlp_mem->qp_out,
+                    opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_XCOND, &tmp_time);
+        mem->time_qp_xcond += tmp_time;
+
+        ocp_nlp_sqp_qp_lhs_copy(nlp_mem->qp_in, mem->qp_lhs);
+        mem->qp_lhs_valid = 1;
+    }
+    else
+    {
+        mem->qp_lhs_reuse_count++;
+    }
+
+    return qp_solver->condense_rhs_and_solve(qp_solver, dims->qp_solver, nlp_mem->qp_in, nlp_mem->qp_out,
+                opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+}
+
+
+
 int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                 void *opts_, void *mem_, void *work_)
 {
@@ -486,18 +644,14 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     mem->time_sim_la = 0.0;
     mem->time_sim_ad = 0.0;
 
+    mem->qp_lhs_reuse_count = 0;
+
     int N = dims->N;
     int ii;
     int qp_status = 0;
     int qp_iter = 0;
     double alpha = 0.0;
 
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-#endif
     ocp_nlp_alias_memory_to_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
     //
@@ -520,11 +674,11 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         // get timings from integrator
         for (ii=0; ii<N; ii++)
         {
-            config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], "time_sim", &tmp_time);
+            config->dynamics[ii]->memory_get_by_id(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], ACADOS_FIELD_TIME_SIM, &tmp_time);
             mem->time_sim += tmp_time;
-            config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], "time_sim_la", &tmp_time);
+            config->dynamics[ii]->memory_get_by_id(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], ACADOS_FIELD_TIME_SIM_LA, &tmp_time);
             mem->time_sim_la += tmp_time;
-            config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], "time_sim_ad", &tmp_time);
+            config->dynamics[ii]->memory_get_by_id(config->dynamics[ii], dims->dynamics[ii], mem->nlp_mem->dynamics[ii], ACADOS_FIELD_TIME_SIM_AD, &tmp_time);
             mem->time_sim_ad += tmp_time;
         }
 
@@ -556,10 +710,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             (nlp_res->inf_norm_res_ineq < opts->tol_ineq) &
             (nlp_res->inf_norm_res_comp < opts->tol_comp))
         {
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
             mem->status = ACADOS_SUCCESS;
             mem->sqp_iter = sqp_iter;
             mem->time_tot = acados_toc(&timer0);
@@ -578,10 +728,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         else if (isnan(nlp_res->inf_norm_res_stat) || isnan(nlp_res->inf_norm_res_eq) ||
              isnan(nlp_res->inf_norm_res_ineq) || isnan(nlp_res->inf_norm_res_comp))
         {
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
             mem->status = ACADOS_NAN_DETECTED;
             mem->sqp_iter = sqp_iter;
             mem->time_tot = acados_toc(&timer0);
@@ -615,13 +761,12 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 #endif
         // solve qp
         acados_tic(&timer1);
-        qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
-                                        opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        qp_status = ocp_nlp_sqp_solve_qp(config, dims, opts, mem, nlp_work);
         mem->time_qp_sol += acados_toc(&timer1);
 
-        qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
+        qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_SOLVER_CALL, &tmp_time);
         mem->time_qp_solver_call += tmp_time;
-        qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_xcond", &tmp_time);
+        qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_XCOND, &tmp_time);
         mem->time_qp_xcond += tmp_time;
 
         // compute correct dual solution in case of Hessian regularization
@@ -691,10 +836,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             printf("\nQP solver returned error status %d in SQP iteration %d, QP iteration %d.\n",
                    qp_status, sqp_iter, qp_iter);
 #endif
-#if defined(ACADOS_WITH_OPENMP)
-            // restore number of threads
-            omp_set_num_threads(num_threads_bkp);
-#endif
 
             if (nlp_opts->print_level > 1)
             {
@@ -858,8 +999,8 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
                 // solve QP
                 // acados_tic(&timer1);
-                qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver, qp_in, qp_out,
-                                                opts->nlp_opts->qp_solver_opts, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+                // NOTE: the QP matrices are the same as in the last QP, with reuse_qp_lhs only the vectors are condensed
+                qp_status = ocp_nlp_sqp_solve_qp(config, dims, opts, mem, nlp_work);
                 // tmp_time = acados_toc(&timer1);
                 // mem->time_qp_sol += tmp_time;
                 // qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
@@ -916,10 +1057,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                     printf("\nQP solver returned error status %d in SQP iteration %d for SOC QP in QP iteration %d.\n",
                         qp_status, sqp_iter, qp_iter);
         #endif
-        #if defined(ACADOS_WITH_OPENMP)
-                    // restore number of threads
-                    omp_set_num_threads(num_threads_bkp);
-        #endif
 
                     if (nlp_opts->print_level > 1)
                     {
@@ -969,10 +1106,6 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     // ocp_nlp_out_print(dims, nlp_out);
 
     // maximum number of iterations reached
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
 
     mem->status = ACADOS_MAXITER;
     mem->sqp_iter = sqp_iter;
@@ -1265,6 +1398,11 @@ void ocp_nlp_sqp_get(void *config_, void *dims_, void *mem_, const char *field,
         double *value = return_value_;
         *value = mem->nlp_mem->cost_value;
     }
+    else if (!strcmp("qp_lhs_reuse_count", field))
+    {
+        int *value = return_value_;
+        *value = mem->qp_lhs_reuse_count;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_sqp_get\n", field);
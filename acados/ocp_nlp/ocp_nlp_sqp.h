@@ -66,6 +66,7 @@ typedef struct
     bool warm_start_first_qp; // to set qp_warm_start in first iteration
     int rti_phase;       // only phase 0 at the moment 
     int initialize_t_slacks;  // 0-false or 1-true
+    int reuse_qp_lhs;    // skip condensing of the QP matrices if they did not change since the last QP (0-false or 1-true)
 
 } ocp_nlp_sqp_opts;
 
@@ -113,6 +114,11 @@ typedef struct
     int status;
     int sqp_iter;
 
+    // QP matrices and bound/slack indices of the last condense_lhs call (used if reuse_qp_lhs)
+    ocp_qp_in *qp_lhs;
+    int qp_lhs_valid;
+    int qp_lhs_reuse_count;  // number of QPs solved with the condensed matrices of a previous QP
+
 } ocp_nlp_sqp_memory;
 
 //
@@ -37,9 +37,6 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
-#if defined(ACADOS_WITH_OPENMP)
-#include <omp.h>
-#endif
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_aux.h"
@@ -50,6 +47,7 @@
 #include "acados/ocp_nlp/ocp_nlp_dynamics_cont.h"
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
@@ -122,6 +120,10 @@ void ocp_nlp_sqp_rti_opts_initialize_default(void *config_,
     opts->ext_qp_res = 0;
     opts->warm_start_first_qp = false;
     opts->rti_phase = 0;
+    opts->as_rti_level = STANDARD_RTI;
+    opts->as_rti_iter = 1;
+    opts->mli_level = LEVEL_D;
+    opts->mli_full_lin_interval = 1;
 
     // overwrite default submodules opts
 
@@ -217,6 +219,48 @@ void ocp_nlp_sqp_rti_opts_set(void *config_, void *opts_,
                 exit(1);
             } else opts->rti_phase = *rti_phase;
         }
+        else if (!strcmp(field, "as_rti_level"))
+        {
+            int* as_rti_level = (int *) value;
+            if (*as_rti_level < LEVEL_A || *as_rti_level > STANDARD_RTI)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: invalid value for as_rti_level field.");
+                printf("possible values are: 0 (LEVEL_A), 1 (LEVEL_B), 2 (LEVEL_C), 3 (LEVEL_D), 4 (STANDARD_RTI)\n");
+                exit(1);
+            }
+            opts->as_rti_level = *as_rti_level;
+        }
+        else if (!strcmp(field, "mli_level"))
+        {
+            int* mli_level = (int *) value;
+            if (*mli_level < LEVEL_A || *mli_level > LEVEL_D)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: invalid value for mli_level field.");
+                printf("possible values are: 0 (LEVEL_A), 1 (LEVEL_B), 2 (LEVEL_C), 3 (LEVEL_D)\n");
+                exit(1);
+            }
+            opts->mli_level = *mli_level;
+        }
+        else if (!strcmp(field, "mli_full_lin_interval"))
+        {
+            int* mli_full_lin_interval = (int *) value;
+            if (*mli_full_lin_interval < 1)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: mli_full_lin_interval has to be positive.\n");
+                exit(1);
+            }
+            opts->mli_full_lin_interval = *mli_full_lin_interval;
+        }
+        else if (!strcmp(field, "as_rti_iter"))
+        {
+            int* as_rti_iter = (int *) value;
+            if (*as_rti_iter < 0)
+            {
+                printf("\nerror: ocp_nlp_sqp_rti_opts_set: as_rti_iter has to be non-negative.\n");
+                exit(1);
+            }
+            opts->as_rti_iter = *as_rti_iter;
+        }
         else
         {
             ocp_nlp_opts_set(config, nlp_opts, field, value);
@@ -257,7 +301,8 @@ acados_size_t ocp_nlp_sqp_rti_memory_calculate_size(void *config_,
     // ocp_nlp_cost_config **cost = config->cost;
     // ocp_nlp_constraints_config **constraints = config->constraints;
 
-    // int N = dims->N;
+    int N = dims->N;
+    int *nv = dims->nv;
     // int *nx = dims->nx;
     // int *nu = dims->nu;
     // int *nz = dims->nz;
@@ -269,6 +314,12 @@ acados_size_t ocp_nlp_sqp_rti_memory_calculate_size(void *config_,
     // nlp mem
     size += ocp_nlp_memory_calculate_size(config, dims, nlp_opts);
 
+    // grad_corr
+    size += (N+1)*sizeof(struct blasfeo_dvec);
+    for (int ii = 0; ii <= N; ii++)
+        size += blasfeo_memsize_dvec(nv[ii]);
+    size += 64;  // blasfeo_mem align
+
     // stat
     int stat_m = 1+1;
     int stat_n = 2;
@@ -300,9 +351,10 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
 
     char *c_ptr = (char *) raw_memory;
 
-    // int ii;
+    int ii;
 
-    // int N = dims->N;
+    int N = dims->N;
+    int *nv = dims->nv;
     // int *nx = dims->nx;
     // int *nu = dims->nu;
     // int *nz = dims->nz;
@@ -325,7 +377,20 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
         mem->stat_n += 4;
     c_ptr += mem->stat_m*mem->stat_n*sizeof(double);
 
+    // grad_corr
+    assign_and_advance_blasfeo_dvec_structs(N+1, &mem->grad_corr, &c_ptr);
+    align_char_to(64, &c_ptr);
+    for (ii = 0; ii <= N; ii++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nv[ii], mem->grad_corr+ii, &c_ptr);
+        blasfeo_dvecse(nv[ii], 0.0, mem->grad_corr+ii, 0);
+    }
+
     mem->status = ACADOS_READY;
+    mem->alpha = 1.0;
+    mem->is_first_call = 1;
+    mem->mli_count = 0;
+    mem->mli_level_last = LEVEL_D;
 
     assert((char *) raw_memory+ocp_nlp_sqp_rti_memory_calculate_size(
         config, dims, opts) >= c_ptr);
@@ -370,6 +435,12 @@ acados_size_t ocp_nlp_sqp_rti_workspace_calculate_size(void *config_,
         size += ocp_qp_res_workspace_calculate_size(dims->qp_solver->orig_dims);
     }
 
+    // advanced-step RTI
+    size += 5*dims->nx[0]*sizeof(double);  // x0_pred, lbx0, ubx0, lbx0_pred, ubx0_pred
+    size += dims->nx[0]*sizeof(int);  // idxbx0
+
+    size += 8;  // align
+
     return size;
 }
 
@@ -412,6 +483,15 @@ static void ocp_nlp_sqp_rti_cast_workspace(
             dims->qp_solver->orig_dims);
     }
 
+    // advanced-step RTI
+    align_char_to(8, &c_ptr);
+    assign_and_advance_double(dims->nx[0], &work->x0_pred, &c_ptr);
+    assign_and_advance_double(dims->nx[0], &work->lbx0, &c_ptr);
+    assign_and_advance_double(dims->nx[0], &work->ubx0, &c_ptr);
+    assign_and_advance_double(dims->nx[0], &work->lbx0_pred, &c_ptr);
+    assign_and_advance_double(dims->nx[0], &work->ubx0_pred, &c_ptr);
+    assign_and_advance_int(dims->nx[0], &work->idxbx0, &c_ptr);
+
     assert((char *) work + ocp_nlp_sqp_rti_workspace_calculate_size(config,
         dims, opts) >= c_ptr);
 
@@ -424,43 +504,357 @@ static void ocp_nlp_sqp_rti_cast_workspace(
  * functions
  ************************************************/
 
+// simulate the first shooting interval with the current first control and
+// set the equality constrained bounds on x0 to the predicted state
+static void ocp_nlp_sqp_rti_predict_x0(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+    ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_nlp_opts *nlp_opts = opts->nlp_opts;
+    ocp_nlp_workspace *nlp_work = work->nlp_work;
+
+    int *nx = dims->nx;
+    int *nv = dims->nv;
+
+    int ii, nbx;
+
+    if (nx[0] != nx[1])
+    {
+        printf("\nerror: ocp_nlp_sqp_rti: advanced-step RTI requires nx[0] == nx[1], got %d, %d\n", nx[0], nx[1]);
+        exit(1);
+    }
+
+    // dynamics compute_fun evaluates x_next(tmp_ux) - tmp_ux1
+    blasfeo_dveccp(nv[0], nlp_out->ux, 0, nlp_work->tmp_nlp_out->ux, 0);
+    blasfeo_dvecse(nv[1], 0.0, nlp_work->tmp_nlp_out->ux+1, 0);
+    config->dynamics[0]->compute_fun(config->dynamics[0], dims->dynamics[0], nlp_in->dynamics[0],
+        nlp_opts->dynamics[0], nlp_mem->dynamics[0], nlp_work->dynamics[0]);
+    struct blasfeo_dvec *x_next = config->dynamics[0]->memory_get_fun_ptr(nlp_mem->dynamics[0]);
+    blasfeo_unpack_dvec(nx[1], x_next, 0, work->x0_pred, 1);
+
+    // replace the bounds with lbx == ubx, i.e. the initial state constraint, by the prediction;
+    // the bounds of the user are kept in lbx0, ubx0 and restored by ocp_nlp_sqp_rti_restore_x0
+    config->constraints[0]->dims_get(config->constraints[0], dims->constraints[0], "nbx", &nbx);
+    config->constraints[0]->model_get(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "idxbx", work->idxbx0);
+    config->constraints[0]->model_get(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "lbx", work->lbx0);
+    config->constraints[0]->model_get(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "ubx", work->ubx0);
+
+    for (ii = 0; ii < nbx; ii++)
+    {
+        work->lbx0_pred[ii] = work->lbx0[ii];
+        work->ubx0_pred[ii] = work->ubx0[ii];
+        if (work->lbx0[ii] == work->ubx0[ii])
+        {
+            work->lbx0_pred[ii] = work->x0_pred[work->idxbx0[ii]];
+            work->ubx0_pred[ii] = work->x0_pred[work->idxbx0[ii]];
+        }
+    }
+
+    config->constraints[0]->model_set(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "lbx", work->lbx0_pred);
+    config->constraints[0]->model_set(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "ubx", work->ubx0_pred);
+
+    return;
+}
+
+
+
+// restore the bounds on x0 saved by ocp_nlp_sqp_rti_predict_x0
+static void ocp_nlp_sqp_rti_restore_x0(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+    ocp_nlp_sqp_rti_workspace *work)
+{
+    config->constraints[0]->model_set(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "lbx", work->lbx0);
+    config->constraints[0]->model_set(config->constraints[0], dims->constraints[0],
+        nlp_in->constraints[0], "ubx", work->ubx0);
+
+    return;
+}
+
+
+
+// update the QP gradient and dynamics residuals in nlp memory to the current iterate,
+// keeping the QP matrices of the last linearization, see ocp_nlp_as_rti_level_t for the levels A, B, C
+// drop the gradient correction, e.g. after a new linearization
+static void ocp_nlp_sqp_rti_reset_grad_corr(ocp_nlp_dims *dims, ocp_nlp_sqp_rti_memory *mem)
+{
+    int N = dims->N;
+    int *nv = dims->nv;
+
+    for (int ii = 0; ii <= N; ii++)
+        blasfeo_dvecse(nv[ii], 0.0, mem->grad_corr+ii, 0);
+
+    return;
+}
+
+
+
+static void ocp_nlp_sqp_rti_update_qp_vectors_level(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+    ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work,
+    int level)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_nlp_opts *nlp_opts = opts->nlp_opts;
+    ocp_nlp_workspace *nlp_work = work->nlp_work;
+    ocp_qp_in *qp_in = nlp_mem->qp_in;
+    ocp_qp_out *qp_out = nlp_mem->qp_out;
+
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *nv = dims->nv;
+    int *ns = dims->ns;
+
+    int ii, jj;
+    double alpha = mem->alpha;
+    struct blasfeo_dvec *tmp_vec;
+
+    if (level == LEVEL_A)
+    {
+        for (ii = 0; ii <= N; ii++)
+        {
+            // gradient of the QP objective at the current iterate: g += alpha * H * step;
+            // accumulated in the correction, as cost_grad may alias the cost module memory
+            blasfeo_dsymv_l(nu[ii]+nx[ii], alpha, qp_in->RSQrq+ii, 0, 0, qp_out->ux+ii, 0,
+                1.0, mem->grad_corr+ii, 0, mem->grad_corr+ii, 0);
+            for (jj = 0; jj < 2*ns[ii]; jj++)
+                BLASFEO_DVECEL(mem->grad_corr+ii, nu[ii]+nx[ii]+jj) += alpha *
+                    BLASFEO_DVECEL(qp_in->Z+ii, jj) * BLASFEO_DVECEL(qp_out->ux+ii, nu[ii]+nx[ii]+jj);
+
+            // linearized dynamics at the current iterate: b += alpha * (BAbt^T * step_i - step_x_{i+1})
+            if (ii < N)
+            {
+                blasfeo_dgemv_t(nu[ii]+nx[ii], nx[ii+1], alpha, qp_in->BAbt+ii, 0, 0, qp_out->ux+ii, 0,
+                    1.0, nlp_mem->dyn_fun+ii, 0, nlp_mem->dyn_fun+ii, 0);
+                blasfeo_daxpy(nx[ii+1], -alpha, qp_out->ux+ii+1, nu[ii+1], nlp_mem->dyn_fun+ii, 0,
+                    nlp_mem->dyn_fun+ii, 0);
+            }
+        }
+        return;
+    }
+
+    // the QP gradient is re-evaluated, only LEVEL_C sets a correction below
+    ocp_nlp_sqp_rti_reset_grad_corr(dims, mem);
+
+    // cost gradient, the cost Hessian goes to a scratch matrix
+    for (ii = 0; ii <= N; ii++)
+    {
+        blasfeo_dgese(nu[ii]+nx[ii], nu[ii]+nx[ii], 0.0, work->tmp_qp_in->RSQrq+ii, 0, 0);
+        config->cost[ii]->memory_set_RSQrq_ptr(work->tmp_qp_in->RSQrq+ii, nlp_mem->cost[ii]);
+        config->cost[ii]->update_qp_matrices(config->cost[ii], dims->cost[ii], nlp_in->cost[ii],
+            nlp_opts->cost[ii], nlp_mem->cost[ii], nlp_work->cost[ii]);
+        config->cost[ii]->memory_set_RSQrq_ptr(qp_in->RSQrq+ii, nlp_mem->cost[ii]);
+
+        tmp_vec = config->cost[ii]->memory_get_grad_ptr(nlp_mem->cost[ii]);
+        blasfeo_dveccp(nv[ii], tmp_vec, 0, nlp_mem->cost_grad+ii, 0);
+    }
+
+    if (level == LEVEL_B)
+    {
+        // simulate all shooting intervals without sensitivities
+        for (ii = 0; ii <= N; ii++)
+            blasfeo_dveccp(nv[ii], nlp_out->ux+ii, 0, nlp_work->tmp_nlp_out->ux+ii, 0);
+
+        for (ii = 0; ii < N; ii++)
+        {
+            config->dynamics[ii]->compute_fun(config->dynamics[ii], dims->dynamics[ii], nlp_in->dynamics[ii],
+                nlp_opts->dynamics[ii], nlp_mem->dynamics[ii], nlp_work->dynamics[ii]);
+            tmp_vec = config->dynamics[ii]->memory_get_fun_ptr(nlp_mem->dynamics[ii]);
+            blasfeo_dveccp(nx[ii+1], tmp_vec, 0, nlp_mem->dyn_fun+ii, 0);
+        }
+    }
+    else // LEVEL_C
+    {
+        // simulate with adjoint sensitivities and compute the gradient correction for the frozen Jacobians:
+        // corr = (J_old - J_new)^T pi = BAbt * pi + adj, with adj = -J_new^T pi and J_old^T = BAbt;
+        // it is added to the QP gradient only, as cost_grad may alias the cost module memory
+        for (ii = 0; ii < N; ii++)
+        {
+            config->dynamics[ii]->compute_fun_and_adj(config->dynamics[ii], dims->dynamics[ii],
+                nlp_in->dynamics[ii], nlp_opts->dynamics[ii], nlp_mem->dynamics[ii], nlp_work->dynamics[ii]);
+            tmp_vec = config->dynamics[ii]->memory_get_fun_ptr(nlp_mem->dynamics[ii]);
+            blasfeo_dveccp(nx[ii+1], tmp_vec, 0, nlp_mem->dyn_fun+ii, 0);
+
+            tmp_vec = config->dynamics[ii]->memory_get_adj_ptr(nlp_mem->dynamics[ii]);
+            blasfeo_dgemv_n(nu[ii]+nx[ii], nx[ii+1], 1.0, qp_in->BAbt+ii, 0, 0, nlp_out->pi+ii, 0,
+                1.0, tmp_vec, 0, mem->grad_corr+ii, 0);
+        }
+    }
+
+    return;
+}
+
+
+
+// add the gradient correction of LEVEL_A and LEVEL_C to the QP gradient,
+// after it has been set by ocp_nlp_approximate_qp_vectors_sqp
+static void ocp_nlp_sqp_rti_add_grad_corr(ocp_nlp_dims *dims, ocp_nlp_sqp_rti_memory *mem)
+{
+    ocp_qp_in *qp_in = mem->nlp_mem->qp_in;
+
+    int N = dims->N;
+    int *nv = dims->nv;
+
+    for (int ii = 0; ii <= N; ii++)
+        blasfeo_daxpy(nv[ii], 1.0, mem->grad_corr+ii, 0, qp_in->rqz+ii, 0, qp_in->rqz+ii, 0);
+
+    return;
+}
+
+
+
+// advanced-step RTI: iterate on the problem with predicted initial state
+static void ocp_nlp_sqp_rti_advanced_step(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
+    ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
+{
+    ocp_nlp_memory *nlp_mem = mem->nlp_mem;
+    ocp_nlp_opts *nlp_opts = opts->nlp_opts;
+    ocp_nlp_workspace *nlp_work = work->nlp_work;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+
+    int iter;
+    int qp_status;
+
+    ocp_nlp_sqp_rti_predict_x0(config, dims, nlp_in, nlp_out, opts, mem, work);
+
+    for (iter = 0; iter < opts->as_rti_iter; iter++)
+    {
+        if (opts->as_rti_level == LEVEL_D)
+        {
+            // full SQP iteration
+            ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+            ocp_nlp_sqp_rti_reset_grad_corr(dims, mem);
+            ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+
+            config->regularize->regularize_hessian(config->regularize,
+                dims->regularize, nlp_opts->regularize, nlp_mem->regularize_mem);
+
+            qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver,
+                nlp_mem->qp_in, nlp_mem->qp_out, nlp_opts->qp_solver_opts,
+                nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        }
+        else
+        {
+            // keep QP matrices (and their condensing), update vectors
+            ocp_nlp_sqp_rti_update_qp_vectors_level(config, dims, nlp_in, nlp_out, opts, mem, work,
+                opts->as_rti_level);
+            ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+            ocp_nlp_sqp_rti_add_grad_corr(dims, mem);
+
+            config->regularize->regularize_rhs(config->regularize,
+                dims->regularize, nlp_opts->regularize, nlp_mem->regularize_mem);
+            if (config->regularize->rhs_modifies_hessian)
+            {
+                qp_solver->condense_lhs(qp_solver, dims->qp_solver,
+                    nlp_mem->qp_in, nlp_mem->qp_out, nlp_opts->qp_solver_opts,
+                    nlp_mem->qp_solver_mem, nlp_work->qp_work);
+            }
+
+            qp_status = qp_solver->condense_rhs_and_solve(qp_solver, dims->qp_solver,
+                nlp_mem->qp_in, nlp_mem->qp_out, nlp_opts->qp_solver_opts,
+                nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        }
+
+        if ((qp_status!=ACADOS_SUCCESS) & (qp_status!=ACADOS_MAXITER))
+        {
+#ifndef ACADOS_SILENT
+            printf("\nSQP_RTI: QP solver returned error status %d in advanced-step iteration %d.\n",
+                    qp_status, iter);
+#endif
+            break;
+        }
+
+        config->regularize->correct_dual_sol(config->regularize,
+            dims->regularize, nlp_opts->regularize, nlp_mem->regularize_mem);
+
+        // full step
+        ocp_nlp_update_variables_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, 1.0);
+        mem->alpha = 1.0;
+    }
+
+    ocp_nlp_sqp_rti_restore_x0(config, dims, nlp_in, work);
+
+    return;
+}
+
+
+
 static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
     ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
 {
     acados_timer timer1;
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
     ocp_nlp_opts *nlp_opts = opts->nlp_opts;
-    // ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
 
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    double tmp_time;
     mem->time_lin = 0.0;
     mem->time_reg = 0.0;
-
-#if defined(ACADOS_WITH_OPENMP)
-    // backup number of threads
-    int num_threads_bkp = omp_get_num_threads();
-    // set number of threads
-    omp_set_num_threads(opts->nlp_opts->num_threads);
-#endif
+    mem->time_qp_xcond = 0.0;
 
     ocp_nlp_alias_memory_to_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
     // initialize QP
     ocp_nlp_initialize_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
+    // advanced-step RTI, needs the QP of the last preparation and the step of the last feedback phase
+    if (opts->as_rti_level != STANDARD_RTI && opts->rti_phase == 1 && !mem->is_first_call)
+    {
+        acados_tic(&timer1);
+        ocp_nlp_sqp_rti_advanced_step(config, dims, nlp_in, nlp_out, opts, mem, work);
+        mem->time_lin += acados_toc(&timer1);
+    }
+
     /* SQP body */
-    // linearizate NLP and update QP matrices
-    acados_tic(&timer1);
-    ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
-        nlp_out, nlp_opts, nlp_mem, nlp_work);
+    // multi-level iteration: full linearization every mli_full_lin_interval-th call
+    int level = opts->mli_level;
+    if (mem->is_first_call || mem->mli_count+1 >= opts->mli_full_lin_interval)
+        level = LEVEL_D;
 
-    mem->time_lin += acados_toc(&timer1);
+    if (level == LEVEL_D)
+    {
+        // linearizate NLP and update QP matrices
+        acados_tic(&timer1);
+        ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
+            nlp_out, nlp_opts, nlp_mem, nlp_work);
+        ocp_nlp_sqp_rti_reset_grad_corr(dims, mem);
+
+        mem->time_lin += acados_toc(&timer1);
+
+        // regularize Hessian (matrix-only part)
+        acados_tic(&timer1);
+        config->regularize->regularize_lhs(config->regularize,
+            dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
+        mem->time_reg += acados_toc(&timer1);
+
+        // condense QP matrices
+        if (!config->regularize->rhs_modifies_hessian)
+        {
+            qp_solver->condense_lhs(qp_solver, dims->qp_solver,
+                nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
+                nlp_mem->qp_solver_mem, nlp_work->qp_work);
+            qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_XCOND, &tmp_time);
+            mem->time_qp_xcond += tmp_time;
+        }
 
-#if defined(ACADOS_WITH_OPENMP)
-    // restore number of threads
-    omp_set_num_threads(num_threads_bkp);
-#endif
+        mem->mli_count = 0;
+    }
+    else
+    {
+        // keep QP matrices (and their condensing), update QP vectors
+        acados_tic(&timer1);
+        ocp_nlp_sqp_rti_update_qp_vectors_level(config, dims, nlp_in, nlp_out, opts, mem, work, level);
+        mem->time_lin += acados_toc(&timer1);
+
+        mem->mli_count++;
+    }
+    mem->mli_level_last = level;
 
     return;
 
@@ -483,19 +877,32 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
     double tmp_time;
     mem->time_qp_sol = 0.0;
     mem->time_qp_solver_call = 0.0;
-    mem->time_qp_xcond = 0.0;
     mem->time_glob = 0.0;
+    // a combined call keeps the condensing time of its preparation phase
+    if (opts->rti_phase == 2)
+        mem->time_qp_xcond = 0.0;
 
     // update QP rhs for SQP (step prim var, abs dual var)
     ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
+    ocp_nlp_sqp_rti_add_grad_corr(dims, mem);
 
-    // regularize Hessian
+    // regularize Hessian (vector-dependent part)
     acados_tic(&timer1);
-    config->regularize->regularize_hessian(config->regularize,
+    config->regularize->regularize_rhs(config->regularize,
         dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize_mem);
     mem->time_reg += acados_toc(&timer1);
 
+    // condense QP matrices, if they have been modified by the regularization
+    if (config->regularize->rhs_modifies_hessian)
+    {
+        qp_solver->condense_lhs(qp_solver, dims->qp_solver,
+            nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
+            nlp_mem->qp_solver_mem, nlp_work->qp_work);
+        qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_XCOND, &tmp_time);
+        mem->time_qp_xcond += tmp_time;
+    }
+
     if (nlp_opts->print_level > 0) {
         printf("\n------- qp_in --------\n");
         print_ocp_qp_in(nlp_mem->qp_in);
@@ -508,17 +915,17 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
             opts->nlp_opts->qp_solver_opts, "warm_start", &tmp_int);
     }
 
-    // solve qp
+    // condense QP vectors, solve qp and expand
     acados_tic(&timer1);
-    qp_status = qp_solver->evaluate(qp_solver, dims->qp_solver,
+    qp_status = qp_solver->condense_rhs_and_solve(qp_solver, dims->qp_solver,
         nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
         nlp_mem->qp_solver_mem, nlp_work->qp_work);
 
     mem->time_qp_sol += acados_toc(&timer1);
 
-    qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_solver_call", &tmp_time);
+    qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_SOLVER_CALL, &tmp_time);
     mem->time_qp_solver_call += tmp_time;
-    qp_solver->memory_get(qp_solver, nlp_mem->qp_solver_mem, "time_qp_xcond", &tmp_time);
+    qp_solver->memory_get_by_id(qp_solver, nlp_mem->qp_solver_mem, ACADOS_FIELD_TIME_QP_XCOND, &tmp_time);
     mem->time_qp_xcond += tmp_time;
 
     // compute correct dual solution in case of Hessian regularization
@@ -577,6 +984,8 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
 
     // update variables
     ocp_nlp_update_variables_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, alpha);
+    mem->alpha = alpha;
+    mem->is_first_call = 0;
 
     // ocp_nlp_dims_print(nlp_out->dims);
     // ocp_nlp_out_print(nlp_out);
@@ -822,6 +1231,11 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
         double *value = return_value_;
         *value = mem->time_solution_sensitivities;
     }
+    else if (!strcmp("mli_level", field))
+    {
+        int *value = return_value_;
+        *value = mem->mli_level_last;
+    }
     else if (!strcmp("stat", field))
     {
         double **value = return_value_;
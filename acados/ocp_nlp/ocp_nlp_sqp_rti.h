@@ -53,6 +53,24 @@ extern "C" {
  * options
  ************************************************/
 
+/// Levels of the QP update for multi-level iterations and advanced-step RTI (AS-RTI).
+/// Multi-level iterations: the preparation phase does a full linearization (LEVEL_D) only every
+/// mli_full_lin_interval-th call and the cheaper update of level mli_level otherwise.
+/// AS-RTI: in the preparation phase, the initial state is predicted by simulating the first shooting
+/// interval with the current first control, and as_rti_iter iterations of level as_rti_level are
+/// performed on the problem with the predicted initial state, before the QP for the next feedback
+/// phase is prepared.
+typedef enum
+{
+    LEVEL_A,       // QP matrices and vectors kept, vectors are shifted linearly to the current iterate
+    LEVEL_B,       // QP matrices kept, dynamics residuals and cost gradient re-evaluated
+    LEVEL_C,       // as LEVEL_B, plus adjoint-based gradient correction for the frozen dynamics Jacobians
+    LEVEL_D,       // full linearization
+    STANDARD_RTI,  // no advanced step
+} ocp_nlp_as_rti_level_t;
+
+
+
 typedef struct
 {
     ocp_nlp_opts *nlp_opts;
@@ -61,6 +79,10 @@ typedef struct
     int qp_warm_start;        // NOTE: this is not actually setting the warm_start! Just for compatibility with sqp.
     bool warm_start_first_qp; // to set qp_warm_start in first iteration
     int rti_phase;            // phase of RTI. Possible values 1 (preparation), 2 (feedback) 0 (both)
+    int as_rti_level;         // advanced-step RTI level, see ocp_nlp_as_rti_level_t; only used with rti_phase 1
+    int as_rti_iter;          // number of advanced-step iterations in the preparation phase
+    int mli_level;            // multi-level iteration: level of the preparation phase between full linearizations
+    int mli_full_lin_interval; // multi-level iteration: full linearization every k-th preparation phase
 
 } ocp_nlp_sqp_rti_opts;
 
@@ -98,6 +120,18 @@ typedef struct
     double time_glob;
     double time_solution_sensitivities;
 
+    // advanced-step RTI
+    double alpha;             // step size of the last iterate update
+    int is_first_call;        // no feedback step has been performed yet
+
+    // multi-level iteration
+    int mli_count;            // preparation phases since the last full linearization
+    int mli_level_last;       // level used in the last preparation phase
+
+    // correction of the QP gradient, added to the QP copy only: the linear shift of LEVEL_A and the
+    // adjoint correction for the frozen dynamics Jacobians of LEVEL_C; zero after a new linearization
+    struct blasfeo_dvec *grad_corr;
+
     // statistics
     double *stat;
     int stat_m;
@@ -131,6 +165,13 @@ typedef struct
     ocp_qp_res *qp_res;
     ocp_qp_res_ws *qp_res_ws;
 
+    // advanced-step RTI: predicted initial state, bounds on x0 of the user and with prediction
+    double *x0_pred;
+    double *lbx0;
+    double *ubx0;
+    double *lbx0_pred;
+    double *ubx0_pred;
+    int *idxbx0;
 
 } ocp_nlp_sqp_rti_workspace;
 
@@ -94,6 +94,8 @@ typedef struct
     void (*memory_get)(void *config, void *mem, const char *field, void* value);
     acados_size_t (*workspace_calculate_size)(void *dims, void *opts);
     int (*condensing)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
+    // matrix part of condensing only, to be complemented by condensing_rhs
+    int (*condensing_lhs)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     int (*condensing_rhs)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     int (*expansion)(void *qp_in, void *qp_out, void *opts, void *mem, void *work);
 } ocp_qp_xcond_config;
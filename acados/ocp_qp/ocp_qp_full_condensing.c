@@ -282,6 +282,16 @@ void ocp_qp_full_condensing_opts_set(void *opts_, const char *field, void* value
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_eq(opts->hpipm_red_opts, *tmp_ptr);
         d_ocp_qp_reduce_eq_dof_arg_set_comp_dual_sol_ineq(opts->hpipm_red_opts, *tmp_ptr);
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        // full condensing has a single block, the option of partial condensing has no effect here
+        int *tmp_ptr = value;
+        if (*tmp_ptr < 1)
+        {
+            printf("\nerror: ocp_qp_full_condensing_opts_set: num_threads has to be >= 1, got %d\n", *tmp_ptr);
+            exit(1);
+        }
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_qp_full_condensing_opts_set\n", field);
@@ -484,7 +494,7 @@ int ocp_qp_full_condensing(void *qp_in_, void *fcond_qp_in_, void *opts_, void *
 
 
 
-int ocp_qp_full_condensing_rhs(void *qp_in_, void *fcond_qp_in_, void *opts_, void *mem_, void *work_)
+int ocp_qp_full_condensing_lhs(void *qp_in_, void *fcond_qp_in_, void *opts_, void *mem_, void *work_)
 {
     ocp_qp_in *qp_in = qp_in_;
     dense_qp_in *fcond_qp_in = fcond_qp_in_;
@@ -500,7 +510,39 @@ int ocp_qp_full_condensing_rhs(void *qp_in_, void *fcond_qp_in_, void *opts_, vo
     mem->ptr_qp_in = qp_in;
 
     // reduce eq constr DOF
-    d_ocp_qp_reduce_eq_dof(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
+    d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
+
+    // condense Hessian and constraint matrices
+    if (opts->cond_hess != 0)
+    {
+        d_cond_qp_cond_lhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
+    }
+
+    // stop timer
+    mem->time_qp_xcond = acados_toc(&timer);
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+int ocp_qp_full_condensing_rhs(void *qp_in_, void *fcond_qp_in_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    dense_qp_in *fcond_qp_in = fcond_qp_in_;
+    ocp_qp_full_condensing_opts *opts = opts_;
+    ocp_qp_full_condensing_memory *mem = mem_;
+
+    acados_timer timer;
+
+    // start timer
+    acados_tic(&timer);
+
+    // save pointer to ocp_qp_in in memory (needed for expansion)
+    mem->ptr_qp_in = qp_in;
+
+    // reduce eq constr DOF, matrices are kept from the last condensing or condensing_lhs call
+    d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // condense gradient only
     d_cond_qp_cond_rhs(mem->red_qp, fcond_qp_in, opts->hpipm_cond_opts, mem->hpipm_cond_work);
@@ -567,6 +609,7 @@ void ocp_qp_full_condensing_config_initialize_default(void *config_)
     config->memory_get = &ocp_qp_full_condensing_memory_get;
     config->workspace_calculate_size = &ocp_qp_full_condensing_workspace_calculate_size;
     config->condensing = &ocp_qp_full_condensing;
+    config->condensing_lhs = &ocp_qp_full_condensing_lhs;
     config->condensing_rhs = &ocp_qp_full_condensing_rhs;
     config->expansion = &ocp_qp_full_expansion;
 
@@ -30,6 +30,8 @@
 
 
 #include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
@@ -212,13 +214,19 @@ static void cpy_osqp_settings(OSQPSettings *from, OSQPSettings *to)
 
 
 
+// OSQP problem layout:
+// - variables are stacked stage-wise as [u, x, sl, su], i.e. in the layout of ocp_qp_out->ux;
+// - constraint rows are grouped in blocks [dynamics, general, bounds, soft upper, slack bounds];
+// - a soft constraint lb - sl <= D*ux <= ub + su keeps its original row for the lower side
+//   (with upper bound +inf) and gets an additional row in the soft upper block for the upper side.
+
 static int acados_osqp_num_vars(ocp_qp_dims *dims)
 {
     int n = 0;
 
     for (int ii = 0; ii <= dims->N; ii++)
     {
-        n += dims->nx[ii] + dims->nu[ii];
+        n += dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii];
     }
 
     return n;
@@ -226,6 +234,20 @@ static int acados_osqp_num_vars(ocp_qp_dims *dims)
 
 
 
+static int acados_osqp_num_slacks(const ocp_qp_dims *dims)
+{
+    int ns = 0;
+
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        ns += dims->ns[ii];
+    }
+
+    return ns;
+}
+
+
+
 static int acados_osqp_num_constr(ocp_qp_dims *dims)
 {
     int m = 0;
@@ -234,6 +256,7 @@ static int acados_osqp_num_constr(ocp_qp_dims *dims)
     {
         m += dims->nb[ii];
         m += dims->ng[ii];
+        m += 3 * dims->ns[ii];  // soft upper rows, slack bounds
 
         if (ii < dims->N)
         {
@@ -255,6 +278,7 @@ static int acados_osqp_nnzmax_P(const ocp_qp_dims *dims)
         nnz += dims->nx[ii] * dims->nx[ii];      // Q
         nnz += dims->nu[ii] * dims->nu[ii];      // R
         nnz += 2 * dims->nx[ii] * dims->nu[ii];  // S
+        nnz += 2 * dims->ns[ii];                 // Z
     }
 
     return nnz;
@@ -273,6 +297,9 @@ static int acados_osqp_nnzmax_A(const ocp_qp_dims *dims)
         nnz += dims->ng[ii] * dims->nx[ii];  // C
         nnz += dims->ng[ii] * dims->nu[ii];  // D
 
+        // soft constraints: slack in the lower row, upper row, slack bounds
+        nnz += dims->ns[ii] * (dims->nx[ii] + dims->nu[ii] + 4);
+
         // equality constraints
         if (ii < dims->N)
         {
@@ -294,8 +321,10 @@ static void update_gradient(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 
     for (kk = 0; kk <= dims->N; kk++)
     {
-        blasfeo_unpack_dvec(dims->nu[kk] + dims->nx[kk], in->rqz + kk, 0, &mem->q[nn], 1);
-        nn += dims->nu[kk] + dims->nx[kk];
+        // r, q, zl, zu
+        blasfeo_unpack_dvec(dims->nu[kk] + dims->nx[kk] + 2 * dims->ns[kk], in->rqz + kk, 0,
+                            &mem->q[nn], 1);
+        nn += dims->nu[kk] + dims->nx[kk] + 2 * dims->ns[kk];
     }
 }
 
@@ -321,7 +350,14 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
             }
         }
 
-        offset += dims->nx[kk] + dims->nu[kk];
+        // writing diag(Z[kk])
+        for (jj = 0; jj < 2 * dims->ns[kk]; jj++)
+        {
+            mem->P_p[col++] = nn;
+            mem->P_i[nn++] = offset + dims->nx[kk] + dims->nu[kk] + jj;
+        }
+
+        offset += dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk];
     }
 
     mem->P_p[col] = nn;
@@ -329,9 +365,12 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
 
 
-static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+// returns 1 if any entry of P_x changed w.r.t. the previous call
+static int update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     c_int ii, jj, kk, nn = 0;
+    int changed = 0;
+    c_float tmp;
     ocp_qp_dims *dims = in->dim;
 
     // Traversing the matrix in column-major order
@@ -345,30 +384,84 @@ static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
                 // we write the lower triangular part in row-major order
                 // that's the same as writing the upper triangular part in
                 // column-major order
-                mem->P_x[nn++] = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
+                tmp = BLASFEO_DMATEL(&in->RSQrq[kk], ii, jj);
+                if (mem->P_x[nn] != tmp)
+                {
+                    mem->P_x[nn] = tmp;
+                    changed = 1;
+                }
+                nn++;
+            }
+        }
+
+        // writing diag(Z[kk])
+        for (ii = 0; ii < 2 * dims->ns[kk]; ii++)
+        {
+            tmp = BLASFEO_DVECEL(&in->Z[kk], ii);
+            if (mem->P_x[nn] != tmp)
+            {
+                mem->P_x[nn] = tmp;
+                changed = 1;
             }
+            nn++;
         }
     }
+
+    return changed;
 }
 
 
 
 static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
-    c_int ii, jj, kk, nn = 0, col = 0;
-    c_int con_start = 0, bnd_start = 0;
+    c_int ii, jj, kk, js, nn = 0, col = 0;
+    c_int con_start = 0, bnd_start = 0, soft_start = 0, slk_start = 0;
     c_int row_offset_dyn = 0, row_offset_con = 0, row_offset_bnd = 0;
+    c_int row_offset_soft = 0;
+    c_int *idxs = mem->idxs;
     ocp_qp_dims *dims = in->dim;
 
     for (kk = 0; kk <= dims->N; kk++)
     {
         con_start += kk < dims->N ? dims->nx[kk + 1] : 0;
         bnd_start += dims->ng[kk];
+        soft_start += dims->nb[kk];
+        slk_start += dims->ns[kk];
+
+        // constraint index of each slack, the mapping of OSQP needs one constraint per slack
+        for (js = 0; js < dims->ns[kk]; js++)
+            idxs[js] = -1;
+        for (js = 0; js < dims->nb[kk] + dims->ng[kk]; js++)
+        {
+            if (in->idxs_rev[kk][js] != -1)
+            {
+                if (idxs[in->idxs_rev[kk][js]] != -1)
+                {
+                    printf("\nerror: ocp_qp_osqp: slack %d of stage %d softens more than one constraint,"
+                           " not supported by the OSQP interface\n", in->idxs_rev[kk][js], (int) kk);
+                    exit(1);
+                }
+                idxs[in->idxs_rev[kk][js]] = js;
+            }
+        }
+        for (js = 0; js < dims->ns[kk]; js++)
+        {
+            if (idxs[js] == -1)
+            {
+                printf("\nerror: ocp_qp_osqp: slack %d of stage %d softens no constraint,"
+                       " not supported by the OSQP interface\n", (int) js, (int) kk);
+                exit(1);
+            }
+        }
+        idxs += dims->ns[kk];
     }
 
     bnd_start += con_start;
+    soft_start += bnd_start;
+    slk_start += soft_start;
 
     // CSC format: A_i are row indices and A_p are column pointers
+    idxs = mem->idxs;
     for (kk = 0; kk <= dims->N; kk++)
     {
         int nbu = 0;
@@ -402,6 +495,16 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                     break;
                 }
             }
+
+            // write upper side of soft constraints on u
+            for (ii = 0; ii < dims->ns[kk]; ii++)
+            {
+                js = idxs[ii];
+                if (js >= dims->nb[kk] || in->idxb[kk][js] == jj)
+                {
+                    mem->A_i[nn++] = ii + soft_start + row_offset_soft;
+                }
+            }
         }
 
         for (jj = 0; jj < dims->nx[kk]; jj++)
@@ -438,11 +541,49 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                     break;
                 }
             }
+
+            // write upper side of soft constraints on x
+            for (ii = 0; ii < dims->ns[kk]; ii++)
+            {
+                js = idxs[ii];
+                if (js >= dims->nb[kk] || in->idxb[kk][js] == jj + dims->nu[kk])
+                {
+                    mem->A_i[nn++] = ii + soft_start + row_offset_soft;
+                }
+            }
+        }
+
+        for (jj = 0; jj < dims->ns[kk]; jj++)
+        {
+            mem->A_p[col++] = nn;
+
+            // write sl into the (lower side) row of the softened constraint
+            js = idxs[jj];
+            if (js < dims->nb[kk])
+                mem->A_i[nn++] = js + bnd_start + row_offset_bnd;
+            else
+                mem->A_i[nn++] = js - dims->nb[kk] + con_start + row_offset_con;
+
+            // write bound on sl
+            mem->A_i[nn++] = jj + slk_start + 2 * row_offset_soft;
+        }
+
+        for (jj = 0; jj < dims->ns[kk]; jj++)
+        {
+            mem->A_p[col++] = nn;
+
+            // write -su into the upper row of the softened constraint
+            mem->A_i[nn++] = jj + soft_start + row_offset_soft;
+
+            // write bound on su
+            mem->A_i[nn++] = jj + dims->ns[kk] + slk_start + 2 * row_offset_soft;
         }
 
         row_offset_bnd += dims->nb[kk];
         row_offset_con += dims->ng[kk];
         row_offset_dyn += kk < dims->N ? dims->nx[kk + 1] : 0;
+        row_offset_soft += dims->ns[kk];
+        idxs += dims->ns[kk];
     }
 
     mem->A_p[col] = nn;
@@ -450,9 +591,25 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
 
 
 
-static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+// writes val to A_x[nn] and flags the matrix as changed if the value differs
+static inline void set_constraints_matrix_entry(ocp_qp_osqp_memory *mem, c_int nn, c_float val,
+                                                int *changed)
 {
-    c_int ii, jj, kk, nn = 0;
+    if (mem->A_x[nn] != val)
+    {
+        mem->A_x[nn] = val;
+        *changed = 1;
+    }
+}
+
+
+
+// returns 1 if any entry of A_x changed w.r.t. the previous call
+static int update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+{
+    c_int ii, jj, kk, js, nn = 0;
+    int changed = 0;
+    c_int *idxs = mem->idxs;
     ocp_qp_dims *dims = in->dim;
 
     // Traverse matrix in column-major order
@@ -467,14 +624,16 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
                 // write column from B
                 for (ii = 0; ii < dims->nx[kk + 1]; ii++)
                 {
-                    mem->A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj, ii);
+                    set_constraints_matrix_entry(mem, nn++,
+                        BLASFEO_DMATEL(&in->BAbt[kk], jj, ii), &changed);
                 }
             }
 
             // write column from D
             for (ii = 0; ii < dims->ng[kk]; ii++)
             {
-                mem->A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj, ii);
+                set_constraints_matrix_entry(mem, nn++,
+                    BLASFEO_DMATEL(&in->DCt[kk], jj, ii), &changed);
             }
 
             // write bound on u
@@ -482,11 +641,26 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == jj)
                 {
-                    mem->A_x[nn++] = 1.0;
+                    set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
                     nbu++;
                     break;
                 }
             }
+
+            // write upper side of soft constraints on u
+            for (ii = 0; ii < dims->ns[kk]; ii++)
+            {
+                js = idxs[ii];
+                if (js >= dims->nb[kk])
+                {
+                    set_constraints_matrix_entry(mem, nn++,
+                        BLASFEO_DMATEL(&in->DCt[kk], jj, js - dims->nb[kk]), &changed);
+                }
+                else if (in->idxb[kk][js] == jj)
+                {
+                    set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
+                }
+            }
         }
 
         for (jj = 0; jj < dims->nx[kk]; jj++)
@@ -494,7 +668,7 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             if (kk > 0)
             {
                 // write column from -I
-                mem->A_x[nn++] = -1.0;
+                set_constraints_matrix_entry(mem, nn++, -1.0, &changed);
             }
 
             if (kk < dims->N)
@@ -502,14 +676,16 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
                 // write column from A
                 for (ii = 0; ii < dims->nx[kk + 1]; ii++)
                 {
-                    mem->A_x[nn++] = BLASFEO_DMATEL(&in->BAbt[kk], jj + dims->nu[kk], ii);
+                    set_constraints_matrix_entry(mem, nn++,
+                        BLASFEO_DMATEL(&in->BAbt[kk], jj + dims->nu[kk], ii), &changed);
                 }
             }
 
             // write column from C
             for (ii = 0; ii < dims->ng[kk]; ii++)
             {
-                mem->A_x[nn++] = BLASFEO_DMATEL(&in->DCt[kk], jj + dims->nu[kk], ii);
+                set_constraints_matrix_entry(mem, nn++,
+                    BLASFEO_DMATEL(&in->DCt[kk], jj + dims->nu[kk], ii), &changed);
             }
 
             // write bound on x
@@ -517,18 +693,54 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == jj + dims->nu[kk])
                 {
-                    mem->A_x[nn++] = 1.0;
+                    set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
+                    break;
+                }
+            }
+
+            // write upper side of soft constraints on x
+            for (ii = 0; ii < dims->ns[kk]; ii++)
+            {
+                js = idxs[ii];
+                if (js >= dims->nb[kk])
+                {
+                    set_constraints_matrix_entry(mem, nn++,
+                        BLASFEO_DMATEL(&in->DCt[kk], jj + dims->nu[kk], js - dims->nb[kk]),
+                        &changed);
+                }
+                else if (in->idxb[kk][js] == jj + dims->nu[kk])
+                {
+                    set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
                 }
             }
         }
+
+        // write sl and bound on sl
+        for (jj = 0; jj < dims->ns[kk]; jj++)
+        {
+            set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
+            set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
+        }
+
+        // write -su and bound on su
+        for (jj = 0; jj < dims->ns[kk]; jj++)
+        {
+            set_constraints_matrix_entry(mem, nn++, -1.0, &changed);
+            set_constraints_matrix_entry(mem, nn++, 1.0, &changed);
+        }
+
+        idxs += dims->ns[kk];
     }
+
+    return changed;
 }
 
 
 
 static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
-    int ii, kk, nn = 0;
+    int ii, kk, js, nn = 0;
+    c_int *idxs = mem->idxs;
     ocp_qp_dims *dims = in->dim;
 
     // write -b to l and u
@@ -557,6 +769,10 @@ static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
         for (ii = 0; ii < dims->ng[kk]; ii++)
         {
             mem->u[nn + ii] = -BLASFEO_DVECEL(&in->d[kk], ii + 2 * dims->nb[kk] + dims->ng[kk]);
+
+            // the upper side of soft constraints is in the soft upper block
+            if (dims->ns[kk] > 0 && in->idxs_rev[kk][dims->nb[kk] + ii] != -1)
+                mem->u[nn + ii] = OSQP_INFTY;
         }
 
         nn += dims->ng[kk];
@@ -572,10 +788,41 @@ static void update_bounds(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
         for (ii = 0; ii < dims->nb[kk]; ii++)
         {
             mem->u[nn + ii] = -BLASFEO_DVECEL(&in->d[kk], ii + dims->nb[kk] + dims->ng[kk]);
+
+            if (dims->ns[kk] > 0 && in->idxs_rev[kk][ii] != -1)
+                mem->u[nn + ii] = OSQP_INFTY;
         }
 
         nn += dims->nb[kk];
     }
+
+    // write ub and ug of soft constraints
+    for (kk = 0; kk <= dims->N; kk++)
+    {
+        for (ii = 0; ii < dims->ns[kk]; ii++)
+        {
+            js = idxs[ii];
+            mem->l[nn + ii] = -OSQP_INFTY;
+            mem->u[nn + ii] = -BLASFEO_DVECEL(&in->d[kk], js + dims->nb[kk] + dims->ng[kk]);
+        }
+
+        nn += dims->ns[kk];
+        idxs += dims->ns[kk];
+    }
+
+    // write lower bounds on sl and su
+    for (kk = 0; kk <= dims->N; kk++)
+    {
+        blasfeo_unpack_dvec(2 * dims->ns[kk], in->d + kk, 2 * dims->nb[kk] + 2 * dims->ng[kk],
+                            &mem->l[nn], 1);
+
+        for (ii = 0; ii < 2 * dims->ns[kk]; ii++)
+        {
+            mem->u[nn + ii] = OSQP_INFTY;
+        }
+
+        nn += 2 * dims->ns[kk];
+    }
 }
 
 
@@ -591,8 +838,19 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
 
     update_bounds(in, mem);
     update_gradient(in, mem);
-    update_hessian_data(in, mem);
-    update_constraints_matrix_data(in, mem);
+
+    // with constant matrices, P and A are only written once and the KKT factorization
+    // computed in the first call is reused
+    if (mem->first_run || !opts->matrices_constant)
+    {
+        mem->P_changed = update_hessian_data(in, mem);
+        mem->A_changed = update_constraints_matrix_data(in, mem);
+    }
+    else
+    {
+        mem->P_changed = 0;
+        mem->A_changed = 0;
+    }
 }
 
 
@@ -640,6 +898,8 @@ void ocp_qp_osqp_opts_initialize_default(void *config_, void *dims_, void *opts_
     opts->osqp_opts->check_termination = 5;
     opts->osqp_opts->warm_start = 1;
 
+    opts->matrices_constant = 0;
+
     return;
 }
 
@@ -704,6 +964,11 @@ void ocp_qp_osqp_opts_set(void *config_, void *opts_, const char *field, void *v
         opts->osqp_opts->warm_start = *tmp_ptr;
         // printf("\nwarm start %d\n", opts->osqp_opts->warm_start);
     }
+    else if (!strcmp(field, "matrices_constant"))
+    {
+        int *tmp_ptr = value;
+        opts->matrices_constant = *tmp_ptr;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_opts_set: wrong field: %s\n", field);
@@ -801,6 +1066,7 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
 
     size_t P_nnzmax = acados_osqp_nnzmax_P(dims);
     size_t A_nnzmax = acados_osqp_nnzmax_A(dims);
+    size_t ns = acados_osqp_num_slacks(dims);
 
     acados_size_t size = 0;
     size += sizeof(ocp_qp_osqp_memory);
@@ -816,6 +1082,8 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
 
+    size += ns * sizeof(c_int);  // idxs
+
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
     size += osqp_workspace_calculate_size(n, m, P_nnzmax, A_nnzmax);
@@ -1118,6 +1386,7 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     int m = acados_osqp_num_constr(dims);
     int P_nnzmax = acados_osqp_nnzmax_P(dims);
     int A_nnzmax = acados_osqp_nnzmax_A(dims);
+    int ns = acados_osqp_num_slacks(dims);
 
     // char pointer
     char *c_ptr = (char *) raw_memory;
@@ -1128,6 +1397,8 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->P_nnzmax = P_nnzmax;
     mem->A_nnzmax = A_nnzmax;
     mem->first_run = 1;
+    mem->P_changed = 1;
+    mem->A_changed = 1;
 
     align_char_to(8, &c_ptr);
 
@@ -1160,6 +1431,9 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->idxs = (c_int *) c_ptr;
+    c_ptr += ns * sizeof(c_int);
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1251,20 +1525,26 @@ acados_size_t ocp_qp_osqp_workspace_calculate_size(void *config_, void *dims_, v
 
 static void fill_in_qp_out(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_memory *mem)
 {
-    int ii, kk, nn = 0, mm, con_start = 0, bnd_start = 0;
+    int ii, kk, js, nn = 0, mm, con_start = 0, bnd_start = 0, soft_start = 0, slk_start = 0;
     ocp_qp_dims *dims = in->dim;
     OSQPSolution *sol = mem->osqp_work->solution;
+    c_int *idxs = mem->idxs;
 
     for (kk = 0; kk <= dims->N; kk++)
     {
-        blasfeo_pack_dvec(dims->nx[kk] + dims->nu[kk], &sol->x[nn], 1, out->ux + kk, 0);
-        nn += dims->nx[kk] + dims->nu[kk];
+        blasfeo_pack_dvec(dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk], &sol->x[nn], 1,
+                          out->ux + kk, 0);
+        nn += dims->nx[kk] + dims->nu[kk] + 2 * dims->ns[kk];
 
         con_start += kk < dims->N ? dims->nx[kk + 1] : 0;
         bnd_start += dims->ng[kk];
+        soft_start += dims->nb[kk];
+        slk_start += dims->ns[kk];
     }
 
     bnd_start += con_start;
+    soft_start += bnd_start;
+    slk_start += soft_start;
 
     nn = 0;
     for (kk = 0; kk < dims->N; kk++)
@@ -1302,28 +1582,73 @@ static void fill_in_qp_out(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_mem
 
         mm += dims->ng[kk];
     }
-}
 
+    // soft constraints
+    nn = 0;
+    for (kk = 0; kk <= dims->N; kk++)
+    {
+        for (ii = 0; ii < dims->ns[kk]; ii++)
+        {
+            // upper side of the softened constraint
+            js = idxs[ii];
+            double lam = sol->y[soft_start + nn + ii];
+            out->lam[kk].pa[dims->nb[kk] + dims->ng[kk] + js] = lam > 0 ? lam : 0.0;
+        }
 
+        for (ii = 0; ii < 2 * dims->ns[kk]; ii++)
+        {
+            // lower bounds on sl and su
+            double lam = sol->y[slk_start + 2 * nn + ii];
+            out->lam[kk].pa[2 * dims->nb[kk] + 2 * dims->ng[kk] + ii] = lam < 0 ? -lam : 0.0;
+        }
 
-int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
-{
-    ocp_qp_in *qp_in = qp_in_;
-    ocp_qp_out *qp_out = qp_out_;
+        nn += dims->ns[kk];
+        idxs += dims->ns[kk];
+    }
+}
 
-    int N = qp_in->dim->N;
-    int *ns = qp_in->dim->ns;
 
-    // print_ocp_qp_dims(qp_in->dim);
 
-    for (int ii = 0; ii <= N; ii++)
+// adds the slack contributions to the constraint slacks computed by ocp_qp_compute_t
+static void compute_t_soft(const ocp_qp_in *in, ocp_qp_out *out, ocp_qp_osqp_memory *mem)
+{
+    int ii, kk, js;
+    ocp_qp_dims *dims = in->dim;
+    c_int *idxs = mem->idxs;
+
+    for (kk = 0; kk <= dims->N; kk++)
     {
-        if (ns[ii] > 0)
+        int nb = dims->nb[kk];
+        int ng = dims->ng[kk];
+        int ns = dims->ns[kk];
+        int nux = dims->nu[kk] + dims->nx[kk];
+
+        for (ii = 0; ii < ns; ii++)
         {
-            printf("\nOSQP interface can not handle ns>0 yet: what about implementing it? :)\n");
-            exit(1);
+            js = idxs[ii];
+            double sl = BLASFEO_DVECEL(&out->ux[kk], nux + ii);
+            double su = BLASFEO_DVECEL(&out->ux[kk], nux + ns + ii);
+
+            BLASFEO_DVECEL(&out->t[kk], js) += sl;
+            BLASFEO_DVECEL(&out->t[kk], nb + ng + js) += su;
+            BLASFEO_DVECEL(&out->t[kk], 2 * nb + 2 * ng + ii) =
+                sl - BLASFEO_DVECEL(&in->d[kk], 2 * nb + 2 * ng + ii);
+            BLASFEO_DVECEL(&out->t[kk], 2 * nb + 2 * ng + ns + ii) =
+                su - BLASFEO_DVECEL(&in->d[kk], 2 * nb + 2 * ng + ns + ii);
         }
+
+        idxs += ns;
     }
+}
+
+
+
+int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_out *qp_out = qp_out_;
+
+    // print_ocp_qp_dims(qp_in->dim);
 
     // print_ocp_qp_in(qp_in);
 
@@ -1345,8 +1670,14 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     if (!mem->first_run)
     {
         osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
+        // only update matrices which changed, otherwise the KKT factorization is reused
+        if (mem->P_changed && mem->A_changed)
+            osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
+                            mem->A_nnzmax);
+        else if (mem->P_changed)
+            osqp_update_P(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax);
+        else if (mem->A_changed)
+            osqp_update_A(mem->osqp_work, mem->A_x, NULL, mem->A_nnzmax);
         osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
         // TODO(oj): update OSQP options here if they were updated?
     }
@@ -1372,6 +1703,7 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     // fill qp_out
     fill_in_qp_out(qp_in, qp_out, mem);
     ocp_qp_compute_t(qp_in, qp_out);
+    compute_t_soft(qp_in, qp_out, mem);
 
     // info
     info->solve_QP_time = acados_toc(&qp_timer);
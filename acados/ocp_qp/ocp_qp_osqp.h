@@ -46,12 +46,15 @@ extern "C" {
 typedef struct ocp_qp_osqp_opts_
 {
     OSQPSettings *osqp_opts;
+    int matrices_constant;  // skip Hessian and constraint matrix updates after the first call
 } ocp_qp_osqp_opts;
 
 
 typedef struct ocp_qp_osqp_memory_
 {
     c_int first_run;
+    int P_changed;  // P_x differs from the data passed to OSQP in the previous call
+    int A_changed;  // A_x differs from the data passed to OSQP in the previous call
 
     c_float *q;
     c_float *l;
@@ -67,6 +70,8 @@ typedef struct ocp_qp_osqp_memory_
     c_int *A_p;
     c_float *A_x;
 
+    c_int *idxs;  // constraint index of each slack, stacked over the stages
+
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
 
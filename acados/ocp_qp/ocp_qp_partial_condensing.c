@@ -31,6 +31,7 @@
 
 // external
 #include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
 #include <string.h>
 // acados
@@ -40,6 +41,7 @@
 #include "hpipm/include/hpipm_d_ocp_qp_red.h"
 // hpipm
 #include "hpipm/include/hpipm_d_cond.h"
+#include "hpipm/include/hpipm_d_cond_aux.h"
 #include "hpipm/include/hpipm_d_dense_qp.h"
 #include "hpipm/include/hpipm_d_dense_qp_sol.h"
 #include "hpipm/include/hpipm_d_ocp_qp.h"
@@ -251,6 +253,7 @@ void ocp_qp_partial_condensing_opts_initialize_default(void *dims_, void *opts_)
     d_ocp_qp_reduce_eq_dof_arg_set_alias_unchanged(opts->hpipm_red_opts, 1);
 
     opts->mem_qp_in = 1;
+    opts->num_threads = 1;
 
     return;
 }
@@ -294,6 +297,16 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
         int *tmp_ptr = value;
         opts->ric_alg = *tmp_ptr;
     }
+    else if(!strcmp(field, "num_threads"))
+    {
+        int *tmp_ptr = value;
+        if (*tmp_ptr < 1)
+        {
+            printf("\nerror: ocp_qp_partial_condensing_opts_set: num_threads has to be >= 1, got %d\n", *tmp_ptr);
+            exit(1);
+        }
+        opts->num_threads = *tmp_ptr;
+    }
     // TODO dual_sol ???
     else
     {
@@ -397,6 +410,8 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
 
     mem->qp_out_info = (qp_info *) mem->pcond_qp_out->misc;
 
+    mem->block_size = dims->block_size;
+
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -455,6 +470,133 @@ acados_size_t ocp_qp_partial_condensing_workspace_calculate_size(void *dims_, vo
  * functions
  ************************************************/
 
+#if defined(ACADOS_WITH_OPENMP)
+// same as d_part_cond_qp_cond_lhs, but the blocks are condensed in parallel:
+// every block has its own hpipm cond arg and workspace, the last stage is copied.
+// NOTE: hpipm has no public call to condense a single block, so this mirrors the block loop of
+// d_part_cond_qp_cond_lhs of the hpipm version in external/hpipm (the one of the stable branch with
+// the fields nbxe, nbue, nge, d_mask, idxe and diag_H_flag in d_ocp_qp_dim and d_ocp_qp).
+// It relies on the hpipm internals d_cond_BAt, d_cond_RSQ, d_cond_DCt (hpipm_d_cond_aux.h),
+// cond_arg of d_part_cond_qp_arg and cond_workspace of d_part_cond_qp_ws;
+// check it against d_part_cond_qp_cond_lhs when updating hpipm,
+// the unit test "mass spring example, threaded partial condensing" compares both.
+
+// The block structs are filled field by field, a field added to d_ocp_qp_dim or d_ocp_qp by a
+// newer hpipm would stay zero. The mirrors below list the fields of the supported hpipm version,
+// a different layout makes the array sizes negative and the compilation fails.
+struct ocp_qp_partial_condensing_hpipm_dim_mirror
+{
+    int *nx, *nu, *nb, *nbx, *nbu, *ng, *ns, *nsbx, *nsbu, *nsg, *nbxe, *nbue, *nge;
+    int N;
+    hpipm_size_t memsize;
+};
+
+struct ocp_qp_partial_condensing_hpipm_qp_mirror
+{
+    struct d_ocp_qp_dim *dim;
+    struct blasfeo_dmat *BAbt, *RSQrq, *DCt;
+    struct blasfeo_dvec *b, *rqz, *d, *d_mask, *m, *Z;
+    int **idxb, **idxs_rev, **idxe;
+    int *diag_H_flag;
+    hpipm_size_t memsize;
+};
+
+typedef char ocp_qp_partial_condensing_check_hpipm_dim_layout[
+    (sizeof(struct d_ocp_qp_dim) == sizeof(struct ocp_qp_partial_condensing_hpipm_dim_mirror) &&
+     offsetof(struct d_ocp_qp_dim, N) ==
+         offsetof(struct ocp_qp_partial_condensing_hpipm_dim_mirror, N)) ? 1 : -1];
+
+typedef char ocp_qp_partial_condensing_check_hpipm_qp_layout[
+    (sizeof(struct d_ocp_qp) == sizeof(struct ocp_qp_partial_condensing_hpipm_qp_mirror) &&
+     offsetof(struct d_ocp_qp, diag_H_flag) ==
+         offsetof(struct ocp_qp_partial_condensing_hpipm_qp_mirror, diag_H_flag)) ? 1 : -1];
+
+static void ocp_qp_partial_condensing_cond_lhs_blocks(ocp_qp_in *red_qp, ocp_qp_in *pcond_qp_in,
+            ocp_qp_partial_condensing_opts *opts, ocp_qp_partial_condensing_memory *mem)
+{
+    struct d_ocp_qp_dim *red_dims = red_qp->dim;
+
+    int N = red_dims->N;
+    int N2 = pcond_qp_in->dim->N;
+    int *block_size = mem->block_size;
+
+    int ii;
+
+    #pragma omp parallel for num_threads(opts->num_threads) schedule(static)
+    for (ii = 0; ii < N2; ii++)
+    {
+        // fields not aliased below stay zero
+        struct d_ocp_qp_dim tmp_dims = {0};
+        struct d_ocp_qp tmp_qp = {0};
+
+        // first stage of the block
+        int N_tmp = 0;
+        for (int jj = 0; jj < ii; jj++)
+            N_tmp += block_size[jj];
+
+        // alias dims of the block
+        tmp_dims.N = block_size[ii];
+        tmp_dims.nx = red_dims->nx+N_tmp;
+        tmp_dims.nu = red_dims->nu+N_tmp;
+        tmp_dims.nb = red_dims->nb+N_tmp;
+        tmp_dims.nbx = red_dims->nbx+N_tmp;
+        tmp_dims.nbu = red_dims->nbu+N_tmp;
+        tmp_dims.ng = red_dims->ng+N_tmp;
+        tmp_dims.ns = red_dims->ns+N_tmp;
+        tmp_dims.nsbx = red_dims->nsbx+N_tmp;
+        tmp_dims.nsbu = red_dims->nsbu+N_tmp;
+        tmp_dims.nsg = red_dims->nsg+N_tmp;
+        tmp_dims.nbxe = red_dims->nbxe+N_tmp;
+        tmp_dims.nbue = red_dims->nbue+N_tmp;
+        tmp_dims.nge = red_dims->nge+N_tmp;
+
+        // alias qp of the block
+        tmp_qp.dim = &tmp_dims;
+        tmp_qp.BAbt = red_qp->BAbt+N_tmp;
+        tmp_qp.RSQrq = red_qp->RSQrq+N_tmp;
+        tmp_qp.DCt = red_qp->DCt+N_tmp;
+        tmp_qp.b = red_qp->b+N_tmp;
+        tmp_qp.rqz = red_qp->rqz+N_tmp;
+        tmp_qp.d = red_qp->d+N_tmp;
+        tmp_qp.d_mask = red_qp->d_mask+N_tmp;
+        tmp_qp.m = red_qp->m+N_tmp;
+        tmp_qp.Z = red_qp->Z+N_tmp;
+        tmp_qp.idxb = red_qp->idxb+N_tmp;
+        tmp_qp.idxs_rev = red_qp->idxs_rev+N_tmp;
+        tmp_qp.idxe = red_qp->idxe+N_tmp;
+        tmp_qp.diag_H_flag = red_qp->diag_H_flag+N_tmp;
+
+        d_cond_BAt(&tmp_qp, pcond_qp_in->BAbt+ii, opts->hpipm_pcond_opts->cond_arg+ii,
+                   mem->hpipm_pcond_work->cond_workspace+ii);
+        d_cond_RSQ(&tmp_qp, pcond_qp_in->RSQrq+ii, opts->hpipm_pcond_opts->cond_arg+ii,
+                   mem->hpipm_pcond_work->cond_workspace+ii);
+        d_cond_DCt(&tmp_qp, pcond_qp_in->idxb[ii], pcond_qp_in->DCt+ii, pcond_qp_in->idxs_rev[ii],
+                   pcond_qp_in->Z+ii, opts->hpipm_pcond_opts->cond_arg+ii,
+                   mem->hpipm_pcond_work->cond_workspace+ii);
+    }
+
+    // copy last stage
+    int *nx = red_dims->nx;
+    int *nu = red_dims->nu;
+    int *nb = red_dims->nb;
+    int *ng = red_dims->ng;
+    int *ns = red_dims->ns;
+
+    blasfeo_dgecp(nu[N]+nx[N], nu[N]+nx[N], red_qp->RSQrq+N, 0, 0, pcond_qp_in->RSQrq+N2, 0, 0);
+    blasfeo_dgecp(nu[N]+nx[N], ng[N], red_qp->DCt+N, 0, 0, pcond_qp_in->DCt+N2, 0, 0);
+    blasfeo_dveccp(2*ns[N], red_qp->Z+N, 0, pcond_qp_in->Z+N2, 0);
+    for (ii = 0; ii < nb[N]; ii++)
+        pcond_qp_in->idxb[N2][ii] = red_qp->idxb[N][ii];
+    for (ii = 0; ii < nb[N]+ng[N]; ii++)
+        pcond_qp_in->idxs_rev[N2][ii] = red_qp->idxs_rev[N][ii];
+    pcond_qp_in->diag_H_flag[N2] = red_qp->diag_H_flag[N];
+
+    return;
+}
+#endif
+
+
+
 int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
 {
     ocp_qp_in *qp_in = qp_in_;
@@ -483,7 +625,17 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
 
     // convert to partially condensed qp structure
     // TODO only if N2<N
-    d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+    {
+        ocp_qp_partial_condensing_cond_lhs_blocks(mem->red_qp, pcond_qp_in, opts, mem);
+        d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    }
+    else
+#endif
+    {
+        d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    }
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -493,7 +645,7 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
 
 
 
-int ocp_qp_partial_condensing_rhs(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
+int ocp_qp_partial_condensing_lhs(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
 {
     ocp_qp_in *qp_in = qp_in_;
     ocp_qp_in *pcond_qp_in = pcond_qp_in_;
@@ -512,7 +664,45 @@ int ocp_qp_partial_condensing_rhs(void *qp_in_, void *pcond_qp_in_, void *opts_,
     mem->ptr_pcond_qp_in = pcond_qp_in;
 
     // reduce eq constr DOF
-    d_ocp_qp_reduce_eq_dof(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
+    d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
+
+    // condense matrices
+    // TODO only if N2<N
+#if defined(ACADOS_WITH_OPENMP)
+    if (opts->num_threads > 1)
+        ocp_qp_partial_condensing_cond_lhs_blocks(mem->red_qp, pcond_qp_in, opts, mem);
+    else
+#endif
+        d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+
+    // stop timer
+    mem->time_qp_xcond = acados_toc(&timer);
+
+    return ACADOS_SUCCESS;
+}
+
+
+
+int ocp_qp_partial_condensing_rhs(void *qp_in_, void *pcond_qp_in_, void *opts_, void *mem_, void *work)
+{
+    ocp_qp_in *qp_in = qp_in_;
+    ocp_qp_in *pcond_qp_in = pcond_qp_in_;
+    ocp_qp_partial_condensing_opts *opts = opts_;
+    ocp_qp_partial_condensing_memory *mem = mem_;
+
+    assert(opts->N2 == opts->N2_bkp);
+
+    acados_timer timer;
+
+    // start timer
+    acados_tic(&timer);
+
+    // save pointers to ocp_qp_in in memory (needed for expansion)
+    mem->ptr_qp_in = qp_in;
+    mem->ptr_pcond_qp_in = pcond_qp_in;
+
+    // reduce eq constr DOF, matrices are kept from the last condensing or condensing_lhs call
+    d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // convert to partially condensed qp structure
     // TODO only if N2<N
@@ -573,6 +763,7 @@ void ocp_qp_partial_condensing_config_initialize_default(void *config_)
     config->memory_get = &ocp_qp_partial_condensing_memory_get;
     config->workspace_calculate_size = &ocp_qp_partial_condensing_workspace_calculate_size;
     config->condensing = &ocp_qp_partial_condensing;
+    config->condensing_lhs = &ocp_qp_partial_condensing_lhs;
     config->condensing_rhs = &ocp_qp_partial_condensing_rhs;
     config->expansion = &ocp_qp_partial_expansion;
 
@@ -66,6 +66,7 @@ typedef struct ocp_qp_partial_condensing_opts_
 //    int expand_dual_sol; // 0 primal sol only, 1 primal + dual sol
     int ric_alg;
     int mem_qp_in; // allocate qp_in in memory
+    int num_threads; // threads for the condensing of the blocks (only with ACADOS_WITH_OPENMP)
 } ocp_qp_partial_condensing_opts;
 
 
@@ -83,6 +84,7 @@ typedef struct ocp_qp_partial_condensing_memory_
     ocp_qp_in *ptr_qp_in;
     ocp_qp_in *ptr_pcond_qp_in;
     qp_info *qp_out_info; // info in pcond_qp_in
+    int *block_size; // block sizes of the reduced qp (pointer to dims)
     double time_qp_xcond;
 } ocp_qp_partial_condensing_memory;
 
@@ -37,6 +37,7 @@
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/timing.h"
 #include "acados/utils/types.h"
@@ -344,6 +345,8 @@ void *ocp_qp_xcond_solver_memory_assign(void *config_, ocp_qp_xcond_solver_dims
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_in", &mem->xcond_qp_in);
     xcond->memory_get(xcond, mem->xcond_memory, "xcond_qp_out", &mem->xcond_qp_out);
 
+    mem->lhs_valid = 0;
+
     assert((char *) raw_memory + ocp_qp_xcond_solver_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -425,6 +428,34 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
 
 
 
+void ocp_qp_xcond_solver_memory_get_by_id(void *config_, void *mem_, int field_id, void* value)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    qp_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    ocp_qp_xcond_solver_memory *mem = mem_;
+
+    // the QP solver and condensing backends only expose string getters,
+    // this skips the dispatch of the xcond solver itself
+    switch (field_id)
+    {
+        case ACADOS_FIELD_TIME_QP_SOLVER_CALL:
+            qp_solver->memory_get(qp_solver, mem->solver_memory, "time_qp_solver_call", value);
+            break;
+        case ACADOS_FIELD_TIME_QP_XCOND:
+            xcond->memory_get(xcond, mem->xcond_memory, "time_qp_xcond", value);
+            break;
+        default:
+            ocp_qp_xcond_solver_memory_get(config_, mem_, acados_field_name(field_id), value);
+    }
+
+    return;
+
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -510,6 +541,90 @@ int ocp_qp_xcond_solver(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     acados_tic(&cond_timer);
     xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
     info->condensing_time = acados_toc(&cond_timer);
+    memory->lhs_valid = 1;
+
+    // solve qp
+    solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
+                                opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+
+    // expansion
+    acados_tic(&cond_timer);
+    xcond->expansion(memory->xcond_qp_out, qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    info->condensing_time += acados_toc(&cond_timer);
+
+    // output qp info
+    qp_info *info_mem;
+    xcond->memory_get(xcond, memory->xcond_memory, "qp_out_info", &info_mem);
+
+    info->total_time = acados_toc(&tot_timer);
+    info->solve_QP_time = info_mem->solve_QP_time;
+    info->interface_time = info_mem->interface_time;
+    info->num_iter = info_mem->num_iter;
+    info->t_computed = info_mem->t_computed;
+
+    return solver_status;
+}
+
+
+
+void ocp_qp_xcond_solver_condense_lhs(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                     void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    qp_info *info = (qp_info *) qp_out->misc;
+    acados_timer cond_timer;
+
+    // cast data structures
+    ocp_qp_xcond_solver_opts *opts = opts_;
+    ocp_qp_xcond_solver_memory *memory = mem_;
+    ocp_qp_xcond_solver_workspace *work = work_;
+
+    // cast workspace
+    cast_workspace(config_, dims, opts, memory, work);
+
+    // condensing of the matrices
+    acados_tic(&cond_timer);
+    xcond->condensing_lhs(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    info->condensing_time = acados_toc(&cond_timer);
+    memory->lhs_valid = 1;
+
+    return;
+}
+
+
+
+int ocp_qp_xcond_solver_condense_rhs_and_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                                     void *opts_, void *mem_, void *work_)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    qp_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    qp_info *info = (qp_info *) qp_out->misc;
+    acados_timer tot_timer, cond_timer;
+    acados_tic(&tot_timer);
+
+    // cast data structures
+    ocp_qp_xcond_solver_opts *opts = opts_;
+    ocp_qp_xcond_solver_memory *memory = mem_;
+    ocp_qp_xcond_solver_workspace *work = work_;
+
+    // cast workspace
+    cast_workspace(config_, dims, opts, memory, work);
+
+    int solver_status = ACADOS_SUCCESS;
+
+    // condensing of the vectors, matrices are taken from the last condense_lhs or evaluate call;
+    // without such a call, e.g. a feedback step without preparation, the matrices are condensed too
+    acados_tic(&cond_timer);
+    if (memory->lhs_valid)
+        xcond->condensing_rhs(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    else
+        xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    info->condensing_time = acados_toc(&cond_timer);
+    memory->lhs_valid = 1;
 
     // solve qp
     solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
@@ -555,9 +670,13 @@ void ocp_qp_xcond_solver_eval_sens(void *config_, ocp_qp_xcond_solver_dims *dims
     cast_workspace(config_, dims, opts, memory, work);
 
 
-    // condensing
+    // condensing, the matrices of param_qp_in are the ones of the last solve
 //    acados_tic(&cond_timer);
-    xcond->condensing_rhs(param_qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    if (memory->lhs_valid)
+        xcond->condensing_rhs(param_qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    else
+        xcond->condensing(param_qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
+    memory->lhs_valid = 1;
 //    info->condensing_time = acados_toc(&cond_timer);
 
     // qp evaluate sensitivity
@@ -600,10 +719,13 @@ void ocp_qp_xcond_solver_config_initialize_default(void *config_)
     config->memory_calculate_size = &ocp_qp_xcond_solver_memory_calculate_size;
     config->memory_assign = &ocp_qp_xcond_solver_memory_assign;
     config->memory_get = &ocp_qp_xcond_solver_memory_get;
+    config->memory_get_by_id = &ocp_qp_xcond_solver_memory_get_by_id;
     config->solver_get = &ocp_qp_xcond_solver_get;
     config->memory_reset = &ocp_qp_xcond_solver_memory_reset; // TODO: unused?
     config->workspace_calculate_size = &ocp_qp_xcond_solver_workspace_calculate_size;
     config->evaluate = &ocp_qp_xcond_solver;
+    config->condense_lhs = &ocp_qp_xcond_solver_condense_lhs;
+    config->condense_rhs_and_solve = &ocp_qp_xcond_solver_condense_rhs_and_solve;
     config->eval_sens = &ocp_qp_xcond_solver_eval_sens;
 
     return;
@@ -64,6 +64,7 @@ typedef struct ocp_qp_xcond_solver_memory_
     void *solver_memory;
     void *xcond_qp_in;
     void *xcond_qp_out;
+    int lhs_valid;  // the condensed matrices are set by a previous condense_lhs or evaluate call
 } ocp_qp_xcond_solver_memory;
 
 
@@ -90,10 +91,15 @@ typedef struct
     acados_size_t (*memory_calculate_size)(void *config, ocp_qp_xcond_solver_dims *dims, void *opts);
     void *(*memory_assign)(void *config, ocp_qp_xcond_solver_dims *dims, void *opts, void *raw_memory);
     void (*memory_get)(void *config_, void *mem_, const char *field, void* value);
+    void (*memory_get_by_id)(void *config_, void *mem_, int field_id, void* value);
     void (*solver_get)(void *config_, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2);
     void (*memory_reset)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
     acados_size_t (*workspace_calculate_size)(void *config, ocp_qp_xcond_solver_dims *dims, void *opts);
     int (*evaluate)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
+    // split of evaluate: condense_lhs only depends on the QP matrices,
+    // condense_rhs_and_solve condenses the vectors, solves and expands the solution
+    void (*condense_lhs)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
+    int (*condense_rhs_and_solve)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts, void *mem, void *work);
     void (*eval_sens)(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *param_qp_in, ocp_qp_out *sens_qp_out, void *opts, void *mem, void *work);
     qp_solver_config *qp_solver;  // either ocp_qp_solver or dense_solver
     ocp_qp_xcond_config *xcond;
@@ -140,6 +146,10 @@ acados_size_t ocp_qp_xcond_solver_workspace_calculate_size(void *config, ocp_qp_
 /* config */
 //
 int ocp_qp_xcond_solver(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, void *work_);
+//
+void ocp_qp_xcond_solver_condense_lhs(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, void *work_);
+//
+int ocp_qp_xcond_solver_condense_rhs_and_solve(void *config, ocp_qp_xcond_solver_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *opts_, void *mem_, void *work_);
 
 //
 void ocp_qp_xcond_solver_config_initialize_default(void *config_);
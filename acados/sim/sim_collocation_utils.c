@@ -461,6 +461,23 @@ static void gauss_radau_iia_nodes(int ns, double *nodes, void *work)
 
 
 
+static acados_size_t butcher_tableau_block_diagonalize_work_calculate_size(int ns)
+{
+    acados_size_t size = 0;
+
+    size += (ns + 1) * sizeof(double);          // char_poly
+    size += 2 * ns * ns * sizeof(double);       // M, AM
+    size += 2 * ns * sizeof(double);            // eig_re, eig_im
+    size += 4 * ns * ns * sizeof(double);       // sys
+    size += 2 * 2 * ns * sizeof(double);        // vec, lu_work
+    size += 2 * ns * ns * sizeof(double);       // T_fact, lu_work_T
+    size += 2 * ns * sizeof(int);               // perm
+
+    return size;
+}
+
+
+
 acados_size_t butcher_tableau_work_calculate_size(int ns)
 {
     acados_size_t size = 0;
@@ -469,8 +486,10 @@ acados_size_t butcher_tableau_work_calculate_size(int ns)
     size += 1 * ns * sizeof(int);  // perm
 
     acados_size_t size_legendre = gauss_legendre_nodes_work_calculate_size(ns);
+    acados_size_t size_block_diag = butcher_tableau_block_diagonalize_work_calculate_size(ns);
 
     size = size > size_legendre ? size : size_legendre;
+    size = size > size_block_diag ? size : size_block_diag;
     make_int_multiple_of(8, &size);
 
     return size;
@@ -646,3 +665,580 @@ void get_explicit_butcher_tableau(int ns, double *A, double *b, double *c)
         }
     }
 }
+
+
+
+void get_dormand_prince_tableau(double *A, double *b, double *e, double *c)
+{
+    int ns = 7;
+
+    for (int i = 0; i < ns * ns; i++)
+        A[i] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 5.0;
+    A[2 + ns * 0] = 3.0 / 40.0;
+    A[2 + ns * 1] = 9.0 / 40.0;
+    A[3 + ns * 0] = 44.0 / 45.0;
+    A[3 + ns * 1] = -56.0 / 15.0;
+    A[3 + ns * 2] = 32.0 / 9.0;
+    A[4 + ns * 0] = 19372.0 / 6561.0;
+    A[4 + ns * 1] = -25360.0 / 2187.0;
+    A[4 + ns * 2] = 64448.0 / 6561.0;
+    A[4 + ns * 3] = -212.0 / 729.0;
+    A[5 + ns * 0] = 9017.0 / 3168.0;
+    A[5 + ns * 1] = -355.0 / 33.0;
+    A[5 + ns * 2] = 46732.0 / 5247.0;
+    A[5 + ns * 3] = 49.0 / 176.0;
+    A[5 + ns * 4] = -5103.0 / 18656.0;
+    A[6 + ns * 0] = 35.0 / 384.0;
+    A[6 + ns * 2] = 500.0 / 1113.0;
+    A[6 + ns * 3] = 125.0 / 192.0;
+    A[6 + ns * 4] = -2187.0 / 6784.0;
+    A[6 + ns * 5] = 11.0 / 84.0;
+    // b, 5th order
+    b[0] = 35.0 / 384.0;
+    b[1] = 0.0;
+    b[2] = 500.0 / 1113.0;
+    b[3] = 125.0 / 192.0;
+    b[4] = -2187.0 / 6784.0;
+    b[5] = 11.0 / 84.0;
+    b[6] = 0.0;
+    // e = b - b_hat, b_hat 4th order
+    if (e != NULL)
+    {
+        e[0] = 35.0 / 384.0 - 5179.0 / 57600.0;
+        e[1] = 0.0;
+        e[2] = 500.0 / 1113.0 - 7571.0 / 16695.0;
+        e[3] = 125.0 / 192.0 - 393.0 / 640.0;
+        e[4] = -2187.0 / 6784.0 + 92097.0 / 339200.0;
+        e[5] = 11.0 / 84.0 - 187.0 / 2100.0;
+        e[6] = -1.0 / 40.0;
+    }
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 5.0;
+    c[2] = 3.0 / 10.0;
+    c[3] = 4.0 / 5.0;
+    c[4] = 8.0 / 9.0;
+    c[5] = 1.0;
+    c[6] = 1.0;
+}
+
+
+
+static void get_rk4_38_tableau(double *A, double *b, double *c)
+{
+    int ns = 4;
+
+    for (int i = 0; i < ns * ns; i++)
+        A[i] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 3.0;
+    A[2 + ns * 0] = -1.0 / 3.0;
+    A[2 + ns * 1] = 1.0;
+    A[3 + ns * 0] = 1.0;
+    A[3 + ns * 1] = -1.0;
+    A[3 + ns * 2] = 1.0;
+    // b
+    b[0] = 1.0 / 8.0;
+    b[1] = 3.0 / 8.0;
+    b[2] = 3.0 / 8.0;
+    b[3] = 1.0 / 8.0;
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 3.0;
+    c[2] = 2.0 / 3.0;
+    c[3] = 1.0;
+}
+
+
+
+static void get_cash_karp_tableau(double *A, double *b, double *c)
+{
+    int ns = 6;
+
+    for (int i = 0; i < ns * ns; i++)
+        A[i] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 5.0;
+    A[2 + ns * 0] = 3.0 / 40.0;
+    A[2 + ns * 1] = 9.0 / 40.0;
+    A[3 + ns * 0] = 3.0 / 10.0;
+    A[3 + ns * 1] = -9.0 / 10.0;
+    A[3 + ns * 2] = 6.0 / 5.0;
+    A[4 + ns * 0] = -11.0 / 54.0;
+    A[4 + ns * 1] = 5.0 / 2.0;
+    A[4 + ns * 2] = -70.0 / 27.0;
+    A[4 + ns * 3] = 35.0 / 27.0;
+    A[5 + ns * 0] = 1631.0 / 55296.0;
+    A[5 + ns * 1] = 175.0 / 512.0;
+    A[5 + ns * 2] = 575.0 / 13824.0;
+    A[5 + ns * 3] = 44275.0 / 110592.0;
+    A[5 + ns * 4] = 253.0 / 4096.0;
+    // b, 5th order
+    b[0] = 37.0 / 378.0;
+    b[1] = 0.0;
+    b[2] = 250.0 / 621.0;
+    b[3] = 125.0 / 594.0;
+    b[4] = 0.0;
+    b[5] = 512.0 / 1771.0;
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 5.0;
+    c[2] = 3.0 / 10.0;
+    c[3] = 3.0 / 5.0;
+    c[4] = 1.0;
+    c[5] = 7.0 / 8.0;
+}
+
+
+
+static void get_butcher6_tableau(double *A, double *b, double *c)
+{
+    int ns = 7;
+
+    for (int i = 0; i < ns * ns; i++)
+        A[i] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 3.0;
+    A[2 + ns * 1] = 2.0 / 3.0;
+    A[3 + ns * 0] = 1.0 / 12.0;
+    A[3 + ns * 1] = 1.0 / 3.0;
+    A[3 + ns * 2] = -1.0 / 12.0;
+    A[4 + ns * 0] = -1.0 / 16.0;
+    A[4 + ns * 1] = 9.0 / 8.0;
+    A[4 + ns * 2] = -3.0 / 16.0;
+    A[4 + ns * 3] = -3.0 / 8.0;
+    A[5 + ns * 1] = 9.0 / 8.0;
+    A[5 + ns * 2] = -3.0 / 8.0;
+    A[5 + ns * 3] = -3.0 / 4.0;
+    A[5 + ns * 4] = 1.0 / 2.0;
+    A[6 + ns * 0] = 9.0 / 44.0;
+    A[6 + ns * 1] = -9.0 / 11.0;
+    A[6 + ns * 2] = 63.0 / 44.0;
+    A[6 + ns * 3] = 18.0 / 11.0;
+    A[6 + ns * 5] = -16.0 / 11.0;
+    // b
+    b[0] = 11.0 / 120.0;
+    b[1] = 0.0;
+    b[2] = 27.0 / 40.0;
+    b[3] = 27.0 / 40.0;
+    b[4] = -4.0 / 15.0;
+    b[5] = -4.0 / 15.0;
+    b[6] = 11.0 / 120.0;
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 3.0;
+    c[2] = 2.0 / 3.0;
+    c[3] = 1.0 / 3.0;
+    c[4] = 1.0 / 2.0;
+    c[5] = 1.0 / 2.0;
+    c[6] = 1.0;
+}
+
+
+
+static void get_cooper_verner8_tableau(double *A, double *b, double *c)
+{
+    int ns = 11;
+    double s21 = sqrt(21.0);
+
+    for (int i = 0; i < ns * ns; i++)
+        A[i] = 0.0;
+
+    // A
+    A[1 + ns * 0] = 1.0 / 2.0;
+    A[2 + ns * 0] = 1.0 / 4.0;
+    A[2 + ns * 1] = 1.0 / 4.0;
+    A[3 + ns * 0] = 1.0 / 7.0;
+    A[3 + ns * 1] = (-7.0 - 3.0 * s21) / 98.0;
+    A[3 + ns * 2] = (21.0 + 5.0 * s21) / 49.0;
+    A[4 + ns * 0] = (11.0 + s21) / 84.0;
+    A[4 + ns * 2] = (18.0 + 4.0 * s21) / 63.0;
+    A[4 + ns * 3] = (21.0 - s21) / 252.0;
+    A[5 + ns * 0] = (5.0 + s21) / 48.0;
+    A[5 + ns * 2] = (9.0 + s21) / 36.0;
+    A[5 + ns * 3] = (-231.0 + 14.0 * s21) / 360.0;
+    A[5 + ns * 4] = (63.0 - 7.0 * s21) / 80.0;
+    A[6 + ns * 0] = (10.0 - s21) / 42.0;
+    A[6 + ns * 2] = (-432.0 + 92.0 * s21) / 315.0;
+    A[6 + ns * 3] = (633.0 - 145.0 * s21) / 90.0;
+    A[6 + ns * 4] = (-504.0 + 115.0 * s21) / 70.0;
+    A[6 + ns * 5] = (63.0 - 13.0 * s21) / 35.0;
+    A[7 + ns * 0] = 1.0 / 14.0;
+    A[7 + ns * 4] = (14.0 - 3.0 * s21) / 126.0;
+    A[7 + ns * 5] = (13.0 - 3.0 * s21) / 63.0;
+    A[7 + ns * 6] = 1.0 / 9.0;
+    A[8 + ns * 0] = 1.0 / 32.0;
+    A[8 + ns * 4] = (91.0 - 21.0 * s21) / 576.0;
+    A[8 + ns * 5] = 11.0 / 72.0;
+    A[8 + ns * 6] = (-385.0 - 75.0 * s21) / 1152.0;
+    A[8 + ns * 7] = (63.0 + 13.0 * s21) / 128.0;
+    A[9 + ns * 0] = 1.0 / 14.0;
+    A[9 + ns * 4] = 1.0 / 9.0;
+    A[9 + ns * 5] = (-733.0 - 147.0 * s21) / 2205.0;
+    A[9 + ns * 6] = (515.0 + 111.0 * s21) / 504.0;
+    A[9 + ns * 7] = (-51.0 - 11.0 * s21) / 56.0;
+    A[9 + ns * 8] = (132.0 + 28.0 * s21) / 245.0;
+    A[10 + ns * 4] = (-42.0 + 7.0 * s21) / 18.0;
+    A[10 + ns * 5] = (-18.0 + 28.0 * s21) / 45.0;
+    A[10 + ns * 6] = (-273.0 - 53.0 * s21) / 72.0;
+    A[10 + ns * 7] = (301.0 + 53.0 * s21) / 72.0;
+    A[10 + ns * 8] = (28.0 - 28.0 * s21) / 45.0;
+    A[10 + ns * 9] = (49.0 - 7.0 * s21) / 18.0;
+    // b
+    for (int i = 0; i < ns; i++)
+        b[i] = 0.0;
+    b[0] = 9.0 / 180.0;
+    b[7] = 49.0 / 180.0;
+    b[8] = 64.0 / 180.0;
+    b[9] = 49.0 / 180.0;
+    b[10] = 9.0 / 180.0;
+    // c
+    c[0] = 0.0;
+    c[1] = 1.0 / 2.0;
+    c[2] = 1.0 / 2.0;
+    c[3] = (7.0 + s21) / 14.0;
+    c[4] = (7.0 + s21) / 14.0;
+    c[5] = 1.0 / 2.0;
+    c[6] = (7.0 - s21) / 14.0;
+    c[7] = (7.0 - s21) / 14.0;
+    c[8] = 1.0 / 2.0;
+    c[9] = (7.0 + s21) / 14.0;
+    c[10] = 1.0;
+}
+
+
+
+int get_erk_tableau(sim_erk_tableau_type tableau, int ns, double *A, double *b, double *c)
+{
+    switch (tableau)
+    {
+        case ERK_CLASSIC:
+            get_explicit_butcher_tableau(ns, A, b, c);
+            return ns;
+        case ERK_RK4_38:
+            get_rk4_38_tableau(A, b, c);
+            return 4;
+        case ERK_CASH_KARP:
+            get_cash_karp_tableau(A, b, c);
+            return 6;
+        case ERK_DOPRI5:
+            get_dormand_prince_tableau(A, b, NULL, c);
+            return 7;
+        case ERK_BUTCHER6:
+            get_butcher6_tableau(A, b, c);
+            return 7;
+        case ERK_COOPER_VERNER8:
+            get_cooper_verner8_tableau(A, b, c);
+            return 11;
+        default:
+            printf("\nerror: get_erk_tableau: tableau %d not in the library\n", tableau);
+            exit(1);
+    }
+}
+
+
+
+int calculate_embedded_error_weights(int ns, double *nodes, double *b, double *e, void *work)
+{
+    if (ns < 2)
+    {
+        printf("\nerror: calculate_embedded_error_weights: ns >= 2 required, got %d\n", ns);
+        exit(1);
+    }
+
+    // quadrature on the first m nodes
+    int m = ns - 1;
+    int i, j;
+
+    char *c_ptr = work;
+
+    // can_vm
+    double *can_vm = (double *) c_ptr;
+    c_ptr += m * m * sizeof(double);
+    // rhs
+    double *rhs = (double *) c_ptr;
+    c_ptr += m * m * sizeof(double);
+    // lu_work
+    double *lu_work = (double *) c_ptr;
+    c_ptr += m * m * sizeof(double);
+    // perm
+    int *perm = (int *) c_ptr;
+    c_ptr += m * sizeof(int);
+
+    assert((char *) work + butcher_tableau_work_calculate_size(ns) >= c_ptr);
+
+    for (j = 0; j < m; j++)
+    {
+        for (i = 0; i < m; i++) can_vm[i + j * m] = pow(nodes[i], j);
+    }
+
+    for (i = 0; i < m * m; i++) rhs[i] = 0.0;
+    for (i = 0; i < m; i++) rhs[i * (m + 1)] = 1.0;
+
+    lu_system_solve(can_vm, rhs, perm, m, m, lu_work);
+
+    for (i = 0; i < m; i++)
+    {
+        e[i] = b[i];
+        for (j = 0; j < m; j++)
+        {
+            e[i] -= 1.0 / (j + 1) * rhs[i * m + j];
+        }
+    }
+    e[m] = b[m];
+
+    return m;
+}
+
+
+
+// eigenpair of A by inverse iteration on the real system
+// [A - re*I, im*I; -im*I, A - re*I] [vr; vi] = rhs (only the first ns rows if im == 0),
+// the eigenvalue re + i*im is refined with the Rayleigh quotient of v = vr + i*vi
+static void butcher_tableau_eigenpair(int ns, double *A, double *re, double *im, double *vr,
+                                      double *vi, double *sys, double *vec, double *lu_work,
+                                      int *perm)
+{
+    int dim = *im == 0.0 ? ns : 2 * ns;
+    int i, j;
+
+    for (i = 0; i < dim; i++)
+        vec[i] = 1.0;
+
+    for (int iter = 0; iter < 3; iter++)
+    {
+        // shift off the eigenvalue to keep the system regular
+        double shift = *re + 1e-10 * (1.0 + fabs(*re) + fabs(*im));
+
+        for (j = 0; j < dim * dim; j++)
+            sys[j] = 0.0;
+        for (j = 0; j < ns; j++)
+        {
+            for (i = 0; i < ns; i++)
+            {
+                sys[i + dim * j] = A[i + ns * j];
+                if (dim > ns)
+                    sys[ns + i + dim * (ns + j)] = A[i + ns * j];
+            }
+            sys[j + dim * j] -= shift;
+            if (dim > ns)
+            {
+                sys[ns + j + dim * (ns + j)] -= shift;
+                sys[j + dim * (ns + j)] = *im;
+                sys[ns + j + dim * j] = -*im;
+            }
+        }
+
+        lu_system_solve(sys, vec, perm, dim, 1, lu_work);
+
+        double nrm = 0.0;
+        for (i = 0; i < dim; i++)
+            nrm += vec[i] * vec[i];
+        nrm = sqrt(nrm);
+        for (i = 0; i < dim; i++)
+            vec[i] /= nrm;
+
+        for (i = 0; i < ns; i++)
+        {
+            vr[i] = vec[i];
+            vi[i] = dim > ns ? vec[ns + i] : 0.0;
+        }
+
+        // Rayleigh quotient v^H A v / v^H v, with v^H v = 1
+        double rq_re = 0.0;
+        double rq_im = 0.0;
+        for (j = 0; j < ns; j++)
+        {
+            for (i = 0; i < ns; i++)
+            {
+                rq_re += A[i + ns * j] * (vr[i] * vr[j] + vi[i] * vi[j]);
+                rq_im += A[i + ns * j] * (vr[i] * vi[j] - vi[i] * vr[j]);
+            }
+        }
+        *re = rq_re;
+        if (dim > ns)
+            *im = rq_im;
+    }
+}
+
+
+
+int butcher_tableau_block_diagonalize(int ns, double *A, double *T, double *T_inv, double *B,
+                                      void *work)
+{
+    int i, j, k;
+
+    char *c_ptr = work;
+
+    double *char_poly = (double *) c_ptr;
+    c_ptr += (ns + 1) * sizeof(double);
+    double *M = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *AM = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *eig_re = (double *) c_ptr;
+    c_ptr += ns * sizeof(double);
+    double *eig_im = (double *) c_ptr;
+    c_ptr += ns * sizeof(double);
+    double *sys = (double *) c_ptr;
+    c_ptr += 4 * ns * ns * sizeof(double);
+    double *vec = (double *) c_ptr;
+    c_ptr += 2 * ns * sizeof(double);
+    double *lu_work = (double *) c_ptr;
+    c_ptr += 2 * ns * sizeof(double);
+    double *T_fact = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *lu_work_T = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    int *perm = (int *) c_ptr;
+    c_ptr += 2 * ns * sizeof(int);
+
+    assert((char *) work + butcher_tableau_work_calculate_size(ns) >= c_ptr);
+
+    // characteristic polynomial lambda^ns + sum_k char_poly[k] lambda^k (Faddeev-LeVerrier)
+    char_poly[ns] = 1.0;
+    for (i = 0; i < ns * ns; i++)
+        M[i] = 0.0;
+    for (k = 1; k <= ns; k++)
+    {
+        // M = A * M + char_poly[ns-k+1] * I
+        for (j = 0; j < ns; j++)
+        {
+            for (i = 0; i < ns; i++)
+            {
+                AM[i + ns * j] = 0.0;
+                for (int l = 0; l < ns; l++)
+                    AM[i + ns * j] += A[i + ns * l] * M[l + ns * j];
+            }
+            AM[j + ns * j] += char_poly[ns - k + 1];
+        }
+        for (i = 0; i < ns * ns; i++)
+            M[i] = AM[i];
+        // char_poly[ns-k] = -trace(A * M) / k
+        double trace = 0.0;
+        for (i = 0; i < ns; i++)
+            for (int l = 0; l < ns; l++)
+                trace += A[i + ns * l] * M[l + ns * i];
+        char_poly[ns - k] = -trace / k;
+    }
+
+    // roots of the characteristic polynomial (Durand-Kerner)
+    double radius = 0.0;
+    for (k = 0; k < ns; k++)
+        radius = fmax(radius, fabs(char_poly[k]));
+    radius = 1.0 + radius;
+    for (i = 0; i < ns; i++)
+    {
+        eig_re[i] = 0.5 * radius * cos(2.0 * M_PI * (i + 0.25) / ns);
+        eig_im[i] = 0.5 * radius * sin(2.0 * M_PI * (i + 0.25) / ns);
+    }
+    for (int iter = 0; iter < 1000; iter++)
+    {
+        double max_step = 0.0;
+        for (i = 0; i < ns; i++)
+        {
+            // p(z) by Horner, and prod_{j != i} (z - z_j)
+            double p_re = 1.0, p_im = 0.0;
+            for (k = ns - 1; k >= 0; k--)
+            {
+                double tmp = p_re * eig_re[i] - p_im * eig_im[i] + char_poly[k];
+                p_im = p_re * eig_im[i] + p_im * eig_re[i];
+                p_re = tmp;
+            }
+            double q_re = 1.0, q_im = 0.0;
+            for (j = 0; j < ns; j++)
+            {
+                if (j == i)
+                    continue;
+                double d_re = eig_re[i] - eig_re[j];
+                double d_im = eig_im[i] - eig_im[j];
+                double tmp = q_re * d_re - q_im * d_im;
+                q_im = q_re * d_im + q_im * d_re;
+                q_re = tmp;
+            }
+            double q_abs2 = q_re * q_re + q_im * q_im;
+            if (q_abs2 == 0.0)
+                return -1;
+            double s_re = (p_re * q_re + p_im * q_im) / q_abs2;
+            double s_im = (p_im * q_re - p_re * q_im) / q_abs2;
+            eig_re[i] -= s_re;
+            eig_im[i] -= s_im;
+            max_step = fmax(max_step, fabs(s_re) + fabs(s_im));
+        }
+        if (max_step < 1e-15 * radius)
+            break;
+    }
+
+    // real block diagonal form A * T = T * B,
+    // 1x1 blocks for real eigenvalues, [re, im; -im, re] for complex conjugate pairs
+    for (i = 0; i < ns * ns; i++)
+        B[i] = 0.0;
+    int col = 0;
+    for (i = 0; i < ns; i++)
+    {
+        double eig_abs = fabs(eig_re[i]) + fabs(eig_im[i]);
+        if (fabs(eig_im[i]) <= 1e-8 * eig_abs)
+        {
+            if (col + 1 > ns)
+                return -1;
+            eig_im[i] = 0.0;
+            butcher_tableau_eigenpair(ns, A, &eig_re[i], &eig_im[i], &T[ns * col], vec + ns,
+                                      sys, vec, lu_work, perm);
+            B[col + ns * col] = eig_re[i];
+            col += 1;
+        }
+        else if (eig_im[i] > 0.0)
+        {
+            if (col + 2 > ns)
+                return -1;
+            butcher_tableau_eigenpair(ns, A, &eig_re[i], &eig_im[i], &T[ns * col],
+                                      &T[ns * (col + 1)], sys, vec, lu_work, perm);
+            B[col + ns * col] = eig_re[i];
+            B[col + ns * (col + 1)] = eig_im[i];
+            B[col + 1 + ns * col] = -eig_im[i];
+            B[col + 1 + ns * (col + 1)] = eig_re[i];
+            col += 2;
+        }
+    }
+    if (col != ns)
+        return -1;
+
+    // T_inv
+    for (i = 0; i < ns * ns; i++)
+    {
+        T_fact[i] = T[i];
+        T_inv[i] = 0.0;
+    }
+    for (i = 0; i < ns; i++)
+        T_inv[i * (ns + 1)] = 1.0;
+    lu_system_solve(T_fact, T_inv, perm, ns, ns, lu_work_T);
+
+    // check A = T * B * T_inv
+    double A_max = 0.0;
+    double err = 0.0;
+    for (i = 0; i < ns * ns; i++)
+        A_max = fmax(A_max, fabs(A[i]));
+    for (j = 0; j < ns; j++)
+    {
+        for (i = 0; i < ns; i++)
+        {
+            double tmp = 0.0;
+            for (k = 0; k < ns; k++)
+            {
+                for (int l = 0; l < ns; l++)
+                    tmp += T[i + ns * k] * B[k + ns * l] * T_inv[l + ns * j];
+            }
+            err = fmax(err, fabs(tmp - A[i + ns * j]));
+        }
+    }
+    if (!(err <= 1e-10 * A_max))
+        return -1;
+
+    return 0;
+}
@@ -73,6 +73,19 @@ typedef enum
 } sim_collocation_type;
 
 
+
+typedef enum
+{
+    ERK_CLASSIC,           // classic schemes, ns = {1,2,3,4}
+    ERK_RK4_38,            // Kutta 3/8-rule, ns = 4, order 4
+    ERK_CASH_KARP,         // Cash-Karp, ns = 6, order 5
+    ERK_DOPRI5,            // Dormand-Prince, ns = 7, order 5
+    ERK_BUTCHER6,          // Butcher, ns = 7, order 6
+    ERK_COOPER_VERNER8,    // Cooper-Verner, ns = 11, order 8
+    ERK_CUSTOM,            // user-supplied A, b; c are the row sums of A
+} sim_erk_tableau_type;
+
+
 //
 // acados_size_t gauss_legendre_nodes_work_calculate_size(int ns);
 //
@@ -91,6 +104,17 @@ void calculate_butcher_tableau(int ns, sim_collocation_type collocation_type, do
 
 //
 void get_explicit_butcher_tableau(int ns, double *A, double *b, double *c);
+// Dormand-Prince 5(4), ns = 7, e = b - b_hat are the weights of the error estimate (optional)
+void get_dormand_prince_tableau(double *A, double *b, double *e, double *c);
+// explicit tableau from the library, ns is only used for ERK_CLASSIC; returns the number of stages
+int get_erk_tableau(sim_erk_tableau_type tableau, int ns, double *A, double *b, double *c);
+// real block diagonal form A = T * B * T_inv with 1x1 blocks for real eigenvalues and
+// [re, im; -im, re] blocks for complex conjugate pairs; returns 0 on success
+int butcher_tableau_block_diagonalize(int ns, double *A, double *T, double *T_inv, double *B,
+                                      void *work);
+// error weights e = b - b_hat, b_hat are the interpolatory quadrature weights on the first ns-1 nodes;
+// returns the order of the embedded quadrature
+int calculate_embedded_error_weights(int ns, double *nodes, double *b, double *e, void *work);
 
 
 
@@ -31,11 +31,13 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 // acados
 #include "acados/sim/sim_common.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 
@@ -126,6 +128,8 @@ sim_in *sim_in_assign(void *config_, void *dims, void *raw_memory)
     config->dims_get(config_, dims, "nu", &nu);
     config->dims_get(config_, dims, "nz", &nz);
     int NF = nx + nu;
+    in->nx = nx;
+    in->nu = nu;
     in->identity_seed = false;
     in->t0 = 0.0;
 
@@ -229,6 +233,37 @@ int sim_in_set_(void *config_, void *dims_, sim_in *in, const char *field, void
 
 
 
+int sim_in_set_by_id_(void *config_, void *dims_, sim_in *in, int field_id, void *value)
+{
+    int nx = in->nx;
+    int nu = in->nu;
+    double *double_values = value;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_SIM_T:
+            in->T = double_values[0];
+            break;
+        case ACADOS_FIELD_SIM_T0:
+            in->t0 = double_values[0];
+            break;
+        case ACADOS_FIELD_X:
+            for (int ii=0; ii < nx; ii++)
+                in->x[ii] = double_values[ii];
+            break;
+        case ACADOS_FIELD_U:
+            for (int ii=0; ii < nu; ii++)
+                in->u[ii] = double_values[ii];
+            break;
+        default:
+            return sim_in_set_(config_, dims_, in, acados_field_name(field_id), value);
+    }
+
+    return ACADOS_SUCCESS;
+}
+
+
+
 /************************************************
  * out
  ************************************************/
@@ -239,10 +274,11 @@ acados_size_t sim_out_calculate_size(void *config_, void *dims)
 
     acados_size_t size = sizeof(sim_out);
 
-    int nx, nu, nz;
+    int nx, nu, nz, nq;
     config->dims_get(config_, dims, "nx", &nx);
     config->dims_get(config_, dims, "nu", &nu);
     config->dims_get(config_, dims, "nz", &nz);
+    config->dims_get(config_, dims, "nq", &nq);
 
     int NF = nx + nu;
     size += sizeof(sim_info);
@@ -257,6 +293,9 @@ acados_size_t sim_out_calculate_size(void *config_, void *dims)
 
     size += NF * sizeof(double);                // grad
 
+    size += nq * sizeof(double);                // qn
+    size += nq * NF * sizeof(double);           // S_q
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -271,10 +310,11 @@ sim_out *sim_out_assign(void *config_, void *dims, void *raw_memory)
 
     char *c_ptr = (char *) raw_memory;
 
-    int nx, nu, nz;
+    int nx, nu, nz, nq;
     config->dims_get(config_, dims, "nx", &nx);
     config->dims_get(config_, dims, "nu", &nu);
     config->dims_get(config_, dims, "nz", &nz);
+    config->dims_get(config_, dims, "nq", &nq);
 
     int NF = nx + nu;
 
@@ -295,6 +335,12 @@ sim_out *sim_out_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(nz, &out->zn, &c_ptr);
     assign_and_advance_double(nz * NF, &out->S_algebraic, &c_ptr);
 
+    assign_and_advance_double(nq, &out->qn, &c_ptr);
+    assign_and_advance_double(nq * NF, &out->S_q, &c_ptr);
+
+    out->BAbt = NULL;
+    out->dzduxt = NULL;
+
     assert((char *) raw_memory + sim_out_calculate_size(config_, dims) >= c_ptr);
 
     return out;
@@ -389,6 +435,25 @@ int sim_out_get_(void *config_, void *dims_, sim_out *out, const char *field, vo
         for (int ii=0; ii < nz*(nu+nx); ii++)
             S_algebraic[ii] = out->S_algebraic[ii];
     }
+    else if (!strcmp(field, "qn") || !strcmp(field, "q"))
+    {
+        int nq;
+        config->dims_get(config_, dims_, "nq", &nq);
+        double *qn = value;
+        for (int ii=0; ii < nq; ii++)
+            qn[ii] = out->qn[ii];
+    }
+    else if (!strcmp(field, "S_q"))
+    {
+        // note: this assumes nf = nu+nx !!!
+        int nx, nu, nq;
+        config->dims_get(config_, dims_, "nq", &nq);
+        config->dims_get(config_, dims_, "nx", &nx);
+        config->dims_get(config_, dims_, "nu", &nu);
+        double *S_q = value;
+        for (int ii=0; ii < nq*(nu+nx); ii++)
+            S_q[ii] = out->S_q[ii];
+    }
     else if (!strcmp(field, "CPUtime") || !strcmp(field, "time_tot"))
     {
         double *time = value;
@@ -404,6 +469,16 @@ int sim_out_get_(void *config_, void *dims_, sim_out *out, const char *field, vo
         double *time = value;
         *time = out->info->LAtime;
     }
+    else if (!strcmp(field, "lu_fact"))
+    {
+        int *lu_fact = value;
+        *lu_fact = out->info->lu_fact;
+    }
+    else if (!strcmp(field, "newton_iter"))
+    {
+        int *newton_iter = value;
+        *newton_iter = out->info->newton_iter;
+    }
     else
     {
         printf("sim_out_get_: field %s not supported \n", field);
@@ -415,6 +490,70 @@ int sim_out_get_(void *config_, void *dims_, sim_out *out, const char *field, vo
 
 
 
+double sim_adaptive_step_size(double step, double t_left, int steps_left, bool *force)
+{
+    *force = false;
+    if (step * steps_left < t_left)
+    {
+        // bounded number of steps has priority over the error control
+        step = t_left / steps_left;
+        *force = true;
+    }
+    // avoid a tiny last step
+    if (step > 0.99 * t_left)
+        step = t_left;
+    return step;
+}
+
+
+
+double sim_adaptive_step_factor(double err, int e_order)
+{
+    // safety factor 0.9, growth limited to [0.2, 5.0]
+    double fac = 5.0;
+    if (err > 0.0)
+        fac = 0.9 * pow(err, -1.0 / (e_order + 1));
+    if (fac > 5.0)
+        fac = 5.0;
+    if (fac < 0.2)
+        fac = 0.2;
+    return fac;
+}
+
+
+
+void sim_out_set_forw_sens(int nx, int nu, struct blasfeo_dmat *S, int ai, int aj, sim_out *out)
+{
+    if (out->BAbt != NULL)
+    {
+        // transpose into [B'; A'] of the caller
+        blasfeo_dgetr(nx, nu, S, ai, aj + nx, out->BAbt, 0, 0);
+        blasfeo_dgetr(nx, nx, S, ai, aj, out->BAbt, nu, 0);
+    }
+    else
+    {
+        blasfeo_unpack_dmat(nx, nx + nu, S, ai, aj, out->S_forw, nx);
+    }
+}
+
+
+
+void sim_out_set_algebraic_sens(int nz, int nx, int nu, struct blasfeo_dmat *S, int ai, int aj,
+                                sim_out *out)
+{
+    if (out->dzduxt != NULL)
+    {
+        blasfeo_dgetr(nz, nu, S, ai, aj + nx, out->dzduxt, 0, 0);
+        blasfeo_dgetr(nz, nx, S, ai, aj, out->dzduxt, nu, 0);
+    }
+    else
+    {
+        blasfeo_unpack_dmat(nz, nx + nu, S, ai, aj, out->S_algebraic, nz);
+    }
+}
+
+
+
 /************************************************
 * sim_opts
 ************************************************/
@@ -482,6 +621,39 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         sim_collocation_type *collocation_type = (sim_collocation_type *) value;
         opts->collocation_type = *collocation_type;
     }
+    else if (!strcmp(field, "erk_tableau"))
+    {
+        sim_erk_tableau_type *erk_tableau = (sim_erk_tableau_type *) value;
+        opts->erk_tableau = *erk_tableau;
+    }
+    else if (!strcmp(field, "tableau_A"))
+    {
+        // column-major ns x ns, strictly lower triangular; ns has to be set before
+        double *A = (double *) value;
+        int ns = opts->ns;
+        if (ns > NS_MAX)
+        {
+            printf("\nerror: sim_opts_set: tableau_A: ns = %d > NS_MAX = %d\n", ns, NS_MAX);
+            exit(1);
+        }
+        for (int ii = 0; ii < ns * ns; ii++)
+            opts->A_mat[ii] = A[ii];
+        for (int ii = 0; ii < ns; ii++)
+        {
+            opts->c_vec[ii] = 0.0;
+            for (int jj = 0; jj < ns; jj++)
+                opts->c_vec[ii] += A[ii + ns * jj];
+        }
+        opts->tableau_size = ns;
+        opts->erk_tableau = ERK_CUSTOM;
+    }
+    else if (!strcmp(field, "tableau_b"))
+    {
+        double *b = (double *) value;
+        for (int ii = 0; ii < opts->ns; ii++)
+            opts->b_vec[ii] = b[ii];
+        opts->erk_tableau = ERK_CUSTOM;
+    }
     else if (!strcmp(field, "cost_type"))
     {
         ocp_nlp_cost_t *cost_type = (ocp_nlp_cost_t *) value;
@@ -492,6 +664,51 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         double *newton_tol = value;
         opts->newton_tol = *newton_tol;
     }
+    else if (!strcmp(field, "jac_reuse_across_calls"))
+    {
+        bool *jac_reuse_across_calls = (bool *) value;
+        opts->jac_reuse_across_calls = *jac_reuse_across_calls;
+    }
+    else if (!strcmp(field, "jac_reuse_contraction_max"))
+    {
+        double *jac_reuse_contraction_max = value;
+        opts->jac_reuse_contraction_max = *jac_reuse_contraction_max;
+    }
+    else if (!strcmp(field, "newton_decoupled"))
+    {
+        bool *newton_decoupled = (bool *) value;
+        opts->newton_decoupled = *newton_decoupled;
+    }
+    else if (!strcmp(field, "step_size_adaptive"))
+    {
+        bool *step_size_adaptive = (bool *) value;
+        opts->step_size_adaptive = *step_size_adaptive;
+    }
+    else if (!strcmp(field, "step_size_atol"))
+    {
+        double *step_size_atol = value;
+        opts->step_size_atol = *step_size_atol;
+    }
+    else if (!strcmp(field, "step_size_rtol"))
+    {
+        double *step_size_rtol = value;
+        opts->step_size_rtol = *step_size_rtol;
+    }
+    else if (!strcmp(field, "num_segments"))
+    {
+        int *num_segments = (int *) value;
+        opts->num_segments = *num_segments;
+    }
+    else if (!strcmp(field, "segment_iter"))
+    {
+        int *segment_iter = (int *) value;
+        opts->segment_iter = *segment_iter;
+    }
+    else if (!strcmp(field, "segment_tol"))
+    {
+        double *segment_tol = value;
+        opts->segment_tol = *segment_tol;
+    }
     else
     {
         printf("\nerror: field %s not available in sim_opts_set_\n", field);
@@ -505,7 +722,17 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
 void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *value)
 {
 
-    if (!strcmp(field, "sens_forw"))
+    if (!strcmp(field, "ns") || !strcmp(field, "num_stages"))
+    {
+        int *ns = value;
+        *ns = opts->ns;
+    }
+    else if (!strcmp(field, "erk_tableau"))
+    {
+        sim_erk_tableau_type *erk_tableau = value;
+        *erk_tableau = opts->erk_tableau;
+    }
+    else if (!strcmp(field, "sens_forw"))
     {
         bool *sens_forw = value;
         *sens_forw = opts->sens_forw;
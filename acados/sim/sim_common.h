@@ -34,6 +34,8 @@
 
 #include <stdbool.h>
 
+#include "blasfeo/include/blasfeo_common.h"
+
 #include "acados/sim/sim_collocation_utils.h"
 #include "acados/utils/timing.h"
 #include "acados/utils/types.h"
@@ -71,6 +73,8 @@ typedef enum
 typedef struct
 {
     void *dims;
+    int nx;  // resolved from dims once, used by sim_in_set_by_id_
+    int nu;
 
     double *x;  // x[NX] - initial state value for simulation
     double *u;  // u[NU] - control - constant over simulation time
@@ -94,6 +98,8 @@ typedef struct
     double CPUtime;  // in seconds
     double LAtime;   // in seconds
     double ADtime;   // in seconds
+    int lu_fact;     // number of LU factorizations
+    int newton_iter; // number of Newton iterations
 
 } sim_info;
 
@@ -112,6 +118,14 @@ typedef struct
 
     double *grad;  // gradient correction
 
+    double *qn;   // qn[NQ] - integral of the quadrature states over the simulation interval
+    double *S_q;  // S_q[NQ*(NX+NU)] - forward sensitivities of qn w.r.t. the seeds [Sx, Su]
+
+    // optional BLASFEO matrices of the caller, NULL by default;
+    // if set, the sensitivities are written there instead of S_forw and S_algebraic
+    struct blasfeo_dmat *BAbt;    // [Su'; Sx'], (nu+nx) x nx
+    struct blasfeo_dmat *dzduxt;  // [dz/du'; dz/dx'], (nu+nx) x nz
+
     sim_info *info;
 
 } sim_out;
@@ -142,6 +156,7 @@ typedef struct
     bool sens_algebraic;  // 1 -- if S_algebraic should be computed
     bool exact_z_output;  // 1 -- if z, S_algebraic should be computed exactly, extra Newton iterations
     sim_collocation_type collocation_type;
+    sim_erk_tableau_type erk_tableau;  // explicit integrators only
 
     // for explicit integrators: newton_iter == 0 && scheme == NULL
     // && jac_reuse=false
@@ -151,6 +166,33 @@ typedef struct
 
     double newton_tol; // optinally used in implicit integrators
 
+    // keep the LU factors of the Newton matrix in memory and reuse them across calls (IRK),
+    // refactorize once the Newton contraction rate exceeds jac_reuse_contraction_max
+    bool jac_reuse_across_calls;
+    double jac_reuse_contraction_max;
+
+    // eigenvalue-decoupled simplified Newton (IRK): A_mat = T_mat * B_mat * T_inv_mat, with
+    // B_mat real block diagonal, one real or complex pair system of size nx+nz per block
+    bool newton_decoupled;
+    double *T_mat;
+    double *T_inv_mat;
+    double *B_mat;
+
+    // adaptive step size control with an embedded error estimate (ERK, IRK),
+    // num_steps is then the maximum number of steps per call
+    bool step_size_adaptive;
+    double step_size_atol;
+    double step_size_rtol;
+    double *e_vec;  // error weights b - b_hat of the embedded method
+    int e_order;    // order of the embedded method
+
+    // split the num_steps into num_segments segments integrated in parallel (ERK, OpenMP),
+    // coupled by at most segment_iter Newton-type corrections along the chained sensitivities,
+    // until the defects at the segment boundaries are below segment_tol
+    int num_segments;
+    int segment_iter;
+    double segment_tol;
+
     // workspace
     void *work;
 
@@ -206,6 +248,8 @@ acados_size_t sim_in_calculate_size(void *config, void *dims);
 sim_in *sim_in_assign(void *config, void *dims, void *raw_memory);
 //
 int sim_in_set_(void *config_, void *dims_, sim_in *in, const char *field, void *value);
+//
+int sim_in_set_by_id_(void *config_, void *dims_, sim_in *in, int field_id, void *value);
 
 /* out */
 //
@@ -214,6 +258,16 @@ acados_size_t sim_out_calculate_size(void *config, void *dims);
 sim_out *sim_out_assign(void *config, void *dims, void *raw_memory);
 //
 int sim_out_get_(void *config, void *dims, sim_out *out, const char *field, void *value);
+// adaptive step size: clips step to the remaining time t_left and enlarges it if needed
+// to reach the end within steps_left steps, in which case *force is set (accept without error test)
+double sim_adaptive_step_size(double step, double t_left, int steps_left, bool *force);
+// adaptive step size: factor for the next step size given the scaled error norm
+double sim_adaptive_step_factor(double err, int e_order);
+// writes the forward sensitivities S = [Sx, Su] (nx x nx+nu at ai, aj) to out
+void sim_out_set_forw_sens(int nx, int nu, struct blasfeo_dmat *S, int ai, int aj, sim_out *out);
+// writes the algebraic sensitivities S = [dz/dx, dz/du] (nz x nx+nu at ai, aj) to out
+void sim_out_set_algebraic_sens(int nz, int nx, int nu, struct blasfeo_dmat *S, int ai, int aj,
+                                sim_out *out);
 
 /* opts */
 //
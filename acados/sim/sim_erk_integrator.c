@@ -31,6 +31,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,6 +41,11 @@
 #include "acados/sim/sim_erk_integrator.h"
 #include "acados/utils/mem.h"
 
+#include "blasfeo/include/blasfeo_d_aux.h"
+
+// number of stages of the embedded Dormand-Prince 5(4) tableau (step_size_adaptive)
+#define ERK_NS_EMBEDDED 7
+
 /************************************************
  * dims
  ************************************************/
@@ -63,6 +69,7 @@ void *sim_erk_dims_assign(void *config_, void *raw_memory)
     dims->nx = 0;
     dims->nu = 0;
     dims->nz = 0;
+    dims->nq = 0;
 
     assert((char *) raw_memory + sim_erk_dims_calculate_size() >= c_ptr);
 
@@ -92,6 +99,10 @@ void sim_erk_dims_set(void *config_, void *dims_, const char *field, const int *
             exit(1);
         }
     }
+    else if (!strcmp(field, "nq"))
+    {
+        dims->nq = *value;
+    }
     else
     {
         printf("\nerror: sim_erk_dims_set: dim type not available: %s\n", field);
@@ -117,6 +128,10 @@ void sim_erk_dims_get(void *config_, void *dims_, const char *field, int *value)
     {
         *value = 0;
     }
+    else if (!strcmp(field, "nq"))
+    {
+        *value = dims->nq;
+    }
     else
     {
         printf("\nerror: sim_erk_dims_get: dim type not available: %s\n", field);
@@ -173,6 +188,10 @@ int sim_erk_model_set(void *model_, const char *field, void *value)
     {
         model->expl_ode_hes = value;
     }
+    else if (!strcmp(field, "quad_fun_jac"))
+    {
+        model->quad_fun_jac = value;
+    }
     else
     {
         printf("\nerror: sim_erk_model_set: wrong field: %s\n", field);
@@ -197,6 +216,7 @@ acados_size_t sim_erk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += ns_max * sizeof(double);           // e_vec
 
     make_int_multiple_of(8, &size);
     size += 1 * 8;
@@ -220,6 +240,7 @@ void *sim_erk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(ns_max, &opts->e_vec, &c_ptr);
 
     assert((char *) raw_memory + sim_erk_opts_calculate_size(config_, dims) >= c_ptr);
 
@@ -264,6 +285,7 @@ void sim_erk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     double *b = opts->b_vec;
     double *c = opts->c_vec;
 
+    opts->erk_tableau = ERK_CLASSIC;
     get_explicit_butcher_tableau(ns, A, b, c);
 
     opts->num_steps = 1;
@@ -275,6 +297,14 @@ void sim_erk_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     opts->output_z = false;
     opts->sens_algebraic = false;
+
+    opts->step_size_adaptive = false;
+    opts->step_size_atol = 1e-6;
+    opts->step_size_rtol = 1e-6;
+
+    opts->num_segments = 1;
+    opts->segment_iter = 100;  // at most num_segments - 1 corrections are needed
+    opts->segment_tol = 1e-12;
 }
 
 
@@ -283,28 +313,80 @@ void sim_erk_opts_update(void *config_, void *dims, void *opts_)
 {
     sim_opts *opts = opts_;
 
-    int ns = opts->ns;
+    double *A = opts->A_mat;
+    double *b = opts->b_vec;
+    double *c = opts->c_vec;
 
-    opts->tableau_size = opts->ns;
+    if (opts->num_segments < 1 || opts->num_steps % opts->num_segments != 0)
+    {
+        printf("\nerror: sim_erk_opts_update: num_steps = %d is not a multiple of num_segments = %d\n",
+               opts->num_steps, opts->num_segments);
+        exit(1);
+    }
+    if (opts->segment_iter < 1 || opts->segment_tol < 0.0)
+    {
+        printf("\nerror: sim_erk_opts_update: segment_iter = %d must be positive and "
+               "segment_tol = %e nonnegative\n", opts->segment_iter, opts->segment_tol);
+        exit(1);
+    }
+    if (opts->num_segments > 1 && opts->step_size_adaptive)
+    {
+        printf("\nerror: sim_erk_opts_update: num_segments > 1 requires a fixed step size\n");
+        exit(1);
+    }
 
-    assert((ns == 1 || ns == 2 || ns == 3 || ns == 4) && "only number of stages = {1,2,3,4} implemented!");
+    // embedded Dormand-Prince 5(4), its tableau is set up in the workspace by sim_erk,
+    // ns and the fixed step tableau are kept for when step_size_adaptive is switched off
+    if (opts->step_size_adaptive)
+        opts->e_order = 4;
 
-    assert(ns <= NS_MAX && "ns > NS_MAX!");
+    int ns = opts->ns;
 
-    // set tableau size
-    opts->tableau_size = opts->ns;
+    if (opts->erk_tableau == ERK_CUSTOM)
+    {
+        // A, b and c have been set by the user
+        if (opts->tableau_size != ns)
+        {
+            printf("\nerror: sim_erk_opts_update: custom tableau set for ns = %d, but ns = %d\n",
+                   opts->tableau_size, ns);
+            exit(1);
+        }
+        for (int ii = 0; ii < ns; ii++)
+        {
+            for (int jj = ii; jj < ns; jj++)
+            {
+                if (A[ii + ns * jj] != 0.0)
+                {
+                    printf("\nerror: sim_erk_opts_update: custom tableau is not explicit, "
+                           "A[%d, %d] = %e\n", ii, jj, A[ii + ns * jj]);
+                    exit(1);
+                }
+            }
+        }
+        return;
+    }
 
-    double *A = opts->A_mat;
-    double *b = opts->b_vec;
-    double *c = opts->c_vec;
+    // library tableaus fix the number of stages
+    ns = get_erk_tableau(opts->erk_tableau, ns, A, b, c);
+    assert(ns <= NS_MAX && "ns > NS_MAX!");
 
-    get_explicit_butcher_tableau(ns, A, b, c);
+    opts->ns = ns;
+    opts->tableau_size = ns;
 
     return;
 }
 
 
 
+// number of stages integrated per step: the embedded tableau with adaptive step size,
+// the fixed step tableau otherwise
+static int sim_erk_num_stages(sim_opts *opts)
+{
+    return opts->step_size_adaptive ? ERK_NS_EMBEDDED : opts->ns;
+}
+
+
+
 /************************************************
  * memory
  ************************************************/
@@ -325,6 +407,9 @@ void *sim_erk_memory_assign(void *config, void *dims, void *opts_, void *raw_mem
     sim_erk_memory *mem = (sim_erk_memory *) c_ptr;
     c_ptr += sizeof(sim_erk_memory);
 
+    mem->step_size = 0.0;
+    mem->num_steps_taken = 0;
+
     return mem;
 }
 
@@ -376,6 +461,11 @@ void sim_erk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_steps_taken"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_steps_taken;
+    }
     else
     {
         printf("sim_erk_memory_get field %s is not supported! \n", field);
@@ -394,7 +484,7 @@ acados_size_t sim_erk_workspace_calculate_size(void *config_, void *dims_, void
     sim_opts *opts = opts_;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
 
-    int ns = opts->ns;
+    int ns = sim_erk_num_stages(opts);
 
     int nx = dims->nx;
     int nu = dims->nu;
@@ -432,6 +522,32 @@ acados_size_t sim_erk_workspace_calculate_size(void *config_, void *dims_, void
         size += ns * (nx + nu) * sizeof(double);  // adj_traj
     }
 
+    if (opts->step_size_adaptive)
+    {
+        size += num_steps * sizeof(double);  // step_traj
+        size += (ns * ns + 3 * ns) * sizeof(double);  // A_emb, b_emb, c_emb, e_emb
+    }
+
+    int num_segments = opts->num_segments;
+    if (num_segments > 1)
+    {
+        size += (num_segments + 1) * nx * sizeof(double);   // seg_x
+        size += 2 * nx * sizeof(double);                    // seg_dx
+        size += num_segments * nX * sizeof(double);         // seg_forw
+        size += num_segments * (nX + nu) * sizeof(double);  // seg_rhs_forw_in
+        size += num_segments * ns * nX * sizeof(double);    // seg_K
+        size += 2 * nx * nf * sizeof(double);               // seg_S
+        size += num_segments * sizeof(double);              // seg_time_ad
+    }
+
+    int nq = dims->nq;
+    if (nq > 0)
+    {
+        size += ns * nq * (1 + nf) * sizeof(double);  // quad_K
+        size += nq * (1 + nf) * sizeof(double);       // quad_q
+        size += nq * (1 + nx + nu) * sizeof(double);  // quad_out
+    }
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -445,7 +561,7 @@ static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, voi
     sim_opts *opts = opts_;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
 
-    int ns = opts->ns;
+    int ns = sim_erk_num_stages(opts);
 
     int nx = dims->nx;
     int nu = dims->nu;
@@ -515,6 +631,50 @@ static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, voi
         d_ptr += ns*(nu+nx);
     }
 
+    if (opts->step_size_adaptive)
+    {
+        work->step_traj = d_ptr;
+        d_ptr += num_steps;
+        work->A_emb = d_ptr;
+        d_ptr += ns*ns;
+        work->b_emb = d_ptr;
+        d_ptr += ns;
+        work->c_emb = d_ptr;
+        d_ptr += ns;
+        work->e_emb = d_ptr;
+        d_ptr += ns;
+    }
+
+    int num_segments = opts->num_segments;
+    if (num_segments > 1)
+    {
+        work->seg_x = d_ptr;
+        d_ptr += (num_segments+1)*nx;
+        work->seg_dx = d_ptr;
+        d_ptr += 2*nx;
+        work->seg_forw = d_ptr;
+        d_ptr += num_segments*nX;
+        work->seg_rhs_forw_in = d_ptr;
+        d_ptr += num_segments*(nX+nu);
+        work->seg_K = d_ptr;
+        d_ptr += num_segments*ns*nX;
+        work->seg_S = d_ptr;
+        d_ptr += 2*nx*nf;
+        work->seg_time_ad = d_ptr;
+        d_ptr += num_segments;
+    }
+
+    int nq = dims->nq;
+    if (nq > 0)
+    {
+        work->quad_K = d_ptr;
+        d_ptr += ns*nq*(1+nf);
+        work->quad_q = d_ptr;
+        d_ptr += nq*(1+nf);
+        work->quad_out = d_ptr;
+        d_ptr += nq*(1+nx+nu);
+    }
+
     // update c_ptr
     c_ptr = (char *) d_ptr;
 
@@ -527,6 +687,392 @@ static void *sim_erk_cast_workspace(void *config_, void *dims_, void *opts_, voi
  * functions
  ************************************************/
 
+// scaled RMS norm of the local error estimate step * sum_s e_s k_s,
+// only the states are controlled, the sensitivities follow the accepted steps
+static double sim_erk_error_norm(int nx, int ns, int nX, double step, double *b_vec, double *e_vec,
+                                 double *x, double *K, double atol, double rtol)
+{
+    double err = 0.0;
+    for (int i = 0; i < nx; i++)
+    {
+        double dx = 0.0;
+        double ex = 0.0;
+        for (int s = 0; s < ns; s++)
+        {
+            dx += b_vec[s] * K[s * nX + i];
+            ex += e_vec[s] * K[s * nX + i];
+        }
+        double x0 = fabs(x[i]);
+        double x1 = fabs(x[i] + step * dx);
+        double tmp = step * ex / (atol + rtol * (x0 > x1 ? x0 : x1));
+        err += tmp * tmp;
+    }
+    return sqrt(err / nx);
+}
+
+
+
+// stage derivative k = f(x, u, t) in k_out, with forward VDE if sens_forw;
+// rhs_in = [x, Sx, Su, u], with u at offset nx + nx*(nx+nu) if sens_forw and nx otherwise;
+// the time is passed as additional last input, it is ignored by functions without time input
+static void sim_erk_eval_rhs(erk_model *model, bool sens_forw, int nx, int nu, double *rhs_in,
+                             double t, double *k_out)
+{
+    ext_fun_arg_t ext_fun_type_in[5];
+    void *ext_fun_in[5];
+    ext_fun_arg_t ext_fun_type_out[3];
+    void *ext_fun_out[3];
+
+    if (sens_forw)
+    {  // simulation + forward sensitivities
+        ext_fun_type_in[0] = COLMAJ;
+        ext_fun_in[0] = rhs_in + 0;  // x: nx
+        ext_fun_type_in[1] = COLMAJ;
+        ext_fun_in[1] = rhs_in + nx;  // Sx: nx*nx
+        ext_fun_type_in[2] = COLMAJ;
+        ext_fun_in[2] = rhs_in + nx + nx * nx;  // Su: nx*nu
+        ext_fun_type_in[3] = COLMAJ;
+        ext_fun_in[3] = rhs_in + nx + nx * nx + nx * nu;  // u: nu
+        ext_fun_type_in[4] = COLMAJ;
+        ext_fun_in[4] = &t;  // t: 1
+
+        ext_fun_type_out[0] = COLMAJ;
+        ext_fun_out[0] = k_out + 0;  // fun: nx
+        ext_fun_type_out[1] = COLMAJ;
+        ext_fun_out[1] = k_out + nx;  // Sx: nx*nx
+        ext_fun_type_out[2] = COLMAJ;
+        ext_fun_out[2] = k_out + nx + nx * nx;  // Su: nx*nu
+
+        // forward VDE evaluation
+        model->expl_vde_for->evaluate(model->expl_vde_for, ext_fun_type_in, ext_fun_in,
+                                      ext_fun_type_out, ext_fun_out);
+    }
+    else
+    {  // simulation only
+        ext_fun_type_in[0] = COLMAJ;
+        ext_fun_in[0] = rhs_in + 0;  // x: nx
+        ext_fun_type_in[1] = COLMAJ;
+        ext_fun_in[1] = rhs_in + nx;  // u: nu
+        ext_fun_type_in[2] = COLMAJ;
+        ext_fun_in[2] = &t;  // t: 1
+
+        ext_fun_type_out[0] = COLMAJ;
+        ext_fun_out[0] = k_out + 0;  // fun: nx
+
+        if (model->expl_ode_fun == 0)
+        {
+            printf("sim ERK: expl_ode_fun is not provided. Exiting.\n");
+            exit(1);
+        }
+        model->expl_ode_fun->evaluate(model->expl_ode_fun, ext_fun_type_in, ext_fun_in,
+                                      ext_fun_type_out, ext_fun_out);  // ODE evaluation
+    }
+}
+
+
+
+// quadrature rhs at a stage, q_out = [f_q, df_q/dx * S + [0, df_q/du]] with the nf forward
+// sensitivities S of the stage (nf = 0 without sensitivities); rhs_in as in sim_erk_eval_rhs
+static void sim_erk_eval_quad(erk_model *model, int nx, int nu, int nq, int nf, double *rhs_in,
+                              double t, double *jac_out, double *q_out)
+{
+    ext_fun_arg_t ext_fun_type_in[4];
+    void *ext_fun_in[4];
+    ext_fun_arg_t ext_fun_type_out[4];
+    void *ext_fun_out[4];
+
+    double *u = rhs_in + nx + nx * nf;
+    double *jac_x = jac_out + nq;
+    double *jac_u = jac_out + nq + nq * nx;
+
+    int i, j, k;
+
+    if (model->quad_fun_jac == 0)
+    {
+        printf("sim ERK: quad_fun_jac is not provided. Exiting.\n");
+        exit(1);
+    }
+
+    ext_fun_type_in[0] = COLMAJ;
+    ext_fun_in[0] = rhs_in + 0;  // x: nx
+    ext_fun_type_in[1] = COLMAJ;
+    ext_fun_in[1] = u;  // u: nu
+    ext_fun_type_in[2] = COLMAJ;
+    ext_fun_in[2] = NULL;  // z: 0
+    ext_fun_type_in[3] = COLMAJ;
+    ext_fun_in[3] = &t;  // t: 1
+
+    ext_fun_type_out[0] = COLMAJ;
+    ext_fun_out[0] = jac_out;  // fun: nq
+    ext_fun_type_out[1] = COLMAJ;
+    ext_fun_out[1] = jac_x;  // jac_x: nq*nx
+    ext_fun_type_out[2] = COLMAJ;
+    ext_fun_out[2] = jac_u;  // jac_u: nq*nu
+    ext_fun_type_out[3] = COLMAJ;
+    ext_fun_out[3] = NULL;  // jac_z: 0
+
+    model->quad_fun_jac->evaluate(model->quad_fun_jac, ext_fun_type_in, ext_fun_in,
+                                  ext_fun_type_out, ext_fun_out);
+
+    for (i = 0; i < nq; i++)
+        q_out[i] = jac_out[i];
+
+    for (j = 0; j < nf; j++)
+    {
+        for (i = 0; i < nq; i++)
+        {
+            q_out[nq + i + j * nq] = j < nx ? 0.0 : jac_u[i + (j - nx) * nq];
+            for (k = 0; k < nx; k++)
+                q_out[nq + i + j * nq] += jac_x[i + k * nq] * rhs_in[nx + k + j * nx];
+        }
+    }
+}
+
+
+
+// num_steps fixed ERK steps from time t0 on forw = [x, S] in place, u has to be set in
+// rhs_in + nX; returns the time spent in the model functions
+static double sim_erk_forward_steps(erk_model *model, sim_opts *opts, bool sens_forw, int nx,
+                                    int nu, int nX, int num_steps, double t0, double step,
+                                    double *forw, double *rhs_in, double *K)
+{
+    int ns = opts->ns;
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+    double *c_vec = opts->c_vec;
+    double a, b;
+
+    acados_timer timer_ad;
+    double timing_ad = 0.0;
+
+    for (int istep = 0; istep < num_steps; istep++)
+    {
+        for (int s = 0; s < ns; s++)
+        {
+            for (int i = 0; i < nX; i++)
+                rhs_in[i] = forw[i];
+            for (int j = 0; j < s; j++)
+            {
+                a = A_mat[j * ns + s];
+                if (a != 0)
+                {
+                    a *= step;
+                    for (int i = 0; i < nX; i++)
+                        rhs_in[i] += a * K[j * nX + i];
+                }
+            }
+
+            acados_tic(&timer_ad);
+            sim_erk_eval_rhs(model, sens_forw, nx, nu, rhs_in,
+                             t0 + (istep + c_vec[s]) * step, K + s * nX);
+            timing_ad += acados_toc(&timer_ad);
+        }
+
+        for (int s = 0; s < ns; s++)
+        {
+            b = step * b_vec[s];
+            for (int i = 0; i < nX; i++)
+                forw[i] += b * K[s * nX + i];
+        }
+    }
+
+    return timing_ad;
+}
+
+
+
+// Integration on num_segments segments of num_steps/num_segments steps each (parareal-type).
+// The segment start states are initialized by a coarse sweep of one ERK step per segment.
+// Each fine sweep integrates all segments with their sensitivities in parallel; while the
+// defects phi_s(x_s) - x_{s+1} exceed segment_tol, the start states are corrected
+// sequentially along the linearization,
+//     x_{s+1} = phi_s(xh_s) + dphi_s/dx * (x_s - xh_s),
+// and the segments are integrated again. The first k start states are exact after k
+// corrections, so at most num_segments - 1 corrections are done. The result is the end of the
+// last fine sweep, its sensitivities are chained as S_{s+1} = dphi_s/dx * S_s + [0, dphi_s/du].
+// Note: nested in the OpenMP stage loop of ocp_nlp the segments run serially,
+// unless nested parallelism is enabled.
+static int sim_erk_segmented(sim_erk_dims *dims, sim_in *in, sim_out *out, sim_opts *opts,
+                             sim_erk_memory *mem, sim_erk_workspace *work)
+{
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nf = opts->num_forw_sens;
+    int nX = nx + nx * nf;
+    int ns = opts->ns;
+
+    int num_segments = opts->num_segments;
+    int seg_steps = opts->num_steps / num_segments;
+    double step = in->T / opts->num_steps;
+
+    erk_model *model = in->model;
+
+    double *seg_x = work->seg_x;
+    double *dx = work->seg_dx;
+    double *tmp = work->seg_dx + nx;
+    double *S_cur = work->seg_S;
+    double *S_next = work->seg_S + nx * nf;
+    double *S_swap;
+
+    int i, j, iseg, iter;
+    double *forw;
+    double defect, defect_tol;
+
+    int max_corr = opts->segment_iter < num_segments - 1 ? opts->segment_iter : num_segments - 1;
+
+    if (nf != nx + nu)
+    {
+        printf("\nerror: sim_erk: num_segments > 1 requires num_forw_sens = nx + nu\n");
+        exit(1);
+    }
+
+    acados_timer timer;
+    double timing_ad = 0.0;
+
+    // start timer
+    acados_tic(&timer);
+
+    // coarse sweep: one step per segment
+    for (i = 0; i < nx; i++)
+        seg_x[i] = in->x[i];
+    for (i = 0; i < nu; i++)
+        work->seg_rhs_forw_in[nx + i] = in->u[i];
+    for (iseg = 0; iseg < num_segments; iseg++)
+    {
+        forw = seg_x + (iseg + 1) * nx;
+        for (i = 0; i < nx; i++)
+            forw[i] = forw[i - nx];
+        timing_ad += sim_erk_forward_steps(model, opts, false, nx, nu, nx, 1,
+                                           in->t0 + iseg * seg_steps * step, seg_steps * step,
+                                           forw, work->seg_rhs_forw_in, work->seg_K);
+    }
+
+    for (iter = 0; ; iter++)
+    {
+        // fine sweep: segments from their start states with identity seed
+#if defined(ACADOS_WITH_OPENMP)
+        #pragma omp parallel for schedule(static)
+#endif
+        for (int jseg = 0; jseg < num_segments; jseg++)
+        {
+            double *seg_forw = work->seg_forw + jseg * nX;
+            double *seg_rhs_in = work->seg_rhs_forw_in + jseg * (nX + nu);
+
+            for (int ii = 0; ii < nx; ii++)
+                seg_forw[ii] = seg_x[jseg * nx + ii];
+            for (int ii = 0; ii < nx * nf; ii++)
+                seg_forw[nx + ii] = 0.0;
+            for (int ii = 0; ii < nx; ii++)
+                seg_forw[nx + ii * (nx + 1)] = 1.0;
+            for (int ii = 0; ii < nu; ii++)
+                seg_rhs_in[nX + ii] = in->u[ii];
+
+            work->seg_time_ad[jseg] = sim_erk_forward_steps(model, opts, true, nx, nu, nX,
+                    seg_steps, in->t0 + jseg * seg_steps * step, step, seg_forw, seg_rhs_in,
+                    work->seg_K + jseg * ns * nX);
+        }
+        for (iseg = 0; iseg < num_segments; iseg++)
+            timing_ad += work->seg_time_ad[iseg];
+
+        // defects at the segment boundaries
+        defect = 0.0;
+        defect_tol = 0.0;
+        for (iseg = 0; iseg < num_segments - 1; iseg++)
+        {
+            forw = work->seg_forw + iseg * nX;
+            for (i = 0; i < nx; i++)
+            {
+                defect = fmax(defect, fabs(forw[i] - seg_x[(iseg + 1) * nx + i]));
+                defect_tol = fmax(defect_tol, fabs(forw[i]));
+            }
+        }
+        if (defect <= opts->segment_tol * (1.0 + defect_tol) || iter >= max_corr)
+            break;
+
+        // sequential correction of the start states
+        for (i = 0; i < nx; i++)
+            dx[i] = 0.0;
+        for (iseg = 0; iseg < num_segments; iseg++)
+        {
+            forw = work->seg_forw + iseg * nX;
+            for (i = 0; i < nx; i++)
+            {
+                tmp[i] = forw[i];
+                for (j = 0; j < nx; j++)
+                    tmp[i] += forw[nx + i + j * nx] * dx[j];
+            }
+            for (i = 0; i < nx; i++)
+            {
+                dx[i] = tmp[i] - seg_x[(iseg + 1) * nx + i];
+                seg_x[(iseg + 1) * nx + i] = tmp[i];
+            }
+        }
+    }
+
+    // chain the segment sensitivities
+    if (in->identity_seed)
+    {
+        for (i = 0; i < nx * nf; i++)
+            S_cur[i] = 0.0;
+        for (i = 0; i < nx; i++)
+            S_cur[i * (nx + 1)] = 1.0;
+    }
+    else
+    {
+        for (i = 0; i < nx * nf; i++)
+            S_cur[i] = in->S_forw[i];
+    }
+    for (iseg = 0; iseg < num_segments; iseg++)
+    {
+        forw = work->seg_forw + iseg * nX;
+        for (int jj = 0; jj < nf; jj++)
+        {
+            for (i = 0; i < nx; i++)
+            {
+                S_next[i + jj * nx] = jj < nx ? 0.0 : forw[nx + i + jj * nx];
+                for (j = 0; j < nx; j++)
+                    S_next[i + jj * nx] += forw[nx + i + j * nx] * S_cur[j + jj * nx];
+            }
+        }
+        S_swap = S_cur;
+        S_cur = S_next;
+        S_next = S_swap;
+    }
+
+    // store trajectory: end of the last segment of the last fine sweep
+    forw = work->seg_forw + (num_segments - 1) * nX;
+    for (i = 0; i < nx; i++)
+        out->xn[i] = forw[i];
+    // store forward sensitivities
+    if (out->BAbt != NULL)
+    {
+        // transpose into [B'; A'] of the caller
+        blasfeo_pack_tran_dmat(nx, nu, S_cur + nx * nx, nx, out->BAbt, 0, 0);
+        blasfeo_pack_tran_dmat(nx, nx, S_cur, nx, out->BAbt, nu, 0);
+    }
+    else
+    {
+        for (i = 0; i < nx * nf; i++)
+            out->S_forw[i] = S_cur[i];
+    }
+    mem->num_steps_taken = opts->num_steps;
+
+    // store timings
+    out->info->CPUtime = acados_toc(&timer);
+    out->info->LAtime = 0.0;
+    out->info->lu_fact = 0;
+    out->info->newton_iter = 0;
+    out->info->ADtime = timing_ad;
+
+    mem->time_sim = out->info->CPUtime;
+    mem->time_ad = out->info->ADtime;
+    mem->time_la = out->info->LAtime;
+
+    return 0;
+}
+
+
+
 int sim_erk_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_,
                        void *work_)
 {
@@ -547,7 +1093,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         printf("Error in sim_erk: the Butcher tableau size does not match ns\n");
         exit(1);
     }
-    int ns = opts->ns;
+    int ns = sim_erk_num_stages(opts);
 
     void *dims_ = in->dims;
     sim_erk_dims *dims = (sim_erk_dims *) dims_;
@@ -583,6 +1129,21 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     int nhess = (nf + 1) * nf / 2;
     int nX = nx + nx * nf;
 
+    if (opts->num_segments > 1)
+    {
+        if (!opts->sens_forw || opts->sens_adj || opts->sens_hess)
+        {
+            printf("sim_erk: num_segments > 1 requires sens_forw and no adjoint or hessian sensitivities\n");
+            exit(1);
+        }
+        if (dims->nq > 0)
+        {
+            printf("sim_erk: num_segments > 1 does not support quadrature states\n");
+            exit(1);
+        }
+        return sim_erk_segmented(dims, in, out, opts, mem, work);
+    }
+
     double *x = in->x;
     double *u = in->u;
     double *S_forw_in = in->S_forw;
@@ -593,7 +1154,23 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
     double *A_mat = opts->A_mat;
     double *b_vec = opts->b_vec;
-    //    double *c_vec = opts->c_vec;
+    double *c_vec = opts->c_vec;
+    double *e_vec = NULL;
+    if (opts->step_size_adaptive)
+    {
+        get_dormand_prince_tableau(work->A_emb, work->b_emb, work->e_emb, work->c_emb);
+        A_mat = work->A_emb;
+        b_vec = work->b_emb;
+        c_vec = work->c_emb;
+        e_vec = work->e_emb;
+    }
+    double t_step = in->t0;
+    double t_stage;
+
+    int nq = dims->nq;
+    int nQ = nq * (1 + nf);
+    double *quad_K = work->quad_K;
+    double *quad_q = work->quad_q;
 
     double *K_traj = work->K_traj;
     double *forw_traj = work->out_forw_traj;
@@ -608,8 +1185,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     double *S_adj_out = out->S_adj;
     double *S_hess_out = out->S_hess;
 
-    ext_fun_arg_t ext_fun_type_in[5];
-    void *ext_fun_in[5];
+    ext_fun_arg_t ext_fun_type_in[6];
+    void *ext_fun_in[6];
     ext_fun_arg_t ext_fun_type_out[3];
     void *ext_fun_out[3];
 
@@ -629,9 +1206,29 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     for (i = 0; i < nx; i++) forw_traj[i] = x[i];  // x0
     if (opts->sens_forw)
     {
-        for (i = 0; i < nx * nf; i++) forw_traj[nx + i] = S_forw_in[i];  // sensitivities
+        if (in->identity_seed)
+        {
+            for (i = 0; i < nx * nf; i++) forw_traj[nx + i] = 0.0;
+            for (i = 0; i < nx; i++) forw_traj[nx + i * (nx + 1)] = 1.0;
+        }
+        else
+        {
+            for (i = 0; i < nx * nf; i++) forw_traj[nx + i] = S_forw_in[i];  // sensitivities
+        }
     }
     for (i = 0; i < nu; i++) rhs_forw_in[nX + i] = u[i];  // controls
+    for (i = 0; i < nQ; i++) quad_q[i] = 0.0;  // quadrature states and sensitivities
+
+    // adaptive step size
+    bool adaptive = opts->step_size_adaptive;
+    bool force_step = false;
+    bool step_accepted;
+    double t_left = in->T;
+    double err = 0.0;
+    double fac = 1.0;
+    int num_steps_taken = num_steps;
+    if (adaptive)
+        step = mem->step_size > 0.0 ? mem->step_size : in->T;
 
     for (istep = 0; istep < num_steps; istep++)
     {
@@ -643,78 +1240,95 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 forw_traj[i] = forw_traj[i - nX];
         }
 
-        for (s = 0; s < ns; s++)
+        if (adaptive)
+            step = sim_adaptive_step_size(step, t_left, num_steps - istep, &force_step);
+
+        step_accepted = false;
+        while (!step_accepted)
         {
-            for (i = 0; i < nX; i++)
-                rhs_forw_in[i] = forw_traj[i];
-            for (j = 0; j < s; j++)
+            for (s = 0; s < ns; s++)
             {
-                a = A_mat[j * ns + s];
-                if (a != 0)
+                for (i = 0; i < nX; i++)
+                    rhs_forw_in[i] = forw_traj[i];
+                for (j = 0; j < s; j++)
                 {
-                    a *= step;
-                    for (i = 0; i < nX; i++)
-                        rhs_forw_in[i] += a * K_traj[j * nX + i];
+                    a = A_mat[j * ns + s];
+                    if (a != 0)
+                    {
+                        a *= step;
+                        for (i = 0; i < nX; i++)
+                            rhs_forw_in[i] += a * K_traj[j * nX + i];
+                    }
                 }
-            }
 
-            acados_tic(&timer_ad);
-            if (opts->sens_forw)
-            {  // simulation + forward sensitivities
-                ext_fun_type_in[0] = COLMAJ;
-                ext_fun_in[0] = rhs_forw_in + 0;  // x: nx
-                ext_fun_type_in[1] = COLMAJ;
-                ext_fun_in[1] = rhs_forw_in + nx;  // Sx: nx*nx
-                ext_fun_type_in[2] = COLMAJ;
-                ext_fun_in[2] = rhs_forw_in + nx + nx * nx;  // Su: nx*nu
-                ext_fun_type_in[3] = COLMAJ;
-                ext_fun_in[3] = rhs_forw_in + nx + nx * nx + nx * nu;  // u: nu
-
-                ext_fun_type_out[0] = COLMAJ;
-                ext_fun_out[0] = K_traj + s * nX + 0;  // fun: nx
-                ext_fun_type_out[1] = COLMAJ;
-                ext_fun_out[1] = K_traj + s * nX + nx;  // Sx: nx*nx
-                ext_fun_type_out[2] = COLMAJ;
-                ext_fun_out[2] = K_traj + s * nX + nx + nx * nx;  // Su: nx*nu
-
-                // forward VDE evaluation
-                model->expl_vde_for->evaluate(model->expl_vde_for, ext_fun_type_in, ext_fun_in,
-                                              ext_fun_type_out, ext_fun_out);
+                t_stage = t_step + c_vec[s] * step;
+                acados_tic(&timer_ad);
+                sim_erk_eval_rhs(model, opts->sens_forw, nx, nu, rhs_forw_in, t_stage,
+                                 K_traj + s * nX);
+                if (nq > 0)
+                    sim_erk_eval_quad(model, nx, nu, nq, nf, rhs_forw_in, t_stage,
+                                      work->quad_out, quad_K + s * nQ);
+                timing_ad += acados_toc(&timer_ad);
             }
-            else
-            {  // simulation only
-                ext_fun_type_in[0] = COLMAJ;
-                ext_fun_in[0] = rhs_forw_in + 0;  // x: nx
-                ext_fun_type_in[1] = COLMAJ;
-                ext_fun_in[1] = rhs_forw_in + nx;  // u: nu
-
-                ext_fun_type_out[0] = COLMAJ;
-                ext_fun_out[0] = K_traj + s * nX + 0;  // fun: nx
 
-                if (model->expl_ode_fun == 0)
+            step_accepted = true;
+            if (adaptive)
+            {
+                err = sim_erk_error_norm(nx, ns, nX, step, b_vec, e_vec, forw_traj, K_traj,
+                                         opts->step_size_atol, opts->step_size_rtol);
+                fac = sim_adaptive_step_factor(err, opts->e_order);
+                if (err > 1.0 && !force_step)
                 {
-                    printf("sim ERK: expl_ode_fun is not provided. Exiting.\n");
-                    exit(1);
+                    // reject, retry with a smaller step
+                    step = sim_adaptive_step_size(fac * step, t_left, num_steps - istep, &force_step);
+                    step_accepted = false;
                 }
-                model->expl_ode_fun->evaluate(model->expl_ode_fun, ext_fun_type_in, ext_fun_in,
-                                              ext_fun_type_out, ext_fun_out);  // ODE evaluation
             }
-            timing_ad += acados_toc(&timer_ad);
         }
+
         for (s = 0; s < ns; s++)
         {
             b = step * b_vec[s];
             for (i = 0; i < nX; i++) forw_traj[i] += b * K_traj[s * nX + i];  // ERK step
+            for (i = 0; i < nQ; i++) quad_q[i] += b * quad_K[s * nQ + i];
+        }
+        t_step += step;
+
+        if (adaptive)
+        {
+            work->step_traj[istep] = step;
+            t_left -= step;
+            if (istep == 0 || t_left > 0.0)
+                mem->step_size = fac * step;
+            step *= fac;
+            if (t_left <= 0.0)
+            {
+                num_steps_taken = istep + 1;
+                break;
+            }
         }
     }
+    mem->num_steps_taken = num_steps_taken;
 
     // store trajectory
     for (i = 0; i < nx; i++) xn[i] = forw_traj[i];
     // store forward sensitivities
     if (opts->sens_forw)
     {
-        for (i = 0; i < nx * nf; i++) S_forw_out[i] = forw_traj[nx + i];
+        if (out->BAbt != NULL)
+        {
+            // transpose into [B'; A'] of the caller
+            blasfeo_pack_tran_dmat(nx, nu, forw_traj + nx + nx * nx, nx, out->BAbt, 0, 0);
+            blasfeo_pack_tran_dmat(nx, nx, forw_traj + nx, nx, out->BAbt, nu, 0);
+        }
+        else
+        {
+            for (i = 0; i < nx * nf; i++) S_forw_out[i] = forw_traj[nx + i];
+        }
     }
+    // store quadrature states and their forward sensitivities
+    for (i = 0; i < nq; i++) out->qn[i] = quad_q[i];
+    for (i = 0; i < nq * nf; i++) out->S_q[i] = quad_q[nq + i];
 
     /************************************************
      * adjoint sweep
@@ -743,11 +1357,14 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         for (i = 0; i < nu; i++)
             rhs_adj_in[nForw + nx + i] = u[i];
 
-        for (istep = num_steps - 1; istep >= 0; istep--)
+        for (istep = num_steps_taken - 1; istep >= 0; istep--)
         {
 
             K_traj = work->K_traj + istep * ns * nX;
             forw_traj = work->out_forw_traj + istep*nX;
+            if (adaptive)
+                step = work->step_traj[istep];
+            t_step -= step;
 
             for (s = ns - 1; s >= 0; s--)
             {
@@ -785,6 +1402,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 }
 
                 // TODO(oj): fix this whole file or write from scratch, not really readable :/
+                t_stage = t_step + c_vec[s] * step;
                 acados_tic(&timer_ad);
                 if (!opts->sens_hess)
                 {
@@ -802,6 +1420,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     ext_fun_in[1] = rhs_adj_in + nx;  // lam: nx
                     ext_fun_type_in[2] = COLMAJ;
                     ext_fun_in[2] = rhs_adj_in + nx + nx;  // u: nu
+                    ext_fun_type_in[3] = COLMAJ;
+                    ext_fun_in[3] = &t_stage;  // t: 1
 
                     ext_fun_type_out[0] = COLMAJ;
                     ext_fun_out[0] = adj_traj + s * nAdj + 0;  // adj: nx+nu
@@ -829,6 +1449,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     ext_fun_in[3] = rhs_adj_in + nx + nx * nx + nx * nu;  // lam: nx
                     ext_fun_type_in[4] = COLMAJ;
                     ext_fun_in[4] = rhs_adj_in + nx + nx * nx + nx * nu + nx;  // u: nu
+                    ext_fun_type_in[5] = COLMAJ;
+                    ext_fun_in[5] = &t_stage;  // t: 1
 
                     ext_fun_type_out[0] = COLMAJ;
                     ext_fun_out[0] = adj_traj + s * nAdj + 0;  // adj: nx+nu
@@ -884,6 +1506,8 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // store timings
     out->info->CPUtime = acados_toc(&timer);
     out->info->LAtime = 0.0;
+    out->info->lu_fact = 0;
+    out->info->newton_iter = 0;
     out->info->ADtime = timing_ad;
 
     mem->time_sim = out->info->CPUtime;
@@ -46,6 +46,7 @@ typedef struct
     int nx;
     int nu;
     int nz;
+    int nq;  // number of quadrature states
 } sim_erk_dims;
 
 
@@ -61,6 +62,8 @@ typedef struct
     external_function_generic *expl_vde_for;
     // adjoint explicit vde
     external_function_generic *expl_vde_adj;
+    // quadrature right hand side and jacobians wrt x, u, z (only if nq > 0)
+    external_function_generic *quad_fun_jac;
 
 } erk_model;
 
@@ -73,6 +76,10 @@ typedef struct
 	double time_ad;
 	double time_la;
 
+	// adaptive step size
+	double step_size;     // proposal for the first step of the next call, 0 if none
+	int num_steps_taken;  // number of accepted steps of the last call
+
 	// workspace structs
 } sim_erk_memory;
 
@@ -90,6 +97,26 @@ typedef struct
     double *out_adj_tmp;
     double *adj_traj;
 
+    double *step_traj;  // accepted step sizes (adaptive step size only)
+    double *A_emb;      // embedded Dormand-Prince tableau (adaptive step size only)
+    double *b_emb;
+    double *c_emb;
+    double *e_emb;
+
+    // segmented integration (num_segments > 1 only)
+    double *seg_x;            // (num_segments+1)*nx segment start states
+    double *seg_dx;           // 2*nx correction and temporary
+    double *seg_forw;         // num_segments*nX segment end states and sensitivities
+    double *seg_rhs_forw_in;  // num_segments*(nX+nu)
+    double *seg_K;            // num_segments*ns*nX
+    double *seg_S;            // 2*nx*nf chained sensitivities
+    double *seg_time_ad;      // num_segments
+
+    // quadrature states (nq > 0 only)
+    double *quad_K;    // ns*nq*(1+nf) stage values of the quadrature rhs and its sensitivities
+    double *quad_q;    // nq*(1+nf) accumulated quadrature states and sensitivities
+    double *quad_out;  // nq*(1+nx+nu) output of quad_fun_jac
+
 } sim_erk_workspace;
 
 
@@ -155,6 +155,11 @@ void sim_gnsf_dims_get(void *config_, void *dims_, const char *field, int *value
     {
         *value = dims->n_out;
     }
+    else if (!strcmp(field, "nq"))
+    {
+        // quadrature states are not supported
+        *value = 0;
+    }
     else
     {
         printf("\nerror: sim_gnsf_dims_get: field not available: %s\n", field);
@@ -449,6 +454,8 @@ void *sim_gnsf_model_assign(void *config, void *dims_, void *raw_memory)
 
     // set default
     model->auto_import_gnsf = true;
+    model->phi_hess = NULL;
+    model->f_lo_hess = NULL;
 
     // assign model matrices
     assign_and_advance_double((nx1 + nz1) * nx1, &model->A, &c_ptr);
@@ -506,6 +513,14 @@ int sim_gnsf_model_set(void *model_, const char *field, void *value)
     {
         model->f_lo_fun_jac_x1_x1dot_u_z = value;
     }
+    else if (!strcmp(field, "phi_hess") || !strcmp(field, "gnsf_phi_hess"))
+    {
+        model->phi_hess = value;
+    }
+    else if (!strcmp(field, "f_lo_hess") || !strcmp(field, "gnsf_f_lo_hess"))
+    {
+        model->f_lo_hess = value;
+    }
     else if (!strcmp(field, "get_gnsf_matrices") || !strcmp(field, "gnsf_get_matrices_fun"))
     {
         model->get_gnsf_matrices = value;
@@ -1619,6 +1634,9 @@ acados_size_t sim_gnsf_workspace_calculate_size(void *config, void *dims_, void
     size += blasfeo_memsize_dvec(nuhat);  // uhat
     size += blasfeo_memsize_dvec(nz);  // z0;
 
+    if (opts->sens_hess)
+        size += blasfeo_memsize_dvec(nK2);  // lambda_K2
+
     // if (opts->sens_algebraic){
     //     size += blasfeo_memsize_dvec(nx1);  // x0dot_1;
     //     size += blasfeo_memsize_dvec(ny);  // y_one_stage
@@ -1659,6 +1677,23 @@ acados_size_t sim_gnsf_workspace_calculate_size(void *config, void *dims_, void
     size += blasfeo_memsize_dmat(nvv, ny + nuhat);  // dPHI_dyuhat
     size += blasfeo_memsize_dmat(nz, nx + nu);  // S_algebraic_aux
 
+    if (opts->sens_hess)
+    {
+        int nyu = ny + nuhat;
+        int nf_lo = 2 * nx1 + nu + nz1;
+        int n_tmp = nyu > nf_lo ? nyu : nf_lo;
+        size += blasfeo_memsize_dmat(num_steps * nx1, nx + nu);  // S_forw_x1_traj
+        size += blasfeo_memsize_dmat(nvv, nx1 + nu);             // dvv_dx1u
+        size += blasfeo_memsize_dmat(nyu, nx1 + nu);             // jac_yuhat
+        size += blasfeo_memsize_dmat(nf_lo, nx1 + nu);           // jac_f_lo
+        size += blasfeo_memsize_dmat(nyu, nyu);                  // phi_hess_val
+        size += blasfeo_memsize_dmat(nf_lo, nf_lo);              // f_lo_hess_val
+        size += blasfeo_memsize_dmat(n_tmp, nx + nu);            // hess_tmp
+        size += blasfeo_memsize_dmat(nx1 + nu, nx1 + nu);        // hess_step
+        size += blasfeo_memsize_dmat(nx1 + nu, nx + nu);         // S_aug
+        size += blasfeo_memsize_dmat(nx + nu, nx + nu);          // Hess
+    }
+
     make_int_multiple_of(8, &size);
     size += 1 * 8;
 
@@ -1742,6 +1777,9 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nuhat, &workspace->uhat, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nz, &workspace->z0, &c_ptr);
 
+    if (opts->sens_hess)
+        assign_and_advance_blasfeo_dvec_mem(nK2, &workspace->lambda_K2, &c_ptr);
+
     // if (opts->sens_algebraic){
         // assign_and_advance_blasfeo_dvec_mem(ny, &workspace->y_one_stage, &c_ptr);
     //     assign_and_advance_blasfeo_dvec_mem(nx1, &workspace->x0dot_1, &c_ptr);
@@ -1789,6 +1827,24 @@ static void *sim_gnsf_cast_workspace(void *config, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dmat_mem(nx, nu, &workspace->dPsi_du, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nz, nx + nu, &workspace->S_algebraic_aux, &c_ptr);
 
+    if (opts->sens_hess)
+    {
+        int nyu = ny + nuhat;
+        int nf_lo = 2 * nx1 + nu + nz1;
+        int n_tmp = nyu > nf_lo ? nyu : nf_lo;
+        assign_and_advance_blasfeo_dmat_mem(num_steps * nx1, nx + nu, &workspace->S_forw_x1_traj,
+                                            &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nvv, nx1 + nu, &workspace->dvv_dx1u, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nyu, nx1 + nu, &workspace->jac_yuhat, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nf_lo, nx1 + nu, &workspace->jac_f_lo, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nyu, nyu, &workspace->phi_hess_val, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nf_lo, nf_lo, &workspace->f_lo_hess_val, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(n_tmp, nx + nu, &workspace->hess_tmp, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx1 + nu, nx1 + nu, &workspace->hess_step, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx1 + nu, nx + nu, &workspace->S_aug, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx + nu, nx + nu, &workspace->Hess, &c_ptr);
+    }
+
     assert((char *) raw_memory + sim_gnsf_workspace_calculate_size(config, dims_, opts) >= c_ptr);
 
     return (void *) workspace;
@@ -1819,6 +1875,11 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         printf("Error in sim_gnsf: option exact_z_output = true not supported.");
         exit(1);
     }
+    if (opts->sens_hess && !opts->sens_forw)
+    {
+        printf("Error in sim_gnsf: sens_hess requires sens_forw.");
+        exit(1);
+    }
 
     // necessary integers
     int nx      = dims->nx;
@@ -1904,6 +1965,22 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     struct blasfeo_dvec *uhat = &workspace->uhat;
     struct blasfeo_dvec *z0 = &workspace->z0;
 
+    // only available if (opts->sens_hess)
+    struct blasfeo_dvec *lambda_K2 = &workspace->lambda_K2;
+    struct blasfeo_dmat *S_forw_x1_traj = &workspace->S_forw_x1_traj;
+    struct blasfeo_dmat *dvv_dx1u = &workspace->dvv_dx1u;
+    struct blasfeo_dmat *jac_yuhat = &workspace->jac_yuhat;
+    struct blasfeo_dmat *jac_f_lo = &workspace->jac_f_lo;
+    struct blasfeo_dmat *phi_hess_val = &workspace->phi_hess_val;
+    struct blasfeo_dmat *f_lo_hess_val = &workspace->f_lo_hess_val;
+    struct blasfeo_dmat *hess_tmp = &workspace->hess_tmp;
+    struct blasfeo_dmat *hess_step = &workspace->hess_step;
+    struct blasfeo_dmat *S_aug = &workspace->S_aug;
+    struct blasfeo_dmat *Hess = &workspace->Hess;
+
+    int nyu = ny + nuhat;
+    int nf_lo = 2 * nx1 + nu + nz1;
+
     int *ipiv_x = model->ipiv_x;
     int *ipiv_z = model->ipiv_z;
 
@@ -1917,6 +1994,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     // memory - precomputed matrices
     double *A_dt = mem->A_dt;
     double *b_dt = mem->b_dt;
+    double dt = mem->dt;
 
     int *ipivM2 = mem->ipivM2;
 
@@ -1980,6 +2058,24 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     blasfeo_dvecpe(nx, ipiv_x, lambda, 0);
     blasfeo_dvecpe(nx, ipiv_x, lambda_old, 0);
 
+    if (opts->sens_hess)
+    {
+        // zero for fully linear models
+        blasfeo_dgese(nx + nu, nx + nu, 0.0, Hess, 0, 0);
+        if (n_out > 0 && model->phi_hess == NULL)
+        {
+            printf("Error in sim_gnsf: sens_hess requires phi_hess.");
+            exit(1);
+        }
+        if (model->nontrivial_f_LO && model->f_lo_hess == NULL)
+        {
+            printf("Error in sim_gnsf: sens_hess requires f_lo_hess.");
+            exit(1);
+        }
+    }
+
+    out->info->lu_fact = 0;
+    out->info->newton_iter = 0;
 
     if (model->fully_linear && !mem->first_call)
     {
@@ -2024,10 +2120,19 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     }
     else
     {
-        // pack seed into S_forw, permute
-        blasfeo_pack_dmat(nx, nx + nu, &in->S_forw[0], nx, S_forw, 0, 0);
-        blasfeo_drowpe(nx, ipiv_x, S_forw);
-        blasfeo_dcolpe(nx, ipiv_x, S_forw);
+        if (in->identity_seed)
+        {
+            // identity is invariant under the permutation
+            blasfeo_dgese(nx, nx + nu, 0.0, S_forw, 0, 0);
+            blasfeo_ddiare(nx, 1.0, S_forw, 0, 0);
+        }
+        else
+        {
+            // pack seed into S_forw, permute
+            blasfeo_pack_dmat(nx, nx + nu, &in->S_forw[0], nx, S_forw, 0, 0);
+            blasfeo_drowpe(nx, ipiv_x, S_forw);
+            blasfeo_dcolpe(nx, ipiv_x, S_forw);
+        }
 
         // initialize vv for first step, for further steps initialize with last vv value in step loop
         for (int i = 0; i < num_stages; i++)
@@ -2041,9 +2146,12 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
          * Set up function input & outputs
          ************************************************/
 
+        // time at the current stage, passed as trailing input to all model functions
+        double t_current = in->t0;
+
         /* PHI - NONLINEARITY FUNCTION */
-        ext_fun_arg_t phi_type_in[2];
-        void *phi_in[2];
+        ext_fun_arg_t phi_type_in[3];
+        void *phi_in[3];
 
         ext_fun_arg_t phi_fun_type_out[1];
         void *phi_fun_out[1];
@@ -2065,6 +2173,8 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         phi_type_in[1] = BLASFEO_DVEC;
         phi_in[0] = &y_in;
         phi_in[1] = uhat;
+        phi_type_in[2] = COLMAJ;
+        phi_in[2] = &t_current;
 
         // set output for phi_fun
         phi_fun_type_out[0] = BLASFEO_DVEC_ARGS;
@@ -2090,8 +2200,8 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         phi_jac_yuhat_out[1] = &phi_jac_uhat_arg;
 
         /* f_lo - LINEAR OUTPUT FUNCTION */
-        ext_fun_arg_t f_lo_fun_type_in[4];
-        void *f_lo_fun_in[4];
+        ext_fun_arg_t f_lo_fun_type_in[5];
+        void *f_lo_fun_in[5];
         ext_fun_arg_t f_lo_fun_type_out[2];
         void *f_lo_fun_out[2];
 
@@ -2111,6 +2221,9 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         f_lo_fun_in[2] = &f_lo_in_z1;
         // f_lo_in[3]: u;
         f_lo_fun_in[3] = u0;
+        // f_lo_in[4]: t;
+        f_lo_fun_type_in[4] = COLMAJ;
+        f_lo_fun_in[4] = &t_current;
 
         // output
         f_lo_fun_type_out[0] = BLASFEO_DVEC_ARGS;
@@ -2123,6 +2236,46 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
         f_lo_fun_out[1] = &f_lo_jac_out;
         f_lo_jac_out.aj = 0;
 
+        /* HESSIANS - only used if (opts->sens_hess) */
+        ext_fun_arg_t phi_hess_type_in[4];
+        void *phi_hess_in[4];
+        ext_fun_arg_t phi_hess_type_out[1];
+        void *phi_hess_out[1];
+
+        struct blasfeo_dvec_args phi_hess_mult;
+        phi_hess_mult.x = res_val;
+
+        phi_hess_type_in[0] = BLASFEO_DVEC_ARGS;
+        phi_hess_in[0] = &y_in;
+        phi_hess_type_in[1] = BLASFEO_DVEC;
+        phi_hess_in[1] = uhat;
+        phi_hess_type_in[2] = BLASFEO_DVEC_ARGS;
+        phi_hess_in[2] = &phi_hess_mult;
+        phi_hess_type_in[3] = COLMAJ;
+        phi_hess_in[3] = &t_current;
+        phi_hess_type_out[0] = BLASFEO_DMAT;
+        phi_hess_out[0] = phi_hess_val;
+
+        ext_fun_arg_t f_lo_hess_type_in[6];
+        void *f_lo_hess_in[6];
+        ext_fun_arg_t f_lo_hess_type_out[1];
+        void *f_lo_hess_out[1];
+
+        struct blasfeo_dvec_args f_lo_hess_mult;
+        f_lo_hess_mult.x = lambda_K2;
+
+        for (int ii = 0; ii < 4; ii++)
+        {
+            f_lo_hess_type_in[ii] = f_lo_fun_type_in[ii];
+            f_lo_hess_in[ii] = f_lo_fun_in[ii];
+        }
+        f_lo_hess_type_in[4] = BLASFEO_DVEC_ARGS;
+        f_lo_hess_in[4] = &f_lo_hess_mult;
+        f_lo_hess_type_in[5] = COLMAJ;
+        f_lo_hess_in[5] = &t_current;
+        f_lo_hess_type_out[0] = BLASFEO_DMAT;
+        f_lo_hess_out[0] = f_lo_hess_val;
+
         /* TIMINGS */
         out->info->ADtime = 0;
         out->info->LAtime = 0;
@@ -2154,6 +2307,10 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
             if (ss > 0)
                 blasfeo_dveccp(nvv, &vv_traj[ss-1], 0, &vv_traj[ss], 0);
 
+            // x1 rows of the sensitivities w.r.t. the initial value, for the hessian
+            if (opts->sens_hess)
+                blasfeo_dgecp(nx1, nx + nu, S_forw, 0, 0, S_forw_x1_traj, ss * nx1, 0);
+
             if (nx1 > 0 || nz1 > 0)
             {
                 // yyss = YY0 + YYu * u + YYx * x0(at_stage)
@@ -2162,6 +2319,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                 y_in.x = &yy_traj[ss];
                 for (int iter = 0; iter < newton_iter; iter++)
                 {  // NEWTON-ITERATION
+                    out->info->newton_iter++;
                     /* EVALUATE RESIDUAL FUNCTION & JACOBIAN */
 
                     blasfeo_dgemv_n(nyy, nvv, 1.0, YYv, 0, 0, &vv_traj[ss], 0, 1.0, yyss, nyy * ss,
@@ -2183,6 +2341,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         y_in.xi = ii * ny;
                         phi_fun_val_arg.xi = ii * n_out;
                         phi_jac_y_arg.ai = ii * n_out;
+                        t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
                         if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
                         {
                             // evaluate
@@ -2217,6 +2376,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     if ((opts->jac_reuse && (ss == 0) & (iter == 0)) || (!opts->jac_reuse))
                     {
                         blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0, ipiv);
+                        out->info->lu_fact++;
                     }
 
                     /* Solve linear system and update vv */
@@ -2286,6 +2446,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
 
                         f_lo_val_out.xi = ii * nxz2;
                         f_lo_jac_out.ai = ii * nxz2;
+                        t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
 
                         acados_tic(&casadi_timer);
                         model->f_lo_fun_jac_x1_x1dot_u_z->evaluate(model->f_lo_fun_jac_x1_x1dot_u_z,
@@ -2344,6 +2505,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         y_in.xi = ii * ny;                 // set input of phi
                         phi_jac_uhat_arg.ai = ii * n_out;  // set output
                         phi_jac_y_arg.ai = ii * n_out;
+                        t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
 
                         acados_tic(&casadi_timer);
                         model->phi_jac_y_uhat->evaluate(model->phi_jac_y_uhat, phi_type_in, phi_in,
@@ -2367,6 +2529,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     acados_tic(&la_timer);
                     blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
                                             ipiv);        // factorize J_r_vv
+                    out->info->lu_fact++;
                     // printf("dPHI_dyuhat = (forward, ss = %d) \n", ss);
                     // blasfeo_print_exp_dmat(nvv, ny+nuhat, dPHI_dyuhat, 0, 0);
 
@@ -2779,7 +2942,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
      * ADJOINT SENSITIVITY PROPAGATION
      ************************************************/
 
-        if (opts->sens_adj)
+        if (opts->sens_adj || opts->sens_hess)
         {
             for (int ss = num_steps - 1; ss >= 0; ss--)
             {
@@ -2826,6 +2989,11 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     blasfeo_dtrsm_lunn(nK2, nu, 1.0, M2_LU, 0, 0, dK2_du, 0, 0, dK2_du, 0, 0);
                     out->info->LAtime += acados_toc(&la_timer);
                 }
+                else
+                {
+                    // K2 does not depend on vv
+                    blasfeo_dgese(nK2, nvv, 0.0, dK2_dvv, 0, 0);
+                }
 
 
                 /*  SOLVE LINEAR SYSTEMS  */
@@ -2876,6 +3044,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                         y_in.xi = ii * ny;  // set input of phi
                         phi_jac_uhat_arg.ai = ii * n_out;
                         phi_jac_y_arg.ai = ii * n_out;
+                        t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
 
                         acados_tic(&casadi_timer);
                         model->phi_jac_y_uhat->evaluate(model->phi_jac_y_uhat, phi_type_in, phi_in,
@@ -2900,6 +3069,7 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     acados_tic(&la_timer);
                     blasfeo_dgetrf_rp(nvv, nvv, J_r_vv, 0, 0, J_r_vv, 0, 0,
                                             ipiv);  // factorize J_r_vv
+                    out->info->lu_fact++;
                     out->info->LAtime += acados_toc(&la_timer);
 
                     blasfeo_dgemv_t(nx, nvv, 1.0, dPsi_dvv, 0, 0, lambda, 0, 0.0, res_val, 0, res_val,
@@ -2911,6 +3081,152 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
                     out->info->LAtime += acados_toc(&la_timer);
                 }
 
+                /*  HESSIAN PROPAGATION  */
+                if (opts->sens_hess)
+                {
+                    // second order adjoint of the step w.r.t. (x1, u), where only phi and f_LO
+                    // contribute, with res_val = J_r_vv' \ (dPsi_dvv' * lambda)
+                    // hess_step = sum_i jac_yuhat_i' * hess(res_val_i' * phi_i) * jac_yuhat_i
+                    //           + sum_i jac_f_lo_i' * hess(lambda_K2_i' * f_LO_i) * jac_f_lo_i
+                    blasfeo_dgese(nx1 + nu, nx1 + nu, 0.0, hess_step, 0, 0);
+
+                    if (nx1 > 0 || nz1 > 0)
+                    {
+                        // dvv_dx1u = J_r_vv \ J_r_x1u = - dvv / d(x1, u)
+                        blasfeo_dgecp(nvv, nx1 + nu, J_r_x1u, 0, 0, dvv_dx1u, 0, 0);
+                        acados_tic(&la_timer);
+                        blasfeo_drowpe(nvv, ipiv, dvv_dx1u);
+                        blasfeo_dtrsm_llnu(nvv, nx1 + nu, 1.0, J_r_vv, 0, 0, dvv_dx1u, 0, 0,
+                                           dvv_dx1u, 0, 0);
+                        blasfeo_dtrsm_lunn(nvv, nx1 + nu, 1.0, J_r_vv, 0, 0, dvv_dx1u, 0, 0,
+                                           dvv_dx1u, 0, 0);
+                        out->info->LAtime += acados_toc(&la_timer);
+
+                        // sensitivities of K1, Z1 as in the forward sweep
+                        blasfeo_dgemm_nn(nK1, nx1, nvv, -1.0, KKv, 0, 0, dvv_dx1u, 0, 0, 1.0, KKx, 0, 0,
+                                        dK1_dx1, 0, 0);
+                        blasfeo_dgemm_nn(nK1, nu, nvv, -1.0, KKv, 0, 0, dvv_dx1u, 0, nx1, 1.0, KKu, 0, 0,
+                                        dK1_du, 0, 0);
+                        blasfeo_dgemm_nn(nZ1, nx1, nvv, -1.0, ZZv, 0, 0, dvv_dx1u, 0, 0, 1.0, ZZx, 0, 0,
+                                        dZ_dx1, 0, 0);
+                        blasfeo_dgemm_nn(nZ1, nu, nvv, -1.0, ZZv, 0, 0, dvv_dx1u, 0, nx1, 1.0, ZZu, 0, 0,
+                                        dZ_du, 0, 0);
+
+                        for (int ii = 0; ii < num_stages && n_out > 0; ii++)
+                        {
+                            // jac_yuhat = [YYx_i - YYv_i * dvv_dx1u_x, YYu_i - YYv_i * dvv_dx1u_u;
+                            //              0,                          Lu]
+                            blasfeo_dgecp(ny, nx1, YYx, ii * ny, 0, jac_yuhat, 0, 0);
+                            blasfeo_dgecp(ny, nu, YYu, ii * ny, 0, jac_yuhat, 0, nx1);
+                            blasfeo_dgemm_nn(ny, nx1 + nu, nvv, -1.0, YYv, ii * ny, 0, dvv_dx1u, 0, 0,
+                                            1.0, jac_yuhat, 0, 0, jac_yuhat, 0, 0);
+                            blasfeo_dgese(nuhat, nx1, 0.0, jac_yuhat, ny, 0);
+                            blasfeo_dgecp(nuhat, nu, Lu, 0, 0, jac_yuhat, ny, nx1);
+
+                            y_in.xi = ii * ny;
+                            phi_hess_mult.xi = ii * n_out;
+                            t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
+
+                            acados_tic(&casadi_timer);
+                            model->phi_hess->evaluate(model->phi_hess, phi_hess_type_in, phi_hess_in,
+                                                      phi_hess_type_out, phi_hess_out);
+                            out->info->ADtime += acados_toc(&casadi_timer);
+
+                            blasfeo_dgemm_nn(nyu, nx1 + nu, nyu, 1.0, phi_hess_val, 0, 0, jac_yuhat, 0, 0,
+                                            0.0, hess_tmp, 0, 0, hess_tmp, 0, 0);
+                            blasfeo_dsyrk_ut(nx1 + nu, nyu, 1.0, jac_yuhat, 0, 0, hess_tmp, 0, 0, 1.0,
+                                            hess_step, 0, 0, hess_step, 0, 0);
+                        }
+                    }
+
+                    if (model->nontrivial_f_LO && nxz2 > 0)
+                    {
+                        // multipliers of the linear output system: M2' \ (dxf_dK2' * lambda)
+                        blasfeo_dvecse(nK2, 0.0, lambda_K2, 0);
+                        for (int ii = 0; ii < num_stages; ii++)
+                            blasfeo_daxpy(nx2, b_dt[ii], lambda, nx1, lambda_K2, ii * nxz2, lambda_K2,
+                                          ii * nxz2);
+                        acados_tic(&la_timer);
+                        blasfeo_dtrsv_utn(nK2, M2_LU, 0, 0, lambda_K2, 0, lambda_K2, 0);
+                        blasfeo_dtrsv_ltu(nK2, M2_LU, 0, 0, lambda_K2, 0, lambda_K2, 0);
+                        blasfeo_dvecpei(nK2, ipivM2, lambda_K2, 0);
+                        out->info->LAtime += acados_toc(&la_timer);
+
+                        // stage values of step ss, as in the forward sweep
+                        if (nx1 > 0 || nz1 > 0)
+                        {
+                            blasfeo_dgemv_n(nK1, nvv, 1.0, KKv, 0, 0, &vv_traj[ss], 0, 1.0, K1u, 0,
+                                            K1_val, 0);
+                            blasfeo_dgemv_n(nK1, nx1, 1.0, KKx, 0, 0, x0_traj, ss * nx, 1.0, K1_val, 0,
+                                            K1_val, 0);
+                            if (nz1)
+                            {
+                                blasfeo_dgemv_n(nZ1, nvv, 1.0, ZZv, 0, 0, &vv_traj[ss], 0, 1.0, Zu, 0,
+                                                Z1_val, 0);
+                                blasfeo_dgemv_n(nZ1, nx1, 1.0, ZZx, 0, 0, x0_traj, ss * nx, 1.0, Z1_val,
+                                                0, Z1_val, 0);
+                            }
+                            for (int ii = 0; ii < num_stages; ii++)
+                            {
+                                blasfeo_dveccp(nx1, x0_traj, ss * nx, x1_stage_val, nx1 * ii);
+                                for (int jj = 0; jj < num_stages; jj++)
+                                {
+                                    blasfeo_daxpy(nx1, A_dt[ii + num_stages * jj], K1_val, nx1 * jj,
+                                                x1_stage_val, nx1 * ii, x1_stage_val, nx1 * ii);
+                                }
+                            }
+                        }
+                        f_lo_in_x1.x = x1_stage_val;
+                        f_lo_in_k1.x = K1_val;
+                        f_lo_in_z1.x = Z1_val;
+
+                        for (int ii = 0; ii < num_stages; ii++)
+                        {
+                            // jac_f_lo = d(x1_i, k1_i, u, z1_i) / d(x1, u)
+                            blasfeo_dgese(nf_lo, nx1 + nu, 0.0, jac_f_lo, 0, 0);
+                            blasfeo_ddiare(nx1, 1.0, jac_f_lo, 0, 0);
+                            for (int jj = 0; jj < num_stages; jj++)
+                            {
+                                blasfeo_dgead(nx1, nx1, A_dt[ii + num_stages * jj], dK1_dx1, jj * nx1, 0,
+                                            jac_f_lo, 0, 0);
+                                blasfeo_dgead(nx1, nu, A_dt[ii + num_stages * jj], dK1_du, jj * nx1, 0,
+                                            jac_f_lo, 0, nx1);
+                            }
+                            blasfeo_dgecp(nx1, nx1, dK1_dx1, ii * nx1, 0, jac_f_lo, nx1, 0);
+                            blasfeo_dgecp(nx1, nu, dK1_du, ii * nx1, 0, jac_f_lo, nx1, nx1);
+                            blasfeo_ddiare(nu, 1.0, jac_f_lo, 2 * nx1, nx1);
+                            blasfeo_dgecp(nz1, nx1, dZ_dx1, ii * nz1, 0, jac_f_lo, 2 * nx1 + nu, 0);
+                            blasfeo_dgecp(nz1, nu, dZ_du, ii * nz1, 0, jac_f_lo, 2 * nx1 + nu, nx1);
+
+                            f_lo_in_x1.xi = ii * nx1;
+                            f_lo_in_k1.xi = ii * nx1;
+                            f_lo_in_z1.xi = ii * nz1;
+                            f_lo_hess_mult.xi = ii * nxz2;
+                            t_current = in->t0 + (ss + opts->c_vec[ii]) * dt;
+
+                            acados_tic(&casadi_timer);
+                            model->f_lo_hess->evaluate(model->f_lo_hess, f_lo_hess_type_in, f_lo_hess_in,
+                                                       f_lo_hess_type_out, f_lo_hess_out);
+                            out->info->ADtime += acados_toc(&casadi_timer);
+
+                            blasfeo_dgemm_nn(nf_lo, nx1 + nu, nf_lo, 1.0, f_lo_hess_val, 0, 0, jac_f_lo,
+                                            0, 0, 0.0, hess_tmp, 0, 0, hess_tmp, 0, 0);
+                            blasfeo_dsyrk_ut(nx1 + nu, nf_lo, 1.0, jac_f_lo, 0, 0, hess_tmp, 0, 0, 1.0,
+                                            hess_step, 0, 0, hess_step, 0, 0);
+                        }
+                    }
+
+                    // Hess += S_aug' * hess_step * S_aug, with S_aug = [S_forw_x1(ss); 0, I]
+                    blasfeo_dtrtr_u(nx1 + nu, hess_step, 0, 0, hess_step, 0, 0);
+                    blasfeo_dgecp(nx1, nx + nu, S_forw_x1_traj, ss * nx1, 0, S_aug, 0, 0);
+                    blasfeo_dgese(nu, nx + nu, 0.0, S_aug, nx1, 0);
+                    blasfeo_ddiare(nu, 1.0, S_aug, nx1, nx);
+                    blasfeo_dgemm_nn(nx1 + nu, nx + nu, nx1 + nu, 1.0, hess_step, 0, 0, S_aug, 0, 0,
+                                    0.0, hess_tmp, 0, 0, hess_tmp, 0, 0);
+                    blasfeo_dsyrk_ut(nx + nu, nx1 + nu, 1.0, S_aug, 0, 0, hess_tmp, 0, 0, 1.0, Hess, 0,
+                                    0, Hess, 0, 0);
+                }
+
                 blasfeo_dveccp(nx + nu, lambda, 0, lambda_old, 0);
                 blasfeo_dgemv_t(nx, nu, 1.0, dPsi_du, 0, 0, lambda_old, 0, 1.0, lambda_old, nx,
                                 lambda, nx);  // update lambda_u
@@ -2936,20 +3252,27 @@ int sim_gnsf(void *config, sim_in *in, sim_out *out, void *args, void *mem_, voi
     {
         blasfeo_drowpei(nx, ipiv_x, S_forw_new);
         blasfeo_dcolpei(nx, ipiv_x, S_forw_new);
-        blasfeo_unpack_dmat(nx, nx + nu, S_forw_new, 0, 0, out->S_forw, nx);
+        sim_out_set_forw_sens(nx, nu, S_forw_new, 0, 0, out);
     }
-    if (opts->sens_adj)
+    if (opts->sens_adj || opts->sens_hess)
     {
         blasfeo_dvecpei(nx, ipiv_x, lambda, 0);
         blasfeo_unpack_dvec(nx + nu, lambda, 0, out->S_adj, 1);
     }
+    if (opts->sens_hess)
+    {
+        blasfeo_dtrtr_u(nx + nu, Hess, 0, 0, Hess, 0, 0);
+        blasfeo_drowpei(nx, ipiv_x, Hess);
+        blasfeo_dcolpei(nx, ipiv_x, Hess);
+        blasfeo_unpack_dmat(nx + nu, nx + nu, Hess, 0, 0, out->S_hess, nx + nu);
+    }
     if (opts->sens_algebraic)
     {
         // permute rows and cols
         blasfeo_dgecp(nz, nx+nu, S_algebraic, 0, 0, S_algebraic_aux, 0, 0);
         blasfeo_drowpei(nz, ipiv_z, S_algebraic_aux);
         blasfeo_dcolpei(nx, ipiv_x, S_algebraic_aux);
-        blasfeo_unpack_dmat(nz, nx+nu, S_algebraic_aux, 0, 0, out->S_algebraic, nz);
+        sim_out_set_algebraic_sens(nz, nx, nu, S_algebraic_aux, 0, 0, out);
     }
     if (opts->output_z)
     {
@@ -88,6 +88,11 @@ typedef struct
     // f_lo: linear output function
     external_function_generic *f_lo_fun_jac_x1_x1dot_u_z;
 
+    // hessians for sens_hess: of mult' * phi w.r.t. (y, uhat),
+    // and of mult' * f_lo w.r.t. (x1, x1dot, u, z1)
+    external_function_generic *phi_hess;
+    external_function_generic *f_lo_hess;
+
     // to import model matrices
     external_function_generic *get_gnsf_matrices;
 
@@ -232,6 +237,19 @@ typedef struct
     struct blasfeo_dmat dPHI_dyuhat;
     struct blasfeo_dvec z0;
 
+    // memory only available if (opts->sens_hess)
+    struct blasfeo_dvec lambda_K2;       // multipliers of the linear output system
+    struct blasfeo_dmat S_forw_x1_traj;  // x1 rows of S_forw at the start of each step
+    struct blasfeo_dmat dvv_dx1u;        // J_r_vv \ J_r_x1u
+    struct blasfeo_dmat jac_yuhat;       // d(y_i, uhat) / d(x1, u)
+    struct blasfeo_dmat jac_f_lo;        // d(x1_i, k1_i, u, z1_i) / d(x1, u)
+    struct blasfeo_dmat phi_hess_val;
+    struct blasfeo_dmat f_lo_hess_val;
+    struct blasfeo_dmat hess_tmp;
+    struct blasfeo_dmat hess_step;       // hessian of one step w.r.t. (x1, u)
+    struct blasfeo_dmat S_aug;           // d(x1, u) / d(x0, u0) at the start of one step
+    struct blasfeo_dmat Hess;
+
     // memory only available if (opts->sens_algebraic)
     // struct blasfeo_dvec y_one_stage;
     // struct blasfeo_dvec x0dot_1;
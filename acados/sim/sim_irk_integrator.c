@@ -33,6 +33,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -46,6 +47,11 @@
 #include "blasfeo/include/blasfeo_d_aux.h"
 #include "blasfeo/include/blasfeo_d_blas.h"
 
+// iterative refinement of the forward sensitivities with the decoupled Newton matrix:
+// relative residual tolerance and maximum number of iterations before the exact solve
+#define SIM_IRK_SENS_REFINE_TOL 1e-12
+#define SIM_IRK_SENS_REFINE_ITER_MAX 20
+
 
 /************************************************
  * dims
@@ -69,6 +75,7 @@ void *sim_irk_dims_assign(void *config_, void *raw_memory)
     dims->nu = 0;
     dims->nz = 0;
     dims->ny = 0;
+    dims->nq = 0;
 
     assert((char *) raw_memory + sim_irk_dims_calculate_size() >= c_ptr);
 
@@ -97,6 +104,10 @@ void sim_irk_dims_set(void *config_, void *dims_, const char *field, const int *
     {
         dims->ny = *value;
     }
+    else if (!strcmp(field, "nq"))
+    {
+        dims->nq = *value;
+    }
     else
     {
         printf("\nerror: sim_irk_dims_set: field not available: %s\n", field);
@@ -122,6 +133,10 @@ void sim_irk_dims_get(void *config_, void *dims_, const char *field, int *value)
     {
         *value = dims->nz;
     }
+    else if (!strcmp(field, "nq"))
+    {
+        *value = dims->nq;
+    }
     else
     {
         printf("\nerror: sim_irk_dims_get: field not available: %s\n", field);
@@ -206,6 +221,10 @@ int sim_irk_model_set(void *model_, const char *field, void *value)
     {
         model->conl_cost_fun = value;
     }
+    else if (!strcmp(field, "quad_fun_jac") )
+    {
+        model->quad_fun_jac = value;
+    }
     else
     {
         printf("\nerror: sim_irk_model_set: wrong field: %s\n", field);
@@ -232,6 +251,8 @@ acados_size_t sim_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * ns_max * sizeof(double);  // A_mat
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
+    size += ns_max * sizeof(double);           // e_vec
+    size += 3 * ns_max * ns_max * sizeof(double);  // T_mat, T_inv_mat, B_mat
 
     size += butcher_tableau_work_calculate_size(ns_max);
 
@@ -259,6 +280,10 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
+    assign_and_advance_double(ns_max, &opts->e_vec, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->T_mat, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->T_inv_mat, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->B_mat, &c_ptr);
 
     assert((char *) raw_memory + sim_irk_opts_calculate_size(config_, dims) >= c_ptr);
 
@@ -285,6 +310,15 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
     opts->newton_tol = 0.0;
+    opts->jac_reuse_across_calls = false;
+    opts->jac_reuse_contraction_max = 0.5;
+    opts->newton_decoupled = false;
+    opts->step_size_adaptive = false;
+    opts->step_size_atol = 1e-6;
+    opts->step_size_rtol = 1e-6;
+    opts->num_segments = 1;
+    opts->segment_iter = 100;
+    opts->segment_tol = 1e-12;
 
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
@@ -321,6 +355,36 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
 
     opts->tableau_size = opts->ns;
 
+    if (opts->num_segments > 1)
+    {
+        printf("\nerror: sim_irk_opts_update: num_segments > 1 is only supported by ERK\n");
+        exit(1);
+    }
+
+    if (opts->step_size_adaptive)
+    {
+        // embedded quadrature on the first ns-1 collocation nodes
+        opts->e_order = calculate_embedded_error_weights(opts->ns, opts->c_vec, opts->b_vec,
+                                                         opts->e_vec, opts->work);
+    }
+
+    if (opts->newton_decoupled)
+    {
+        if (opts->collocation_type != GAUSS_LEGENDRE && opts->collocation_type != GAUSS_RADAU_IIA)
+        {
+            printf("\nerror: sim_irk_opts_update: newton_decoupled requires collocation_type "
+                   "GAUSS_LEGENDRE or GAUSS_RADAU_IIA\n");
+            exit(1);
+        }
+        if (butcher_tableau_block_diagonalize(opts->ns, opts->A_mat, opts->T_mat,
+                                              opts->T_inv_mat, opts->B_mat, opts->work))
+        {
+            printf("\nerror: sim_irk_opts_update: failed to block diagonalize the Butcher "
+                   "tableau with ns = %d\n", opts->ns);
+            exit(1);
+        }
+    }
+
     // for debugging: print butcher tableau
     // printf("Butcher tableau\n");
     // printf("\nc_vec:\n");
@@ -361,6 +425,20 @@ void sim_irk_opts_get(void *config_, void *opts_, const char *field, void *value
  * memory
  ************************************************/
 
+// size (in stages) of the diagonal block of B_mat starting at stage l:
+// 1 for a real eigenvalue, 2 for a complex pair, 0 inside a complex pair
+static int sim_irk_decoupled_block_size(int ns, double *B_mat, int l)
+{
+    if (l > 0 && B_mat[l + ns * (l - 1)] != 0.0)
+        return 0;
+    if (l < ns - 1 && B_mat[(l + 1) + ns * l] != 0.0)
+        return 2;
+    return 1;
+}
+
+
+
+
 acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opts_)
 {
     // typecast
@@ -382,6 +460,28 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
     {
         size += 1 * sizeof(struct blasfeo_dmat);  // cost_hess
         size += 1 * blasfeo_memsize_dmat(nx+nu, nx+nu);  // cost_hess
+        size += 64;  // blasfeo_mem align
+    }
+
+    if (opts->newton_decoupled)
+    {
+        int ns = opts->ns;
+        size += ns * sizeof(struct blasfeo_dmat);  // dG_dK_dec
+        for (int l = 0; l < ns; l++)
+        {
+            int m = sim_irk_decoupled_block_size(ns, opts->B_mat, l) * (nx + nz);
+            size += blasfeo_memsize_dmat(m, m);  // dG_dK_dec
+        }
+        size += ns * (nx + nz) * sizeof(int);  // ipiv_dec
+        size += 64;  // blasfeo_mem align
+    }
+    else if (opts->jac_reuse_across_calls)
+    {
+        int nK = opts->ns * (nx + nz);
+        size += 1 * sizeof(struct blasfeo_dmat);  // dG_dK_lu
+        size += 1 * blasfeo_memsize_dmat(nK, nK);  // dG_dK_lu
+        size += nK * sizeof(int);  // ipiv_lu
+        size += 64;  // blasfeo_mem align
     }
 
     make_int_multiple_of(8, &size);
@@ -407,21 +507,60 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
     sim_irk_memory *mem = (sim_irk_memory *) c_ptr;
     c_ptr += sizeof(sim_irk_memory);
 
+    mem->step_size = 0.0;
+    mem->num_steps_taken = 0;
+    mem->lu_valid = false;
+    mem->lu_step = 0.0;
+
+    int nK = opts->ns * (nx + nz);
+
     align_char_to(8, &c_ptr);
     if (opts->cost_computation)
     {
         assign_and_advance_blasfeo_dmat_structs(1, &mem->cost_hess, &c_ptr);
     }
+    if (opts->newton_decoupled)
+    {
+        assign_and_advance_blasfeo_dmat_structs(opts->ns, &mem->dG_dK_dec, &c_ptr);
+    }
+    else if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_blasfeo_dmat_structs(1, &mem->dG_dK_lu, &c_ptr);
+    }
 
     // assign doubles
     assign_and_advance_double(nz, &mem->z, &c_ptr);
     assign_and_advance_double(nx, &mem->xdot, &c_ptr);
 
+    // assign ints
+    if (opts->newton_decoupled)
+    {
+        assign_and_advance_int(nK, &mem->ipiv_dec, &c_ptr);
+    }
+    else if (opts->jac_reuse_across_calls)
+    {
+        assign_and_advance_int(nK, &mem->ipiv_lu, &c_ptr);
+    }
+
     if (opts->cost_computation)
     {
         align_char_to(64, &c_ptr);
         assign_and_advance_blasfeo_dmat_mem(nx+nu, nx+nu, mem->cost_hess, &c_ptr);
     }
+    if (opts->newton_decoupled)
+    {
+        align_char_to(64, &c_ptr);
+        for (int l = 0; l < opts->ns; l++)
+        {
+            int m = sim_irk_decoupled_block_size(opts->ns, opts->B_mat, l) * (nx + nz);
+            assign_and_advance_blasfeo_dmat_mem(m, m, &mem->dG_dK_dec[l], &c_ptr);
+        }
+    }
+    else if (opts->jac_reuse_across_calls)
+    {
+        align_char_to(64, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nK, mem->dG_dK_lu, &c_ptr);
+    }
 
     // initialization of xdot, z is 0 if not changed
     for (int ii = 0; ii < nx; ii++)
@@ -541,6 +680,11 @@ void sim_irk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_steps_taken"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_steps_taken;
+    }
     else if (!strcmp(field, "cost_hess"))
     {
         struct blasfeo_dmat **ptr = value;
@@ -570,6 +714,7 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     int nu = dims->nu;
     int nz = dims->nz;
     int ny = dims->ny;
+    int nq = dims->nq;
 
     int nK = (nx + nz) * ns;
 
@@ -591,6 +736,12 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
     }
 
     size += 2 * sizeof(struct blasfeo_dvec);  // lambda, lambdaK
+    if (opts->newton_decoupled)
+    {
+        size += 2 * sizeof(struct blasfeo_dvec);  // rG_dec, dK_dec
+        if (opts->sens_forw)
+            size += 5 * sizeof(struct blasfeo_dmat);  // dK_dxu_rhs, _res, _corr, _dec, _blk
+    }
     if (!opts->sens_hess)
     {
         size += 4 * sizeof(struct blasfeo_dmat);  // dG_dxu, dG_dK, dK_dxu, S_forw
@@ -610,6 +761,12 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
         }
     }
 
+    if (nq > 0)
+    {
+        size += 5 * sizeof(struct blasfeo_dmat);  // quad_jac_x, _jac_u, _jac_z, _S, _S_stage
+        size += 2 * sizeof(struct blasfeo_dvec);  // quad_fun, quad_q
+    }
+
     /* blasfeo mem */
     if (opts->cost_computation)
     {
@@ -625,12 +782,32 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
         }
     }
 
+    if (nq > 0)
+    {
+        size += blasfeo_memsize_dmat(nq, nx);           // quad_jac_x
+        size += blasfeo_memsize_dmat(nq, nu);           // quad_jac_u
+        size += blasfeo_memsize_dmat(nq, nz);           // quad_jac_z
+        size += blasfeo_memsize_dmat(nq, nx + nu);      // quad_S
+        size += blasfeo_memsize_dmat(nx, nx + nu);      // quad_S_stage
+        size += 2 * blasfeo_memsize_dvec(nq);           // quad_fun, quad_q
+    }
+
     size += blasfeo_memsize_dvec(nK);   // K
     size += blasfeo_memsize_dvec(nK);   // rG
     size += 3 * blasfeo_memsize_dvec(nx);           // xt, xn, xtdot
     size += 1 * blasfeo_memsize_dvec(nx + nu);      // lambda
     size += 1 * blasfeo_memsize_dvec(nK);           // lambdaK
 
+    if (opts->newton_decoupled)
+    {
+        size += 2 * blasfeo_memsize_dvec(nK);  // rG_dec, dK_dec
+        if (opts->sens_forw)
+        {
+            size += 4 * blasfeo_memsize_dmat(nK, nx + nu);  // dK_dxu_rhs, _res, _corr, _dec
+            size += 1 * blasfeo_memsize_dmat(2 * (nx + nz), nx + nu);  // dK_dxu_blk
+        }
+    }
+
     if (!opts->sens_hess){
         size += 1 * blasfeo_memsize_dmat(nK, nx + nu);  // dG_dxu
         size += 1 * blasfeo_memsize_dmat(nK, nK);       // dG_dK
@@ -684,6 +861,7 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     int nu = dims->nu;
     int nz = dims->nz;
     int ny = dims->ny;
+    int nq = dims->nq;
     int nK = (nx + nz) * ns;
 
     int steps = opts->num_steps;
@@ -706,6 +884,20 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambdaK, &c_ptr);
 
+    if (opts->newton_decoupled)
+    {
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->rG_dec, &c_ptr);
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->dK_dec, &c_ptr);
+        if (opts->sens_forw)
+        {
+            assign_and_advance_blasfeo_dmat_structs(1, &workspace->dK_dxu_rhs, &c_ptr);
+            assign_and_advance_blasfeo_dmat_structs(1, &workspace->dK_dxu_res, &c_ptr);
+            assign_and_advance_blasfeo_dmat_structs(1, &workspace->dK_dxu_corr, &c_ptr);
+            assign_and_advance_blasfeo_dmat_structs(1, &workspace->dK_dxu_dec, &c_ptr);
+            assign_and_advance_blasfeo_dmat_structs(1, &workspace->dK_dxu_blk, &c_ptr);
+        }
+    }
+
     // dG_dxu, dG_dK, dK_dxu, S_forw
     if (!opts->sens_hess){
         assign_and_advance_blasfeo_dmat_structs(1, &workspace->dG_dxu, &c_ptr);
@@ -737,6 +929,17 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_blasfeo_dvec_structs(1, &workspace->nls_res, &c_ptr);
     }
 
+    if (nq > 0)
+    {
+        assign_and_advance_blasfeo_dmat_structs(1, &workspace->quad_jac_x, &c_ptr);
+        assign_and_advance_blasfeo_dmat_structs(1, &workspace->quad_jac_u, &c_ptr);
+        assign_and_advance_blasfeo_dmat_structs(1, &workspace->quad_jac_z, &c_ptr);
+        assign_and_advance_blasfeo_dmat_structs(1, &workspace->quad_S, &c_ptr);
+        assign_and_advance_blasfeo_dmat_structs(1, &workspace->quad_S_stage, &c_ptr);
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->quad_fun, &c_ptr);
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->quad_q, &c_ptr);
+    }
+
     /* algin c_ptr to 64 blasfeo_dmat_mem has to be assigned directly after that  */
     align_char_to(64, &c_ptr);
 
@@ -754,6 +957,15 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         }
     }
 
+    if (nq > 0)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nq, nx, workspace->quad_jac_x, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nq, nu, workspace->quad_jac_u, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nq, nz, workspace->quad_jac_z, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nq, nx + nu, workspace->quad_S, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, workspace->quad_S_stage, &c_ptr);
+    }
+
     if (!opts->sens_hess){
         assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->dG_dxu, &c_ptr);
         assign_and_advance_blasfeo_dmat_mem(nK, nK,      workspace->dG_dK, &c_ptr);
@@ -781,6 +993,15 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dmat_mem(nx + nz, nu, &workspace->df_du, &c_ptr);
     assign_and_advance_blasfeo_dmat_mem(nx + nz, nz, &workspace->df_dz, &c_ptr);
 
+    if (opts->newton_decoupled && opts->sens_forw)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->dK_dxu_rhs, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->dK_dxu_res, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->dK_dxu_corr, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->dK_dxu_dec, &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(2 * (nx + nz), nx + nu, workspace->dK_dxu_blk, &c_ptr);
+    }
+
     if (opts->sens_algebraic && opts->exact_z_output)
     {
         assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nz, &workspace->df_dxdotz, &c_ptr);
@@ -793,6 +1014,12 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_blasfeo_dvec_mem(ny, workspace->nls_res, &c_ptr);
     }
 
+    if (nq > 0)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nq, workspace->quad_fun, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nq, workspace->quad_q, &c_ptr);
+    }
+
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->rG, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->K, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xt, &c_ptr);
@@ -801,6 +1028,12 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
 
+    if (opts->newton_decoupled)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->rG_dec, &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->dK_dec, &c_ptr);
+    }
+
 
     if ( opts->sens_adj || opts->sens_hess ){
         for (int i = 0; i < steps; i++)
@@ -843,6 +1076,261 @@ int sim_irk_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, voi
  * integrator
  ************************************************/
 
+// scaled RMS norm of the local error estimate step * sum_i e_i k_i,
+// only the states are controlled, the sensitivities follow the accepted steps
+static double sim_irk_error_norm(int nx, int ns, double step, double *b_vec, double *e_vec,
+                                 struct blasfeo_dvec *xn, struct blasfeo_dvec *K, double atol,
+                                 double rtol)
+{
+    double err = 0.0;
+    for (int i = 0; i < nx; i++)
+    {
+        double dx = 0.0;
+        double ex = 0.0;
+        for (int s = 0; s < ns; s++)
+        {
+            double k = blasfeo_dvecex1(K, s * nx + i);
+            dx += b_vec[s] * k;
+            ex += e_vec[s] * k;
+        }
+        double x0 = fabs(blasfeo_dvecex1(xn, i));
+        double x1 = fabs(blasfeo_dvecex1(xn, i) + step * dx);
+        double tmp = step * ex / (atol + rtol * (x0 > x1 ? x0 : x1));
+        err += tmp * tmp;
+    }
+    return sqrt(err / nx);
+}
+
+
+
+// max abs entry of the m x n matrix A
+static double sim_irk_dmat_max_abs(int m, int n, struct blasfeo_dmat *A)
+{
+    double nrm = 0.0;
+    for (int jj = 0; jj < n; jj++)
+    {
+        for (int ii = 0; ii < m; ii++)
+        {
+            double tmp = fabs(blasfeo_dgeex1(A, ii, jj));
+            nrm = tmp > nrm ? tmp : nrm;
+        }
+    }
+    return nrm;
+}
+
+
+
+// factorize the decoupled simplified Newton matrix: block l of
+// h * B_mat (x) [df_dx, 0] + I (x) [df_dxdot, df_dz], with one real or complex pair block
+// of size (nx+nz) or 2*(nx+nz) per eigenvalue of A_mat
+static void sim_irk_decoupled_factorize(int nx, int nz, double step, sim_opts *opts,
+                                        sim_irk_memory *mem, struct blasfeo_dmat *df_dx,
+                                        struct blasfeo_dmat *df_dxdot, struct blasfeo_dmat *df_dz)
+{
+    int ns = opts->ns;
+    int n = nx + nz;
+    double *B_mat = opts->B_mat;
+
+    for (int l = 0; l < ns; l++)
+    {
+        int bs = sim_irk_decoupled_block_size(ns, B_mat, l);
+        if (bs == 0)
+            continue;
+        struct blasfeo_dmat *blk = &mem->dG_dK_dec[l];
+        blasfeo_dgese(bs * n, bs * n, 0.0, blk, 0, 0);
+        for (int p = 0; p < bs; p++)
+        {
+            for (int q = 0; q < bs; q++)
+            {
+                double b_pq = B_mat[(l + p) + ns * (l + q)];
+                if (b_pq != 0.0)
+                    blasfeo_dgead(n, nx, step * b_pq, df_dx, 0, 0, blk, p * n, q * n);
+            }
+            blasfeo_dgead(n, nx, 1.0, df_dxdot, 0, 0, blk, p * n, p * n);
+            blasfeo_dgead(n, nz, 1.0, df_dz, 0, 0, blk, p * n, p * n + nx);
+        }
+        blasfeo_dgetrf_rp(bs * n, bs * n, blk, 0, 0, blk, 0, 0, mem->ipiv_dec + l * n);
+    }
+}
+
+
+
+// sol = M^{-1} rhs for the decoupled Newton matrix M = (T (x) I) M_dec (T_inv (x) I);
+// rhs is ordered stage-wise as G, sol as K = (k_1,..., k_{ns}, z_1,..., z_{ns})
+static void sim_irk_decoupled_solve_vec(int nx, int nz, sim_opts *opts, sim_irk_memory *mem,
+                                        struct blasfeo_dvec *rhs, struct blasfeo_dvec *tmp,
+                                        struct blasfeo_dvec *sol)
+{
+    int ns = opts->ns;
+    int n = nx + nz;
+    double *T_mat = opts->T_mat;
+    double *T_inv_mat = opts->T_inv_mat;
+
+    // tmp = (T_inv (x) I) rhs
+    blasfeo_dvecse(ns * n, 0.0, tmp, 0);
+    for (int l = 0; l < ns; l++)
+        for (int i = 0; i < ns; i++)
+            blasfeo_daxpy(n, T_inv_mat[l + ns * i], rhs, i * n, tmp, l * n, tmp, l * n);
+
+    // independent block solves
+    for (int l = 0; l < ns; l++)
+    {
+        int m = sim_irk_decoupled_block_size(ns, opts->B_mat, l) * n;
+        if (m == 0)
+            continue;
+        blasfeo_dvecpe(m, mem->ipiv_dec + l * n, tmp, l * n);
+        blasfeo_dtrsv_lnu(m, &mem->dG_dK_dec[l], 0, 0, tmp, l * n, tmp, l * n);
+        blasfeo_dtrsv_unn(m, &mem->dG_dK_dec[l], 0, 0, tmp, l * n, tmp, l * n);
+    }
+
+    // sol = (T (x) I) tmp
+    blasfeo_dvecse(ns * n, 0.0, sol, 0);
+    for (int j = 0; j < ns; j++)
+    {
+        for (int l = 0; l < ns; l++)
+        {
+            double t_jl = T_mat[j + ns * l];
+            blasfeo_daxpy(nx, t_jl, tmp, l * n, sol, j * nx, sol, j * nx);
+            blasfeo_daxpy(nz, t_jl, tmp, l * n + nx, sol, ns * nx + j * nz,
+                          sol, ns * nx + j * nz);
+        }
+    }
+}
+
+
+
+// matrix version of sim_irk_decoupled_solve_vec, blk holds one block of rows
+static void sim_irk_decoupled_solve_mat(int nx, int nz, int ncol, sim_opts *opts,
+                                        sim_irk_memory *mem, struct blasfeo_dmat *rhs,
+                                        struct blasfeo_dmat *tmp, struct blasfeo_dmat *blk,
+                                        struct blasfeo_dmat *sol)
+{
+    int ns = opts->ns;
+    int n = nx + nz;
+    double *T_mat = opts->T_mat;
+    double *T_inv_mat = opts->T_inv_mat;
+
+    blasfeo_dgese(ns * n, ncol, 0.0, tmp, 0, 0);
+    for (int l = 0; l < ns; l++)
+        for (int i = 0; i < ns; i++)
+            blasfeo_dgead(n, ncol, T_inv_mat[l + ns * i], rhs, i * n, 0, tmp, l * n, 0);
+
+    for (int l = 0; l < ns; l++)
+    {
+        int m = sim_irk_decoupled_block_size(ns, opts->B_mat, l) * n;
+        if (m == 0)
+            continue;
+        blasfeo_dgecp(m, ncol, tmp, l * n, 0, blk, 0, 0);
+        blasfeo_drowpe(m, mem->ipiv_dec + l * n, blk);
+        blasfeo_dtrsm_llnu(m, ncol, 1.0, &mem->dG_dK_dec[l], 0, 0, blk, 0, 0, blk, 0, 0);
+        blasfeo_dtrsm_lunn(m, ncol, 1.0, &mem->dG_dK_dec[l], 0, 0, blk, 0, 0, blk, 0, 0);
+        blasfeo_dgecp(m, ncol, blk, 0, 0, tmp, l * n, 0);
+    }
+
+    blasfeo_dgese(ns * n, ncol, 0.0, sol, 0, 0);
+    for (int j = 0; j < ns; j++)
+    {
+        for (int l = 0; l < ns; l++)
+        {
+            double t_jl = T_mat[j + ns * l];
+            blasfeo_dgead(nx, ncol, t_jl, tmp, l * n, 0, sol, j * nx, 0);
+            blasfeo_dgead(nz, ncol, t_jl, tmp, l * n + nx, 0, sol, ns * nx + j * nz, 0);
+        }
+    }
+}
+
+
+
+// quadrature states of one step, q += step * sum_i b_i * f_q(x_i, u, z_i, t_i) over the stage
+// values of K; if dK_dxu != NULL (holding -dK/dxu), also the sensitivities along S_forw of the
+// step start, S_q += step * sum_i b_i * (df_q/dx * dx_i/dxu + df_q/dz * dz_i/dxu + [0, df_q/du])
+static void sim_irk_quadrature_step(sim_irk_dims *dims, sim_opts *opts, irk_model *model,
+                                    double *u, double t_step, double step,
+                                    struct blasfeo_dvec *xn, struct blasfeo_dvec *K,
+                                    struct blasfeo_dmat *S_forw, struct blasfeo_dmat *dK_dxu,
+                                    sim_irk_workspace *workspace)
+{
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nz = dims->nz;
+    int nq = dims->nq;
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+    double a, b, t_current;
+
+    struct blasfeo_dvec *xt = workspace->xt;
+    struct blasfeo_dmat *S_stage = workspace->quad_S_stage;
+
+    if (model->quad_fun_jac == NULL)
+    {
+        printf("\nerror: sim_irk: quad_fun_jac is not provided\n");
+        exit(1);
+    }
+
+    struct blasfeo_dvec_args z_in;
+    z_in.x = K;
+
+    ext_fun_arg_t type_in[4];
+    void *fun_in[4];
+    ext_fun_arg_t type_out[4];
+    void *fun_out[4];
+
+    type_in[0] = BLASFEO_DVEC;
+    fun_in[0] = xt;
+    type_in[1] = COLMAJ;
+    fun_in[1] = u;
+    type_in[2] = BLASFEO_DVEC_ARGS;
+    fun_in[2] = &z_in;
+    type_in[3] = COLMAJ;
+    fun_in[3] = &t_current;
+
+    type_out[0] = BLASFEO_DVEC;
+    fun_out[0] = workspace->quad_fun;
+    type_out[1] = BLASFEO_DMAT;
+    fun_out[1] = workspace->quad_jac_x;
+    type_out[2] = BLASFEO_DMAT;
+    fun_out[2] = workspace->quad_jac_u;
+    type_out[3] = BLASFEO_DMAT;
+    fun_out[3] = workspace->quad_jac_z;
+
+    for (int ii = 0; ii < ns; ii++)
+    {
+        z_in.xi = ns * nx + ii * nz;
+        t_current = t_step + opts->c_vec[ii] * step;
+        b = step * b_vec[ii];
+
+        // stage state and its sensitivity
+        blasfeo_dveccp(nx, xn, 0, xt, 0);
+        if (dK_dxu != NULL)
+            blasfeo_dgecp(nx, nx + nu, S_forw, 0, 0, S_stage, 0, 0);
+        for (int jj = 0; jj < ns; jj++)
+        {
+            a = A_mat[ii + ns * jj] * step;
+            blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
+            if (dK_dxu != NULL)
+                blasfeo_dgead(nx, nx + nu, -a, dK_dxu, jj * nx, 0, S_stage, 0, 0);
+        }
+
+        model->quad_fun_jac->evaluate(model->quad_fun_jac, type_in, fun_in, type_out, fun_out);
+
+        blasfeo_daxpy(nq, b, workspace->quad_fun, 0, workspace->quad_q, 0, workspace->quad_q, 0);
+
+        if (dK_dxu != NULL)
+        {
+            blasfeo_dgemm_nn(nq, nx + nu, nx, b, workspace->quad_jac_x, 0, 0, S_stage, 0, 0,
+                             1.0, workspace->quad_S, 0, 0, workspace->quad_S, 0, 0);
+            blasfeo_dgemm_nn(nq, nx + nu, nz, -b, workspace->quad_jac_z, 0, 0,
+                             dK_dxu, ns * nx + ii * nz, 0, 1.0, workspace->quad_S, 0, 0,
+                             workspace->quad_S, 0, 0);
+            blasfeo_dgead(nq, nu, b, workspace->quad_jac_u, 0, 0, workspace->quad_S, 0, nx);
+        }
+    }
+}
+
+
+
 int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_)
 {
     // Get variables from workspace, etc;
@@ -882,6 +1370,34 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     double *b_vec = opts->b_vec;
     int num_steps = opts->num_steps;
     double step = in->T / num_steps;
+    double t_step = t0;
+
+    // adaptive step size
+    bool adaptive = opts->step_size_adaptive;
+    bool force_step = false;
+    bool step_accepted;
+    bool last_step = false;
+    double t_left = in->T;
+    double err = 0.0;
+    double fac = 1.0;
+    int num_steps_taken = num_steps;
+    if (adaptive)
+    {
+        if (opts->sens_adj || opts->sens_hess || opts->cost_computation)
+        {
+            printf("\nerror: sim_irk: step_size_adaptive is only implemented for forward sensitivities\n");
+            exit(1);
+        }
+        step = mem->step_size > 0.0 ? mem->step_size : in->T;
+    }
+
+    // eigenvalue-decoupled simplified Newton
+    bool decoupled = opts->newton_decoupled;
+    if (decoupled && opts->sens_hess)
+    {
+        printf("\nerror: sim_irk: newton_decoupled is not implemented for sens_hess\n");
+        exit(1);
+    }
 
     int *ipiv = workspace->ipiv;
     double *Z_work = workspace->Z_work;
@@ -919,7 +1435,6 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     struct blasfeo_dmat *Hess = &workspace->Hess;
 
     double *x_out = out->xn;
-    double *S_forw_out = out->S_forw;
     double *S_adj_out = out->S_adj;
     double *S_algebraic = out->S_algebraic;
 
@@ -945,6 +1460,14 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     struct blasfeo_dmat *S_forw_ss = S_forw;
     int *ipiv_ss;
 
+    // Newton matrix factorization: kept in memory across calls or recomputed per step
+    bool lu_cached = opts->jac_reuse_across_calls;
+    struct blasfeo_dmat *dG_dK_newton;
+    int *ipiv_newton;
+    bool eval_jac;
+    double newton_step_norm;
+    double newton_step_norm_prev = 0.0;
+
 
     // SET FUNCTION IN- & OUTPUT TYPES
     // INPUT: impl_ode
@@ -1034,6 +1557,8 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // initialize
     double timing_ad = 0.0;
     double timing_la = 0.0;
+    out->info->lu_fact = 0;
+    out->info->newton_iter = 0;
     blasfeo_dvecse(nK, 0.0, lambdaK, 0);
     if (opts->sens_hess){
         blasfeo_dgese(nx + nu, nx + nu, 0.0, Hess, 0, 0);
@@ -1052,9 +1577,24 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         }
     }
 
+    if (dims->nq > 0)
+    {
+        // initialize quadrature states and their sensitivities
+        blasfeo_dvecse(dims->nq, 0.0, workspace->quad_q, 0);
+        blasfeo_dgese(dims->nq, nx + nu, 0.0, workspace->quad_S, 0, 0);
+    }
+
     // pack
     blasfeo_pack_dvec(nx, in->x, 1, xn, 0);
-    blasfeo_pack_dmat(nx, nx + nu, in->S_forw, nx, S_forw, 0, 0);
+    if (in->identity_seed)
+    {
+        blasfeo_dgese(nx, nx + nu, 0.0, S_forw, 0, 0);
+        blasfeo_ddiare(nx, 1.0, S_forw, 0, 0);
+    }
+    else
+    {
+        blasfeo_pack_dmat(nx, nx + nu, in->S_forw, nx, S_forw, 0, 0);
+    }
     blasfeo_pack_dvec(nx + nu, in->S_adj, 1, lambda, 0); // TODO set to zero u-part ???
 
     // initialize integration variables
@@ -1083,6 +1623,8 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     acados_tic(&timer);
     for (int ss = 0; ss < num_steps; ss++)
     {
+        // refactorize at the start of a step only if the step size may have changed
+        bool new_step_jac = ss == 0 || adaptive;
 
         // decide whether results from forward sensitivity propagation are stored,
         // or if memory has to be reused --> set pointers accordingly
@@ -1113,112 +1655,179 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             S_forw_ss = S_forw;
         }
 
+        if (lu_cached)
+        {
+            dG_dK_newton = mem->dG_dK_lu;
+            ipiv_newton = mem->ipiv_lu;
+        }
+        else
+        {
+            dG_dK_newton = dG_dK_ss;
+            ipiv_newton = ipiv_ss;
+        }
+
         if ( opts->sens_adj || opts->sens_hess )  // store current xn
             blasfeo_dveccp(nx, xn, 0, &xn_traj[ss], 0);
 
-        for (int iter = 0; iter < newton_iter; iter++)
+        if (adaptive)
+            step = sim_adaptive_step_size(step, t_left, num_steps - ss, &force_step);
+
+        step_accepted = false;
+        while (!step_accepted)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            for (int iter = 0; iter < newton_iter; iter++)
             {
-                // if new jacobian gets computed, initialize dG_dK_ss with zeros
-                blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
-            }
+                out->info->newton_iter++;
+                if (lu_cached)
+                    eval_jac = !mem->lu_valid || mem->lu_step != step;
+                else
+                    eval_jac = (opts->jac_reuse && new_step_jac && (iter == 0)) || (!opts->jac_reuse);
 
-            for (int ii = 0; ii < ns; ii++)
-            {  // ii-th row of tableau
-                // take x(n); copy a strvec into a strvec
-                blasfeo_dveccp(nx, xn, 0, xt, 0);
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
-
-                for (int jj = 0; jj < ns; jj++)
-                {  // jj-th col of tableau
-                    // TODO(oj): precompute A_mat * step;
-                    a = A_mat[ii + ns * jj] * step;
-                    // xt = xt + T_int * a[i,j]*K_j
-                    blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
+                if (eval_jac && !decoupled)
+                {
+                    // if new jacobian gets computed, initialize dG_dK_newton with zeros
+                    blasfeo_dgese(nK, nK, 0.0, dG_dK_newton, 0, 0);
                 }
-                impl_ode_xdot_in.xi = ii * nx;  // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
-                impl_ode_z_in.xi = ns * nx + ii * nz;
-                                // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
-                impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
-                // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
-                {   // evaluate the ode function & jacobian w.r.t. x, xdot;
-                    // &  compute jacobian dG_dK_ss;
-                    acados_tic(&timer_ad);
-                    model->impl_ode_fun_jac_x_xdot_z->evaluate(
-                        model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
-                        impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
-                    timing_ad += acados_toc(&timer_ad);
+                for (int ii = 0; ii < ns; ii++)
+                {  // ii-th row of tableau
+                    // take x(n); copy a strvec into a strvec
+                    blasfeo_dveccp(nx, xn, 0, xt, 0);
+                    t_current = t_step + opts->c_vec[ii] * step;
 
-                    // compute the blocks of dG_dK_ss
                     for (int jj = 0; jj < ns; jj++)
-                    {  // compute the block (ii,jj)th block of dG_dK_ss
+                    {  // jj-th col of tableau
+                        // TODO(oj): precompute A_mat * step;
                         a = A_mat[ii + ns * jj] * step;
-                        blasfeo_dgead(nx + nz, nx, a, df_dx, 0, 0,
-                                            dG_dK_ss, ii * (nx + nz), jj * nx);
-                        if (jj == ii)
+                        // xt = xt + T_int * a[i,j]*K_j
+                        blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
+                    }
+                    impl_ode_xdot_in.xi = ii * nx;  // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
+                    impl_ode_z_in.xi = ns * nx + ii * nz;
+                                    // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
+                    impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
+
+                    // compute the residual of implicit ode at time t_ii
+                    if (eval_jac && (!decoupled || ii == ns - 1))
+                    {   // evaluate the ode function & jacobian w.r.t. x, xdot;
+                        // &  compute jacobian dG_dK_newton;
+                        // decoupled: one jacobian for all stages, taken at the last stage
+                        acados_tic(&timer_ad);
+                        model->impl_ode_fun_jac_x_xdot_z->evaluate(
+                            model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
+                            impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
+                        timing_ad += acados_toc(&timer_ad);
+
+                        // compute the blocks of dG_dK_newton
+                        for (int jj = 0; jj < ns && !decoupled; jj++)
+                        {  // compute the block (ii,jj)th block of dG_dK_newton
+                            a = A_mat[ii + ns * jj] * step;
+                            blasfeo_dgead(nx + nz, nx, a, df_dx, 0, 0,
+                                                dG_dK_newton, ii * (nx + nz), jj * nx);
+                            if (jj == ii)
+                            {
+                                blasfeo_dgead(nx + nz, nx, 1, df_dxdot, 0, 0,
+                                              dG_dK_newton, ii * (nx + nz), jj * nx);
+                                blasfeo_dgead(nx + nz, nz, 1, df_dz,    0, 0,
+                                              dG_dK_newton, ii * (nx + nz), (nx * ns) + jj * nz);
+                            }
+                        }  // end jj
+                    }
+                    else // only eval function (without jacobian)
+                    {
+                        if (model->impl_ode_fun == 0)
                         {
-                            blasfeo_dgead(nx + nz, nx, 1, df_dxdot, 0, 0,
-                                          dG_dK_ss, ii * (nx + nz), jj * nx);
-                            blasfeo_dgead(nx + nz, nz, 1, df_dz,    0, 0,
-                                          dG_dK_ss, ii * (nx + nz), (nx * ns) + jj * nz);
+                            printf("sim IRK: impl_ode_fun is not provided. Exiting.\n");
+                            exit(1);
                         }
-                    }  // end jj
-                }
-                else // only eval function (without jacobian)
+                        acados_tic(&timer_ad);
+                        model->impl_ode_fun->evaluate(model->impl_ode_fun, impl_ode_type_in,
+                                                      impl_ode_in, impl_ode_fun_type_out,
+                                                      impl_ode_fun_out);
+                        timing_ad += acados_toc(&timer_ad);
+                    }
+                }  // end ii
+
+                acados_tic(&timer_la);
+                // DGETRF computes an LU factorization of a general M-by-N matrix A
+                // using partial pivoting with row interchanges.
+                // printf("dG_dK_newton = (IRK) \n");
+                // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_newton, 0, 0);
+                if (eval_jac)
                 {
-                    if (model->impl_ode_fun == 0)
+                    if (decoupled)
+                        sim_irk_decoupled_factorize(nx, nz, step, opts, mem, df_dx, df_dxdot, df_dz);
+                    else
+                        blasfeo_dgetrf_rp(nK, nK, dG_dK_newton, 0, 0, dG_dK_newton, 0, 0,
+                                          ipiv_newton);
+                    out->info->lu_fact++;
+                    if (lu_cached)
                     {
-                        printf("sim IRK: impl_ode_fun is not provided. Exiting.\n");
-                        exit(1);
+                        mem->lu_valid = true;
+                        mem->lu_step = step;
                     }
-                    acados_tic(&timer_ad);
-                    model->impl_ode_fun->evaluate(model->impl_ode_fun, impl_ode_type_in,
-                                                  impl_ode_in, impl_ode_fun_type_out,
-                                                  impl_ode_fun_out);
-                    timing_ad += acados_toc(&timer_ad);
                 }
-            }  // end ii
 
-            acados_tic(&timer_la);
-            // DGETRF computes an LU factorization of a general M-by-N matrix A
-            // using partial pivoting with row interchanges.
-            // printf("dG_dK_ss = (IRK) \n");
-            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
-            {
-                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
-            }
+                if (decoupled)
+                {
+                    sim_irk_decoupled_solve_vec(nx, nz, opts, mem, rG, workspace->rG_dec,
+                                                workspace->dK_dec);
+                    blasfeo_dveccp(nK, workspace->dK_dec, 0, rG, 0);
+                }
+                else
+                {
+                    // permute also the r.h.s
+                    blasfeo_dvecpe(nK, ipiv_newton, rG, 0);
 
-            // permute also the r.h.s
-            blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
+                    // solve dG_dK_newton * y = rG, dG_dK_newton on the (l)eft, (l)ower-trian,
+                    // (n)o-trans (u)nit trian
+                    blasfeo_dtrsv_lnu(nK, dG_dK_newton, 0, 0, rG, 0, rG, 0);
 
-            // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
-            // (u)nit trian
-            blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                    // solve dG_dK_newton * x = rG, dG_dK_newton on the (l)eft, (u)pper-trian,
+                    // (n)o-trans (n)o unit trian , and store x in rG
+                    blasfeo_dtrsv_unn(nK, dG_dK_newton, 0, 0, rG, 0, rG, 0);
+                }
+
+                timing_la += acados_toc(&timer_la);
 
-            // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
-            // (n)o unit trian , and store x in rG
-            blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is
+                // [DeltaK, DeltaZ]
+                blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
 
-            timing_la += acados_toc(&timer_la);
+                blasfeo_dvecnrm_inf(nK, rG, 0, &newton_step_norm);
 
-            // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is
-            // [DeltaK, DeltaZ]
-            blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
+                // slow contraction with the cached factorization: refresh it in the next iteration
+                if (lu_cached && iter > 0 &&
+                    newton_step_norm > opts->jac_reuse_contraction_max * newton_step_norm_prev)
+                {
+                    mem->lu_valid = false;
+                }
+                newton_step_norm_prev = newton_step_norm;
 
-            // check early termination based on tolerance
-            if (opts->newton_tol > 0)
+                // check early termination based on tolerance
+                if (opts->newton_tol > 0)
+                {
+                    if (newton_step_norm < opts->newton_tol)
+                    {
+                        break;
+                    }
+                }
+            } // end newton_iter
+
+            step_accepted = true;
+            if (adaptive)
             {
-                blasfeo_dvecnrm_inf(nK, rG, 0, &a);
-                if (a < opts->newton_tol)
+                err = sim_irk_error_norm(nx, ns, step, b_vec, opts->e_vec, xn, K,
+                                         opts->step_size_atol, opts->step_size_rtol);
+                fac = sim_adaptive_step_factor(err, opts->e_order);
+                if (err > 1.0 && !force_step)
                 {
-                    break;
+                    // reject, retry with a smaller step
+                    step = sim_adaptive_step_size(fac * step, t_left, num_steps - ss, &force_step);
+                    step_accepted = false;
                 }
             }
-        } // end newton_iter
+        }
 
         if ( opts->sens_adj || opts->sens_hess )
         {
@@ -1244,7 +1853,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // xt = xt + T_int * a[i,j]*K_j
                     blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
                 }
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
 
                 acados_tic(&timer_ad);
                 model->impl_ode_jac_x_xdot_u_z->evaluate(
@@ -1271,9 +1880,24 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 }  // end jj
             }  // end ii
 
-            // factorize dG_dK_ss
+            // factorize dG_dK_ss, decoupled: keep it as is for the residuals of the
+            // iterative refinement below
             acados_tic(&timer_la);
-            blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+            if (!decoupled)
+            {
+                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                out->info->lu_fact++;
+            }
+
+            if (lu_cached && !decoupled)
+            {
+                // factorization at the converged iterate refreshes the cached one
+                blasfeo_dgecp(nK, nK, dG_dK_ss, 0, 0, mem->dG_dK_lu, 0, 0);
+                for (int ii = 0; ii < nK; ii++)
+                    mem->ipiv_lu[ii] = ipiv_ss[ii];
+                mem->lu_valid = true;
+                mem->lu_step = step;
+            }
             timing_la += acados_toc(&timer_la);
 
             // obtain dK_dxu
@@ -1292,9 +1916,57 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }
             // solve linear system
             acados_tic(&timer_la);
-            blasfeo_drowpe(nK, ipiv_ss, dK_dxu_ss);
-            blasfeo_dtrsm_llnu(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
-            blasfeo_dtrsm_lunn(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0, dK_dxu_ss, 0, 0);
+            if (decoupled)
+            {
+                // iterative refinement on the exact dG_dK_ss, preconditioned with the
+                // decoupled Newton matrix, until the residual is at rounding level;
+                // if it does not get there, solve with the LU factorization of dG_dK_ss
+                struct blasfeo_dmat *dK_dxu_rhs = workspace->dK_dxu_rhs;
+                struct blasfeo_dmat *dK_dxu_res = workspace->dK_dxu_res;
+                struct blasfeo_dmat *dK_dxu_corr = workspace->dK_dxu_corr;
+
+                blasfeo_dgecp(nK, nx + nu, dK_dxu_ss, 0, 0, dK_dxu_rhs, 0, 0);
+                sim_irk_decoupled_solve_mat(nx, nz, nx + nu, opts, mem, dK_dxu_rhs,
+                        workspace->dK_dxu_dec, workspace->dK_dxu_blk, dK_dxu_ss);
+
+                double refine_tol = SIM_IRK_SENS_REFINE_TOL *
+                        (1.0 + sim_irk_dmat_max_abs(nK, nx + nu, dK_dxu_rhs));
+                bool refine_converged = false;
+                for (int iter = 0; iter < SIM_IRK_SENS_REFINE_ITER_MAX; iter++)
+                {
+                    // res = rhs - dG_dK_ss * dK_dxu_ss
+                    blasfeo_dgemm_nn(nK, nx + nu, nK, -1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0,
+                                     1.0, dK_dxu_rhs, 0, 0, dK_dxu_res, 0, 0);
+                    if (sim_irk_dmat_max_abs(nK, nx + nu, dK_dxu_res) <= refine_tol)
+                    {
+                        refine_converged = true;
+                        break;
+                    }
+                    sim_irk_decoupled_solve_mat(nx, nz, nx + nu, opts, mem, dK_dxu_res,
+                            workspace->dK_dxu_dec, workspace->dK_dxu_blk, dK_dxu_corr);
+                    blasfeo_dgead(nK, nx + nu, 1.0, dK_dxu_corr, 0, 0, dK_dxu_ss, 0, 0);
+                }
+
+                if (!refine_converged)
+                {
+                    blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                    out->info->lu_fact++;
+                    blasfeo_dgecp(nK, nx + nu, dK_dxu_rhs, 0, 0, dK_dxu_ss, 0, 0);
+                    blasfeo_drowpe(nK, ipiv_ss, dK_dxu_ss);
+                    blasfeo_dtrsm_llnu(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0,
+                                       dK_dxu_ss, 0, 0);
+                    blasfeo_dtrsm_lunn(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0,
+                                       dK_dxu_ss, 0, 0);
+                }
+            }
+            else
+            {
+                blasfeo_drowpe(nK, ipiv_ss, dK_dxu_ss);
+                blasfeo_dtrsm_llnu(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0,
+                                   dK_dxu_ss, 0, 0);
+                blasfeo_dtrsm_lunn(nK, nx + nu, 1.0, dG_dK_ss, 0, 0, dK_dxu_ss, 0, 0,
+                                   dK_dxu_ss, 0, 0);
+            }
             timing_la += acados_toc(&timer_la);
 
             // printf("dK_dxu (solved) = (IRK, ss = %d) \n", ss);
@@ -1331,7 +2003,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1423,7 +2095,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t_step + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1490,6 +2162,14 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 }
             }
 
+            if (dims->nq > 0)
+            {
+                acados_tic(&timer_ad);
+                sim_irk_quadrature_step(dims, opts, model, u, t_step, step, xn, K, S_forw_ss,
+                                        dK_dxu_ss, workspace);
+                timing_ad += acados_toc(&timer_ad);
+            }
+
             // update forward sensitivity
             // NOTE(oj): dK_dxu_ss is actually -dK_dxu_ss, because alpha = -1.0
             // was not supported by blasfeos backsolve initially.
@@ -1521,7 +2201,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1574,7 +2254,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t_step + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1593,12 +2273,25 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }
         } // end NLS cost_computation without sens
 
+        // quadrature states without sensitivities
+        if (dims->nq > 0 && !(opts->sens_forw || opts->sens_hess))
+        {
+            acados_tic(&timer_ad);
+            sim_irk_quadrature_step(dims, opts, model, u, t_step, step, xn, K, NULL, NULL,
+                                    workspace);
+            timing_ad += acados_toc(&timer_ad);
+        }
 
         // obtain x(n+1)
         for (int ii = 0; ii < ns; ii++){
             // xn += b_i * k_i
             blasfeo_daxpy(nx, step * b_vec[ii], K, ii * nx, xn, 0, xn, 0);
         }
+        if (adaptive)
+        {
+            t_left -= step;
+            last_step = t_left <= 0.0;
+        }
 
         // algebraic variables output and corresponding sensitivity propagation
         if (ss == 0)
@@ -1631,7 +2324,11 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         }
                         neville_algorithm(0.0, ns - 1, opts->c_vec, Z_work, &interpolated_value);
                                     // eval polynomial through vals in Z_work at 0.
-                        S_algebraic[ii+jj*nz] = -interpolated_value;
+                        if (out->dzduxt != NULL)  // [u; x] rows
+                            blasfeo_dgein1(-interpolated_value, out->dzduxt,
+                                           jj < nx ? nu + jj : jj - nx, ii);
+                        else
+                            S_algebraic[ii+jj*nz] = -interpolated_value;
                         // printf("\ndz[ii=%d]_dxu[jj=%d] = %e\n", ii, jj, interpolated_value);
                         // blasfeo_pack_dvec(1, &interpolated_value, 1, xtdot, ii);
                     }
@@ -1672,6 +2369,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // perform extra newton iterations to get xdot0, z0 more precisely.
                     for (int ii = 0; ii < opts->newton_iter; ii++)
                     {
+                        out->info->newton_iter++;
 
                         if (ii == 0 || !opts->jac_reuse)
                         {
@@ -1689,6 +2387,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                             // factorize
                             blasfeo_dgetrf_rp(nx + nz, nx + nz, df_dxdotz, 0, 0, df_dxdotz, 0, 0,
                                                                                         ipiv_one_stage);
+                            out->info->lu_fact++;
                         }
 
                         // permute rhs
@@ -1730,6 +2429,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     acados_tic(&timer_la);
                     blasfeo_dgetrf_rp(nx + nz, nx + nz, df_dxdotz, 0, 0, df_dxdotz, 0, 0,
                                                                                 ipiv_one_stage);
+                    out->info->lu_fact++;
                     blasfeo_drowpe(nx + nz, ipiv_one_stage, dk0_dxu);
                     blasfeo_dtrsm_llnu(nx + nz, nx + nu, 1.0, df_dxdotz, 0, 0,
                                     dk0_dxu, 0, 0, dk0_dxu, 0, 0);
@@ -1741,7 +2441,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     blasfeo_dgesc(nx + nz, nx + nu, -1.0, dk0_dxu, 0, 0);
 
                     // extract output
-                    blasfeo_unpack_dmat(nz, nx + nu, dk0_dxu, nx, 0, S_algebraic, nz);
+                    sim_out_set_algebraic_sens(nz, nx, nu, dk0_dxu, nx, 0, out);
                 } // if sens_algebraic
                 // Reset impl_ode inputs
                 impl_ode_type_in[0] = BLASFEO_DVEC;       // xt
@@ -1752,19 +2452,40 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_in[3] = &impl_ode_z_in;     // 4th input is part of Z[ss]
             } // if exact_z_output
         }  //  end if (ss == 0)
-        if (ss == num_steps-1)
+        if (ss == num_steps-1 || last_step)
         {
             // store last xdot, z values for next initialization
             blasfeo_unpack_dvec(nx, K, (ns-1) * nx, mem->xdot, 1);
             blasfeo_unpack_dvec(nz, K, (ns-1) * nz + ns*nx, mem->z, 1);
         }
+
+        t_step += step;
+        if (adaptive)
+        {
+            if (ss == 0 || !last_step)
+                mem->step_size = fac * step;
+            step *= fac;
+            if (last_step)
+            {
+                num_steps_taken = ss + 1;
+                break;
+            }
+        }
     }  // end step loop (ss)
+    mem->num_steps_taken = num_steps_taken;
 
     // extract results from forward sweep to output
     blasfeo_unpack_dvec(nx, xn, 0, x_out, 1);
 
     if  ( opts->sens_forw || opts->sens_hess )
-        blasfeo_unpack_dmat(nx, nx + nu, S_forw_ss, 0, 0, S_forw_out, nx);
+        sim_out_set_forw_sens(nx, nu, S_forw_ss, 0, 0, out);
+
+    if (dims->nq > 0)
+    {
+        blasfeo_unpack_dvec(dims->nq, workspace->quad_q, 0, out->qn, 1);
+        if (opts->sens_forw || opts->sens_hess)
+            blasfeo_unpack_dmat(dims->nq, nx + nu, workspace->quad_S, 0, 0, out->S_q, dims->nq);
+    }
 
 /*****************************************************************************
 * Backward Sweep
@@ -1848,6 +2569,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 // factorize dG_dK_ss - already done in forw if hessian is active
                 acados_tic(&timer_la);
                 blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                out->info->lu_fact++;
                 timing_la += acados_toc(&timer_la);
 
             }  // end if( !opts->sens_hess )
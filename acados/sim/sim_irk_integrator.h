@@ -48,6 +48,7 @@ typedef struct
     int nz;
 
     int ny;  // for NLS cost propagation
+    int nq;  // number of quadrature states
 
 } sim_irk_dims;
 
@@ -72,6 +73,9 @@ typedef struct
     external_function_generic *conl_cost_fun_jac_hess;
     external_function_generic *conl_cost_fun;
 
+    // quadrature right hand side and jacobians wrt x, u, z (only if nq > 0)
+    external_function_generic *quad_fun_jac;
+
 } irk_model;
 
 
@@ -121,6 +125,16 @@ typedef struct
     //         if ( opts->sens_hess) - array of blasfeo_dmat to store intermediate results
     struct blasfeo_dmat *dG_dK;   // jacobian of G over K ((nx+nz)*ns, (nx+nz)*ns)
 
+    // only allocated if (opts->newton_decoupled)
+    struct blasfeo_dvec *rG_dec;       // transformed residual (nK)
+    struct blasfeo_dvec *dK_dec;       // Newton step in the ordering of K (nK)
+    // only allocated if (opts->newton_decoupled && opts->sens_forw)
+    struct blasfeo_dmat *dK_dxu_rhs;   // right hand side of the sensitivity system (nK, nx+nu)
+    struct blasfeo_dmat *dK_dxu_res;   // residual of the sensitivity system (nK, nx+nu)
+    struct blasfeo_dmat *dK_dxu_corr;  // correction of dK_dxu (nK, nx+nu)
+    struct blasfeo_dmat *dK_dxu_dec;   // transformed right hand side (nK, nx+nu)
+    struct blasfeo_dmat *dK_dxu_blk;   // right hand side of one block (2*(nx+nz), nx+nu)
+
     // ipiv: index of pivot vector
     //         if (!opts->sens_hess) - array (ns * (nx + nz)) that is reused
     //         if ( opts->sens_hess) - array (ns * (nx + nz)) * num_steps, to store all
@@ -152,6 +166,14 @@ typedef struct
     struct blasfeo_dmat *tmp_nv_ny;
     struct blasfeo_dmat *Jt_z;
 
+    /* the following variables are only available if (dims->nq > 0) */
+    struct blasfeo_dvec *quad_fun;      // quadrature rhs at a stage (nq)
+    struct blasfeo_dvec *quad_q;        // accumulated quadrature states (nq)
+    struct blasfeo_dmat *quad_jac_x;    // jacobian of the quadrature rhs w.r.t. x (nq, nx)
+    struct blasfeo_dmat *quad_jac_u;    // jacobian of the quadrature rhs w.r.t. u (nq, nu)
+    struct blasfeo_dmat *quad_jac_z;    // jacobian of the quadrature rhs w.r.t. z (nq, nz)
+    struct blasfeo_dmat *quad_S;        // accumulated sensitivities of quad_q (nq, nx+nu)
+    struct blasfeo_dmat *quad_S_stage;  // sensitivities of the stage state (nx, nx+nu)
 
 } sim_irk_workspace;
 
@@ -165,6 +187,20 @@ typedef struct
     double time_ad;
     double time_la;
 
+    // adaptive step size
+    double step_size;     // proposal for the first step of the next call, 0 if none
+    int num_steps_taken;  // number of accepted steps of the last call
+
+    // LU factors of dG_dK kept across calls, only if (opts->jac_reuse_across_calls)
+    struct blasfeo_dmat *dG_dK_lu;
+    int *ipiv_lu;
+    // LU factors of the decoupled Newton blocks, only if (opts->newton_decoupled);
+    // block l starts at stage l and has size (nx+nz) or 2*(nx+nz), see opts->B_mat
+    struct blasfeo_dmat *dG_dK_dec;
+    int *ipiv_dec;
+    bool lu_valid;   // false until the first factorization or after a contraction failure
+    double lu_step;  // step size the factors were computed for
+
     double *cost_fun;
     struct blasfeo_dmat *W_chol;  // cholesky factor of weight matrix
     struct blasfeo_dvec *y_ref;  // y_ref for NLS cost
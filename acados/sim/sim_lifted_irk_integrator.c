@@ -39,6 +39,7 @@
 // acados
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
+#include "acados/utils/math.h"
 
 #include "acados/sim/sim_common.h"
 
@@ -120,6 +121,11 @@ void sim_lifted_irk_dims_get(void *config_, void *dims_, const char *field, int
     {
         *value = dims->nz;
     }
+    else if (!strcmp(field, "nq"))
+    {
+        // quadrature states are not supported
+        *value = 0;
+    }
     else
     {
         printf("\nerror: sim_lifted_irk_dims_get: field not available: %s\n", field);
@@ -151,6 +157,11 @@ void *sim_lifted_irk_model_assign(void *config, void *dims, void *raw_memory)
     lifted_irk_model *data = (lifted_irk_model *) c_ptr;
     c_ptr += sizeof(lifted_irk_model);
 
+    data->impl_ode_fun = NULL;
+    data->impl_ode_fun_jac_x_xdot_u = NULL;
+    data->impl_ode_jac_x_xdot_u_z = NULL;
+    data->impl_ode_hess = NULL;
+
     assert((char *) raw_memory + sim_lifted_irk_model_calculate_size(config, dims) >= c_ptr);
 
     return data;
@@ -170,6 +181,15 @@ int sim_lifted_irk_model_set(void *model_, const char *field, void *value)
     {
         model->impl_ode_fun_jac_x_xdot_u = value;
     }
+    else if (!strcmp(field, "impl_ode_jac_x_xdot_u") || !strcmp(field, "impl_dae_jac_x_xdot_u") ||
+             !strcmp(field, "impl_ode_jac_x_xdot_u_z") || !strcmp(field, "impl_dae_jac_x_xdot_u_z"))
+    {
+        model->impl_ode_jac_x_xdot_u_z = value;
+    }
+    else if (!strcmp(field, "impl_ode_hess") || !strcmp(field, "impl_dae_hess"))
+    {
+        model->impl_ode_hess = value;
+    }
     else
     {
         printf("\nerror: sim_lifted_irk_model_set: wrong field: %s\n", field);
@@ -250,6 +270,8 @@ void sim_lifted_irk_opts_initialize_default(void *config_, void *dims_, void *op
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
+    opts->jac_reuse_across_calls = false;
+    opts->jac_reuse_contraction_max = 0.5;
 
     assert(opts->ns <= NS_MAX && "ns > NS_MAX!");
 
@@ -319,25 +341,38 @@ acados_size_t sim_lifted_irk_memory_calculate_size(void *config, void *dims_, vo
 
     int nx = dims->nx;
     int nu = dims->nu;
+    int nz = dims->nz;
+    int nK = ns * (nx + nz);
 
     int num_steps = opts->num_steps;
+    // jacobians of G are kept per step for the backward sweep; sens_adj, sens_hess and
+    // jac_reuse_across_calls can be changed after creation, their buffers are always allocated
+    int num_jac = num_steps;
 
     acados_size_t size = sizeof(sim_lifted_irk_memory);
 
     size += 1 * sizeof(struct blasfeo_dmat);            // S_forw
-    size += 2 * sizeof(struct blasfeo_dmat);            // JGK, JGf
+    size += 2 * num_jac * sizeof(struct blasfeo_dmat);  // JGK, JGf
     size += (num_steps) * sizeof(struct blasfeo_dmat);  // JKf
     size += (num_steps) * sizeof(struct blasfeo_dvec);  // K
     size += 2 * sizeof(struct blasfeo_dvec);            // x, u
 
     size += blasfeo_memsize_dmat(nx, nx + nu);                    // S_forw
-    size += blasfeo_memsize_dmat(nx * ns, nx * ns);               // JGK
-    size += 1 * blasfeo_memsize_dmat(nx * ns, nx + nu);           // JGf
-    size += (num_steps) *blasfeo_memsize_dmat(nx * ns, nx + nu);  // JKf
-    size += (num_steps) *blasfeo_memsize_dvec(nx * ns);           // K
+    size += num_jac * blasfeo_memsize_dmat(nK, nK);               // JGK
+    size += num_jac * blasfeo_memsize_dmat(nK, nx + nu);          // JGf
+    size += (num_steps) *blasfeo_memsize_dmat(nK, nx + nu);       // JKf
+    size += (num_steps) *blasfeo_memsize_dvec(nK);                // K
     size += 1 * blasfeo_memsize_dvec(nx);                         // x
     size += 1 * blasfeo_memsize_dvec(nu);                         // u
 
+    size += 1 * sizeof(struct blasfeo_dmat);  // JGK_lu
+    size += 1 * blasfeo_memsize_dmat(nK, nK);  // JGK_lu
+    size += nK * sizeof(int);  // ipiv_lu
+    size += num_steps * sizeof(struct blasfeo_dvec);  // lambdaK
+    size += num_steps * blasfeo_memsize_dvec(nK);  // lambdaK
+
+    size += (nx + nz) * sizeof(double);  // xdot, z
+
     size += 1 * 8; // initial align
     make_int_multiple_of(64, &size);
     size += 1 * 64;
@@ -358,8 +393,11 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
 
     int nx = dims->nx;
     int nu = dims->nu;
+    int nz = dims->nz;
+    int nK = ns * (nx + nz);
 
     int num_steps = opts->num_steps;
+    int num_jac = num_steps;
 
     // initial align
     align_char_to(8, &c_ptr);
@@ -370,11 +408,8 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
     memory->S_forw = (struct blasfeo_dmat *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dmat);
 
-    memory->JGK = (struct blasfeo_dmat *) c_ptr;
-    c_ptr += sizeof(struct blasfeo_dmat);
-
-    memory->JGf = (struct blasfeo_dmat *) c_ptr;
-    c_ptr += sizeof(struct blasfeo_dmat);
+    assign_and_advance_blasfeo_dmat_structs(num_jac, &memory->JGK, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(num_jac, &memory->JGf, &c_ptr);
 
     assign_and_advance_blasfeo_dmat_structs(num_steps, &memory->JKf, &c_ptr);
 
@@ -386,21 +421,33 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
     memory->u = (struct blasfeo_dvec *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dvec);
 
+    assign_and_advance_blasfeo_dmat_structs(1, &memory->JGK_lu, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_steps, &memory->lambdaK, &c_ptr);
+
     align_char_to(64, &c_ptr);
 
     assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, memory->S_forw, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx * ns, nx * ns, memory->JGK, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx * ns, nx + nu, memory->JGf, &c_ptr);
+    for (int i = 0; i < num_jac; i++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nK, nK, &memory->JGK[i], &c_ptr);
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, &memory->JGf[i], &c_ptr);
+    }
     for (int i = 0; i < num_steps; i++)
     {
-        assign_and_advance_blasfeo_dmat_mem(nx * ns, nx + nu, &memory->JKf[i], &c_ptr);
-        blasfeo_dgese(nx * ns, nx + nu, 0.0, &memory->JKf[i], 0, 0);
+        assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, &memory->JKf[i], &c_ptr);
+        blasfeo_dgese(nK, nx + nu, 0.0, &memory->JKf[i], 0, 0);
     }
+    assign_and_advance_blasfeo_dmat_mem(nK, nK, memory->JGK_lu, &c_ptr);
 
     for (int i = 0; i < num_steps; i++)
     {
-        assign_and_advance_blasfeo_dvec_mem(nx * ns, &memory->K[i], &c_ptr);
-        blasfeo_dvecse(nx * ns, 0.0, &memory->K[i], 0);
+        assign_and_advance_blasfeo_dvec_mem(nK, &memory->K[i], &c_ptr);
+        blasfeo_dvecse(nK, 0.0, &memory->K[i], 0);
+    }
+    for (int i = 0; i < num_steps; i++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nK, &memory->lambdaK[i], &c_ptr);
+        blasfeo_dvecse(nK, 0.0, &memory->lambdaK[i], 0);
     }
 
     assign_and_advance_blasfeo_dvec_mem(nx, memory->x, &c_ptr);
@@ -408,7 +455,20 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
     assign_and_advance_blasfeo_dvec_mem(nu, memory->u, &c_ptr);
     blasfeo_dvecse(nu, 0.0, memory->u, 0);
 
-    // memory->init_K = 0;
+    assign_and_advance_double(nx, &memory->xdot, &c_ptr);
+    assign_and_advance_double(nz, &memory->z, &c_ptr);
+    for (int ii = 0; ii < nx; ii++)
+        memory->xdot[ii] = 0.0;
+    for (int ii = 0; ii < nz; ii++)
+        memory->z[ii] = 0.0;
+
+    assign_and_advance_int(nK, &memory->ipiv_lu, &c_ptr);
+
+    memory->lu_valid = false;
+    memory->lu_step = 0.0;
+    memory->newton_step_norm_prev = 0.0;
+
+    memory->init_K = 0;
 
     // TODO(andrea): need to move this to options.
     memory->update_sens = 1;
@@ -423,38 +483,48 @@ void *sim_lifted_irk_memory_assign(void *config, void *dims_, void *opts_, void
 
 int sim_lifted_irk_memory_set(void *config_, void *dims_, void *mem_, const char *field, void *value)
 {
-    // sim_config *config = config_;
-    // sim_lifted_irk_memory *mem = (sim_lifted_irk_memory *) mem_;
-
-    printf("sim_lifted_irk_memory_set field %s is not supported! \n", field);
-    exit(1);
-
-    // sim_config *config = config_;
-    // sim_lifted_irk_memory *mem = (sim_lifted_irk_memory *) mem_;
-    // if (!strcmp(field, "xdot_guess"))
-    // {
-    //     int nx;
-    //     config->dims_get(config_, dims_, "nx", &nx);
-    //     double *xdot = value;
-    //     blasfeo_pack_dvec(nx, xdot, 0, &mem->K[0], 0);
-    //     mem->init_K = 1;
-    // }
-    // else if (!strcmp(field, "guesses_blasfeo"))
-    // {
-    //     int nx, nz;
-    //     config->dims_get(config_, dims_, "nx", &nx);
-    //     config->dims_get(config_, dims_, "nz", &nz);
-
-    //     struct blasfeo_dvec *sim_guess = (struct blasfeo_dvec *) value;
-    //     blasfeo_dveccp(nx+nz, sim_guess, 0, &mem->K[0], 0);
-    //     mem->init_K = 1;
-    // }
-    // else
-    // {
-    //     printf("sim_lifted_irk_memory_set field %s is not supported! \n", field);
-    //     exit(1);
-    // }
-    // return ACADOS_SUCCESS;
+    sim_config *config = config_;
+    sim_lifted_irk_memory *mem = (sim_lifted_irk_memory *) mem_;
+
+    int status = ACADOS_SUCCESS;
+
+    // guesses are spread over all stages and steps in the next call
+    if (!strcmp(field, "xdot"))
+    {
+        int nx;
+        config->dims_get(config_, dims_, "nx", &nx);
+        double *xdot = value;
+        for (int ii = 0; ii < nx; ii++)
+            mem->xdot[ii] = xdot[ii];
+        mem->init_K = 1;
+    }
+    else if (!strcmp(field, "z"))
+    {
+        int nz;
+        config->dims_get(config_, dims_, "nz", &nz);
+        double *z = value;
+        for (int ii = 0; ii < nz; ii++)
+            mem->z[ii] = z[ii];
+        mem->init_K = 1;
+    }
+    else if (!strcmp(field, "guesses_blasfeo"))
+    {
+        int nx, nz;
+        config->dims_get(config_, dims_, "nx", &nx);
+        config->dims_get(config_, dims_, "nz", &nz);
+
+        struct blasfeo_dvec *sim_guess = (struct blasfeo_dvec *) value;
+        blasfeo_unpack_dvec(nx, sim_guess, 0, mem->xdot, 1);
+        blasfeo_unpack_dvec(nz, sim_guess, nx, mem->z, 1);
+        mem->init_K = 1;
+    }
+    else
+    {
+        printf("sim_lifted_irk_memory_set field %s is not supported! \n", field);
+        exit(1);
+    }
+
+    return status;
 }
 
 
@@ -469,12 +539,18 @@ int sim_lifted_irk_memory_set_to_zero(void *config_, void * dims_, void *opts_,
 
     if (!strcmp(field, "guesses"))
     {
-        int nx;
+        int nx, nz, nu;
         config->dims_get(config_, dims_, "nx", &nx);
+        config->dims_get(config_, dims_, "nz", &nz);
+        config->dims_get(config_, dims_, "nu", &nu);
+        int nK = opts->ns * (nx + nz);
         for (int i = 0; i < opts->num_steps; i++)
         {
-            blasfeo_dvecse(nx * opts->ns, 0.0, &mem->K[i], 0);
+            blasfeo_dvecse(nK, 0.0, &mem->K[i], 0);
+            blasfeo_dgese(nK, nx + nu, 0.0, &mem->JKf[i], 0, 0);
+            blasfeo_dvecse(nK, 0.0, &mem->lambdaK[i], 0);
         }
+        mem->lu_valid = false;
     }
     else
     {
@@ -528,22 +604,47 @@ acados_size_t sim_lifted_irk_workspace_calculate_size(void *config_, void *dims_
 
     int nx = dims->nx;
     int nu = dims->nu;
+    int nz = dims->nz;
+    int nK = ns * (nx + nz);
+
+    int num_steps = opts->num_steps;
 
     acados_size_t size = sizeof(sim_lifted_irk_workspace);
 
-    size += 3 * sizeof(struct blasfeo_dmat);  // J_temp_x, J_temp_xdot, J_temp_u
+    size += 4 * sizeof(struct blasfeo_dmat);  // J_temp_x, J_temp_xdot, J_temp_u, J_temp_z
 
     size += 5 * sizeof(struct blasfeo_dvec);  // rG, xt, xn, xn_out, dxn
     size += 1 * sizeof(struct blasfeo_dvec);  // w ([x; u])
 
-    size += 2 * blasfeo_memsize_dmat(nx, nx);  // J_temp_x, J_temp_xdot
-    size += blasfeo_memsize_dmat(nx, nu);      // J_temp_u
+    size += 2 * blasfeo_memsize_dmat(nx + nz, nx);  // J_temp_x, J_temp_xdot
+    size += blasfeo_memsize_dmat(nx + nz, nu);      // J_temp_u
+    size += blasfeo_memsize_dmat(nx + nz, nz);      // J_temp_z
 
-    size += 1 * blasfeo_memsize_dvec(nx * ns);  // rG
+    size += 1 * blasfeo_memsize_dvec(nK);       // rG
     size += 4 * blasfeo_memsize_dvec(nx);       // xt, xn, xn_out, dxn
     size += blasfeo_memsize_dvec(nx + nu);      // w
 
-    size += nx * ns * sizeof(int);  // ipiv
+    // backward sweep: trajectory of the forward sweep and adjoint variables
+    size += 2 * num_steps * sizeof(struct blasfeo_dvec);  // xn_traj, K_traj
+    size += 3 * sizeof(struct blasfeo_dvec);  // lambda, lambdaK, lambdaK_res
+    size += num_steps * blasfeo_memsize_dvec(nx);  // xn_traj
+    size += num_steps * blasfeo_memsize_dvec(nK);  // K_traj
+    size += blasfeo_memsize_dvec(nx + nu);  // lambda
+    size += 2 * blasfeo_memsize_dvec(nK);  // lambdaK, lambdaK_res
+
+    // hessian propagation
+    size += (num_steps + 4) * sizeof(struct blasfeo_dmat);  // S_forw_traj, f_hess, ...
+    size += num_steps * blasfeo_memsize_dmat(nx, nx + nu);  // S_forw_traj
+    size += blasfeo_memsize_dmat(2*nx+nz+nu, 2*nx+nz+nu);  // f_hess
+    size += 2 * blasfeo_memsize_dmat(2*nx+nz+nu, nx+nu);  // dxkzu_dw0, tmp_dxkzu_dw0
+    size += blasfeo_memsize_dmat(nx + nu, nx + nu);  // Hess
+
+    size += sizeof(struct blasfeo_dmat);  // JKf_res
+    size += blasfeo_memsize_dmat(nK, nx + nu);  // JKf_res
+
+    size += ns * sizeof(double);  // Z_work
+
+    size += num_steps * nK * sizeof(int);  // ipiv
 
     make_int_multiple_of(64, &size);
     size += 1 * 64;
@@ -563,6 +664,10 @@ static void *sim_lifted_irk_cast_workspace(void *config_, void *dims_, void *opt
 
     int nx = dims->nx;
     int nu = dims->nu;
+    int nz = dims->nz;
+    int nK = ns * (nx + nz);
+
+    int num_steps = opts->num_steps;
 
     char *c_ptr = (char *) raw_memory;
 
@@ -576,6 +681,8 @@ static void *sim_lifted_irk_cast_workspace(void *config_, void *dims_, void *opt
     c_ptr += sizeof(struct blasfeo_dmat);
     workspace->J_temp_u = (struct blasfeo_dmat *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dmat);
+    workspace->J_temp_z = (struct blasfeo_dmat *) c_ptr;
+    c_ptr += sizeof(struct blasfeo_dmat);
 
     workspace->rG = (struct blasfeo_dvec *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dvec);
@@ -595,20 +702,55 @@ static void *sim_lifted_irk_cast_workspace(void *config_, void *dims_, void *opt
     workspace->w = (struct blasfeo_dvec *) c_ptr;
     c_ptr += sizeof(struct blasfeo_dvec);
 
+    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->xn_traj, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(num_steps, &workspace->K_traj, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambda, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambdaK, &c_ptr);
+    assign_and_advance_blasfeo_dvec_structs(1, &workspace->lambdaK_res, &c_ptr);
+
+    assign_and_advance_blasfeo_dmat_structs(num_steps, &workspace->S_forw_traj, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->f_hess, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->dxkzu_dw0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->tmp_dxkzu_dw0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->Hess, &c_ptr);
+
+    assign_and_advance_blasfeo_dmat_structs(1, &workspace->JKf_res, &c_ptr);
+
     align_char_to(64, &c_ptr);
 
-    assign_and_advance_blasfeo_dmat_mem(nx, nx, workspace->J_temp_x, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx, nx, workspace->J_temp_xdot, &c_ptr);
-    assign_and_advance_blasfeo_dmat_mem(nx, nu, workspace->J_temp_u, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx + nz, nx, workspace->J_temp_x, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx + nz, nx, workspace->J_temp_xdot, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx + nz, nu, workspace->J_temp_u, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx + nz, nz, workspace->J_temp_z, &c_ptr);
+
+    for (int i = 0; i < num_steps; i++)
+        assign_and_advance_blasfeo_dmat_mem(nx, nx + nu, &workspace->S_forw_traj[i], &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(2*nx+nz+nu, 2*nx+nz+nu, workspace->f_hess, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(2*nx+nz+nu, nx+nu, workspace->dxkzu_dw0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(2*nx+nz+nu, nx+nu, workspace->tmp_dxkzu_dw0, &c_ptr);
+    assign_and_advance_blasfeo_dmat_mem(nx + nu, nx + nu, workspace->Hess, &c_ptr);
+
+    assign_and_advance_blasfeo_dmat_mem(nK, nx + nu, workspace->JKf_res, &c_ptr);
 
-    assign_and_advance_blasfeo_dvec_mem(nx * ns, workspace->rG, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nK, workspace->rG, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xt, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xn, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->xn_out, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx, workspace->dxn, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->w, &c_ptr);
 
-    assign_and_advance_int(nx * ns, &workspace->ipiv, &c_ptr);
+    for (int i = 0; i < num_steps; i++)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nx, &workspace->xn_traj[i], &c_ptr);
+        assign_and_advance_blasfeo_dvec_mem(nK, &workspace->K_traj[i], &c_ptr);
+    }
+    assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
+    assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK_res, &c_ptr);
+
+    assign_and_advance_double(ns, &workspace->Z_work, &c_ptr);
+
+    assign_and_advance_int(num_steps * nK, &workspace->ipiv, &c_ptr);
 
     assert((char *) raw_memory +
                sim_lifted_irk_workspace_calculate_size(config_, dims, opts_) >=
@@ -646,11 +788,14 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         (sim_lifted_irk_workspace *) sim_lifted_irk_cast_workspace(config, dims, opts,
                                                                            work_);
 
+    lifted_irk_model *model = in->model;
+
     int nx = dims->nx;
     int nu = dims->nu;
     int nz = dims->nz;
 
     int ns = opts->ns;
+    int nK = ns * (nx + nz);
 
     if ( opts->ns != opts->tableau_size )
     {
@@ -658,19 +803,25 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         exit(1);
     }
     // assert - only use supported features
-    if (nz != 0)
+    if (nz > 0 && model->impl_ode_jac_x_xdot_u_z == NULL)
+    {
+        printf("\nerror: sim_lifted_irk: nz > 0 requires impl_dae_jac_x_xdot_u_z\n");
+        exit(1);
+    }
+    if (opts->exact_z_output)
     {
-        printf("nz should be zero - DAEs are not supported by the lifted IRK integrator");
+        printf("\nerror: sim_lifted_irk: exact_z_output is not supported\n");
         exit(1);
     }
-    if (opts->output_z)
+    if (opts->sens_hess && model->impl_ode_hess == NULL)
     {
-        printf("opts->output_z should be false - DAEs are not supported for the lifted IRK integrator");
+        printf("\nerror: sim_lifted_irk: sens_hess requires impl_dae_hess\n");
         exit(1);
     }
-    if (opts->sens_algebraic)
+    if (!mem->update_sens && (opts->sens_adj || opts->sens_hess))
     {
-        printf("opts->sens_algebraic should be false - DAEs are not supported for the lifted IRK integrator");
+        printf("\nerror: sim_lifted_irk: sens_adj and sens_hess require update_sens, "
+               "the backward sweep needs the factorized jacobians of the current call\n");
         exit(1);
     }
 
@@ -689,16 +840,29 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
     int num_steps = opts->num_steps;
 
     double step = in->T / num_steps;
+    double t_current;
     // TODO(FreyJo): this should be an option!
     int update_sens = mem->update_sens;
 
+    // jacobians of each step are kept for the backward sweep
+    bool store_traj = opts->sens_adj || opts->sens_hess;
+    // inexact Newton: the factorization of JGK is kept across calls and the lifted
+    // sensitivities are updated by one iteration with it instead of an exact solve
+    bool inexact = opts->jac_reuse_across_calls;
+
     int *ipiv = workspace->ipiv;
+    int *ipiv_ss;
     struct blasfeo_dmat *JGK = mem->JGK;
+    struct blasfeo_dmat *JGK_ss;
+    struct blasfeo_dmat *JGf_ss;
+    struct blasfeo_dmat *JGK_fact;  // factorized Newton matrix
+    int *ipiv_fact;
     struct blasfeo_dmat *S_forw = mem->S_forw;
 
     struct blasfeo_dmat *J_temp_x = workspace->J_temp_x;
     struct blasfeo_dmat *J_temp_xdot = workspace->J_temp_xdot;
     struct blasfeo_dmat *J_temp_u = workspace->J_temp_u;
+    struct blasfeo_dmat *J_temp_z = workspace->J_temp_z;
 
     struct blasfeo_dvec *rG = workspace->rG;
     struct blasfeo_dvec *K = mem->K;
@@ -711,89 +875,169 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
 
     struct blasfeo_dvec *w = workspace->w;
 
+    // for adjoint and hessian propagation
+    struct blasfeo_dvec *xn_traj = workspace->xn_traj;
+    struct blasfeo_dvec *K_traj = workspace->K_traj;
+    struct blasfeo_dvec *lambda = workspace->lambda;
+    struct blasfeo_dvec *lambdaK = workspace->lambdaK;
+    struct blasfeo_dvec *lambdaK_res = workspace->lambdaK_res;
+    struct blasfeo_dmat *S_forw_traj = workspace->S_forw_traj;
+    struct blasfeo_dmat *f_hess = workspace->f_hess;
+    struct blasfeo_dmat *dxkzu_dw0 = workspace->dxkzu_dw0;
+    struct blasfeo_dmat *tmp_dxkzu_dw0 = workspace->tmp_dxkzu_dw0;
+    struct blasfeo_dmat *Hess = workspace->Hess;
+    struct blasfeo_dmat *JKf_res = workspace->JKf_res;
+    double *Z_work = workspace->Z_work;
+
     double *x_out = out->xn;
-    double *S_forw_out = out->S_forw;
 
+    // input: x, xdot (part of K), u, z (part of K), t
     struct blasfeo_dvec_args ext_fun_in_K;
-
-    ext_fun_arg_t ext_fun_type_in[4];
-    void *ext_fun_in[4];
-    // TODO: fix this for z
-    ext_fun_type_in[3] = COLMAJ;
-    ext_fun_in[3] = u;
-
+    struct blasfeo_dvec_args ext_fun_in_Z;
+
+    ext_fun_arg_t ext_fun_type_in[5];
+    void *ext_fun_in[5];
+    ext_fun_type_in[0] = BLASFEO_DVEC;
+    ext_fun_in[0] = xt;  // x: nx
+    ext_fun_type_in[1] = BLASFEO_DVEC_ARGS;
+    ext_fun_in[1] = &ext_fun_in_K;  // K[ii*nx]: nx
+    ext_fun_type_in[2] = COLMAJ;
+    ext_fun_in[2] = u;  // u: nu
+    ext_fun_type_in[3] = BLASFEO_DVEC_ARGS;
+    ext_fun_in[3] = &ext_fun_in_Z;  // K[ns*nx+ii*nz]: nz
+    ext_fun_type_in[4] = COLMAJ;
+    ext_fun_in[4] = &t_current;  // t
 
     struct blasfeo_dvec_args ext_fun_out_rG;
+    ext_fun_out_rG.x = rG;
     ext_fun_arg_t ext_fun_type_out[5];
     void *ext_fun_out[5];
 
-    lifted_irk_model *model = in->model;
+    // impl_ode_hess: x, xdot, u, z, multiplier, t
+    struct blasfeo_dvec_args hess_in_lambda;
+    ext_fun_arg_t hess_type_in[6];
+    void *hess_in[6];
+    hess_type_in[0] = BLASFEO_DVEC;
+    hess_in[0] = xt;
+    hess_type_in[1] = BLASFEO_DVEC_ARGS;
+    hess_in[1] = &ext_fun_in_K;
+    hess_type_in[2] = COLMAJ;
+    hess_in[2] = u;
+    hess_type_in[3] = BLASFEO_DVEC_ARGS;
+    hess_in[3] = &ext_fun_in_Z;
+    hess_type_in[4] = BLASFEO_DVEC_ARGS;
+    hess_in[4] = &hess_in_lambda;
+    hess_type_in[5] = COLMAJ;
+    hess_in[5] = &t_current;
+
+    ext_fun_arg_t hess_type_out[1];
+    void *hess_out[1];
+    hess_type_out[0] = BLASFEO_DMAT;
+    hess_out[0] = f_hess;
 
     acados_timer timer, timer_ad, timer_la;
     double timing_ad = 0.0;
     out->info->LAtime = 0.0;
+    out->info->lu_fact = 0;
+    out->info->newton_iter = 0;
 
-    if (opts->sens_hess)
-    {
-        printf("LIFTED_IRK with HESSIAN PROPAGATION - NOT IMPLEMENTED YET - EXITING.");
-        exit(1);
-    }
-    if (opts->sens_adj)
+    double newton_step_norm;
+    double newton_step_norm_max = 0.0;
+
+    // initialize the lifted variables from the guesses
+    if (mem->init_K)
     {
-        printf("LIFTED_IRK with ADJOINT SENSITIVITIES - NOT IMPLEMENTED YET - EXITING.");
-        exit(1);
+        for (ss = 0; ss < num_steps; ss++)
+        {
+            for (ii = 0; ii < ns; ii++)
+            {
+                blasfeo_pack_dvec(nx, mem->xdot, 1, &K[ss], ii * nx);
+                blasfeo_pack_dvec(nz, mem->z, 1, &K[ss], ns * nx + ii * nz);
+            }
+            blasfeo_dgese(nK, nx + nu, 0.0, &JKf[ss], 0, 0);
+        }
+        // no expansion step on guesses
+        blasfeo_pack_dvec(nx, in->x, 1, mem->x, 0);
+        blasfeo_pack_dvec(nu, in->u, 1, mem->u, 0);
+        mem->init_K = 0;
     }
 
-    // if (mem->init_K)
-    // {
-    //     for (ss = 0; ss < num_steps; ss++)
-    //     {
-    //         for (ii = 0; ii < ns; ii++)
-    //         {
-    //             if (!(ii == 0 && ss == 0))
-    //                 blasfeo_dveccp(nx, &mem->K[0], 0, &mem->K[ss], ii*nx);
-    //         }
-    //     }
-    //     mem->init_K = 0;
-    // }
+    blasfeo_dgese(nx + nz, nx, 0.0, J_temp_x, 0, 0);
+    blasfeo_dgese(nx + nz, nx, 0.0, J_temp_xdot, 0, 0);
+    blasfeo_dgese(nx + nz, nu, 0.0, J_temp_u, 0, 0);
+    blasfeo_dgese(nx + nz, nz, 0.0, J_temp_z, 0, 0);
 
-    blasfeo_dgese(nx, nx, 0.0, J_temp_x, 0, 0);
-    blasfeo_dgese(nx, nx, 0.0, J_temp_xdot, 0, 0);
-    blasfeo_dgese(nx, nu, 0.0, J_temp_x, 0, 0);
-
-    blasfeo_dvecse(nx * ns, 0.0, rG, 0);
+    blasfeo_dvecse(nK, 0.0, rG, 0);
 
     // TODO(dimitris): shouldn't this be NF instead of nx+nu??
-    if (update_sens) blasfeo_pack_dmat(nx, nx + nu, S_forw_in, nx, S_forw, 0, 0);
+    if (update_sens)
+    {
+        if (in->identity_seed)
+        {
+            blasfeo_dgese(nx, nx + nu, 0.0, S_forw, 0, 0);
+            blasfeo_ddiare(nx, 1.0, S_forw, 0, 0);
+        }
+        else
+        {
+            blasfeo_pack_dmat(nx, nx + nu, S_forw_in, nx, S_forw, 0, 0);
+        }
+    }
 
-    blasfeo_dvecse(nx * ns, 0.0, rG, 0);
     blasfeo_pack_dvec(nx, x, 1, xn, 0);
     blasfeo_pack_dvec(nx, x, 1, xn_out, 0);
     blasfeo_dvecse(nx, 0.0, dxn, 0);
 
+    // expansion step (K variables): change of x and u since the last call
+    blasfeo_pack_dvec(nx, in->x, 1, w, 0);
+    blasfeo_pack_dvec(nu, in->u, 1, w, nx);
+    blasfeo_daxpy(nx, -1.0, mem->x, 0, w, 0, w, 0);
+    blasfeo_daxpy(nu, -1.0, mem->u, 0, w, nx, w, nx);
+
+    blasfeo_pack_dvec(nx, in->x, 1, mem->x, 0);
+    blasfeo_pack_dvec(nu, in->u, 1, mem->u, 0);
+
+    // inexact Newton: refactorize if the step size changed
+    if (inexact && mem->lu_valid && mem->lu_step != step)
+        mem->lu_valid = false;
 
     // start the loop
     acados_tic(&timer);
     for (ss = 0; ss < num_steps; ss++)
     {
-        // initialize
-        blasfeo_dgese(nx * ns, nx * ns, 0.0, JGK, 0, 0);
-        blasfeo_dgese(nx * ns, nx + nu, 0.0, JGf, 0, 0);
+        if (store_traj)
+        {
+            JGK_ss = &JGK[ss];
+            JGf_ss = &JGf[ss];
+            ipiv_ss = inexact ? ipiv : ipiv + ss * nK;
+        }
+        else
+        {
+            JGK_ss = JGK;
+            JGf_ss = JGf;
+            ipiv_ss = ipiv;
+        }
 
-        // expansion step (K variables)
-        // compute x and u step
-        blasfeo_pack_dvec(nx, in->x, 1, w, 0);
-        blasfeo_pack_dvec(nu, in->u, 1, w, nx);
+        // initialize, without update_sens the jacobians of the previous call are used
+        if (update_sens)
+        {
+            blasfeo_dgese(nK, nK, 0.0, JGK_ss, 0, 0);
+            blasfeo_dgese(nK, nx + nu, 0.0, JGf_ss, 0, 0);
+        }
 
-        blasfeo_daxpy(nx, -1.0, mem->x, 0, w, 0, w, 0);
-        blasfeo_daxpy(nu, -1.0, mem->u, 0, w, nx, w, nx);
-        blasfeo_dgemv_n(nx * ns, nx + nu, 1.0, &JKf[ss], 0, 0, w, 0, 1.0, &K[ss], 0, &K[ss], 0);
+        // expansion step, K = K + dK/dw * dw, where dK/dw = -JKf
+        blasfeo_dgemv_n(nK, nx + nu, -1.0, &JKf[ss], 0, 0, w, 0, 1.0, &K[ss], 0, &K[ss], 0);
 
-        blasfeo_pack_dvec(nx, in->x, 1, mem->x, 0);
-        blasfeo_pack_dvec(nu, in->u, 1, mem->u, 0);
+        // store the linearization point for the backward sweep
+        if (store_traj)
+        {
+            blasfeo_dveccp(nx, xn, 0, &xn_traj[ss], 0);
+            blasfeo_dveccp(nK, &K[ss], 0, &K_traj[ss], 0);
+        }
+        if (opts->sens_hess)
+            blasfeo_dgecp(nx, nx + nu, S_forw, 0, 0, &S_forw_traj[ss], 0, 0);
 
-        // reset value of JKf
-        blasfeo_dgese(nx * ns, nx + nu, 0.0, &JKf[ss], 0, 0);
+        ext_fun_in_K.x = &K[ss];
+        ext_fun_in_Z.x = &K[ss];
 
         for (ii = 0; ii < ns; ii++)  // ii-th row of tableau
         {
@@ -810,49 +1054,41 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
                     blasfeo_daxpy(nx, a, &K[ss], jj * nx, xt, 0, xt, 0);
                 }
             }
+            t_current = in->t0 + ss * step + opts->c_vec[ii] * step;
+
+            ext_fun_in_K.xi = ii * nx;  // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
+            ext_fun_in_Z.xi = ns * nx + ii * nz;  // use z_i of K
 
-            if (!update_sens)
+            ext_fun_type_out[0] = BLASFEO_DVEC_ARGS;
+            ext_fun_out_rG.xi = ii * (nx + nz);
+            ext_fun_out[0] = &ext_fun_out_rG;  // fun: nx+nz
+
+            acados_tic(&timer_ad);
+            if (!update_sens || nz > 0)
             {
                 // compute the residual of implicit ode at time t_ii, store value in rGt
-                acados_tic(&timer_ad);
-
-                ext_fun_type_in[0] = BLASFEO_DVEC;
-                ext_fun_in[0] = xt;  // x: nx
-                ext_fun_type_in[1] = BLASFEO_DVEC_ARGS;
-                ext_fun_in_K.xi = ii * nx;
-                ext_fun_in_K.x = &K[ss];
-                ext_fun_in[1] = &ext_fun_in_K;  // K[ii*nx]: nx
-                ext_fun_type_in[2] = COLMAJ;
-                ext_fun_in[2] = u;  // u: nu
-
-                ext_fun_type_out[0] = BLASFEO_DVEC_ARGS;
-                ext_fun_out_rG.x = rG;
-                ext_fun_out_rG.xi = ii * nx;
-                ext_fun_out[0] = &ext_fun_out_rG;  // fun: nx
-
                 model->impl_ode_fun->evaluate(model->impl_ode_fun, ext_fun_type_in, ext_fun_in,
                                               ext_fun_type_out, ext_fun_out);
+            }
+            if (update_sens && nz > 0)
+            {
+                // compute the jacobians of the implicit dae
+                ext_fun_type_out[0] = BLASFEO_DMAT;
+                ext_fun_out[0] = J_temp_x;  // jac_x: (nx+nz)*nx
+                ext_fun_type_out[1] = BLASFEO_DMAT;
+                ext_fun_out[1] = J_temp_xdot;  // jac_xdot: (nx+nz)*nx
+                ext_fun_type_out[2] = BLASFEO_DMAT;
+                ext_fun_out[2] = J_temp_u;  // jac_u: (nx+nz)*nu
+                ext_fun_type_out[3] = BLASFEO_DMAT;
+                ext_fun_out[3] = J_temp_z;  // jac_z: (nx+nz)*nz
 
-                timing_ad += acados_toc(&timer_ad);
+                model->impl_ode_jac_x_xdot_u_z->evaluate(model->impl_ode_jac_x_xdot_u_z,
+                                                         ext_fun_type_in, ext_fun_in,
+                                                         ext_fun_type_out, ext_fun_out);
             }
-            else
+            else if (update_sens)
             {
-                // compute the jacobian of implicit ode
-                acados_tic(&timer_ad);
-
-                ext_fun_type_in[0] = BLASFEO_DVEC;
-                ext_fun_in[0] = xt;  // x: nx
-                ext_fun_type_in[1] = BLASFEO_DVEC_ARGS;
-                ext_fun_in_K.xi = ii * nx;  // K[ii*nx]: nx
-                ext_fun_in_K.x = &K[ss];
-                ext_fun_in[1] = &ext_fun_in_K;
-                ext_fun_type_in[2] = COLMAJ;
-                ext_fun_in[2] = u;  // u: nu
-
-                ext_fun_type_out[0] = BLASFEO_DVEC_ARGS;
-                ext_fun_out_rG.x = rG;
-                ext_fun_out_rG.xi = ii * nx;
-                ext_fun_out[0] = &ext_fun_out_rG;  // fun: nx
+                // compute the residual and the jacobians of the implicit ode
                 ext_fun_type_out[1] = BLASFEO_DMAT;
                 ext_fun_out[1] = J_temp_x;  // jac_x: nx*nx
                 ext_fun_type_out[2] = BLASFEO_DMAT;
@@ -863,11 +1099,13 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
                 model->impl_ode_fun_jac_x_xdot_u->evaluate(model->impl_ode_fun_jac_x_xdot_u,
                                                            ext_fun_type_in, ext_fun_in,
                                                            ext_fun_type_out, ext_fun_out);
+            }
+            timing_ad += acados_toc(&timer_ad);
 
-                timing_ad += acados_toc(&timer_ad);
-
-                blasfeo_dgecp(nx, nx, J_temp_x, 0, 0, JGf, ii * nx, 0);
-                blasfeo_dgecp(nx, nu, J_temp_u, 0, 0, JGf, ii * nx, nx);
+            if (update_sens)
+            {
+                blasfeo_dgecp(nx + nz, nx, J_temp_x, 0, 0, JGf_ss, ii * (nx + nz), 0);
+                blasfeo_dgecp(nx + nz, nu, J_temp_u, 0, 0, JGf_ss, ii * (nx + nz), nx);
 
                 for (jj = 0; jj < ns; jj++)
                 {
@@ -876,11 +1114,13 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
                     if (a != 0)
                     {
                         a *= step;
-                        blasfeo_dgead(nx, nx, a, J_temp_x, 0, 0, JGK, ii * nx, jj * nx);
+                        blasfeo_dgead(nx + nz, nx, a, J_temp_x, 0, 0, JGK_ss, ii * (nx + nz), jj * nx);
                     }
                     if (jj == ii)
                     {
-                        blasfeo_dgead(nx, nx, 1, J_temp_xdot, 0, 0, JGK, ii * nx, jj * nx);
+                        blasfeo_dgead(nx + nz, nx, 1, J_temp_xdot, 0, 0, JGK_ss, ii * (nx + nz), jj * nx);
+                        blasfeo_dgead(nx + nz, nz, 1, J_temp_z, 0, 0, JGK_ss, ii * (nx + nz),
+                                      ns * nx + jj * nz);
                     }
                 }  // end jj
             }
@@ -892,51 +1132,90 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
 
         // DGETRF computes an LU factorization of a general M-by-N matrix A
         // using partial pivoting with row interchanges.
-
-        if (update_sens)
+        acados_tic(&timer_la);
+        if (inexact)
         {
-            blasfeo_dgetrf_rp(nx * ns, nx * ns, JGK, 0, 0, JGK, 0, 0, ipiv);
+            // factorization kept in memory, JGK_ss stays available for the residuals
+            if (!mem->lu_valid)
+            {
+                blasfeo_dgecp(nK, nK, JGK_ss, 0, 0, mem->JGK_lu, 0, 0);
+                blasfeo_dgetrf_rp(nK, nK, mem->JGK_lu, 0, 0, mem->JGK_lu, 0, 0, mem->ipiv_lu);
+                out->info->lu_fact++;
+                mem->lu_valid = true;
+                mem->lu_step = step;
+            }
+            JGK_fact = mem->JGK_lu;
+            ipiv_fact = mem->ipiv_lu;
         }
+        else
+        {
+            if (update_sens)
+            {
+                blasfeo_dgetrf_rp(nK, nK, JGK_ss, 0, 0, JGK_ss, 0, 0, ipiv_ss);
+                out->info->lu_fact++;
+            }
+            JGK_fact = JGK_ss;
+            ipiv_fact = ipiv_ss;
+        }
+
+        // one (lifted) Newton iteration per integration step
+        out->info->newton_iter++;
 
         // update r.h.s (6.23, Quirynen2017)
-        blasfeo_dgemv_n(nx * ns, nx, 1.0, JGf, 0, 0, dxn, 0, 1.0, rG, 0, rG, 0);
+        blasfeo_dgemv_n(nK, nx, 1.0, JGf_ss, 0, 0, dxn, 0, 1.0, rG, 0, rG, 0);
 
 
         // permute also the r.h.s
-        blasfeo_dvecpe(nx * ns, ipiv, rG, 0);
+        blasfeo_dvecpe(nK, ipiv_fact, rG, 0);
 
         // solve JGK * y = rG, JGK on the (l)eft, (l)ower-trian, (n)o-trans
         //                    (u)nit trian
-        blasfeo_dtrsv_lnu(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
+        blasfeo_dtrsv_lnu(nK, JGK_fact, 0, 0, rG, 0, rG, 0);
 
         // solve JGK * x = rG, JGK on the (l)eft, (u)pper-trian, (n)o-trans
         //                    (n)o unit trian , and store x in rG
-        blasfeo_dtrsv_unn(nx * ns, JGK, 0, 0, rG, 0, rG, 0);
+        blasfeo_dtrsv_unn(nK, JGK_fact, 0, 0, rG, 0, rG, 0);
+        out->info->LAtime += acados_toc(&timer_la);
 
 
         // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is DeltaK
-        blasfeo_daxpy(nx * ns, -1.0, rG, 0, &K[ss], 0, &K[ss], 0);
+        blasfeo_daxpy(nK, -1.0, rG, 0, &K[ss], 0, &K[ss], 0);
+
+        blasfeo_dvecnrm_inf(nK, rG, 0, &newton_step_norm);
+        if (newton_step_norm > newton_step_norm_max)
+            newton_step_norm_max = newton_step_norm;
 
         // obtain dx(n)
         for (ii = 0; ii < ns; ii++)
             blasfeo_daxpy(nx, -step * b_vec[ii], rG, ii * nx, dxn, 0, dxn, 0);
 
         // update JKf
-        // JKf[ss] = JGf * S_forw;
+        // right hand side JGf * S_forw
+        struct blasfeo_dmat *JKf_rhs = inexact ? JKf_res : &JKf[ss];
         if (in->identity_seed && ss == 0) // omit matrix multiplication for identity seed
-            blasfeo_dgecp(nx * ns, nx + nu, JGf, 0, 0, &JKf[ss], 0, 0);
+            blasfeo_dgecp(nK, nx + nu, JGf_ss, 0, 0, JKf_rhs, 0, 0);
         else
         {
-            blasfeo_dgemm_nn(nx * ns, nx + nu, nx, 1.0, JGf, 0, 0, S_forw, 0, 0, 0.0, &JKf[ss], 0, 0,
-                            &JKf[ss], 0, 0);
-            blasfeo_dgead(nx * ns, nu, 1.0, JGf, 0, nx, &JKf[ss], 0, nx);
+            blasfeo_dgemm_nn(nK, nx + nu, nx, 1.0, JGf_ss, 0, 0, S_forw, 0, 0, 0.0, JKf_rhs, 0, 0,
+                            JKf_rhs, 0, 0);
+            blasfeo_dgead(nK, nu, 1.0, JGf_ss, 0, nx, JKf_rhs, 0, nx);
         }
 
-        // solve linear system
         acados_tic(&timer_la);
-        blasfeo_drowpe(nx * ns, ipiv, &JKf[ss]);
-        blasfeo_dtrsm_llnu(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
-        blasfeo_dtrsm_lunn(nx * ns, nx + nu, 1.0, JGK, 0, 0, &JKf[ss], 0, 0, &JKf[ss], 0, 0);
+        if (inexact)
+        {
+            // JKf_res = JGK * JKf - JGf * S_forw
+            blasfeo_dgemm_nn(nK, nx + nu, nK, 1.0, JGK_ss, 0, 0, &JKf[ss], 0, 0, -1.0,
+                             JKf_res, 0, 0, JKf_res, 0, 0);
+        }
+
+        // solve linear system
+        blasfeo_drowpe(nK, ipiv_fact, JKf_rhs);
+        blasfeo_dtrsm_llnu(nK, nx + nu, 1.0, JGK_fact, 0, 0, JKf_rhs, 0, 0, JKf_rhs, 0, 0);
+        blasfeo_dtrsm_lunn(nK, nx + nu, 1.0, JGK_fact, 0, 0, JKf_rhs, 0, 0, JKf_rhs, 0, 0);
+
+        if (inexact)
+            blasfeo_dgead(nK, nx + nu, -1.0, JKf_res, 0, 0, &JKf[ss], 0, 0);
         out->info->LAtime += acados_toc(&timer_la);
 
         // update forward sensitivity
@@ -947,13 +1226,151 @@ int sim_lifted_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *m
         for (ii = 0; ii < ns; ii++)
             blasfeo_daxpy(nx, step * b_vec[ii], &K[ss], ii * nx, xn_out, 0, xn_out, 0);
 
+        // algebraic variables output and sensitivities at the start of the interval
+        if (ss == 0 && nz > 0 && (opts->output_z || opts->sens_algebraic))
+        {
+            for (ii = 0; ii < nz; ii++)
+            {
+                for (jj = 0; jj < ns; jj++)
+                    Z_work[jj] = blasfeo_dvecex1(&K[0], nx * ns + nz * jj + ii);
+                // eval polynomial through (c_jj, z_jj) at 0.
+                neville_algorithm(0.0, ns - 1, opts->c_vec, Z_work, &out->zn[ii]);
+            }
+            if (opts->sens_algebraic)
+            {
+                double interpolated_value;
+                for (jj = 0; jj < nx + nu; jj++)
+                {
+                    for (ii = 0; ii < nz; ii++)
+                    {
+                        for (int kk = 0; kk < ns; kk++)
+                            Z_work[kk] = blasfeo_dgeex1(&JKf[0], nx * ns + kk * nz + ii, jj);
+                        neville_algorithm(0.0, ns - 1, opts->c_vec, Z_work, &interpolated_value);
+                        if (out->dzduxt != NULL)  // [u; x] rows
+                            blasfeo_dgein1(-interpolated_value, out->dzduxt,
+                                           jj < nx ? nu + jj : jj - nx, ii);
+                        else
+                            out->S_algebraic[ii + jj * nz] = -interpolated_value;
+                    }
+                }
+            }
+        }
+
     }  // end int step ss
 
+    // inexact Newton: refresh the factorization if the lifted iteration contracts slowly
+    if (inexact)
+    {
+        if (mem->newton_step_norm_prev > 0.0 && newton_step_norm_max >
+                opts->jac_reuse_contraction_max * mem->newton_step_norm_prev)
+            mem->lu_valid = false;
+        mem->newton_step_norm_prev = newton_step_norm_max;
+    }
+
+    /************************************************
+    * Backward Sweep
+    *       - adjoint sensitivities & symmetric hessian propagation
+    *         at the linearization point of the forward sweep
+    ************************************************/
+    if (store_traj)
+    {
+        blasfeo_pack_dvec(nx + nu, in->S_adj, 1, lambda, 0);
+        if (opts->sens_hess)
+            blasfeo_dgese(nx + nu, nx + nu, 0.0, Hess, 0, 0);
+
+        for (ss = num_steps - 1; ss > -1; ss--)
+        {
+            JGK_ss = &JGK[ss];
+            JGf_ss = &JGf[ss];
+
+            // right hand side: lambdaK_jj = -step b_jj * lambda_x
+            blasfeo_dvecse(nK, 0.0, lambdaK_res, 0);
+            for (jj = 0; jj < ns; jj++)
+                blasfeo_dveccpsc(nx, -step * b_vec[jj], lambda, 0, lambdaK_res, jj * nx);
+
+            acados_tic(&timer_la);
+            if (inexact)
+            {
+                // lifted adjoint: lambdaK = lambdaK - JGK_lu^-T (JGK^T lambdaK - rhs)
+                blasfeo_dgemv_t(nK, nK, 1.0, JGK_ss, 0, 0, &mem->lambdaK[ss], 0, -1.0,
+                                lambdaK_res, 0, lambdaK_res, 0);
+                blasfeo_dtrsv_utn(nK, mem->JGK_lu, 0, 0, lambdaK_res, 0, lambdaK_res, 0);
+                blasfeo_dtrsv_ltu(nK, mem->JGK_lu, 0, 0, lambdaK_res, 0, lambdaK_res, 0);
+                blasfeo_dvecpei(nK, mem->ipiv_lu, lambdaK_res, 0);
+                blasfeo_daxpy(nK, -1.0, lambdaK_res, 0, &mem->lambdaK[ss], 0,
+                              &mem->lambdaK[ss], 0);
+                blasfeo_dveccp(nK, &mem->lambdaK[ss], 0, lambdaK, 0);
+            }
+            else
+            {
+                // JGK_ss - already factorized in the forward sweep
+                blasfeo_dtrsv_utn(nK, JGK_ss, 0, 0, lambdaK_res, 0, lambdaK, 0);
+                blasfeo_dtrsv_ltu(nK, JGK_ss, 0, 0, lambdaK, 0, lambdaK, 0);
+                blasfeo_dvecpei(nK, ipiv + ss * nK, lambdaK, 0);
+            }
+            out->info->LAtime += acados_toc(&timer_la);
+
+            // lambda = lambda + JGf' * lambdaK
+            blasfeo_dgemv_t(nK, nx + nu, 1.0, JGf_ss, 0, 0, lambdaK, 0, 1.0, lambda, 0,
+                            lambda, 0);
+
+            if (opts->sens_hess)
+            {
+                ext_fun_in_K.x = &K_traj[ss];
+                ext_fun_in_Z.x = &K_traj[ss];
+                hess_in_lambda.x = lambdaK;
+
+                for (ii = 0; ii < ns; ii++)
+                {
+                    // dxkzu_dw0 = [dxt_dw0; dk_dw0; dz_dw0; du_dw0] at stage ii
+                    blasfeo_dgecp(nx, nx + nu, &S_forw_traj[ss], 0, 0, dxkzu_dw0, 0, 0);
+                    blasfeo_dveccp(nx, &xn_traj[ss], 0, xt, 0);
+                    for (jj = 0; jj < ns; jj++)
+                    {
+                        a = A_mat[ii + ns * jj] * step;
+                        blasfeo_daxpy(nx, a, &K_traj[ss], jj * nx, xt, 0, xt, 0);
+                        blasfeo_dgead(nx, nx + nu, -a, &JKf[ss], jj * nx, 0, dxkzu_dw0, 0, 0);
+                    }
+                    blasfeo_dgecpsc(nx, nx + nu, -1.0, &JKf[ss], ii * nx, 0, dxkzu_dw0, nx, 0);
+                    blasfeo_dgecpsc(nz, nx + nu, -1.0, &JKf[ss], ns * nx + ii * nz, 0,
+                                    dxkzu_dw0, 2 * nx, 0);
+                    blasfeo_dgese(nu, nx + nu, 0.0, dxkzu_dw0, 2 * nx + nz, 0);
+                    blasfeo_ddiare(nu, 1.0, dxkzu_dw0, 2 * nx + nz, nx);
+
+                    ext_fun_in_K.xi = ii * nx;
+                    ext_fun_in_Z.xi = ns * nx + ii * nz;
+                    hess_in_lambda.xi = ii * (nx + nz);
+                    t_current = in->t0 + ss * step + opts->c_vec[ii] * step;
+
+                    acados_tic(&timer_ad);
+                    model->impl_ode_hess->evaluate(model->impl_ode_hess, hess_type_in, hess_in,
+                                                   hess_type_out, hess_out);
+                    timing_ad += acados_toc(&timer_ad);
+
+                    // Hess += dxkzu_dw0' * f_hess * dxkzu_dw0, exploit that du_dw0 is [0, I]
+                    blasfeo_dgemm_nn(2*nx+nz+nu, nx+nu, 2*nx+nz, 1.0, f_hess, 0, 0, dxkzu_dw0, 0, 0,
+                                     0.0, tmp_dxkzu_dw0, 0, 0, tmp_dxkzu_dw0, 0, 0);
+                    blasfeo_dgead(2*nx+nz+nu, nu, 1.0, f_hess, 0, 2*nx+nz, tmp_dxkzu_dw0, 0, nx);
+                    blasfeo_dsyrk_ut(nx+nu, 2*nx+nz, 1.0, dxkzu_dw0, 0, 0, tmp_dxkzu_dw0, 0, 0,
+                                     1.0, Hess, 0, 0, Hess, 0, 0);
+                    blasfeo_dgead(nu, nx+nu, 1.0, tmp_dxkzu_dw0, 2*nx+nz, 0, Hess, nx, 0);
+                }  // end ii
+            }
+        }  // end ss
+
+        blasfeo_unpack_dvec(nx + nu, lambda, 0, out->S_adj, 1);
+        if (opts->sens_hess)
+        {
+            blasfeo_dtrtr_u(nx + nu, Hess, 0, 0, Hess, 0, 0);
+            blasfeo_unpack_dmat(nx + nu, nx + nu, Hess, 0, 0, out->S_hess, nx + nu);
+        }
+    }
+
 
     // extract output
     blasfeo_unpack_dvec(nx, xn_out, 0, x_out, 1);
 
-    blasfeo_unpack_dmat(nx, nx + nu, S_forw, 0, 0, S_forw_out, nx);
+    sim_out_set_forw_sens(nx, nu, S_forw, 0, 0, out);
 
     out->info->CPUtime = acados_toc(&timer);
     out->info->ADtime = timing_ad;
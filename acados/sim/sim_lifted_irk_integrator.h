@@ -55,6 +55,10 @@ typedef struct
     external_function_generic *impl_ode_fun;
     // implicit ode & jax_x & jac_xdot & jac_u implicit ode
     external_function_generic *impl_ode_fun_jac_x_xdot_u;
+    // jac_x & jac_xdot & jac_u & jac_z implicit dae, replaces the above if nz > 0
+    external_function_generic *impl_ode_jac_x_xdot_u_z;
+    // hessian of the implicit dae times a multiplier, for sens_hess
+    external_function_generic *impl_ode_hess;
 
 } lifted_irk_model;
 
@@ -63,18 +67,38 @@ typedef struct
 typedef struct
 {
 
-    struct blasfeo_dmat *J_temp_x;     // temporary Jacobian of ode w.r.t x (nx, nx)
-    struct blasfeo_dmat *J_temp_xdot;  // temporary Jacobian of ode w.r.t xdot (nx, nx)
-    struct blasfeo_dmat *J_temp_u;     // temporary Jacobian of ode w.r.t u (nx, nu)
+    struct blasfeo_dmat *J_temp_x;     // temporary Jacobian of ode w.r.t x (nx+nz, nx)
+    struct blasfeo_dmat *J_temp_xdot;  // temporary Jacobian of ode w.r.t xdot (nx+nz, nx)
+    struct blasfeo_dmat *J_temp_u;     // temporary Jacobian of ode w.r.t u (nx+nz, nu)
+    struct blasfeo_dmat *J_temp_z;     // temporary Jacobian of ode w.r.t z (nx+nz, nz)
 
-    struct blasfeo_dvec *rG;      // residuals of G (nx*ns)
+    struct blasfeo_dvec *rG;      // residuals of G (nK)
     struct blasfeo_dvec *xt;      // temporary x
     struct blasfeo_dvec *xn;      // x at each integration step (for evaluations)
     struct blasfeo_dvec *xn_out;  // x at each integration step (output)
     struct blasfeo_dvec *dxn;     // dx at each integration step
     struct blasfeo_dvec *w;       // stacked x and u
 
-    int *ipiv;  // index of pivot vector
+    // used if (sens_adj || sens_hess)
+    struct blasfeo_dvec *xn_traj;  // xn at the start of each step (num_steps x nx)
+    struct blasfeo_dvec *K_traj;   // linearization point of each step (num_steps x nK)
+    struct blasfeo_dvec *lambda;   // adjoint sensitivities (nx+nu)
+    struct blasfeo_dvec *lambdaK;  // adjoint sensitivities of the stage variables (nK)
+    struct blasfeo_dvec *lambdaK_res;  // residual of the lifted adjoint system (nK), inexact only
+
+    // used if (sens_hess)
+    struct blasfeo_dmat *S_forw_traj;   // S_forw at the start of each step (num_steps x (nx, nx+nu))
+    struct blasfeo_dmat *f_hess;        // hessian of the dae (2*nx+nz+nu, 2*nx+nz+nu)
+    struct blasfeo_dmat *dxkzu_dw0;     // stage sensitivities (2*nx+nz+nu, nx+nu)
+    struct blasfeo_dmat *tmp_dxkzu_dw0; // (2*nx+nz+nu, nx+nu)
+    struct blasfeo_dmat *Hess;          // propagated hessian (nx+nu, nx+nu)
+
+    // used if inexact Newton (jac_reuse_across_calls)
+    struct blasfeo_dmat *JKf_res;  // residual of the lifted sensitivity system (nK, nx+nu)
+
+    double *Z_work;  // interpolation of the algebraic variables (ns), only if nz > 0
+
+    int *ipiv;  // index of pivot vector (num_steps x nK)
 
 } sim_lifted_irk_workspace;
 
@@ -82,18 +106,30 @@ typedef struct
 
 typedef struct
 {
-    // memory for lifted integrators
+    // memory for lifted integrators; the buffers for adjoints, hessians and inexact Newton
+    // are always allocated, since the options can be changed after creation
     struct blasfeo_dmat *S_forw;    // forward sensitivities
-    struct blasfeo_dmat *JGK;       // jacobian of G over K (nx*ns, nx*ns)
-    struct blasfeo_dmat *JGf;       // jacobian of G over x and u (nx*ns, nx+nu);
-    struct blasfeo_dmat *JKf;       // jacobian of K over x and u (nx*ns, nx+nu);
+    struct blasfeo_dmat *JGK;       // jacobian of G over K (nK, nK), per step
+    struct blasfeo_dmat *JGf;       // jacobian of G over x and u (nK, nx+nu), per step as JGK
+    struct blasfeo_dmat *JKf;       // jacobian of K over x and u (nK, nx+nu), per step
 
-    struct blasfeo_dvec *K;         // internal variables (nx*ns)
+    struct blasfeo_dvec *K;         // internal variables (nK), per step
+    struct blasfeo_dvec *lambdaK;   // lifted adjoint variables (nK), per step, inexact only
     struct blasfeo_dvec *x;         // states (nx) -- for expansion step
     struct blasfeo_dvec *u;         // controls (nu) -- for expansion step
 
+    // inexact Newton (jac_reuse_across_calls): factorization of JGK kept across calls
+    struct blasfeo_dmat *JGK_lu;    // (nK, nK)
+    int *ipiv_lu;                   // (nK)
+    bool lu_valid;                  // false until the first factorization
+    double lu_step;                 // step size the factorization was computed with
+    double newton_step_norm_prev;   // max norm of the last K update
+
+    double *xdot;  // guess for the state derivatives (nx)
+    double *z;     // guess for the algebraic variables (nz)
+
     int update_sens;
-    // int init_K;
+    int init_K;  // initialize K from xdot, z in the next call
 
 	double time_sim;
 	double time_ad;
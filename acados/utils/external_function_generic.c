@@ -120,6 +120,32 @@ void external_function_param_generic_assign(external_function_param_generic *fun
 
 
 
+acados_size_t external_function_param_generic_calculate_size_shared(external_function_param_generic *fun, int np)
+{
+    acados_size_t size = external_function_param_generic_calculate_size(fun, np);
+
+    // parameters are stored in the shared block
+    size -= fun->np * sizeof(double);
+
+    return size;
+}
+
+
+
+void external_function_param_generic_assign_shared(external_function_param_generic *fun, void *raw_memory,
+                                                   double *p_shared)
+{
+    // save initial pointer to external memory
+    fun->ptr_ext_mem = raw_memory;
+
+    // p
+    fun->p = p_shared;
+
+    return;
+}
+
+
+
 void external_function_param_generic_wrapper(void *self, ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *type_out, void **out)
 {
 	// TODO somehow check on types ?????
@@ -193,148 +219,77 @@ static int casadi_nnz(const int *sparsity)
 
 
 
-static void d_cvt_casadi_to_colmaj(double *in, int *sparsity_in, double *out)
+static void casadi_arg_plan_init(const int *sparsity, external_function_casadi_arg_plan *plan)
 {
-    int ii, jj, idx;
-
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
-    int dense = sparsity_in[2];
-
-    if ((nrow<=0 )| (ncol<=0))
+    plan->nrow = 0;
+    plan->ncol = 0;
+    plan->nnz = 0;
+    plan->dense = 1;
+    plan->row = NULL;
+    plan->col = NULL;
+
+    if (sparsity == NULL)
         return;
 
-    if (dense)
-    {
-        for (ii = 0; ii < ncol * nrow; ii++) out[ii] = in[ii];
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
-        // Fill with zeros
-        for (jj = 0; jj < ncol; jj++)
-            for (ii = 0; ii < nrow; ii++) out[ii + jj * nrow] = 0.0;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                out[row[idx] + jj * nrow] = ptr[0];
-                ptr++;
-            }
-        }
-    }
+    plan->nrow = sparsity[0];
+    plan->ncol = sparsity[1];
+    plan->nnz = casadi_nnz(sparsity);
+    // compact dense format, or compressed column format without structural zeros:
+    // in both cases the casadi data is the column-major matrix
+    plan->dense = sparsity[2] | (plan->nnz == plan->nrow * plan->ncol);
 
     return;
 }
 
 
 
-static void d_cvt_colmaj_to_casadi(double *in, double *out, int *sparsity_out)
+// number of ints needed by the scatter lists of the plans of num casadi arguments
+static int casadi_arg_plans_int_size(int num, const int *(*sparsity)(int))
 {
-    int ii, jj, idx;
+    external_function_casadi_arg_plan plan;
+    int size = 0;
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
-    int dense = sparsity_out[2];
-
-    if ((nrow<=0 )| (ncol<=0))
-        return;
-
-    if (dense)
-    {
-        for (ii = 0; ii < ncol * nrow; ii++) out[ii] = in[ii];
-    }
-    else
+    for (int ii = 0; ii < num; ii++)
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                ptr[0] = in[row[idx] + jj * nrow];
-                ptr++;
-            }
-        }
+        casadi_arg_plan_init(sparsity(ii), &plan);
+        if (!plan.dense)
+            size += 2 * plan.nnz;  // row, col
     }
 
-    return;
+    return size;
 }
 
 
 
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_casadi_to_dmat(double *in, int *sparsity_in, struct blasfeo_dmat *out)
+static void casadi_arg_plans_assign(int num, const int *(*sparsity)(int),
+                                    external_function_casadi_arg_plan *plans, char **c_ptr)
 {
-    int jj, idx;
+    int jj, idx, kk;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
-    int dense = sparsity_in[2];
-
-    if ((nrow<=0 )| (ncol<=0))
-        return;
-
-    if (dense)
+    for (int ii = 0; ii < num; ii++)
     {
-        blasfeo_pack_dmat(nrow, ncol, in, nrow, out, 0, 0);
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
-        // Fill with zeros
-        blasfeo_dgese(nrow, ncol, 0.0, out, 0, 0);
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
-        {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                BLASFEO_DMATEL(out, row[idx], jj) = ptr[0];
-                ptr++;
-            }
-        }
-    }
+        const int *sp = sparsity(ii);
+        external_function_casadi_arg_plan *plan = plans + ii;
 
-    return;
-}
-
-
-
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_dmat_to_casadi(struct blasfeo_dmat *in, double *out, int *sparsity_out)
-{
-    int jj, idx;
+        casadi_arg_plan_init(sp, plan);
 
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
-    int dense = sparsity_out[2];
+        if (plan->dense)
+            continue;
 
-    if ((nrow<=0 )| (ncol<=0))
-        return;
+        assign_and_advance_int(plan->nnz, &plan->row, c_ptr);
+        assign_and_advance_int(plan->nnz, &plan->col, c_ptr);
 
-    if (dense)
-    {
-        blasfeo_unpack_dmat(nrow, ncol, in, 0, 0, out, nrow);
-    }
-    else
-    {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
+        // scatter list in the order of the casadi nonzeros
+        const int *idxcol = sp + 2;
+        const int *row = sp + plan->ncol + 3;
+        kk = 0;
+        for (jj = 0; jj < plan->ncol; jj++)
         {
             for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
             {
-                ptr[0] = BLASFEO_DMATEL(in, row[idx], jj);
-                ptr++;
+                plan->row[kk] = row[idx];
+                plan->col[kk] = jj;
+                kk++;
             }
         }
     }
@@ -344,156 +299,157 @@ static void d_cvt_dmat_to_casadi(struct blasfeo_dmat *in, double *out, int *spar
 
 
 
-// column vector: assume sparsity_in[1] = 1 !!! or empty vector;
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_casadi_to_dvec(double *in, int *sparsity_in, struct blasfeo_dvec *out)
+// returns 1 if the nnz doubles at ptr overlap one of the input arguments aliased to caller memory
+static int casadi_res_overlaps_args(double *ptr, int nnz, int in_num, double **args,
+                                    double **args_mem, external_function_casadi_arg_plan *args_plan)
 {
-    int idx;
-
-    assert((sparsity_in[1] == 1) | (sparsity_in[0] == 0) | (sparsity_in[1] == 0));
-
-    int n = sparsity_in[0];
-    int dense = sparsity_in[2];
-
-    if (n<=0)
-        return;
-
-    if (dense)
+    for (int ii = 0; ii < in_num; ii++)
     {
-        blasfeo_pack_dvec(n, in, 1, out, 0);
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + 1 + 3;
-        // Fill with zeros
-        blasfeo_dvecse(n, 0.0, out, 0);
-        // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            BLASFEO_DVECEL(out, row[idx]) = ptr[0];
-            ptr++;
-        }
+        if (args[ii] == args_mem[ii])
+            continue;
+        if ((ptr < args[ii] + args_plan[ii].nnz) & (args[ii] < ptr + nnz))
+            return 1;
     }
 
-    return;
+    return 0;
 }
 
 
 
-// column vector: assume sparsity_in[1] = 1 !!! or empty vector;
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_dvec_to_casadi(struct blasfeo_dvec *in, double *out, int *sparsity_out)
+// set casadi argument arg from input in, either as alias of in or gathered into mem
+static void d_cvt_in_to_casadi(ext_fun_arg_t type, void *in, external_function_casadi_arg_plan *plan,
+                               double *mem, double **arg, int idx_arg)
 {
-    int idx;
+    int ii, jj, kk;
 
-    assert((sparsity_out[1] == 1) | (sparsity_out[0] == 0) | (sparsity_out[1] == 0));
+    int nrow = plan->nrow;
+    int ncol = plan->ncol;
+    int nnz = plan->nnz;
+    int *row = plan->row;
+    int *col = plan->col;
 
-    int n = sparsity_out[0];
-    int dense = sparsity_out[2];
+    *arg = mem;
 
-    if (n<=0)
-        return;
-
-    if (dense)
+    switch (type)
     {
-        blasfeo_unpack_dvec(n, in, 0, out, 1);
-    }
-    else
-    {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + 1 + 3;
-        // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
+        case COLMAJ:
         {
-            ptr[0] = BLASFEO_DVECEL(in, row[idx]);
-            ptr++;
+            double *A = in;
+            if (plan->dense)
+            {
+                *arg = A;
+            }
+            else
+            {
+                for (kk = 0; kk < nnz; kk++) mem[kk] = A[row[kk] + col[kk] * nrow];
+            }
+            break;
         }
-    }
 
-    return;
-}
-
-
-
-static void d_cvt_casadi_to_colmaj_args(double *in, int *sparsity_in, struct colmaj_args *out)
-{
-    int ii, jj, idx;
-
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
-    int dense = sparsity_in[2];
-
-    if ((nrow<=0 )| (ncol<=0))
-        return;
-
-    double *A = out->A;
-    int lda = out->lda;
-
-    if (dense)
-    {
-        for (ii = 0; ii < ncol; ii++)
-            for (jj = 0; jj < nrow; jj++) A[ii + jj * lda] = in[ii + ncol * jj];
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
-        // Fill with zeros
-        for (jj = 0; jj < ncol; jj++)
-            for (ii = 0; ii < nrow; ii++) A[ii + jj * lda] = 0.0;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
+        case COLMAJ_ARGS:
         {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+            struct colmaj_args *A_args = in;
+            double *A = A_args->A;
+            int lda = A_args->lda;
+            if (plan->dense & (lda == nrow))
+            {
+                *arg = A;
+            }
+            else if (plan->dense)
             {
-                A[row[idx] + jj * lda] = ptr[0];
-                ptr++;
+                for (jj = 0; jj < ncol; jj++)
+                    for (ii = 0; ii < nrow; ii++) mem[ii + jj * nrow] = A[ii + jj * lda];
             }
+            else
+            {
+                for (kk = 0; kk < nnz; kk++) mem[kk] = A[row[kk] + col[kk] * lda];
+            }
+            break;
         }
-    }
 
-    return;
-}
-
-
-
-static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, int *sparsity_out)
-{
-    int ii, jj, idx;
-
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
-    int dense = sparsity_out[2];
+        case BLASFEO_DMAT:
+        {
+            struct blasfeo_dmat *A = in;
+            if ((nrow <= 0) | (ncol <= 0))
+                break;
+            // panel-major: no alias possible, packed gather
+            if (plan->dense)
+            {
+                blasfeo_unpack_dmat(nrow, ncol, A, 0, 0, mem, nrow);
+            }
+            else
+            {
+                for (kk = 0; kk < nnz; kk++) mem[kk] = BLASFEO_DMATEL(A, row[kk], col[kk]);
+            }
+            break;
+        }
 
-    if ((nrow<=0 )| (ncol<=0))
-        return;
+        case BLASFEO_DMAT_ARGS:
+        {
+            struct blasfeo_dmat_args *A_args = in;
+            struct blasfeo_dmat *A = A_args->A;
+            int ai = A_args->ai;
+            int aj = A_args->aj;
+            if ((nrow <= 0) | (ncol <= 0))
+                break;
+            if (plan->dense)
+            {
+                blasfeo_unpack_dmat(nrow, ncol, A, ai, aj, mem, nrow);
+            }
+            else
+            {
+                for (kk = 0; kk < nnz; kk++)
+                    mem[kk] = BLASFEO_DMATEL(A, ai + row[kk], aj + col[kk]);
+            }
+            break;
+        }
 
-    double *A = in->A;
-    int lda = in->lda;
+        case BLASFEO_DVEC:
+        {
+            // column vector: assume ncol = 1 !!! or empty vector
+            assert((ncol == 1) | (nrow == 0) | (ncol == 0));
+            struct blasfeo_dvec *x = in;
+            if (nrow <= 0)
+                break;
+            if (plan->dense)
+            {
+                *arg = &BLASFEO_DVECEL(x, 0);
+            }
+            else
+            {
+                for (kk = 0; kk < nnz; kk++) mem[kk] = BLASFEO_DVECEL(x, row[kk]);
+            }
+            break;
+        }
 
-    if (dense)
-    {
-        for (ii = 0; ii < ncol; ii++)
-            for (jj = 0; jj < nrow; jj++) out[ii + ncol * jj] = A[ii + jj * lda];
-    }
-    else
-    {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
+        case BLASFEO_DVEC_ARGS:
         {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+            // column vector: assume ncol = 1 !!! or empty vector
+            assert((ncol == 1) | (nrow == 0) | (ncol == 0));
+            struct blasfeo_dvec_args *x_args = in;
+            struct blasfeo_dvec *x = x_args->x;
+            int xi = x_args->xi;
+            if (nrow <= 0)
+                break;
+            if (plan->dense)
+            {
+                *arg = &BLASFEO_DVECEL(x, xi);
+            }
+            else
             {
-                ptr[0] = A[row[idx] + jj * lda];
-                ptr++;
+                for (kk = 0; kk < nnz; kk++) mem[kk] = BLASFEO_DVECEL(x, xi + row[kk]);
             }
+            break;
         }
+
+        case IGNORE_ARGUMENT:
+            // do nothing
+            break;
+
+        default:
+            printf("\ntype in %d\n", type);
+            printf("\nUnknown external function argument type for argument %i\n\n", idx_arg);
+            exit(1);
     }
 
     return;
@@ -501,124 +457,173 @@ static void d_cvt_colmaj_args_to_casadi(struct colmaj_args *in, double *out, int
 
 
 
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_casadi_to_dmat_args(double *in, int *sparsity_in, struct blasfeo_dmat_args *out)
+// pointer to the caller memory of a dense output, if casadi can write it in place; NULL otherwise
+static double *casadi_res_alias(ext_fun_arg_t type, void *out, external_function_casadi_arg_plan *plan)
 {
-    int jj, idx;
+    if (!plan->dense)
+        return NULL;
 
-    int nrow = sparsity_in[0];
-    int ncol = sparsity_in[1];
-    int dense = sparsity_in[2];
+    switch (type)
+    {
+        case COLMAJ:
+            return out;
 
-    if ((nrow<=0 )| (ncol<=0))
-        return;
+        case COLMAJ_ARGS:
+        {
+            struct colmaj_args *A_args = out;
+            return A_args->lda == plan->nrow ? A_args->A : NULL;
+        }
 
-    struct blasfeo_dmat *A = out->A;
-    int ai = out->ai;
-    int aj = out->aj;
+        case BLASFEO_DVEC:
+            return plan->nrow > 0 ? &BLASFEO_DVECEL((struct blasfeo_dvec *) out, 0) : NULL;
 
-    if (dense)
-    {
-        blasfeo_pack_dmat(nrow, ncol, in, nrow, A, ai, aj);
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + ncol + 3;
-        // Fill with zeros
-        blasfeo_dgese(nrow, ncol, 0.0, A, ai, aj);
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
+        case BLASFEO_DVEC_ARGS:
         {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
-            {
-                BLASFEO_DMATEL(A, ai + row[idx], aj + jj) = ptr[0];
-                ptr++;
-            }
+            struct blasfeo_dvec_args *x_args = out;
+            return plan->nrow > 0 ? &BLASFEO_DVECEL(x_args->x, x_args->xi) : NULL;
         }
-    }
 
-    return;
+        default:
+            return NULL;
+    }
 }
 
 
 
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_dmat_args_to_casadi(struct blasfeo_dmat_args *in, double *out, int *sparsity_out)
+// write casadi result res into output out, scattering the nonzeros
+static void d_cvt_casadi_to_out(ext_fun_arg_t type, double *res, external_function_casadi_arg_plan *plan,
+                                void *out, int idx_res)
 {
-    int jj, idx;
-
-    int nrow = sparsity_out[0];
-    int ncol = sparsity_out[1];
-    int dense = sparsity_out[2];
-
-    if ((nrow<=0 )| (ncol<=0))
-        return;
+    int ii, jj, kk;
 
-    struct blasfeo_dmat *A = in->A;
-    int ai = in->ai;
-    int aj = in->aj;
+    int nrow = plan->nrow;
+    int ncol = plan->ncol;
+    int nnz = plan->nnz;
+    int *row = plan->row;
+    int *col = plan->col;
 
-    if (dense)
-    {
-        blasfeo_unpack_dmat(nrow, ncol, A, ai, aj, out, nrow);
-    }
-    else
+    switch (type)
     {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + ncol + 3;
-        // Copy nonzeros
-        for (jj = 0; jj < ncol; jj++)
+        case COLMAJ:
         {
-            for (idx = idxcol[jj]; idx != idxcol[jj + 1]; idx++)
+            double *A = out;
+            if (plan->dense)
+            {
+                for (kk = 0; kk < nnz; kk++) A[kk] = res[kk];
+            }
+            else
             {
-                ptr[0] = BLASFEO_DMATEL(A, ai + row[idx], aj + jj);
-                ptr++;
+                for (kk = 0; kk < nrow * ncol; kk++) A[kk] = 0.0;
+                for (kk = 0; kk < nnz; kk++) A[row[kk] + col[kk] * nrow] = res[kk];
             }
+            break;
         }
-    }
-
-    return;
-}
 
+        case COLMAJ_ARGS:
+        {
+            struct colmaj_args *A_args = out;
+            double *A = A_args->A;
+            int lda = A_args->lda;
+            if (plan->dense)
+            {
+                for (jj = 0; jj < ncol; jj++)
+                    for (ii = 0; ii < nrow; ii++) A[ii + jj * lda] = res[ii + jj * nrow];
+            }
+            else
+            {
+                for (jj = 0; jj < ncol; jj++)
+                    for (ii = 0; ii < nrow; ii++) A[ii + jj * lda] = 0.0;
+                for (kk = 0; kk < nnz; kk++) A[row[kk] + col[kk] * lda] = res[kk];
+            }
+            break;
+        }
 
+        case BLASFEO_DMAT:
+        {
+            struct blasfeo_dmat *A = out;
+            if ((nrow <= 0) | (ncol <= 0))
+                break;
+            if (plan->dense)
+            {
+                blasfeo_pack_dmat(nrow, ncol, res, nrow, A, 0, 0);
+            }
+            else
+            {
+                blasfeo_dgese(nrow, ncol, 0.0, A, 0, 0);
+                for (kk = 0; kk < nnz; kk++) BLASFEO_DMATEL(A, row[kk], col[kk]) = res[kk];
+            }
+            break;
+        }
 
-// column vector: assume sparsity_in[1] = 1 !!! or empty vector;
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_casadi_to_dvec_args(double *in, int *sparsity_in, struct blasfeo_dvec_args *out)
-{
-    int idx;
-
-    assert((sparsity_in[1] == 1) | (sparsity_in[0] == 0) | (sparsity_in[1] == 0));
-
-    int n = sparsity_in[0];
-    int dense = sparsity_in[2];
-
-    if (n<=0)
-        return;
+        case BLASFEO_DMAT_ARGS:
+        {
+            struct blasfeo_dmat_args *A_args = out;
+            struct blasfeo_dmat *A = A_args->A;
+            int ai = A_args->ai;
+            int aj = A_args->aj;
+            if ((nrow <= 0) | (ncol <= 0))
+                break;
+            if (plan->dense)
+            {
+                blasfeo_pack_dmat(nrow, ncol, res, nrow, A, ai, aj);
+            }
+            else
+            {
+                blasfeo_dgese(nrow, ncol, 0.0, A, ai, aj);
+                for (kk = 0; kk < nnz; kk++)
+                    BLASFEO_DMATEL(A, ai + row[kk], aj + col[kk]) = res[kk];
+            }
+            break;
+        }
 
-    struct blasfeo_dvec *x = out->x;
-    int xi = out->xi;
+        case BLASFEO_DVEC:
+        {
+            // column vector: assume ncol = 1 !!! or empty vector
+            assert((ncol == 1) | (nrow == 0) | (ncol == 0));
+            struct blasfeo_dvec *x = out;
+            if (nrow <= 0)
+                break;
+            if (plan->dense)
+            {
+                blasfeo_pack_dvec(nrow, res, 1, x, 0);
+            }
+            else
+            {
+                blasfeo_dvecse(nrow, 0.0, x, 0);
+                for (kk = 0; kk < nnz; kk++) BLASFEO_DVECEL(x, row[kk]) = res[kk];
+            }
+            break;
+        }
 
-    if (dense)
-    {
-        blasfeo_pack_dvec(n, in, 1, x, xi);
-    }
-    else
-    {
-        double *ptr = in;
-        int *idxcol = sparsity_in + 2;
-        int *row = sparsity_in + 1 + 3;
-        // Fill with zeros
-        blasfeo_dvecse(n, 0.0, x, xi);
-        // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
+        case BLASFEO_DVEC_ARGS:
         {
-            BLASFEO_DVECEL(x, xi + row[idx]) = ptr[0];
-            ptr++;
+            // column vector: assume ncol = 1 !!! or empty vector
+            assert((ncol == 1) | (nrow == 0) | (ncol == 0));
+            struct blasfeo_dvec_args *x_args = out;
+            struct blasfeo_dvec *x = x_args->x;
+            int xi = x_args->xi;
+            if (nrow <= 0)
+                break;
+            if (plan->dense)
+            {
+                blasfeo_pack_dvec(nrow, res, 1, x, xi);
+            }
+            else
+            {
+                blasfeo_dvecse(nrow, 0.0, x, xi);
+                for (kk = 0; kk < nnz; kk++) BLASFEO_DVECEL(x, xi + row[kk]) = res[kk];
+            }
+            break;
         }
+
+        case IGNORE_ARGUMENT:
+            // do nothing
+            break;
+
+        default:
+            printf("\ntype out %d\n", type);
+            printf("\nUnknown external function argument type for output %i\n\n", idx_res);
+            exit(1);
     }
 
     return;
@@ -626,38 +631,37 @@ static void d_cvt_casadi_to_dvec_args(double *in, int *sparsity_in, struct blasf
 
 
 
-// column vector: assume sparsity_in[1] = 1 !!! or empty vector;
-// TODO(all): detect if dense from number of elements per column !!!
-static void d_cvt_dvec_args_to_casadi(struct blasfeo_dvec_args *in, double *out, int *sparsity_out)
+// evaluate a casadi function using the conversion plans of its arguments;
+// the first in_num arguments are converted from in, the remaining ones are left untouched
+static void casadi_evaluate_with_plans(int (*casadi_fun)(const double **, double **, int *, double *, void *),
+    int in_num, int out_num, double **args, double **args_mem, external_function_casadi_arg_plan *args_plan,
+    double **res, double **res_mem, external_function_casadi_arg_plan *res_plan, int *iw, double *w,
+    ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *type_out, void **out)
 {
-    int idx;
-
-    assert((sparsity_out[1] == 1) | (sparsity_out[0] == 0) | (sparsity_out[1] == 0));
+    int ii;
+    double *ptr;
 
-    int n = sparsity_out[0];
-    int dense = sparsity_out[2];
+    // in as args
+    for (ii = 0; ii < in_num; ii++)
+        d_cvt_in_to_casadi(type_in[ii], in[ii], args_plan + ii, args_mem[ii], args + ii, ii);
 
-    if (n<=0)
-        return;
+    // dense outputs are written by casadi directly into the caller memory
+    for (ii = 0; ii < out_num; ii++)
+    {
+        res[ii] = res_mem[ii];
+        ptr = casadi_res_alias(type_out[ii], out[ii], res_plan + ii);
+        if (ptr != NULL &&
+            !casadi_res_overlaps_args(ptr, res_plan[ii].nnz, in_num, args, args_mem, args_plan))
+            res[ii] = ptr;
+    }
 
-    struct blasfeo_dvec *x = in->x;
-    int xi = in->xi;
+    // call casadi function
+    casadi_fun((const double **) args, res, iw, w, NULL);
 
-    if (dense)
+    for (ii = 0; ii < out_num; ii++)
     {
-        blasfeo_unpack_dvec(n, x, xi, out, 1);
-    }
-    else
-    {
-        double *ptr = out;
-        int *idxcol = sparsity_out + 2;
-        int *row = sparsity_out + 1 + 3;
-        // Copy nonzeros
-        for (idx = idxcol[0]; idx != idxcol[1]; idx++)
-        {
-            ptr[0] = BLASFEO_DVECEL(x, xi + row[idx]);
-            ptr++;
-        }
+        if (res[ii] == res_mem[ii])
+            d_cvt_casadi_to_out(type_out[ii], res[ii], res_plan + ii, out[ii], ii);
     }
 
     return;
@@ -750,13 +754,19 @@ acados_size_t external_function_casadi_calculate_size(external_function_casadi *
     acados_size_t size = 0;
 
     // double pointers
-    size += fun->args_num * sizeof(double *);  // args
-    size += fun->res_num * sizeof(double *);   // res
+    size += 2 * fun->args_num * sizeof(double *);  // args, args_mem
+    size += 2 * fun->res_num * sizeof(double *);   // res, res_mem
+
+    // conversion plans
+    size += fun->args_num * sizeof(external_function_casadi_arg_plan);  // args_plan
+    size += fun->res_num * sizeof(external_function_casadi_arg_plan);   // res_plan
 
     // ints
     size += fun->args_num * sizeof(int);  // args_size
     size += fun->res_num * sizeof(int);   // res_size
     size += fun->iw_size * sizeof(int);   // iw
+    size += casadi_arg_plans_int_size(fun->args_num, fun->casadi_sparsity_in) * sizeof(int);
+    size += casadi_arg_plans_int_size(fun->res_num, fun->casadi_sparsity_out) * sizeof(int);
 
     // doubles
     size += fun->args_size_tot * sizeof(double);  // args
@@ -791,8 +801,16 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
 
     // args
     assign_and_advance_double_ptrs(fun->args_num, &fun->args, &c_ptr);
+    assign_and_advance_double_ptrs(fun->args_num, &fun->args_mem, &c_ptr);
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
+    assign_and_advance_double_ptrs(fun->res_num, &fun->res_mem, &c_ptr);
+
+    // conversion plans
+    fun->args_plan = (external_function_casadi_arg_plan *) c_ptr;
+    c_ptr += fun->args_num * sizeof(external_function_casadi_arg_plan);
+    fun->res_plan = (external_function_casadi_arg_plan *) c_ptr;
+    c_ptr += fun->res_num * sizeof(external_function_casadi_arg_plan);
 
     // args_size
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
@@ -804,16 +822,25 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
         fun->res_size[ii] = casadi_nnz(fun->casadi_sparsity_out(ii));
     // iw
     assign_and_advance_int(fun->iw_size, &fun->iw, &c_ptr);
+    // scatter lists of sparse arguments
+    casadi_arg_plans_assign(fun->args_num, fun->casadi_sparsity_in, fun->args_plan, &c_ptr);
+    casadi_arg_plans_assign(fun->res_num, fun->casadi_sparsity_out, fun->res_plan, &c_ptr);
 
     // align to double
     align_char_to(8, &c_ptr);
 
     // args
     for (ii = 0; ii < fun->args_num; ii++)
-        assign_and_advance_double(fun->args_size[ii], &fun->args[ii], &c_ptr);
+    {
+        assign_and_advance_double(fun->args_size[ii], &fun->args_mem[ii], &c_ptr);
+        fun->args[ii] = fun->args_mem[ii];
+    }
     // res
     for (ii = 0; ii < fun->res_num; ii++)
-        assign_and_advance_double(fun->res_size[ii], &fun->res[ii], &c_ptr);
+    {
+        assign_and_advance_double(fun->res_size[ii], &fun->res_mem[ii], &c_ptr);
+        fun->res[ii] = fun->res_mem[ii];
+    }
     // w
     assign_and_advance_double(fun->w_size, &fun->w, &c_ptr);
 
@@ -830,106 +857,15 @@ void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void *
     // cast into external casadi function
     external_function_casadi *fun = self;
 
-    // loop index
-    int ii;
-
-    // in as args
-    for (ii = 0; ii < fun->in_num; ii++)
-    {
-        switch (type_in[ii])
-        {
-            case COLMAJ:
-                d_cvt_colmaj_to_casadi(in[ii], (double *) fun->args[ii],
-                                       (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_dmat_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_dvec_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case COLMAJ_ARGS:
-                d_cvt_colmaj_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                            (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_dmat_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_dvec_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype in %d\n", type_in[ii]);
-                printf("\nUnknown external function argument type for argument %i\n\n", ii);
-                exit(1);
-        }
-    }
-
-    // call casadi function
-    fun->casadi_fun((const double **) fun->args, fun->res, fun->iw, fun->w, NULL);
-
-    for (ii = 0; ii < fun->out_num; ii++)
-    {
-        switch (type_out[ii])
-        {
-            case COLMAJ:
-                d_cvt_casadi_to_colmaj((double *) fun->res[ii],
-                                       (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_casadi_to_dmat((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_casadi_to_dvec((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case COLMAJ_ARGS:
-                d_cvt_casadi_to_colmaj_args((double *) fun->res[ii],
-                                            (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_casadi_to_dmat_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_casadi_to_dvec_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
-
-            default:
-                printf("\ntype out %d\n", type_out[ii]);
-                printf("\nUnknown external function argument type for output %i\n\n", ii);
-                exit(1);
-        }
-    }
+    casadi_evaluate_with_plans(fun->casadi_fun, fun->in_num, fun->out_num,
+        fun->args, fun->args_mem, fun->args_plan, fun->res, fun->res_mem, fun->res_plan,
+        fun->iw, fun->w, type_in, in, type_out, out);
 
     return;
 }
 
+
+
 /************************************************
  * casadi external parametric function
  ************************************************/
@@ -1049,13 +985,19 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     acados_size_t size = 0;
 
     // double pointers
-    size += fun->args_num * sizeof(double *);  // args
-    size += fun->res_num * sizeof(double *);   // res
+    size += 2 * fun->args_num * sizeof(double *);  // args, args_mem
+    size += 2 * fun->res_num * sizeof(double *);   // res, res_mem
+
+    // conversion plans
+    size += fun->args_num * sizeof(external_function_casadi_arg_plan);  // args_plan
+    size += fun->res_num * sizeof(external_function_casadi_arg_plan);   // res_plan
 
     // ints
     size += fun->args_num * sizeof(int);  // args_size
     size += fun->res_num * sizeof(int);   // res_size
     size += fun->iw_size * sizeof(int);   // iw
+    size += casadi_arg_plans_int_size(fun->args_num, fun->casadi_sparsity_in) * sizeof(int);
+    size += casadi_arg_plans_int_size(fun->res_num, fun->casadi_sparsity_out) * sizeof(int);
 
     // doubles
     size += fun->args_size_tot * sizeof(double);  // args
@@ -1073,7 +1015,9 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
 
 
 
-void external_function_param_casadi_assign(external_function_param_casadi *fun, void *raw_memory)
+// p_shared: if not NULL, the parameter argument of the casadi function points to it
+static void external_function_param_casadi_assign_args(external_function_param_casadi *fun,
+                                                       void *raw_memory, double *p_shared)
 {
     // loop index
     int ii;
@@ -1091,8 +1035,16 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
 
     // args
     assign_and_advance_double_ptrs(fun->args_num, &fun->args, &c_ptr);
+    assign_and_advance_double_ptrs(fun->args_num, &fun->args_mem, &c_ptr);
     // res
     assign_and_advance_double_ptrs(fun->res_num, &fun->res, &c_ptr);
+    assign_and_advance_double_ptrs(fun->res_num, &fun->res_mem, &c_ptr);
+
+    // conversion plans
+    fun->args_plan = (external_function_casadi_arg_plan *) c_ptr;
+    c_ptr += fun->args_num * sizeof(external_function_casadi_arg_plan);
+    fun->res_plan = (external_function_casadi_arg_plan *) c_ptr;
+    c_ptr += fun->res_num * sizeof(external_function_casadi_arg_plan);
 
     // args_size
     assign_and_advance_int(fun->args_num, &fun->args_size, &c_ptr);
@@ -1104,129 +1056,80 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
         fun->res_size[ii] = casadi_nnz(fun->casadi_sparsity_out(ii));
     // iw
     assign_and_advance_int(fun->iw_size, &fun->iw, &c_ptr);
+    // scatter lists of sparse arguments
+    casadi_arg_plans_assign(fun->args_num, fun->casadi_sparsity_in, fun->args_plan, &c_ptr);
+    casadi_arg_plans_assign(fun->res_num, fun->casadi_sparsity_out, fun->res_plan, &c_ptr);
 
     // align to double
     align_char_to(8, &c_ptr);
 
     // args
     for (ii = 0; ii < fun->args_num; ii++)
-        assign_and_advance_double(fun->args_size[ii], &fun->args[ii], &c_ptr);
+    {
+        if (p_shared != NULL && ii == fun->in_num - 1)
+            fun->args_mem[ii] = p_shared;
+        else
+            assign_and_advance_double(fun->args_size[ii], &fun->args_mem[ii], &c_ptr);
+        fun->args[ii] = fun->args_mem[ii];
+    }
     // res
     for (ii = 0; ii < fun->res_num; ii++)
-        assign_and_advance_double(fun->res_size[ii], &fun->res[ii], &c_ptr);
+    {
+        assign_and_advance_double(fun->res_size[ii], &fun->res_mem[ii], &c_ptr);
+        fun->res[ii] = fun->res_mem[ii];
+    }
     // w
     assign_and_advance_double(fun->w_size, &fun->w, &c_ptr);
 
-    assert((char *) raw_memory + external_function_param_casadi_calculate_size(fun, fun->np) >=
-           c_ptr);
+    assert((char *) raw_memory + (p_shared == NULL ?
+           external_function_param_casadi_calculate_size(fun, fun->np) :
+           external_function_param_casadi_calculate_size_shared(fun, fun->np)) >= c_ptr);
 
     return;
 }
 
 
 
-void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
-                                            ext_fun_arg_t *type_out, void **out)
+void external_function_param_casadi_assign(external_function_param_casadi *fun, void *raw_memory)
 {
-    // cast into external casadi function
-    external_function_param_casadi *fun = self;
-
-    // loop index
-    int ii;
-
-    // in as args
-    // skip last argument (that is the parameters vector)
-    for (ii = 0; ii < fun->in_num - 1; ii++)
-    {
-        switch (type_in[ii])
-        {
-            case COLMAJ:
-                d_cvt_colmaj_to_casadi(in[ii], (double *) fun->args[ii],
-                                       (int *) fun->casadi_sparsity_in(ii));
-                break;
+    external_function_param_casadi_assign_args(fun, raw_memory, NULL);
+    return;
+}
 
-            case BLASFEO_DMAT:
-                d_cvt_dmat_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
 
-            case BLASFEO_DVEC:
-                d_cvt_dvec_to_casadi(in[ii], (double *) fun->args[ii],
-                                     (int *) fun->casadi_sparsity_in(ii));
-                break;
-            case COLMAJ_ARGS:
-                d_cvt_colmaj_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                            (int *) fun->casadi_sparsity_in(ii));
-                break;
 
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_dmat_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
+acados_size_t external_function_param_casadi_calculate_size_shared(external_function_param_casadi *fun, int np)
+{
+    acados_size_t size = external_function_param_casadi_calculate_size(fun, np);
 
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_dvec_args_to_casadi(in[ii], (double *) fun->args[ii],
-                                          (int *) fun->casadi_sparsity_in(ii));
-                break;
+    // parameters are stored in the shared block
+    size -= casadi_nnz(fun->casadi_sparsity_in(fun->in_num - 1)) * sizeof(double);
 
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
+    return size;
+}
 
-            default:
-                printf("\ntype in %d\n", type_in[ii]);
-                printf("\nUnknown external function argument type for argument %i\n\n", ii);
-                exit(1);
-        }
-    }
-    // parameters are last argument and set via external_function_param_casadi_set_param
 
-    // call casadi function
-    fun->casadi_fun((const double **) fun->args, fun->res, fun->iw, fun->w, NULL);
 
-    for (ii = 0; ii < fun->out_num; ii++)
-    {
-        switch (type_out[ii])
-        {
-            case COLMAJ:
-                d_cvt_casadi_to_colmaj((double *) fun->res[ii],
-                                       (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
-
-            case BLASFEO_DMAT:
-                d_cvt_casadi_to_dmat((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-
-            case BLASFEO_DVEC:
-                d_cvt_casadi_to_dvec((double *) fun->res[ii], (int *) fun->casadi_sparsity_out(ii),
-                                     out[ii]);
-                break;
-            case COLMAJ_ARGS:
-                d_cvt_casadi_to_colmaj_args((double *) fun->res[ii],
-                                            (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
+void external_function_param_casadi_assign_shared(external_function_param_casadi *fun, void *raw_memory,
+                                                  double *p_shared)
+{
+    external_function_param_casadi_assign_args(fun, raw_memory, p_shared);
+    return;
+}
 
-            case BLASFEO_DMAT_ARGS:
-                d_cvt_casadi_to_dmat_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
 
-            case BLASFEO_DVEC_ARGS:
-                d_cvt_casadi_to_dvec_args((double *) fun->res[ii],
-                                          (int *) fun->casadi_sparsity_out(ii), out[ii]);
-                break;
 
-            case IGNORE_ARGUMENT:
-                // do nothing
-                break;
+void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
+                                            ext_fun_arg_t *type_out, void **out)
+{
+    // cast into external casadi function
+    external_function_param_casadi *fun = self;
 
-            default:
-                printf("\ntype in %d\n", type_out[ii]);
-                printf("\nUnknown external function argument type for output %i\n\n", ii);
-                exit(1);
-        }
-    }
+    // skip last argument (that is the parameters vector)
+    // parameters are last argument and set via external_function_param_casadi_set_param
+    casadi_evaluate_with_plans(fun->casadi_fun, fun->in_num - 1, fun->out_num,
+        fun->args, fun->args_mem, fun->args_plan, fun->res, fun->res_mem, fun->res_plan,
+        fun->iw, fun->w, type_in, in, type_out, out);
 
     return;
 }
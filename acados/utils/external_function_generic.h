@@ -112,6 +112,10 @@ void external_function_param_generic_set_fun(external_function_param_generic *fu
 acados_size_t external_function_param_generic_calculate_size(external_function_param_generic *fun, int np);
 //
 void external_function_param_generic_assign(external_function_param_generic *fun, void *mem);
+// shared parameters: the function uses the np parameters at p_shared instead of its own memory
+acados_size_t external_function_param_generic_calculate_size_shared(external_function_param_generic *fun, int np);
+//
+void external_function_param_generic_assign_shared(external_function_param_generic *fun, void *mem, double *p_shared);
 //
 void external_function_param_generic_wrapper(void *self, ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *type_out, void **out);
 //
@@ -124,6 +128,17 @@ void external_function_param_generic_set_param(void *self, double *p);
  * casadi external function
  ************************************************/
 
+// conversion plan of one casadi argument, precomputed from its sparsity pattern
+typedef struct
+{
+    int nrow;
+    int ncol;
+    int nnz;
+    int dense;  // casadi data is the column-major matrix (no structural zeros)
+    int *row;   // row index of each nonzero (sparse arguments only)
+    int *col;   // column index of each nonzero (sparse arguments only)
+} external_function_casadi_arg_plan;
+
 typedef struct
 {
     // public members (have to be the same as in the prototype, and before the private ones)
@@ -136,8 +151,12 @@ typedef struct
     const int *(*casadi_sparsity_out)(int);
     int (*casadi_n_in)(void);
     int (*casadi_n_out)(void);
-    double **args;
-    double **res;
+    double **args;      // casadi arguments, point to args_mem or directly to dense inputs
+    double **res;       // casadi results, point to res_mem or directly to dense outputs
+    double **args_mem;
+    double **res_mem;
+    external_function_casadi_arg_plan *args_plan;
+    external_function_casadi_arg_plan *res_plan;
     double *w;
     int *iw;
     int *args_size;     // size of args[i]
@@ -194,8 +213,12 @@ typedef struct
     const int *(*casadi_sparsity_out)(int);
     int (*casadi_n_in)(void);
     int (*casadi_n_out)(void);
-    double **args;
-    double **res;
+    double **args;      // casadi arguments, point to args_mem or directly to dense inputs
+    double **res;       // casadi results, point to res_mem or directly to dense outputs
+    double **args_mem;
+    double **res_mem;
+    external_function_casadi_arg_plan *args_plan;
+    external_function_casadi_arg_plan *res_plan;
     double *w;
     int *iw;
     int *args_size;     // size of args[i]
@@ -229,6 +252,11 @@ void external_function_param_casadi_set_n_out(external_function_param_casadi *fu
 acados_size_t external_function_param_casadi_calculate_size(external_function_param_casadi *fun, int np);
 //
 void external_function_param_casadi_assign(external_function_param_casadi *fun, void *mem);
+// shared parameters: the parameter argument points to the np parameters at p_shared,
+// set_param of any function sharing the block updates all of them
+acados_size_t external_function_param_casadi_calculate_size_shared(external_function_param_casadi *fun, int np);
+//
+void external_function_param_casadi_assign_shared(external_function_param_casadi *fun, void *mem, double *p_shared);
 //
 void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                             ext_fun_arg_t *type_out, void **out);
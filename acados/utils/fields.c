@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <stdio.h>
+#include <string.h>
+// acados
+#include "acados/utils/fields.h"
+
+
+
+typedef struct
+{
+    const char *name;
+    acados_field_t id;
+} acados_field_entry;
+
+
+
+// the first entry of each id is its canonical name, aliases follow
+static const acados_field_entry acados_field_table[] =
+{
+    {"x", ACADOS_FIELD_X},
+    {"u", ACADOS_FIELD_U},
+    {"z", ACADOS_FIELD_Z},
+    {"sl", ACADOS_FIELD_SL},
+    {"su", ACADOS_FIELD_SU},
+    {"pi", ACADOS_FIELD_PI},
+    {"lam", ACADOS_FIELD_LAM},
+    {"t", ACADOS_FIELD_T},
+    {"kkt_norm_inf", ACADOS_FIELD_KKT_NORM_INF},
+    {"kkt_norm", ACADOS_FIELD_KKT_NORM_INF},
+    {"Ts", ACADOS_FIELD_TS},
+    {"yref", ACADOS_FIELD_YREF},
+    {"y_ref", ACADOS_FIELD_YREF},
+    {"W", ACADOS_FIELD_W},
+    {"Z", ACADOS_FIELD_Z_MAT},
+    {"Zl", ACADOS_FIELD_ZL_MAT},
+    {"Zu", ACADOS_FIELD_ZU_MAT},
+    {"zl", ACADOS_FIELD_ZL},
+    {"zu", ACADOS_FIELD_ZU},
+    {"lbx", ACADOS_FIELD_LBX},
+    {"ubx", ACADOS_FIELD_UBX},
+    {"lbu", ACADOS_FIELD_LBU},
+    {"ubu", ACADOS_FIELD_UBU},
+    {"lg", ACADOS_FIELD_LG},
+    {"ug", ACADOS_FIELD_UG},
+    {"lh", ACADOS_FIELD_LH},
+    {"uh", ACADOS_FIELD_UH},
+    {"lphi", ACADOS_FIELD_LPHI},
+    {"uphi", ACADOS_FIELD_UPHI},
+    {"T", ACADOS_FIELD_SIM_T},
+    {"t0", ACADOS_FIELD_SIM_T0},
+    {"time_sim", ACADOS_FIELD_TIME_SIM},
+    {"time_sim_ad", ACADOS_FIELD_TIME_SIM_AD},
+    {"time_sim_la", ACADOS_FIELD_TIME_SIM_LA},
+    {"time_qp_solver_call", ACADOS_FIELD_TIME_QP_SOLVER_CALL},
+    {"time_qp_xcond", ACADOS_FIELD_TIME_QP_XCOND},
+};
+
+
+
+int acados_field_id(const char *field)
+{
+    int n_entries = sizeof(acados_field_table) / sizeof(acados_field_entry);
+
+    for (int ii = 0; ii < n_entries; ii++)
+    {
+        if (!strcmp(field, acados_field_table[ii].name))
+            return acados_field_table[ii].id;
+    }
+
+    return ACADOS_FIELD_UNKNOWN;
+}
+
+
+
+const char *acados_field_name(int field_id)
+{
+    int n_entries = sizeof(acados_field_table) / sizeof(acados_field_entry);
+
+    for (int ii = 0; ii < n_entries; ii++)
+    {
+        if (acados_field_table[ii].id == field_id)
+            return acados_field_table[ii].name;
+    }
+
+    return "unknown";
+}
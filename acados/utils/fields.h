@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_UTILS_FIELDS_H_
+#define ACADOS_UTILS_FIELDS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Integer handles for field names used in setters and getters.
+// A field name is resolved once with acados_field_id(), the *_set_by_id / *_get_by_id
+// functions then dispatch on the handle with a switch instead of a strcmp chain.
+typedef enum
+{
+    ACADOS_FIELD_UNKNOWN = 0,
+    // iterate
+    ACADOS_FIELD_X,
+    ACADOS_FIELD_U,
+    ACADOS_FIELD_Z,
+    ACADOS_FIELD_SL,
+    ACADOS_FIELD_SU,
+    ACADOS_FIELD_PI,
+    ACADOS_FIELD_LAM,
+    ACADOS_FIELD_T,
+    ACADOS_FIELD_KKT_NORM_INF,
+    // ocp_nlp_in
+    ACADOS_FIELD_TS,
+    // cost
+    ACADOS_FIELD_YREF,
+    ACADOS_FIELD_W,
+    ACADOS_FIELD_Z_MAT,
+    ACADOS_FIELD_ZL_MAT,
+    ACADOS_FIELD_ZU_MAT,
+    ACADOS_FIELD_ZL,
+    ACADOS_FIELD_ZU,
+    // constraints
+    ACADOS_FIELD_LBX,
+    ACADOS_FIELD_UBX,
+    ACADOS_FIELD_LBU,
+    ACADOS_FIELD_UBU,
+    ACADOS_FIELD_LG,
+    ACADOS_FIELD_UG,
+    ACADOS_FIELD_LH,
+    ACADOS_FIELD_UH,
+    ACADOS_FIELD_LPHI,
+    ACADOS_FIELD_UPHI,
+    // sim_in
+    ACADOS_FIELD_SIM_T,
+    ACADOS_FIELD_SIM_T0,
+    // timings in memory
+    ACADOS_FIELD_TIME_SIM,
+    ACADOS_FIELD_TIME_SIM_AD,
+    ACADOS_FIELD_TIME_SIM_LA,
+    ACADOS_FIELD_TIME_QP_SOLVER_CALL,
+    ACADOS_FIELD_TIME_QP_XCOND,
+    // number of fields
+    ACADOS_NUM_FIELDS,
+} acados_field_t;
+
+// returns the handle of a field name, ACADOS_FIELD_UNKNOWN if the name has no handle
+int acados_field_id(const char *field);
+// returns the canonical name of a field handle
+const char *acados_field_name(int field_id);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_UTILS_FIELDS_H_
@@ -104,6 +104,51 @@ int vde_adj_chain_nm7(const real_t **arg, real_t **res, int *iw, real_t *w, void
 int vde_adj_chain_nm8(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 int vde_adj_chain_nm9(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 
+int vde_adj_chain_nm2_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm3_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm4_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm5_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm6_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm7_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm8_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_adj_chain_nm9_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+
+const int* vde_adj_chain_nm2_sparsity_in(int i);
+const int* vde_adj_chain_nm3_sparsity_in(int i);
+const int* vde_adj_chain_nm4_sparsity_in(int i);
+const int* vde_adj_chain_nm5_sparsity_in(int i);
+const int* vde_adj_chain_nm6_sparsity_in(int i);
+const int* vde_adj_chain_nm7_sparsity_in(int i);
+const int* vde_adj_chain_nm8_sparsity_in(int i);
+const int* vde_adj_chain_nm9_sparsity_in(int i);
+
+const int* vde_adj_chain_nm2_sparsity_out(int i);
+const int* vde_adj_chain_nm3_sparsity_out(int i);
+const int* vde_adj_chain_nm4_sparsity_out(int i);
+const int* vde_adj_chain_nm5_sparsity_out(int i);
+const int* vde_adj_chain_nm6_sparsity_out(int i);
+const int* vde_adj_chain_nm7_sparsity_out(int i);
+const int* vde_adj_chain_nm8_sparsity_out(int i);
+const int* vde_adj_chain_nm9_sparsity_out(int i);
+
+int vde_adj_chain_nm2_n_in();
+int vde_adj_chain_nm3_n_in();
+int vde_adj_chain_nm4_n_in();
+int vde_adj_chain_nm5_n_in();
+int vde_adj_chain_nm6_n_in();
+int vde_adj_chain_nm7_n_in();
+int vde_adj_chain_nm8_n_in();
+int vde_adj_chain_nm9_n_in();
+
+int vde_adj_chain_nm2_n_out();
+int vde_adj_chain_nm3_n_out();
+int vde_adj_chain_nm4_n_out();
+int vde_adj_chain_nm5_n_out();
+int vde_adj_chain_nm6_n_out();
+int vde_adj_chain_nm7_n_out();
+int vde_adj_chain_nm8_n_out();
+int vde_adj_chain_nm9_n_out();
+
 /* hessian vde (or ode???) */
 int vde_hess_chain_nm2(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 int vde_hess_chain_nm3(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
@@ -114,6 +159,51 @@ int vde_hess_chain_nm7(const real_t **arg, real_t **res, int *iw, real_t *w, voi
 int vde_hess_chain_nm8(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 int vde_hess_chain_nm9(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 
+int vde_hess_chain_nm2_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm3_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm4_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm5_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm6_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm7_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm8_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+int vde_hess_chain_nm9_work(int *sz_arg, int* sz_res, int *sz_iw, int *sz_w);
+
+const int* vde_hess_chain_nm2_sparsity_in(int i);
+const int* vde_hess_chain_nm3_sparsity_in(int i);
+const int* vde_hess_chain_nm4_sparsity_in(int i);
+const int* vde_hess_chain_nm5_sparsity_in(int i);
+const int* vde_hess_chain_nm6_sparsity_in(int i);
+const int* vde_hess_chain_nm7_sparsity_in(int i);
+const int* vde_hess_chain_nm8_sparsity_in(int i);
+const int* vde_hess_chain_nm9_sparsity_in(int i);
+
+const int* vde_hess_chain_nm2_sparsity_out(int i);
+const int* vde_hess_chain_nm3_sparsity_out(int i);
+const int* vde_hess_chain_nm4_sparsity_out(int i);
+const int* vde_hess_chain_nm5_sparsity_out(int i);
+const int* vde_hess_chain_nm6_sparsity_out(int i);
+const int* vde_hess_chain_nm7_sparsity_out(int i);
+const int* vde_hess_chain_nm8_sparsity_out(int i);
+const int* vde_hess_chain_nm9_sparsity_out(int i);
+
+int vde_hess_chain_nm2_n_in();
+int vde_hess_chain_nm3_n_in();
+int vde_hess_chain_nm4_n_in();
+int vde_hess_chain_nm5_n_in();
+int vde_hess_chain_nm6_n_in();
+int vde_hess_chain_nm7_n_in();
+int vde_hess_chain_nm8_n_in();
+int vde_hess_chain_nm9_n_in();
+
+int vde_hess_chain_nm2_n_out();
+int vde_hess_chain_nm3_n_out();
+int vde_hess_chain_nm4_n_out();
+int vde_hess_chain_nm5_n_out();
+int vde_hess_chain_nm6_n_out();
+int vde_hess_chain_nm7_n_out();
+int vde_hess_chain_nm8_n_out();
+int vde_hess_chain_nm9_n_out();
+
 /* ls cost */
 int ls_cost_nm2(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
 int ls_cost_nm3(const real_t **arg, real_t **res, int *iw, real_t *w, void *mem);
@@ -39,6 +39,13 @@ extern "C" {
 
 /* explicit ODE */
 
+// explicit ODE
+int odeFun(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
+int odeFun_work(int *, int *, int *, int *);
+const int *odeFun_sparsity_in(int);
+const int *odeFun_sparsity_out(int);
+int odeFun_n_in();
+int odeFun_n_out();
 // forward explicit VDE
 int vdeFun(const real_t** arg, real_t** res, int* iw, real_t* w, void *mem);
 int vdeFun_work(int *, int *, int *, int *);
@@ -75,6 +75,9 @@
 #define MAX_SQP_ITERS 10
 #define NREP 10
 
+// 1: nlp memory aliases cost gradients and constraint adjoints of the submodules
+#define FUSED_LINEARIZATION 1
+
 // constraints (at stage 0): 0 box, 1 general
 #define CONSTRAINTS 1
 
@@ -1348,6 +1351,9 @@ int main()
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
     ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
 
+    int fused_linearization = FUSED_LINEARIZATION;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "fused_linearization", &fused_linearization);
+
     /************************************************
     * ocp_nlp out
     ************************************************/
@@ -1399,6 +1405,30 @@ int main()
 	printf("\nlinearization time = %f ms\n", time_lin*1e3);
 	printf("\nqp solution time   = %f ms\n", time_qp_sol*1e3);
 	printf("\ntotal time         = %f ms\n", time_tot*1e3);
+
+    // compare the linearization time without and with fused linearization
+    for (int fused = 0; fused < 2; fused++)
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "fused_linearization", &fused);
+        ocp_nlp_solver *solver_cmp = ocp_nlp_solver_create(config, dims, nlp_opts);
+        ocp_nlp_precompute(solver_cmp, nlp_in, nlp_out);
+
+        double time_lin_cmp = 0.0;
+        for (int rep = 0; rep < NREP; rep++)
+        {
+            for (int i=0; i<=NN; i++)
+            {
+                blasfeo_pack_dvec(nu[i], uref, 1, nlp_out->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, nlp_out->ux+i, nu[i]);
+            }
+            ocp_nlp_solve(solver_cmp, nlp_in, nlp_out);
+            ocp_nlp_get(config, solver_cmp, "time_lin", &time_lin);
+            time_lin_cmp += time_lin;
+        }
+        printf("\nfused_linearization = %d: linearization time = %f ms\n", fused, time_lin_cmp/NREP*1e3);
+
+        ocp_nlp_solver_destroy(solver_cmp);
+    }
 	printf("\n\n");
 
     for (int k =0; k < 3; k++) {
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados/utils/timing.h"
+#include "acados_c/sim_interface.h"
+
+#include "examples/c/sim_benchmark/sim_benchmark.h"
+
+#define SIM_BENCHMARK_MAX_FUN 8
+#define SIM_BENCHMARK_NUM_SENS 4
+
+// sensitivity modes, each one includes the previous ones
+static const char *sens_names[SIM_BENCHMARK_NUM_SENS] = {"none", "forw", "forw_adj", "hess"};
+
+// sweeps
+static const int ns_values[] = {1, 2, 4};
+static const int num_steps_values[] = {1, 2, 4};
+static const int newton_iter_values[] = {1, 3};
+
+
+
+/************************************************
+* external function call counter
+************************************************/
+
+// wraps an external function and counts its evaluations
+typedef struct
+{
+    // public members (have to be the same as in the prototype, and before the private ones)
+    void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    // private members
+    external_function_generic *fun;
+    const char *field;
+    int num_calls;
+} sim_benchmark_counter;
+
+
+
+typedef struct
+{
+    sim_benchmark_counter counter[SIM_BENCHMARK_MAX_FUN];
+    int num_fun;
+} sim_benchmark_counters;
+
+
+
+static void sim_benchmark_counter_evaluate(void *self, ext_fun_arg_t *type_in, void **in,
+                                           ext_fun_arg_t *type_out, void **out)
+{
+    sim_benchmark_counter *counter = self;
+    counter->num_calls++;
+    counter->fun->evaluate(counter->fun, type_in, in, type_out, out);
+}
+
+
+
+static void sim_benchmark_model_set(sim_config *config, sim_in *in,
+                                    sim_benchmark_counters *counters, const char *field,
+                                    external_function_generic *fun)
+{
+    if (fun == NULL)
+        return;
+
+    if (counters->num_fun >= SIM_BENCHMARK_MAX_FUN)
+    {
+        printf("\nerror: sim_benchmark_model_set: too many external functions\n");
+        exit(1);
+    }
+
+    sim_benchmark_counter *counter = &counters->counter[counters->num_fun];
+    counters->num_fun++;
+
+    counter->evaluate = &sim_benchmark_counter_evaluate;
+    counter->fun = fun;
+    counter->field = field;
+    counter->num_calls = 0;
+
+    config->model_set(in->model, field, counter);
+}
+
+
+
+/************************************************
+* model & opts
+************************************************/
+
+void sim_benchmark_model_init(sim_benchmark_model *model)
+{
+    model->name = "";
+
+    model->nx = 0;
+    model->nu = 0;
+    model->nz = 0;
+
+    model->T = 0.0;
+    model->x0 = NULL;
+    model->u0 = NULL;
+
+    model->expl_ode_fun = NULL;
+    model->expl_vde_for = NULL;
+    model->expl_vde_adj = NULL;
+    model->expl_ode_hess = NULL;
+
+    model->impl_ode_fun = NULL;
+    model->impl_ode_fun_jac_x_xdot = NULL;
+    model->impl_ode_jac_x_xdot_u = NULL;
+    model->impl_ode_fun_jac_x_xdot_u = NULL;
+    model->impl_ode_hess = NULL;
+
+    model->nx1 = 0;
+    model->nz1 = 0;
+    model->nout = 0;
+    model->ny = 0;
+    model->nuhat = 0;
+    model->phi_fun = NULL;
+    model->phi_fun_jac_y = NULL;
+    model->phi_jac_y_uhat = NULL;
+    model->f_lo_fun_jac_x1k1uz = NULL;
+    model->get_matrices_fun = NULL;
+    model->phi_hess = NULL;
+    model->f_lo_hess = NULL;
+}
+
+
+
+// usage: <benchmark> [output file] [nrep]
+void sim_benchmark_opts_init(sim_benchmark_opts *opts, int argc, char **argv)
+{
+    opts->nrep = 100;
+    opts->file = stdout;
+
+    if (argc > 1)
+    {
+        opts->file = fopen(argv[1], "w");
+        if (opts->file == NULL)
+        {
+            printf("\nerror: sim_benchmark: cannot open %s\n", argv[1]);
+            exit(1);
+        }
+    }
+    if (argc > 2)
+        opts->nrep = atoi(argv[2]);
+
+    if (opts->nrep < 1)
+        opts->nrep = 1;
+}
+
+
+
+void sim_benchmark_opts_free(sim_benchmark_opts *opts)
+{
+    if (opts->file != stdout)
+        fclose(opts->file);
+}
+
+
+
+/************************************************
+* benchmark
+************************************************/
+
+static const char *sim_benchmark_solver_name(sim_solver_t solver)
+{
+    switch (solver)
+    {
+        case ERK:
+            return "ERK";
+        case IRK:
+            return "IRK";
+        case GNSF:
+            return "GNSF";
+        case LIFTED_IRK:
+            return "LIFTED_IRK";
+        default:
+            return "INVALID";
+    }
+}
+
+
+
+// checks if the model provides all functions needed for the given integrator & sensitivity mode
+static bool sim_benchmark_supported(sim_benchmark_model *model, sim_solver_t solver, int sens)
+{
+    switch (solver)
+    {
+        case ERK:
+            if (model->nz > 0)
+                return false;
+            if (sens == 0)
+                return model->expl_ode_fun != NULL;
+            if (model->expl_vde_for == NULL)
+                return false;
+            if (sens == 2 && model->expl_vde_adj == NULL)
+                return false;
+            if (sens == 3 && model->expl_ode_hess == NULL)
+                return false;
+            return true;
+
+        case IRK:
+            if (model->impl_ode_fun == NULL || model->impl_ode_fun_jac_x_xdot == NULL ||
+                model->impl_ode_jac_x_xdot_u == NULL)
+                return false;
+            if (sens == 3 && model->impl_ode_hess == NULL)
+                return false;
+            return true;
+
+        case LIFTED_IRK:
+            if (model->impl_ode_fun == NULL || model->impl_ode_fun_jac_x_xdot_u == NULL)
+                return false;
+            if (model->nz > 0 && model->impl_ode_jac_x_xdot_u == NULL)
+                return false;
+            if (sens == 3 && model->impl_ode_hess == NULL)
+                return false;
+            return true;
+
+        case GNSF:
+            if (model->phi_fun == NULL || model->phi_fun_jac_y == NULL ||
+                model->phi_jac_y_uhat == NULL || model->f_lo_fun_jac_x1k1uz == NULL ||
+                model->get_matrices_fun == NULL)
+                return false;
+            if (sens == 3 && model->phi_hess == NULL)
+                return false;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+
+
+static void sim_benchmark_config(sim_benchmark_model *model, sim_benchmark_opts *bench_opts,
+                                 sim_solver_t solver_type, int ns, int num_steps,
+                                 int newton_iter, int sens, bool first)
+{
+    int nx = model->nx;
+    int nu = model->nu;
+    int nrep = bench_opts->nrep;
+    FILE *file = bench_opts->file;
+
+    /* config & dims */
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver_type;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &model->nx);
+    sim_dims_set(config, dims, "nu", &model->nu);
+    sim_dims_set(config, dims, "nz", &model->nz);
+    if (solver_type == GNSF)
+    {
+        sim_dims_set(config, dims, "nx1", &model->nx1);
+        sim_dims_set(config, dims, "nz1", &model->nz1);
+        sim_dims_set(config, dims, "nout", &model->nout);
+        sim_dims_set(config, dims, "ny", &model->ny);
+        sim_dims_set(config, dims, "nuhat", &model->nuhat);
+    }
+
+    /* opts */
+    void *opts = sim_opts_create(config, dims);
+
+    bool sens_forw = sens >= 1;
+    bool sens_adj = sens >= 2;
+    bool sens_hess = sens >= 3;
+
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    if (solver_type != ERK)
+        sim_opts_set(config, opts, "newton_iter", &newton_iter);
+    sim_opts_set(config, opts, "sens_forw", &sens_forw);
+    sim_opts_set(config, opts, "sens_adj", &sens_adj);
+    sim_opts_set(config, opts, "sens_hess", &sens_hess);
+
+    /* in & out */
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    sim_in_set(config, dims, in, "T", &model->T);
+
+    sim_benchmark_counters counters;
+    counters.num_fun = 0;
+
+    switch (solver_type)
+    {
+        case ERK:
+            sim_benchmark_model_set(config, in, &counters, "expl_ode_fun", model->expl_ode_fun);
+            sim_benchmark_model_set(config, in, &counters, "expl_vde_for", model->expl_vde_for);
+            sim_benchmark_model_set(config, in, &counters, "expl_vde_adj", model->expl_vde_adj);
+            sim_benchmark_model_set(config, in, &counters, "expl_ode_hess", model->expl_ode_hess);
+            break;
+
+        case IRK:
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_fun", model->impl_ode_fun);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_fun_jac_x_xdot",
+                                    model->impl_ode_fun_jac_x_xdot);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_jac_x_xdot_u",
+                                    model->impl_ode_jac_x_xdot_u);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_hess", model->impl_ode_hess);
+            break;
+
+        case LIFTED_IRK:
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_fun", model->impl_ode_fun);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_fun_jac_x_xdot_u",
+                                    model->impl_ode_fun_jac_x_xdot_u);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_jac_x_xdot_u",
+                                    model->impl_ode_jac_x_xdot_u);
+            sim_benchmark_model_set(config, in, &counters, "impl_ode_hess", model->impl_ode_hess);
+            break;
+
+        case GNSF:
+            sim_benchmark_model_set(config, in, &counters, "phi_fun", model->phi_fun);
+            sim_benchmark_model_set(config, in, &counters, "phi_fun_jac_y", model->phi_fun_jac_y);
+            sim_benchmark_model_set(config, in, &counters, "phi_jac_y_uhat",
+                                    model->phi_jac_y_uhat);
+            sim_benchmark_model_set(config, in, &counters, "f_lo_jac_x1_x1dot_u_z",
+                                    model->f_lo_fun_jac_x1k1uz);
+            sim_benchmark_model_set(config, in, &counters, "get_gnsf_matrices",
+                                    model->get_matrices_fun);
+            sim_benchmark_model_set(config, in, &counters, "phi_hess", model->phi_hess);
+            sim_benchmark_model_set(config, in, &counters, "f_lo_hess", model->f_lo_hess);
+            break;
+
+        default:
+            printf("\nerror: sim_benchmark_config: unsupported integrator\n");
+            exit(1);
+    }
+
+    // seeds
+    for (int ii = 0; ii < nx * (nx + nu); ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = 0; ii < nu; ii++)
+        in->S_adj[nx + ii] = 0.0;
+
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = model->x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = model->u0[ii];
+
+    /* solver */
+    sim_solver *solver = sim_solver_create(config, dims, opts);
+
+    int status = sim_precompute(solver, in, out);
+
+    // warm-up call, keeps one-time initializations out of the counters
+    if (status == 0)
+        status = sim_solve(solver, in, out);
+
+    for (int ii = 0; ii < counters.num_fun; ii++)
+        counters.counter[ii].num_calls = 0;
+
+    double time_tot_min = 1e12;
+    double time_tot = 0.0;
+    double time_la = 0.0;
+    double time_ad = 0.0;
+    int lu_fact = 0;
+    int num_newton_iter = 0;
+    int num_calls = 0;
+
+    int rep;
+    for (rep = 0; rep < nrep && status == 0; rep++)
+    {
+        status = sim_solve(solver, in, out);
+
+        time_tot += out->info->CPUtime;
+        time_la += out->info->LAtime;
+        time_ad += out->info->ADtime;
+        if (out->info->CPUtime < time_tot_min)
+            time_tot_min = out->info->CPUtime;
+        lu_fact += out->info->lu_fact;
+        num_newton_iter += out->info->newton_iter;
+    }
+    if (rep == 0)
+        rep = 1;
+
+    for (int ii = 0; ii < counters.num_fun; ii++)
+        num_calls += counters.counter[ii].num_calls;
+
+    acados_size_t memory_bytes = config->memory_calculate_size(config, dims, opts);
+    acados_size_t workspace_bytes = config->workspace_calculate_size(config, dims, opts);
+
+    /* JSON entry; counters are per integrator call */
+    fprintf(file, "%s\n    {", first ? "" : ",");
+    fprintf(file, "\"integrator\": \"%s\", ", sim_benchmark_solver_name(solver_type));
+    fprintf(file, "\"ns\": %d, \"num_steps\": %d, \"newton_iter\": %d, ", ns, num_steps,
+            solver_type == ERK ? 0 : newton_iter);
+    fprintf(file, "\"sens\": \"%s\", \"status\": %d,\n", sens_names[sens], status);
+    fprintf(file, "     \"time_tot_min\": %e, \"time_tot\": %e, \"time_la\": %e, \"time_ad\": %e,\n",
+            time_tot_min, time_tot / rep, time_la / rep, time_ad / rep);
+    fprintf(file, "     \"ext_fun_calls\": %g, \"ext_fun\": {", (double) num_calls / rep);
+    for (int ii = 0; ii < counters.num_fun; ii++)
+    {
+        fprintf(file, "%s\"%s\": %g", ii == 0 ? "" : ", ", counters.counter[ii].field,
+                (double) counters.counter[ii].num_calls / rep);
+    }
+    fprintf(file, "},\n");
+    fprintf(file, "     \"lu_fact\": %g, \"newton_iter\": %g, ", (double) lu_fact / rep,
+            (double) num_newton_iter / rep);
+    fprintf(file, "\"memory_bytes\": %zu, \"workspace_bytes\": %zu}", (size_t) memory_bytes,
+            (size_t) workspace_bytes);
+
+    /* free */
+    sim_solver_destroy(solver);
+    sim_out_destroy(out);
+    sim_in_destroy(in);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+}
+
+
+
+void sim_benchmark_run(sim_benchmark_model *model, sim_benchmark_opts *opts)
+{
+    FILE *file = opts->file;
+
+    sim_solver_t solvers[] = {ERK, IRK, LIFTED_IRK, GNSF};
+    int num_solvers = sizeof(solvers) / sizeof(solvers[0]);
+    int num_ns = sizeof(ns_values) / sizeof(ns_values[0]);
+    int num_num_steps = sizeof(num_steps_values) / sizeof(num_steps_values[0]);
+    int num_newton_iter = sizeof(newton_iter_values) / sizeof(newton_iter_values[0]);
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"model\": \"%s\", \"nx\": %d, \"nu\": %d, \"nz\": %d, \"T\": %e, \"nrep\": %d,\n",
+            model->name, model->nx, model->nu, model->nz, model->T, opts->nrep);
+    fprintf(file, "  \"runs\": [");
+
+    bool first = true;
+    for (int isolver = 0; isolver < num_solvers; isolver++)
+    {
+        sim_solver_t solver = solvers[isolver];
+        // the explicit integrator has no Newton iterations
+        int num_newton = solver == ERK ? 1 : num_newton_iter;
+
+        for (int sens = 0; sens < SIM_BENCHMARK_NUM_SENS; sens++)
+        {
+            if (!sim_benchmark_supported(model, solver, sens))
+                continue;
+
+            for (int ins = 0; ins < num_ns; ins++)
+            {
+                for (int isteps = 0; isteps < num_num_steps; isteps++)
+                {
+                    for (int inewton = 0; inewton < num_newton; inewton++)
+                    {
+                        sim_benchmark_config(model, opts, solver, ns_values[ins],
+                                             num_steps_values[isteps],
+                                             newton_iter_values[inewton], sens, first);
+                        first = false;
+                    }
+                }
+            }
+        }
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    fflush(file);
+}
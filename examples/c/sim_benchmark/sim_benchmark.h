@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef EXAMPLES_C_SIM_BENCHMARK_SIM_BENCHMARK_H_
+#define EXAMPLES_C_SIM_BENCHMARK_SIM_BENCHMARK_H_
+
+#include <stdio.h>
+
+#include "acados/utils/external_function_generic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+
+// model functions and data of one benchmark model; functions which are not available are NULL,
+// configurations which would need them are skipped
+typedef struct
+{
+    const char *name;
+
+    int nx;
+    int nu;
+    int nz;
+
+    double T;  // simulation time of one call
+    double *x0;
+    double *u0;
+
+    // explicit model (ERK)
+    external_function_generic *expl_ode_fun;
+    external_function_generic *expl_vde_for;
+    external_function_generic *expl_vde_adj;
+    external_function_generic *expl_ode_hess;
+
+    // implicit model (IRK, LIFTED_IRK)
+    external_function_generic *impl_ode_fun;
+    external_function_generic *impl_ode_fun_jac_x_xdot;
+    external_function_generic *impl_ode_jac_x_xdot_u;
+    external_function_generic *impl_ode_fun_jac_x_xdot_u;
+    external_function_generic *impl_ode_hess;
+
+    // GNSF model
+    int nx1;
+    int nz1;
+    int nout;
+    int ny;
+    int nuhat;
+    external_function_generic *phi_fun;
+    external_function_generic *phi_fun_jac_y;
+    external_function_generic *phi_jac_y_uhat;
+    external_function_generic *f_lo_fun_jac_x1k1uz;
+    external_function_generic *get_matrices_fun;
+    external_function_generic *phi_hess;
+    external_function_generic *f_lo_hess;
+
+} sim_benchmark_model;
+
+
+
+// options of a benchmark run
+typedef struct
+{
+    int nrep;      // number of timed calls per configuration
+    FILE *file;    // JSON output
+
+} sim_benchmark_opts;
+
+
+
+//
+void sim_benchmark_model_init(sim_benchmark_model *model);
+//
+void sim_benchmark_opts_init(sim_benchmark_opts *opts, int argc, char **argv);
+// runs all integrators for which the model provides the functions, sweeping ns, num_steps,
+// newton_iter and the sensitivity modes, and writes one JSON document to opts->file
+void sim_benchmark_run(sim_benchmark_model *model, sim_benchmark_opts *opts);
+//
+void sim_benchmark_opts_free(sim_benchmark_opts *opts);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // EXAMPLES_C_SIM_BENCHMARK_SIM_BENCHMARK_H_
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// integrator benchmark on the chain model with 4 masses (ERK, IRK, LIFTED_IRK)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados_c/external_function_interface.h"
+
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/implicit_chain_model/chain_model_impl.h"
+#include "examples/c/sim_benchmark/sim_benchmark.h"
+
+// x0
+#include "examples/c/chain_model/x0_nm4.c"
+
+
+
+int main(int argc, char **argv)
+{
+    sim_benchmark_opts opts;
+    sim_benchmark_opts_init(&opts, argc, argv);
+
+    int num_free_masses = 3;
+    int nx = 6 * num_free_masses;
+    int nu = 3;
+
+    double u0[3] = {0.0, 0.0, 0.0};
+
+    /************************************************
+    * external functions (explicit model)
+    ************************************************/
+
+    // expl_vde_for
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &vde_chain_nm4;
+    expl_vde_for.casadi_work = &vde_chain_nm4_work;
+    expl_vde_for.casadi_sparsity_in = &vde_chain_nm4_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &vde_chain_nm4_sparsity_out;
+    expl_vde_for.casadi_n_in = &vde_chain_nm4_n_in;
+    expl_vde_for.casadi_n_out = &vde_chain_nm4_n_out;
+    external_function_casadi_create(&expl_vde_for);
+
+    // expl_vde_adj
+    external_function_casadi expl_vde_adj;
+    expl_vde_adj.casadi_fun = &vde_adj_chain_nm4;
+    expl_vde_adj.casadi_work = &vde_adj_chain_nm4_work;
+    expl_vde_adj.casadi_sparsity_in = &vde_adj_chain_nm4_sparsity_in;
+    expl_vde_adj.casadi_sparsity_out = &vde_adj_chain_nm4_sparsity_out;
+    expl_vde_adj.casadi_n_in = &vde_adj_chain_nm4_n_in;
+    expl_vde_adj.casadi_n_out = &vde_adj_chain_nm4_n_out;
+    external_function_casadi_create(&expl_vde_adj);
+
+    // expl_ode_hess
+    external_function_casadi expl_ode_hess;
+    expl_ode_hess.casadi_fun = &vde_hess_chain_nm4;
+    expl_ode_hess.casadi_work = &vde_hess_chain_nm4_work;
+    expl_ode_hess.casadi_sparsity_in = &vde_hess_chain_nm4_sparsity_in;
+    expl_ode_hess.casadi_sparsity_out = &vde_hess_chain_nm4_sparsity_out;
+    expl_ode_hess.casadi_n_in = &vde_hess_chain_nm4_n_in;
+    expl_ode_hess.casadi_n_out = &vde_hess_chain_nm4_n_out;
+    external_function_casadi_create(&expl_ode_hess);
+
+    /************************************************
+    * external functions (implicit model)
+    ************************************************/
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun_chain_nm4;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_chain_nm4_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_chain_nm4_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_chain_nm4_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_chain_nm4_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_chain_nm4_n_out;
+    external_function_casadi_create(&impl_ode_fun);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_chain_nm4_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u_chain_nm4;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_chain_nm4_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_chain_nm4_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_chain_nm4_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_chain_nm4_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_chain_nm4_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u);
+
+    // impl_ode_fun_jac_x_xdot_u
+    external_function_casadi impl_ode_fun_jac_x_xdot_u;
+    impl_ode_fun_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4;
+    impl_ode_fun_jac_x_xdot_u.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4_work;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4_sparsity_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4_sparsity_out;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4_n_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_u_chain_nm4_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot_u);
+
+    /************************************************
+    * benchmark
+    ************************************************/
+
+    sim_benchmark_model model;
+    sim_benchmark_model_init(&model);
+
+    model.name = "chain_nm4";
+    model.nx = nx;
+    model.nu = nu;
+    model.T = 0.2;
+    model.x0 = x0_nm4;
+    model.u0 = u0;
+
+    model.expl_vde_for = (external_function_generic *) &expl_vde_for;
+    model.expl_vde_adj = (external_function_generic *) &expl_vde_adj;
+    model.expl_ode_hess = (external_function_generic *) &expl_ode_hess;
+
+    model.impl_ode_fun = (external_function_generic *) &impl_ode_fun;
+    model.impl_ode_fun_jac_x_xdot = (external_function_generic *) &impl_ode_fun_jac_x_xdot;
+    model.impl_ode_jac_x_xdot_u = (external_function_generic *) &impl_ode_jac_x_xdot_u;
+    model.impl_ode_fun_jac_x_xdot_u = (external_function_generic *) &impl_ode_fun_jac_x_xdot_u;
+
+    sim_benchmark_run(&model, &opts);
+
+    /************************************************
+    * free
+    ************************************************/
+
+    external_function_casadi_free(&expl_vde_for);
+    external_function_casadi_free(&expl_vde_adj);
+    external_function_casadi_free(&expl_ode_hess);
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot_u);
+
+    sim_benchmark_opts_free(&opts);
+
+    return 0;
+}
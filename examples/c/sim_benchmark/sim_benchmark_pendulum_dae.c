@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// integrator benchmark on the pendulum DAE model (IRK, LIFTED_IRK, GNSF)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados_c/external_function_interface.h"
+
+#include "examples/c/pendulum_dae_model/pendulum_dae_model.h"
+#include "examples/c/sim_benchmark/sim_benchmark.h"
+
+
+
+int main(int argc, char **argv)
+{
+    sim_benchmark_opts opts;
+    sim_benchmark_opts_init(&opts, argc, argv);
+
+    int nx = 6;
+    int nu = 1;
+    int nz = 5;
+
+    double x0[6] = {0.049999166670833, -4.999750002083326, 0.01, 0.0, 0.0, 0.0};
+    double u0[1] = {3.5};
+
+    /************************************************
+    * external functions (implicit model)
+    ************************************************/
+
+    // impl_ode_fun
+    external_function_param_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &pendulum_dae_dyn_impl_ode_fun;
+    impl_ode_fun.casadi_work = &pendulum_dae_dyn_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &pendulum_dae_dyn_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &pendulum_dae_dyn_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &pendulum_dae_dyn_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &pendulum_dae_dyn_impl_ode_fun_n_out;
+    external_function_param_casadi_create(&impl_ode_fun, 0);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_param_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_param_casadi_create(&impl_ode_fun_jac_x_xdot, 0);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_param_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &pendulum_dae_dyn_impl_ode_jac_x_xdot_u_n_out;
+    external_function_param_casadi_create(&impl_ode_jac_x_xdot_u, 0);
+
+    // impl_ode_fun_jac_x_xdot_u
+    external_function_param_casadi impl_ode_fun_jac_x_xdot_u;
+    impl_ode_fun_jac_x_xdot_u.casadi_fun = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u;
+    impl_ode_fun_jac_x_xdot_u.casadi_work = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u_work;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_in = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u_sparsity_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_out = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u_sparsity_out;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_in = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u_n_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_out = &pendulum_dae_dyn_impl_ode_fun_jac_x_xdot_u_n_out;
+    external_function_param_casadi_create(&impl_ode_fun_jac_x_xdot_u, 0);
+
+    // impl_ode_hess
+    external_function_param_casadi impl_ode_hess;
+    impl_ode_hess.casadi_fun = &pendulum_dae_dyn_impl_ode_hess;
+    impl_ode_hess.casadi_work = &pendulum_dae_dyn_impl_ode_hess_work;
+    impl_ode_hess.casadi_sparsity_in = &pendulum_dae_dyn_impl_ode_hess_sparsity_in;
+    impl_ode_hess.casadi_sparsity_out = &pendulum_dae_dyn_impl_ode_hess_sparsity_out;
+    impl_ode_hess.casadi_n_in = &pendulum_dae_dyn_impl_ode_hess_n_in;
+    impl_ode_hess.casadi_n_out = &pendulum_dae_dyn_impl_ode_hess_n_out;
+    external_function_param_casadi_create(&impl_ode_hess, 0);
+
+    /************************************************
+    * external functions (GNSF model)
+    ************************************************/
+
+    // phi_fun
+    external_function_param_casadi phi_fun;
+    phi_fun.casadi_fun = &pendulum_dae_dyn_gnsf_phi_fun;
+    phi_fun.casadi_work = &pendulum_dae_dyn_gnsf_phi_fun_work;
+    phi_fun.casadi_sparsity_in = &pendulum_dae_dyn_gnsf_phi_fun_sparsity_in;
+    phi_fun.casadi_sparsity_out = &pendulum_dae_dyn_gnsf_phi_fun_sparsity_out;
+    phi_fun.casadi_n_in = &pendulum_dae_dyn_gnsf_phi_fun_n_in;
+    phi_fun.casadi_n_out = &pendulum_dae_dyn_gnsf_phi_fun_n_out;
+    external_function_param_casadi_create(&phi_fun, 0);
+
+    // phi_fun_jac_y
+    external_function_param_casadi phi_fun_jac_y;
+    phi_fun_jac_y.casadi_fun = &pendulum_dae_dyn_gnsf_phi_fun_jac_y;
+    phi_fun_jac_y.casadi_work = &pendulum_dae_dyn_gnsf_phi_fun_jac_y_work;
+    phi_fun_jac_y.casadi_sparsity_in = &pendulum_dae_dyn_gnsf_phi_fun_jac_y_sparsity_in;
+    phi_fun_jac_y.casadi_sparsity_out = &pendulum_dae_dyn_gnsf_phi_fun_jac_y_sparsity_out;
+    phi_fun_jac_y.casadi_n_in = &pendulum_dae_dyn_gnsf_phi_fun_jac_y_n_in;
+    phi_fun_jac_y.casadi_n_out = &pendulum_dae_dyn_gnsf_phi_fun_jac_y_n_out;
+    external_function_param_casadi_create(&phi_fun_jac_y, 0);
+
+    // phi_jac_y_uhat
+    external_function_param_casadi phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_fun = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_work = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat_work;
+    phi_jac_y_uhat.casadi_sparsity_in = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat_sparsity_in;
+    phi_jac_y_uhat.casadi_sparsity_out = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat_sparsity_out;
+    phi_jac_y_uhat.casadi_n_in = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat_n_in;
+    phi_jac_y_uhat.casadi_n_out = &pendulum_dae_dyn_gnsf_phi_jac_y_uhat_n_out;
+    external_function_param_casadi_create(&phi_jac_y_uhat, 0);
+
+    // f_lo_fun_jac_x1k1uz
+    external_function_param_casadi f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_fun = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_work = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz_work;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_in = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz_sparsity_in;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_out = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz_sparsity_out;
+    f_lo_fun_jac_x1k1uz.casadi_n_in = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz_n_in;
+    f_lo_fun_jac_x1k1uz.casadi_n_out = &pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz_n_out;
+    external_function_param_casadi_create(&f_lo_fun_jac_x1k1uz, 0);
+
+    // get_matrices_fun
+    external_function_param_casadi get_matrices_fun;
+    get_matrices_fun.casadi_fun = &pendulum_dae_dyn_gnsf_get_matrices_fun;
+    get_matrices_fun.casadi_work = &pendulum_dae_dyn_gnsf_get_matrices_fun_work;
+    get_matrices_fun.casadi_sparsity_in = &pendulum_dae_dyn_gnsf_get_matrices_fun_sparsity_in;
+    get_matrices_fun.casadi_sparsity_out = &pendulum_dae_dyn_gnsf_get_matrices_fun_sparsity_out;
+    get_matrices_fun.casadi_n_in = &pendulum_dae_dyn_gnsf_get_matrices_fun_n_in;
+    get_matrices_fun.casadi_n_out = &pendulum_dae_dyn_gnsf_get_matrices_fun_n_out;
+    external_function_param_casadi_create(&get_matrices_fun, 0);
+
+    /************************************************
+    * benchmark
+    ************************************************/
+
+    sim_benchmark_model model;
+    sim_benchmark_model_init(&model);
+
+    model.name = "pendulum_dae";
+    model.nx = nx;
+    model.nu = nu;
+    model.nz = nz;
+    model.T = 0.1;
+    model.x0 = x0;
+    model.u0 = u0;
+
+    model.impl_ode_fun = (external_function_generic *) &impl_ode_fun;
+    model.impl_ode_fun_jac_x_xdot = (external_function_generic *) &impl_ode_fun_jac_x_xdot;
+    model.impl_ode_jac_x_xdot_u = (external_function_generic *) &impl_ode_jac_x_xdot_u;
+    model.impl_ode_fun_jac_x_xdot_u = (external_function_generic *) &impl_ode_fun_jac_x_xdot_u;
+    model.impl_ode_hess = (external_function_generic *) &impl_ode_hess;
+
+    model.nx1 = 5;
+    model.nz1 = 5;
+    model.nout = 3;
+    model.ny = 8;
+    model.nuhat = 1;
+    model.phi_fun = (external_function_generic *) &phi_fun;
+    model.phi_fun_jac_y = (external_function_generic *) &phi_fun_jac_y;
+    model.phi_jac_y_uhat = (external_function_generic *) &phi_jac_y_uhat;
+    model.f_lo_fun_jac_x1k1uz = (external_function_generic *) &f_lo_fun_jac_x1k1uz;
+    model.get_matrices_fun = (external_function_generic *) &get_matrices_fun;
+
+    sim_benchmark_run(&model, &opts);
+
+    /************************************************
+    * free
+    ************************************************/
+
+    external_function_param_casadi_free(&impl_ode_fun);
+    external_function_param_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_param_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_param_casadi_free(&impl_ode_fun_jac_x_xdot_u);
+    external_function_param_casadi_free(&impl_ode_hess);
+    external_function_param_casadi_free(&phi_fun);
+    external_function_param_casadi_free(&phi_fun_jac_y);
+    external_function_param_casadi_free(&phi_jac_y_uhat);
+    external_function_param_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_param_casadi_free(&get_matrices_fun);
+
+    sim_benchmark_opts_free(&opts);
+
+    return 0;
+}
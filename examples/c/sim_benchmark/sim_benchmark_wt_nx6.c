@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// integrator benchmark on the wind turbine model with nx = 6 (ERK, IRK, LIFTED_IRK, GNSF)
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados_c/external_function_interface.h"
+
+#include "examples/c/sim_benchmark/sim_benchmark.h"
+#include "examples/c/wt_model_nx6/wt_model.h"
+
+// x0 and u for simulation
+#include "examples/c/wt_model_nx6/u_x0.c"
+
+#define WT_NUM_PARAM_FUN 11
+
+
+
+int main(int argc, char **argv)
+{
+    sim_benchmark_opts opts;
+    sim_benchmark_opts_init(&opts, argc, argv);
+
+    int nx = 6;
+    int nu = 2;
+    int np = 1;
+
+    /************************************************
+    * external functions (explicit model)
+    ************************************************/
+
+    // expl_ode_fun
+    external_function_param_casadi expl_ode_fun;
+    expl_ode_fun.casadi_fun = &casadi_expl_ode_fun;
+    expl_ode_fun.casadi_work = &casadi_expl_ode_fun_work;
+    expl_ode_fun.casadi_sparsity_in = &casadi_expl_ode_fun_sparsity_in;
+    expl_ode_fun.casadi_sparsity_out = &casadi_expl_ode_fun_sparsity_out;
+    expl_ode_fun.casadi_n_in = &casadi_expl_ode_fun_n_in;
+    expl_ode_fun.casadi_n_out = &casadi_expl_ode_fun_n_out;
+    external_function_param_casadi_create(&expl_ode_fun, np);
+
+    // expl_vde_for
+    external_function_param_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_param_casadi_create(&expl_vde_for, np);
+
+    // expl_vde_adj
+    external_function_param_casadi expl_vde_adj;
+    expl_vde_adj.casadi_fun = &casadi_expl_vde_adj;
+    expl_vde_adj.casadi_work = &casadi_expl_vde_adj_work;
+    expl_vde_adj.casadi_sparsity_in = &casadi_expl_vde_adj_sparsity_in;
+    expl_vde_adj.casadi_sparsity_out = &casadi_expl_vde_adj_sparsity_out;
+    expl_vde_adj.casadi_n_in = &casadi_expl_vde_adj_n_in;
+    expl_vde_adj.casadi_n_out = &casadi_expl_vde_adj_n_out;
+    external_function_param_casadi_create(&expl_vde_adj, np);
+
+    /************************************************
+    * external functions (implicit model)
+    ************************************************/
+
+    // impl_ode_fun
+    external_function_param_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_param_casadi_create(&impl_ode_fun, np);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_param_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_param_casadi_create(&impl_ode_fun_jac_x_xdot, np);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_param_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_param_casadi_create(&impl_ode_jac_x_xdot_u, np);
+
+    // impl_ode_fun_jac_x_xdot_u
+    external_function_param_casadi impl_ode_fun_jac_x_xdot_u;
+    impl_ode_fun_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot_u;
+    impl_ode_fun_jac_x_xdot_u.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_u_work;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_u_sparsity_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_u_sparsity_out;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_u_n_in;
+    impl_ode_fun_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_u_n_out;
+    external_function_param_casadi_create(&impl_ode_fun_jac_x_xdot_u, np);
+
+    /************************************************
+    * external functions (GNSF model)
+    ************************************************/
+
+    // phi_fun
+    external_function_param_casadi phi_fun;
+    phi_fun.casadi_fun = &casadi_phi_fun;
+    phi_fun.casadi_work = &casadi_phi_fun_work;
+    phi_fun.casadi_sparsity_in = &casadi_phi_fun_sparsity_in;
+    phi_fun.casadi_sparsity_out = &casadi_phi_fun_sparsity_out;
+    phi_fun.casadi_n_in = &casadi_phi_fun_n_in;
+    phi_fun.casadi_n_out = &casadi_phi_fun_n_out;
+    external_function_param_casadi_create(&phi_fun, np);
+
+    // phi_fun_jac_y
+    external_function_param_casadi phi_fun_jac_y;
+    phi_fun_jac_y.casadi_fun = &casadi_phi_fun_jac_y;
+    phi_fun_jac_y.casadi_work = &casadi_phi_fun_jac_y_work;
+    phi_fun_jac_y.casadi_sparsity_in = &casadi_phi_fun_jac_y_sparsity_in;
+    phi_fun_jac_y.casadi_sparsity_out = &casadi_phi_fun_jac_y_sparsity_out;
+    phi_fun_jac_y.casadi_n_in = &casadi_phi_fun_jac_y_n_in;
+    phi_fun_jac_y.casadi_n_out = &casadi_phi_fun_jac_y_n_out;
+    external_function_param_casadi_create(&phi_fun_jac_y, np);
+
+    // phi_jac_y_uhat
+    external_function_param_casadi phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_fun = &casadi_phi_jac_y_uhat;
+    phi_jac_y_uhat.casadi_work = &casadi_phi_jac_y_uhat_work;
+    phi_jac_y_uhat.casadi_sparsity_in = &casadi_phi_jac_y_uhat_sparsity_in;
+    phi_jac_y_uhat.casadi_sparsity_out = &casadi_phi_jac_y_uhat_sparsity_out;
+    phi_jac_y_uhat.casadi_n_in = &casadi_phi_jac_y_uhat_n_in;
+    phi_jac_y_uhat.casadi_n_out = &casadi_phi_jac_y_uhat_n_out;
+    external_function_param_casadi_create(&phi_jac_y_uhat, np);
+
+    // f_lo_fun_jac_x1k1uz
+    external_function_param_casadi f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_fun = &casadi_f_lo_fun_jac_x1k1uz;
+    f_lo_fun_jac_x1k1uz.casadi_work = &casadi_f_lo_fun_jac_x1k1uz_work;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_in = &casadi_f_lo_fun_jac_x1k1uz_sparsity_in;
+    f_lo_fun_jac_x1k1uz.casadi_sparsity_out = &casadi_f_lo_fun_jac_x1k1uz_sparsity_out;
+    f_lo_fun_jac_x1k1uz.casadi_n_in = &casadi_f_lo_fun_jac_x1k1uz_n_in;
+    f_lo_fun_jac_x1k1uz.casadi_n_out = &casadi_f_lo_fun_jac_x1k1uz_n_out;
+    external_function_param_casadi_create(&f_lo_fun_jac_x1k1uz, np);
+
+    // get_matrices_fun
+    external_function_casadi get_matrices_fun;
+    get_matrices_fun.casadi_fun = &casadi_get_matrices_fun;
+    get_matrices_fun.casadi_work = &casadi_get_matrices_fun_work;
+    get_matrices_fun.casadi_sparsity_in = &casadi_get_matrices_fun_sparsity_in;
+    get_matrices_fun.casadi_sparsity_out = &casadi_get_matrices_fun_sparsity_out;
+    get_matrices_fun.casadi_n_in = &casadi_get_matrices_fun_n_in;
+    get_matrices_fun.casadi_n_out = &casadi_get_matrices_fun_n_out;
+    external_function_casadi_create(&get_matrices_fun);
+
+    // parameters of the first simulation step
+    external_function_param_casadi *param_fun[WT_NUM_PARAM_FUN] = {&expl_ode_fun, &expl_vde_for,
+        &expl_vde_adj, &impl_ode_fun, &impl_ode_fun_jac_x_xdot, &impl_ode_jac_x_xdot_u,
+        &impl_ode_fun_jac_x_xdot_u, &phi_fun, &phi_fun_jac_y, &phi_jac_y_uhat,
+        &f_lo_fun_jac_x1k1uz};
+    for (int ii = 0; ii < WT_NUM_PARAM_FUN; ii++)
+        param_fun[ii]->set_param(param_fun[ii], p_sim);
+
+    /************************************************
+    * benchmark
+    ************************************************/
+
+    sim_benchmark_model model;
+    sim_benchmark_model_init(&model);
+
+    model.name = "wt_nx6";
+    model.nx = nx;
+    model.nu = nu;
+    model.T = 0.2;
+    model.x0 = x_ref;
+    model.u0 = u_sim;
+
+    model.expl_ode_fun = (external_function_generic *) &expl_ode_fun;
+    model.expl_vde_for = (external_function_generic *) &expl_vde_for;
+    model.expl_vde_adj = (external_function_generic *) &expl_vde_adj;
+
+    model.impl_ode_fun = (external_function_generic *) &impl_ode_fun;
+    model.impl_ode_fun_jac_x_xdot = (external_function_generic *) &impl_ode_fun_jac_x_xdot;
+    model.impl_ode_jac_x_xdot_u = (external_function_generic *) &impl_ode_jac_x_xdot_u;
+    model.impl_ode_fun_jac_x_xdot_u = (external_function_generic *) &impl_ode_fun_jac_x_xdot_u;
+
+    model.nx1 = 6;
+    model.nz1 = 0;
+    model.nout = 1;
+    model.ny = 5;
+    model.nuhat = 0;
+    model.phi_fun = (external_function_generic *) &phi_fun;
+    model.phi_fun_jac_y = (external_function_generic *) &phi_fun_jac_y;
+    model.phi_jac_y_uhat = (external_function_generic *) &phi_jac_y_uhat;
+    model.f_lo_fun_jac_x1k1uz = (external_function_generic *) &f_lo_fun_jac_x1k1uz;
+    model.get_matrices_fun = (external_function_generic *) &get_matrices_fun;
+
+    sim_benchmark_run(&model, &opts);
+
+    /************************************************
+    * free
+    ************************************************/
+
+    for (int ii = 0; ii < WT_NUM_PARAM_FUN; ii++)
+        external_function_param_casadi_free(param_fun[ii]);
+    external_function_casadi_free(&get_matrices_fun);
+
+    sim_benchmark_opts_free(&opts);
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+// benchmark of the explicit Butcher tableaus on the chain model:
+// accuracy of x and forward sensitivities vs. cost per shooting interval
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// acados
+#include "acados/sim/sim_collocation_utils.h"
+#include "acados/utils/timing.h"
+
+#include "acados_c/external_function_interface.h"
+#include "acados_c/sim_interface.h"
+
+// chain model
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/chain_model/x0_nm4.c"
+
+
+#define NREP 200
+
+
+
+static double sim_chain(sim_erk_tableau_type tableau, int ns, int num_steps, double T,
+                        double *x0, double *u0, external_function_casadi *forw_vde,
+                        double *xn, double *S_forw, double *cpu_time)
+{
+    int nx = 18;
+    int nu = 3;
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    void *opts = sim_opts_create(config, dims);
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    sim_opts_set(config, opts, "erk_tableau", &tableau);
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    sim_in_set(config, dims, in, "T", &T);
+    sim_in_set(config, dims, in, "x", x0);
+    sim_in_set(config, dims, in, "u", u0);
+
+    // identity seed
+    double S_forw_in[18 * 21];
+    for (int ii = 0; ii < nx * (nx + nu); ii++)
+        S_forw_in[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        S_forw_in[ii * (nx + 1)] = 1.0;
+    sim_in_set(config, dims, in, "S_forw", S_forw_in);
+    sim_in_set(config, dims, in, "expl_vde_for", forw_vde);
+
+    sim_solver *solver = sim_solver_create(config, dims, opts);
+
+    acados_timer timer;
+    acados_tic(&timer);
+    for (int rep = 0; rep < NREP; rep++)
+    {
+        if (sim_solve(solver, in, out) != 0)
+        {
+            printf("\nerror in sim solver\n");
+            exit(1);
+        }
+    }
+    *cpu_time = acados_toc(&timer) / NREP;
+
+    sim_out_get(config, dims, out, "xn", xn);
+    sim_out_get(config, dims, out, "S_forw", S_forw);
+
+    // number of stages actually used
+    sim_opts_get(config, opts, "ns", &ns);
+
+    sim_solver_destroy(solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    return (double) ns * num_steps;
+}
+
+
+
+static double max_abs_diff(int n, double *a, double *b)
+{
+    double err = 0.0;
+    for (int ii = 0; ii < n; ii++)
+        err = fmax(err, fabs(a[ii] - b[ii]));
+    return err;
+}
+
+
+
+int main()
+{
+    int nx = 18;
+    int nu = 3;
+    int NF = nx + nu;
+
+    // one shooting interval of the nonlinear chain example
+    double T = 0.2;
+    double u0[3] = {0.1, -0.1, 0.1};
+
+    external_function_casadi forw_vde;
+    forw_vde.casadi_fun = &vde_chain_nm4;
+    forw_vde.casadi_work = &vde_chain_nm4_work;
+    forw_vde.casadi_sparsity_in = &vde_chain_nm4_sparsity_in;
+    forw_vde.casadi_sparsity_out = &vde_chain_nm4_sparsity_out;
+    forw_vde.casadi_n_in = &vde_chain_nm4_n_in;
+    forw_vde.casadi_n_out = &vde_chain_nm4_n_out;
+    external_function_casadi_create(&forw_vde);
+
+    double xn[18];
+    double S_forw[18 * 21];
+    double xn_ref[18];
+    double S_forw_ref[18 * 21];
+    double cpu_time;
+
+    // reference solution
+    sim_chain(ERK_COOPER_VERNER8, 0, 200, T, x0_nm4, u0, &forw_vde, xn_ref, S_forw_ref, &cpu_time);
+
+    sim_erk_tableau_type tableaus[] = {ERK_CLASSIC, ERK_RK4_38, ERK_CASH_KARP, ERK_DOPRI5,
+                                       ERK_BUTCHER6, ERK_COOPER_VERNER8};
+    const char *names[] = {"RK4", "RK4 3/8", "Cash-Karp 5", "DOPRI 5", "Butcher 6", "Cooper-Verner 8"};
+    int num_tableaus = 6;
+    int steps[] = {1, 2, 4, 8};
+    int num_step_settings = 4;
+
+    printf("\n%-16s %6s %8s %12s %12s %12s\n", "tableau", "steps", "VDE evals",
+           "err x", "err S_forw", "time [us]");
+    for (int it = 0; it < num_tableaus; it++)
+    {
+        for (int is = 0; is < num_step_settings; is++)
+        {
+            double num_evals = sim_chain(tableaus[it], 4, steps[is], T, x0_nm4, u0, &forw_vde,
+                                         xn, S_forw, &cpu_time);
+            printf("%-16s %6d %8.0f %12.3e %12.3e %12.2f\n", names[it], steps[is], num_evals,
+                   max_abs_diff(nx, xn, xn_ref), max_abs_diff(nx * NF, S_forw, S_forw_ref),
+                   1e6 * cpu_time);
+        }
+    }
+
+    external_function_casadi_free(&forw_vde);
+
+    return 0;
+}
@@ -56,6 +56,9 @@
 #define MAX_SQP_ITERS 10
 #define NREP 1
 
+// 1: nlp memory aliases cost gradients and constraint adjoints of the submodules
+#define FUSED_LINEARIZATION 1
+
 
 
 static void shift_states(ocp_nlp_dims *dims, ocp_nlp_out *out, double *x_end)
@@ -889,6 +892,9 @@ int main()
         ocp_nlp_solver_opts_set(config, nlp_opts, "qp_cond_N", &cond_N);
     }
 
+    int fused_linearization = FUSED_LINEARIZATION;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "fused_linearization", &fused_linearization);
+
     // update opts after manual changes
     ocp_nlp_solver_opts_update(config, dims, nlp_opts);
 
@@ -1037,6 +1043,31 @@ int main()
 
     printf("\n\ntotal time (including printing) = %f ms (time per SQP = %f)\n\n", time*1e3, time*1e3/n_sim);
 
+    // compare the linearization time without and with fused linearization on the last problem,
+    // each solver starting from the same initial guess
+    ocp_nlp_out *cmp_nlp_out = ocp_nlp_out_create(config, dims);
+    for (int fused = 0; fused < 2; fused++)
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "fused_linearization", &fused);
+        ocp_nlp_solver *solver_cmp = ocp_nlp_solver_create(config, dims, nlp_opts);
+        ocp_nlp_precompute(solver_cmp, nlp_in, cmp_nlp_out);
+
+        for (int i=0; i<=NN; i++)
+        {
+            blasfeo_pack_dvec(2, u0_ref, 1, cmp_nlp_out->ux+i, 0);
+            blasfeo_pack_dvec(nx[i], x0_ref, 1, cmp_nlp_out->ux+i, nu[i]);
+        }
+        ocp_nlp_solve(solver_cmp, nlp_in, cmp_nlp_out);
+
+        double time_lin;
+        ocp_nlp_get(config, solver_cmp, "time_lin", &time_lin);
+        printf("fused_linearization = %d: linearization time = %f ms\n", fused, time_lin*1e3);
+
+        ocp_nlp_solver_destroy(solver_cmp);
+    }
+    printf("\n");
+    ocp_nlp_out_destroy(cmp_nlp_out);
+
 #if 0
 	d_print_mat(nx_, n_sim+1, x_sim, nx_);
 	d_print_mat(nu_, n_sim, u_sim, nu_);
@@ -58,6 +58,19 @@ void external_function_param_generic_create(external_function_param_generic *fun
 
 
 
+void external_function_param_generic_create_shared(external_function_param_generic *fun, int np,
+                                                   double *p_shared)
+{
+    acados_size_t fun_size = external_function_param_generic_calculate_size_shared(fun, np);
+    void *fun_mem = acados_malloc(1, fun_size);
+    assert(fun_mem != 0);
+    external_function_param_generic_assign_shared(fun, fun_mem, p_shared);
+
+    return;
+}
+
+
+
 void external_function_param_generic_free(external_function_param_generic *fun)
 {
     free(fun->ptr_ext_mem);
@@ -157,6 +170,19 @@ void external_function_param_casadi_create(external_function_param_casadi *fun,
 
 
 
+void external_function_param_casadi_create_shared(external_function_param_casadi *fun, int np,
+                                                  double *p_shared)
+{
+    acados_size_t fun_size = external_function_param_casadi_calculate_size_shared(fun, np);
+    void *fun_mem = acados_malloc(1, fun_size);
+    assert(fun_mem != 0);
+    external_function_param_casadi_assign_shared(fun, fun_mem, p_shared);
+
+    return;
+}
+
+
+
 void external_function_param_casadi_create_array(int size, external_function_param_casadi *funs, int np)
 {
     // loop index
@@ -46,6 +46,9 @@ extern "C" {
 
 //
 void external_function_param_generic_create(external_function_param_generic *fun, int np);
+// parameters are not copied into the function, it uses the np parameters at p_shared
+void external_function_param_generic_create_shared(external_function_param_generic *fun, int np,
+                                                   double *p_shared);
 //
 void external_function_param_generic_free(external_function_param_generic *fun);
 
@@ -72,6 +75,9 @@ void external_function_casadi_free_array(int size, external_function_casadi *fun
 
 //
 void external_function_param_casadi_create(external_function_param_casadi *fun, int np);
+// parameters are not copied into the function, it uses the np parameters at p_shared
+void external_function_param_casadi_create_shared(external_function_param_casadi *fun, int np,
+                                                  double *p_shared);
 //
 void external_function_param_casadi_free(external_function_param_casadi *fun);
 //
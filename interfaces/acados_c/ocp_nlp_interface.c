@@ -384,16 +384,33 @@ void ocp_nlp_in_destroy(void *in_)
 void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         const char *field, void *value)
 {
-    if (!strcmp(field, "Ts"))
-    {
-        double *Ts_value = value;
-        in->Ts[stage] = Ts_value[0];
-    }
-    else
+    int field_id = acados_field_id(field);
+    if (field_id == ACADOS_FIELD_UNKNOWN)
     {
         printf("\nerror: ocp_nlp_in_set: field %s not available\n", field);
         exit(1);
     }
+    ocp_nlp_in_set_by_id(config, dims, in, stage, field_id, value);
+    return;
+}
+
+
+
+void ocp_nlp_in_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+        int stage, int field_id, void *value)
+{
+    double *double_values = value;
+
+    switch (field_id)
+    {
+        case ACADOS_FIELD_TS:
+            in->Ts[stage] = double_values[0];
+            break;
+        default:
+            printf("\nerror: ocp_nlp_in_set: field %s not available\n",
+                   acados_field_name(field_id));
+            exit(1);
+    }
     return;
 }
 
@@ -439,6 +456,17 @@ int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 
 
 
+int ocp_nlp_cost_model_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, int stage, int field_id, void *value)
+{
+    ocp_nlp_cost_config *cost_config = config->cost[stage];
+
+    return cost_config->model_set_by_id(cost_config, dims->cost[stage], in->cost[stage],
+            field_id, value);
+}
+
+
+
 int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value)
 {
@@ -449,6 +477,17 @@ int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 }
 
 
+
+int ocp_nlp_constraints_model_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, int stage, int field_id, void *value)
+{
+    ocp_nlp_constraints_config *constr_config = config->constraints[stage];
+
+    return constr_config->model_set_by_id(constr_config, dims->constraints[stage],
+            in->constraints[stage], field_id, value);
+}
+
+
 void ocp_nlp_constraints_model_get(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value)
 {
@@ -496,111 +535,291 @@ void ocp_nlp_out_destroy(void *out_)
 void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value)
 {
-    if (!strcmp(field, "x"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->nx[stage], double_values, 1, &out->ux[stage], dims->nu[stage]);
-    }
-    else if (!strcmp(field, "u"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->nu[stage], double_values, 1, &out->ux[stage], 0);
-    }
-    else if (!strcmp(field, "sl"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
-                            dims->nu[stage] + dims->nx[stage]);
-    }
-    else if (!strcmp(field, "su"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
-                            dims->nu[stage] + dims->nx[stage] + dims->ns[stage]);
-    }
-    else if (!strcmp(field, "pi"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->nx[stage+1], double_values, 1, &out->pi[stage], 0);
-    }
-    else if (!strcmp(field, "lam"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(2*dims->ni[stage], double_values, 1, &out->lam[stage], 0);
-    }
-    else if (!strcmp(field, "t"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(2*dims->ni[stage], double_values, 1, &out->t[stage], 0);
-    }
-    else if (!strcmp(field, "z"))
-    {
-        double *double_values = value;
-        blasfeo_pack_dvec(dims->nz[stage], double_values, 1, &out->z[stage], 0);
-    }
-    else
+    int field_id = acados_field_id(field);
+    if (field_id == ACADOS_FIELD_UNKNOWN)
     {
         printf("\nerror: ocp_nlp_out_set: field %s not available\n", field);
         exit(1);
     }
+    ocp_nlp_out_set_by_id(config, dims, out, stage, field_id, value);
 }
 
 
 
-void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
-        int stage, const char *field, void *value)
+void ocp_nlp_out_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, int field_id, void *value)
 {
-    if (!strcmp(field, "x"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nx[stage], &out->ux[stage], dims->nu[stage], double_values, 1);
-    }
-    else if (!strcmp(field, "u"))
+    double *double_values = value;
+
+    switch (field_id)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nu[stage], &out->ux[stage], 0, double_values, 1);
+        case ACADOS_FIELD_X:
+            blasfeo_pack_dvec(dims->nx[stage], double_values, 1, &out->ux[stage], dims->nu[stage]);
+            break;
+        case ACADOS_FIELD_U:
+            blasfeo_pack_dvec(dims->nu[stage], double_values, 1, &out->ux[stage], 0);
+            break;
+        case ACADOS_FIELD_SL:
+            blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
+                                dims->nu[stage] + dims->nx[stage]);
+            break;
+        case ACADOS_FIELD_SU:
+            blasfeo_pack_dvec(dims->ns[stage], double_values, 1, &out->ux[stage],
+                                dims->nu[stage] + dims->nx[stage] + dims->ns[stage]);
+            break;
+        case ACADOS_FIELD_PI:
+            blasfeo_pack_dvec(dims->nx[stage+1], double_values, 1, &out->pi[stage], 0);
+            break;
+        case ACADOS_FIELD_LAM:
+            blasfeo_pack_dvec(2*dims->ni[stage], double_values, 1, &out->lam[stage], 0);
+            break;
+        case ACADOS_FIELD_T:
+            blasfeo_pack_dvec(2*dims->ni[stage], double_values, 1, &out->t[stage], 0);
+            break;
+        case ACADOS_FIELD_Z:
+            blasfeo_pack_dvec(dims->nz[stage], double_values, 1, &out->z[stage], 0);
+            break;
+        default:
+            printf("\nerror: ocp_nlp_out_set: field %s not available\n",
+                   acados_field_name(field_id));
+            exit(1);
     }
-    else if (!strcmp(field, "sl"))
+}
+
+
+
+void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, const char *field, void *value)
+{
+    int field_id = acados_field_id(field);
+    if (field_id == ACADOS_FIELD_UNKNOWN)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
-             dims->nu[stage] + dims->nx[stage], double_values, 1);
+        printf("\nerror: ocp_nlp_out_get: field %s not available\n", field);
+        exit(1);
     }
-    else if (!strcmp(field, "su"))
+    ocp_nlp_out_get_by_id(config, dims, out, stage, field_id, value);
+}
+
+
+
+void ocp_nlp_out_get_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, int field_id, void *value)
+{
+    double *double_values = value;
+
+    switch (field_id)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
-             dims->nu[stage] + dims->nx[stage] + dims->ns[stage], double_values, 1);
+        case ACADOS_FIELD_X:
+            blasfeo_unpack_dvec(dims->nx[stage], &out->ux[stage], dims->nu[stage], double_values, 1);
+            break;
+        case ACADOS_FIELD_U:
+            blasfeo_unpack_dvec(dims->nu[stage], &out->ux[stage], 0, double_values, 1);
+            break;
+        case ACADOS_FIELD_SL:
+            blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
+                 dims->nu[stage] + dims->nx[stage], double_values, 1);
+            break;
+        case ACADOS_FIELD_SU:
+            blasfeo_unpack_dvec(dims->ns[stage], &out->ux[stage],
+                 dims->nu[stage] + dims->nx[stage] + dims->ns[stage], double_values, 1);
+            break;
+        case ACADOS_FIELD_Z:
+            blasfeo_unpack_dvec(dims->nz[stage], &out->z[stage], 0, double_values, 1);
+            break;
+        case ACADOS_FIELD_PI:
+            blasfeo_unpack_dvec(dims->nx[stage+1], &out->pi[stage], 0, double_values, 1);
+            break;
+        case ACADOS_FIELD_LAM:
+            blasfeo_unpack_dvec(2*dims->ni[stage], &out->lam[stage], 0, double_values, 1);
+            break;
+        case ACADOS_FIELD_T:
+            blasfeo_unpack_dvec(2*dims->ni[stage], &out->t[stage], 0, double_values, 1);
+            break;
+        case ACADOS_FIELD_KKT_NORM_INF:
+            double_values[0] = out->inf_norm_res;
+            break;
+        default:
+            printf("\nerror: ocp_nlp_out_get: field %s not available\n",
+                   acados_field_name(field_id));
+            exit(1);
     }
-    else if (!strcmp(field, "z"))
-    {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nz[stage], &out->z[stage], 0, double_values, 1);
+}
+
+
+
+/************************************************
+* whole horizon
+************************************************/
+
+// number of stages a field is defined on, stage-major arrays cover stages 0 to this - 1
+static int ocp_nlp_field_num_stages(ocp_nlp_dims *dims, int field_id)
+{
+    if (field_id == ACADOS_FIELD_PI)
+        return dims->N;
+    return dims->N + 1;
+}
+
+
+
+// size of a field at the given stage, -1 if the field has no per-stage vector
+// or the module of the stage does not provide it
+static int ocp_nlp_field_stage_dim(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        int stage, int field_id)
+{
+    switch (field_id)
+    {
+        case ACADOS_FIELD_X:
+            return dims->nx[stage];
+        case ACADOS_FIELD_U:
+            return dims->nu[stage];
+        case ACADOS_FIELD_Z:
+            return dims->nz[stage];
+        case ACADOS_FIELD_SL:
+        case ACADOS_FIELD_SU:
+        case ACADOS_FIELD_ZL_MAT:
+        case ACADOS_FIELD_ZU_MAT:
+        case ACADOS_FIELD_ZL:
+        case ACADOS_FIELD_ZU:
+            return dims->ns[stage];
+        case ACADOS_FIELD_PI:
+            return dims->nx[stage+1];
+        case ACADOS_FIELD_LAM:
+        case ACADOS_FIELD_T:
+            return 2*dims->ni[stage];
+        case ACADOS_FIELD_YREF:
+            // not all cost modules have a reference, ask the module
+            return config->cost[stage]->model_field_dim(config->cost[stage],
+                    dims->cost[stage], field_id);
+        case ACADOS_FIELD_LBX:
+        case ACADOS_FIELD_UBX:
+        case ACADOS_FIELD_LBU:
+        case ACADOS_FIELD_UBU:
+        case ACADOS_FIELD_LG:
+        case ACADOS_FIELD_UG:
+        case ACADOS_FIELD_LH:
+        case ACADOS_FIELD_UH:
+        case ACADOS_FIELD_LPHI:
+        case ACADOS_FIELD_UPHI:
+            return config->constraints[stage]->model_field_dim(config->constraints[stage],
+                    dims->constraints[stage], field_id);
+        default:
+            return -1;
     }
-    else if (!strcmp(field, "pi"))
+}
+
+
+
+static int ocp_nlp_field_id_all(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        const char *field, const char *caller)
+{
+    int field_id = acados_field_id(field);
+    if (field_id != ACADOS_FIELD_UNKNOWN)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(dims->nx[stage+1], &out->pi[stage], 0, double_values, 1);
+        // the field has to be provided by the module of at least one stage
+        int num_stages = ocp_nlp_field_num_stages(dims, field_id);
+        for (int stage = 0; stage < num_stages; stage++)
+        {
+            if (ocp_nlp_field_stage_dim(config, dims, stage, field_id) >= 0)
+                return field_id;
+        }
     }
-    else if (!strcmp(field, "lam"))
+    printf("\nerror: %s: field %s not available\n", caller, field);
+    exit(1);
+}
+
+
+
+int ocp_nlp_dims_get_all_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field)
+{
+    int field_id = ocp_nlp_field_id_all(config, dims, field, "ocp_nlp_dims_get_all_from_attr");
+    int num_stages = ocp_nlp_field_num_stages(dims, field_id);
+
+    int size = 0;
+    for (int stage = 0; stage < num_stages; stage++)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(2*dims->ni[stage], &out->lam[stage], 0, double_values, 1);
+        int dim = ocp_nlp_field_stage_dim(config, dims, stage, field_id);
+        if (dim > 0)
+            size += dim;
     }
-    else if (!strcmp(field, "t"))
+
+    return size;
+}
+
+
+
+void ocp_nlp_out_get_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value)
+{
+    int field_id = ocp_nlp_field_id_all(config, dims, field, "ocp_nlp_out_get_all");
+    int num_stages = ocp_nlp_field_num_stages(dims, field_id);
+    double *double_values = value;
+
+    for (int stage = 0; stage < num_stages; stage++)
     {
-        double *double_values = value;
-        blasfeo_unpack_dvec(2*dims->ni[stage], &out->t[stage], 0, double_values, 1);
+        ocp_nlp_out_get_by_id(config, dims, out, stage, field_id, double_values);
+        double_values += ocp_nlp_field_stage_dim(config, dims, stage, field_id);
     }
-    else if ((!strcmp(field, "kkt_norm_inf")) || (!strcmp(field, "kkt_norm")))
+}
+
+
+
+void ocp_nlp_out_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value)
+{
+    int field_id = ocp_nlp_field_id_all(config, dims, field, "ocp_nlp_out_set_all");
+    int num_stages = ocp_nlp_field_num_stages(dims, field_id);
+    double *double_values = value;
+
+    for (int stage = 0; stage < num_stages; stage++)
     {
-        double *double_values = value;
-        double_values[0] = out->inf_norm_res;
+        ocp_nlp_out_set_by_id(config, dims, out, stage, field_id, double_values);
+        double_values += ocp_nlp_field_stage_dim(config, dims, stage, field_id);
     }
-    else
+}
+
+
+
+void ocp_nlp_in_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+        const char *field, void *value)
+{
+    int field_id = ocp_nlp_field_id_all(config, dims, field, "ocp_nlp_in_set_all");
+    int num_stages = ocp_nlp_field_num_stages(dims, field_id);
+    double *double_values = value;
+
+    for (int stage = 0; stage < num_stages; stage++)
     {
-        printf("\nerror: ocp_nlp_out_get: field %s not available\n", field);
-        exit(1);
+        // stages whose module does not have the field take no entries of value
+        int dim = ocp_nlp_field_stage_dim(config, dims, stage, field_id);
+        if (dim < 0)
+            continue;
+
+        switch (field_id)
+        {
+            case ACADOS_FIELD_YREF:
+            case ACADOS_FIELD_ZL_MAT:
+            case ACADOS_FIELD_ZU_MAT:
+            case ACADOS_FIELD_ZL:
+            case ACADOS_FIELD_ZU:
+                ocp_nlp_cost_model_set_by_id(config, dims, in, stage, field_id, double_values);
+                break;
+            case ACADOS_FIELD_LBX:
+            case ACADOS_FIELD_UBX:
+            case ACADOS_FIELD_LBU:
+            case ACADOS_FIELD_UBU:
+            case ACADOS_FIELD_LG:
+            case ACADOS_FIELD_UG:
+            case ACADOS_FIELD_LH:
+            case ACADOS_FIELD_UH:
+            case ACADOS_FIELD_LPHI:
+            case ACADOS_FIELD_UPHI:
+                ocp_nlp_constraints_model_set_by_id(config, dims, in, stage, field_id, double_values);
+                break;
+            default:
+                printf("\nerror: ocp_nlp_in_set_all: field %s not available\n", field);
+                exit(1);
+        }
+        double_values += dim;
     }
 }
 
@@ -1064,6 +1283,224 @@ int ocp_nlp_precompute(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *
 
 
 
+/************************************************
+* batch of solvers
+************************************************/
+
+static acados_size_t ocp_nlp_solver_batch_calculate_size(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, void **instance_opts, int num_instances)
+{
+    acados_size_t bytes = sizeof(ocp_nlp_solver_batch);
+
+    bytes += 4 * num_instances * sizeof(void *);  // instance_opts, nlp_in, nlp_out, solver
+    bytes += 2 * num_instances * sizeof(int);     // status, sqp_iter
+    bytes += 1 * num_instances * sizeof(double);  // time_tot
+
+    // instances, each aligned to a cache line
+    for (int ii = 0; ii < num_instances; ii++)
+    {
+        bytes += ocp_nlp_in_calculate_size(config, dims);
+        bytes += ocp_nlp_out_calculate_size(config, dims);
+        bytes += ocp_nlp_calculate_size(config, dims, instance_opts[ii]);
+        bytes += 3 * 64;  // align
+    }
+
+    bytes += 8;  // align to double
+
+    return bytes;
+}
+
+
+
+ocp_nlp_solver_batch *ocp_nlp_solver_batch_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_solver_opts_set_fun set_opts, void *user_data, int num_instances)
+{
+    int ii;
+
+    // the solvers write to their options during the solve (e.g. warm start of the first QP,
+    // sensitivity flags of the integrators), so each instance gets its own options,
+    // created with the defaults and set by the user function
+    void **instance_opts = (void **) acados_malloc(num_instances, sizeof(void *));
+    assert(instance_opts != 0);
+    for (ii = 0; ii < num_instances; ii++)
+    {
+        instance_opts[ii] = ocp_nlp_solver_opts_create(config, dims);
+        if (set_opts != NULL)
+            set_opts(config, dims, instance_opts[ii], user_data);
+        config->opts_update(config, dims, instance_opts[ii]);
+    }
+
+    acados_size_t bytes = ocp_nlp_solver_batch_calculate_size(config, dims, instance_opts, num_instances);
+
+    void *raw_memory = acados_calloc(1, bytes);
+    assert(raw_memory != 0);
+
+    char *c_ptr = (char *) raw_memory;
+
+    ocp_nlp_solver_batch *batch = (ocp_nlp_solver_batch *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_solver_batch);
+
+    batch->config = config;
+    batch->dims = dims;
+    batch->num_instances = num_instances;
+    batch->raw_memory = raw_memory;
+
+    ocp_nlp_opts *nlp_opts;
+    config->opts_get(config, dims, instance_opts[0], "nlp_opts", &nlp_opts);
+    batch->num_threads = nlp_opts->num_threads;
+    batch->schedule = STAGE_SCHEDULE_DYNAMIC;
+
+    batch->instance_opts = (void **) c_ptr;
+    c_ptr += num_instances * sizeof(void *);
+    batch->nlp_in = (ocp_nlp_in **) c_ptr;
+    c_ptr += num_instances * sizeof(ocp_nlp_in *);
+    batch->nlp_out = (ocp_nlp_out **) c_ptr;
+    c_ptr += num_instances * sizeof(ocp_nlp_out *);
+    batch->solver = (ocp_nlp_solver **) c_ptr;
+    c_ptr += num_instances * sizeof(ocp_nlp_solver *);
+
+    assign_and_advance_int(num_instances, &batch->status, &c_ptr);
+    assign_and_advance_int(num_instances, &batch->sqp_iter, &c_ptr);
+    align_char_to(8, &c_ptr);
+    assign_and_advance_double(num_instances, &batch->time_tot, &c_ptr);
+
+    for (ii = 0; ii < num_instances; ii++)
+    {
+        batch->instance_opts[ii] = instance_opts[ii];
+
+        align_char_to(64, &c_ptr);
+        batch->nlp_in[ii] = ocp_nlp_in_assign(config, dims, c_ptr);
+        batch->nlp_in[ii]->raw_memory = NULL;  // owned by the batch
+        c_ptr += ocp_nlp_in_calculate_size(config, dims);
+
+        align_char_to(64, &c_ptr);
+        batch->nlp_out[ii] = ocp_nlp_out_assign(config, dims, c_ptr);
+        batch->nlp_out[ii]->raw_memory = NULL;  // owned by the batch
+        c_ptr += ocp_nlp_out_calculate_size(config, dims);
+
+        align_char_to(64, &c_ptr);
+        batch->solver[ii] = ocp_nlp_assign(config, dims, batch->instance_opts[ii], c_ptr);
+        c_ptr += ocp_nlp_calculate_size(config, dims, batch->instance_opts[ii]);
+    }
+
+    assert((char *) raw_memory + bytes >= c_ptr);
+
+    free(instance_opts);
+
+    return batch;
+}
+
+
+
+void ocp_nlp_solver_batch_destroy(void *batch_)
+{
+    ocp_nlp_solver_batch *batch = batch_;
+    for (int ii = 0; ii < batch->num_instances; ii++)
+        ocp_nlp_solver_opts_destroy(batch->instance_opts[ii]);
+    free(batch->raw_memory);
+}
+
+
+
+void ocp_nlp_solver_batch_set(ocp_nlp_solver_batch *batch, const char *field, void *value)
+{
+    if (!strcmp(field, "num_threads"))
+    {
+        int *num_threads = (int *) value;
+        batch->num_threads = *num_threads;
+    }
+    else if (!strcmp(field, "schedule"))
+    {
+        char *schedule = (char *) value;
+        if (!strcmp(schedule, "serial"))
+            batch->schedule = STAGE_SCHEDULE_SERIAL;
+        else if (!strcmp(schedule, "static"))
+            batch->schedule = STAGE_SCHEDULE_STATIC;
+        else if (!strcmp(schedule, "dynamic"))
+            batch->schedule = STAGE_SCHEDULE_DYNAMIC;
+        else
+        {
+            printf("\nerror: ocp_nlp_solver_batch_set: schedule %s not available\n", schedule);
+            exit(1);
+        }
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_solver_batch_set: field %s not available\n", field);
+        exit(1);
+    }
+    return;
+}
+
+
+
+int ocp_nlp_precompute_batch(ocp_nlp_solver_batch *batch)
+{
+    int status = ACADOS_SUCCESS;
+
+    for (int ii = 0; ii < batch->num_instances; ii++)
+    {
+        batch->status[ii] = ocp_nlp_precompute(batch->solver[ii], batch->nlp_in[ii],
+                                               batch->nlp_out[ii]);
+        if (status == ACADOS_SUCCESS)
+            status = batch->status[ii];
+    }
+
+    return status;
+}
+
+
+
+static void ocp_nlp_solve_batch_instance(ocp_nlp_solver_batch *batch, int ii)
+{
+    ocp_nlp_solver *solver = batch->solver[ii];
+
+    batch->status[ii] = ocp_nlp_solve(solver, batch->nlp_in[ii], batch->nlp_out[ii]);
+
+    ocp_nlp_get(solver->config, solver, "sqp_iter", batch->sqp_iter + ii);
+    ocp_nlp_get(solver->config, solver, "time_tot", batch->time_tot + ii);
+}
+
+
+
+int ocp_nlp_solve_batch(ocp_nlp_solver_batch *batch)
+{
+    int ii;
+    int num_instances = batch->num_instances;
+
+#if defined(ACADOS_WITH_OPENMP)
+    int num_threads = batch->num_threads < 1 ? 1 : batch->num_threads;
+    if (batch->schedule == STAGE_SCHEDULE_DYNAMIC)
+    {
+        #pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+        for (ii = 0; ii < num_instances; ii++)
+            ocp_nlp_solve_batch_instance(batch, ii);
+    }
+    else if (batch->schedule == STAGE_SCHEDULE_STATIC)
+    {
+        #pragma omp parallel for num_threads(num_threads) schedule(static)
+        for (ii = 0; ii < num_instances; ii++)
+            ocp_nlp_solve_batch_instance(batch, ii);
+    }
+    else
+#endif
+    {
+        for (ii = 0; ii < num_instances; ii++)
+            ocp_nlp_solve_batch_instance(batch, ii);
+    }
+
+    int status = ACADOS_SUCCESS;
+    for (ii = 0; ii < num_instances; ii++)
+    {
+        if (status == ACADOS_SUCCESS)
+            status = batch->status[ii];
+    }
+
+    return status;
+}
+
+
+
 void ocp_nlp_eval_param_sens(ocp_nlp_solver *solver, char *field, int stage, int index,
                              ocp_nlp_out *sens_nlp_out)
 {
@@ -43,6 +43,7 @@ extern "C" {
 #include "acados/sim/sim_irk_integrator.h"
 #include "acados/sim/sim_lifted_irk_integrator.h"
 #include "acados/sim/sim_gnsf.h"
+#include "acados/utils/fields.h"
 #include "acados/utils/types.h"
 // acados_c
 #include "acados_c/ocp_qp_interface.h"
@@ -135,6 +136,30 @@ typedef struct ocp_nlp_solver
 } ocp_nlp_solver;
 
 
+/// Function setting the options of one instance of a batch, e.g. through ocp_nlp_solver_opts_set.
+typedef void (*ocp_nlp_solver_opts_set_fun)(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                            void *opts, void *user_data);
+
+/// Structure to store a batch of solvers for instances of the same optimal control problem,
+/// sharing one configuration and dimension struct; every instance works on its own options
+typedef struct ocp_nlp_solver_batch
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    int num_instances;
+    void **instance_opts;        // options of the instances, created by ocp_nlp_solver_opts_create
+    ocp_nlp_in **nlp_in;         // inputs of the instances
+    ocp_nlp_out **nlp_out;       // outputs of the instances
+    ocp_nlp_solver **solver;     // solvers of the instances
+    int *status;                 // solver status of the instances after ocp_nlp_solve_batch
+    int *sqp_iter;               // number of SQP iterations of the instances
+    double *time_tot;            // total solution time of the instances
+    int num_threads;             // number of threads solving instances in parallel
+    ocp_nlp_stage_schedule_t schedule;  // assignment of the instances to the threads
+    void *raw_memory;            // pointer to the arena holding all of the above
+} ocp_nlp_solver_batch;
+
+
 /// Constructs an empty plan struct (user nlp configuration), all fields are set to a
 /// default/invalid state.
 ///
@@ -192,6 +217,10 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_in_destroy(void *in);
 ACADOS_SYMBOL_EXPORT void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         const char *field, void *value);
 
+/// Same as ocp_nlp_in_set, with the field given by its handle from acados_field_id().
+ACADOS_SYMBOL_EXPORT void ocp_nlp_in_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+        int stage, int field_id, void *value);
+
 ///
 // void ocp_nlp_in_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
 //         const char *field, void *value);
@@ -221,6 +250,11 @@ ACADOS_SYMBOL_EXPORT int ocp_nlp_dynamics_model_set(ocp_nlp_config *config, ocp_
 ACADOS_SYMBOL_EXPORT int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
         int stage, const char *field, void *value);
 
+/// Same as ocp_nlp_cost_model_set, with the field given by its handle from acados_field_id().
+/// yref, W, Zl, Zu, zl, zu are dispatched without string comparisons.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_cost_model_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, int stage, int field_id, void *value);
+
 
 /// Sets the function pointers to the constraints functions for the given stage.
 ///
@@ -233,6 +267,11 @@ ACADOS_SYMBOL_EXPORT int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_
 ACADOS_SYMBOL_EXPORT int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value);
 
+/// Same as ocp_nlp_constraints_model_set, with the field given by its handle from acados_field_id().
+/// Bounds on x, u, g and h (phi) are dispatched without string comparisons.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_constraints_model_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims,
+        ocp_nlp_in *in, int stage, int field_id, void *value);
+
 ///
 ACADOS_SYMBOL_EXPORT void ocp_nlp_constraints_model_get(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value);
@@ -262,6 +301,10 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_out_destroy(void *out);
 ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value);
 
+/// Same as ocp_nlp_out_set, with the field given by its handle from acados_field_id().
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, int field_id, void *value);
+
 
 /// Gets values of fields in the output struct of an nlp solver.
 ///
@@ -274,6 +317,41 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *
 ACADOS_SYMBOL_EXPORT void ocp_nlp_out_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, void *value);
 
+/// Same as ocp_nlp_out_get, with the field given by its handle from acados_field_id().
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_get_by_id(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        int stage, int field_id, void *value);
+
+/* whole horizon */
+
+/// Gets a field of the output struct for all stages at once.
+/// The stage vectors are concatenated stage-major into value, i.e. for "x" value has to hold
+/// nx[0] + ... + nx[N] doubles, see ocp_nlp_dims_get_all_from_attr.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param out The output struct.
+/// \param field The name of the field, either x, u, z, sl, su, pi (stages 0 to N-1), lam, t.
+/// \param value Pointer to the output memory.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_get_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value);
+
+/// Sets a field of the output struct for all stages at once, layout as in ocp_nlp_out_get_all.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_out_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value);
+
+/// Sets a cost or constraints field for all stages at once from one stage-major array.
+/// Stages whose cost or constraints module does not have the field, e.g. yref with an
+/// external cost or lh with BGP constraints, take no entries of the array.
+///
+/// \param field The name of the field, either yref, Zl, Zu, zl, zu, lbx, ubx, lbu, ubu, lg, ug,
+///     lh, uh, lphi, uphi.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_in_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+        const char *field, void *value);
+
+/// Returns the length of the stage-major array of a field used by the *_all functions.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_dims_get_all_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field);
+
 //
 ACADOS_SYMBOL_EXPORT void ocp_nlp_get_at_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_solver *solver,
         int stage, const char *field, void *value);
@@ -352,6 +430,50 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_destroy(void *solver);
 ACADOS_SYMBOL_EXPORT int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
 
+/// Creates a batch of solvers for num_instances instances of the same optimal control problem.
+/// Inputs, outputs and solver memory of all instances are allocated in one contiguous arena,
+/// each instance starts on its own cache line.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param set_opts Function called once per instance on options freshly created by
+///                 ocp_nlp_solver_opts_create, to apply the settings of the user;
+///                 NULL keeps the default options.
+/// \param user_data Passed to set_opts.
+/// \param num_instances Number of instances.
+/// \return The batch.
+ACADOS_SYMBOL_EXPORT ocp_nlp_solver_batch *ocp_nlp_solver_batch_create(ocp_nlp_config *config,
+        ocp_nlp_dims *dims, ocp_nlp_solver_opts_set_fun set_opts, void *user_data, int num_instances);
+
+/// Destructor of the batch, frees the options, inputs, outputs and solvers of all instances.
+///
+/// \param batch The batch struct.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_batch_destroy(void *batch);
+
+/// Sets an option of the batch.
+///
+/// \param batch The batch struct.
+/// \param field Either "num_threads" (int) or "schedule" (string: "serial", "static", "dynamic").
+/// \param value Value of the option.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_batch_set(ocp_nlp_solver_batch *batch, const char *field,
+        void *value);
+
+/// Performs the precomputations for all instances of the batch.
+///
+/// \param batch The batch struct.
+/// \return ACADOS_SUCCESS, or the first nonzero status of an instance.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_precompute_batch(ocp_nlp_solver_batch *batch);
+
+/// Solves all instances of the batch, in parallel if acados is compiled with OpenMP.
+/// Status, number of SQP iterations and solution time of each instance are stored in
+/// batch->status, batch->sqp_iter and batch->time_tot.
+/// NOTE: the stage loops within an instance run serially, unless nested parallelism is enabled.
+///
+/// \param batch The batch struct.
+/// \return ACADOS_SUCCESS if all instances succeeded, otherwise the first nonzero status.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_solve_batch(ocp_nlp_solver_batch *batch);
+
+
 
 /// Resets the memory of the QP solver
 ///
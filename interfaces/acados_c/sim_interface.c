@@ -238,6 +238,13 @@ int sim_in_set(void *config_, void *dims_, sim_in *in, const char *field, void *
 
 
 
+int sim_in_set_by_id(void *config_, void *dims_, sim_in *in, int field_id, void *value)
+{
+    return sim_in_set_by_id_(config_, dims_, in, field_id, value);
+}
+
+
+
 /************************************************
 * out
 ************************************************/
@@ -524,6 +524,27 @@ class AcadosOcpSolver:
         getattr(self.shared_lib, f"{self.name}_acados_get_nlp_solver").restype = c_void_p
         self.nlp_solver = getattr(self.shared_lib, f"{self.name}_acados_get_nlp_solver")(self.capsule)
 
+        # whole horizon getters and setters, argtypes are set once here
+        self.__dims_get_all = self.__acados_lib.ocp_nlp_dims_get_all_from_attr
+        self.__dims_get_all.argtypes = [c_void_p, c_void_p, c_void_p, c_char_p]
+        self.__dims_get_all.restype = c_int
+
+        self.__out_get_all = self.__acados_lib.ocp_nlp_out_get_all
+        self.__out_get_all.argtypes = [c_void_p, c_void_p, c_void_p, c_char_p, c_void_p]
+        self.__out_get_all.restype = None
+
+        self.__out_set_all = self.__acados_lib.ocp_nlp_out_set_all
+        self.__out_set_all.argtypes = [c_void_p, c_void_p, c_void_p, c_char_p, c_void_p]
+        self.__out_set_all.restype = None
+
+        self.__in_set_all = self.__acados_lib.ocp_nlp_in_set_all
+        self.__in_set_all.argtypes = [c_void_p, c_void_p, c_void_p, c_char_p, c_void_p]
+        self.__in_set_all.restype = None
+
+        self.__update_params_all = getattr(self.shared_lib, f"{self.name}_acados_update_params_all")
+        self.__update_params_all.argtypes = [c_void_p, POINTER(c_double), c_int]
+        self.__update_params_all.restype = c_int
+
 
 
     def solve_for_x0(self, x0_bar, fail_on_nonzero_status=True, print_stats_on_failure=True):
@@ -1142,6 +1163,77 @@ class AcadosOcpSolver:
         return out.flatten()
 
 
+    def get_all(self, field_):
+        """
+        Get the last solution of the solver for all shooting nodes with one call.
+
+            :param field: string in ['x', 'u', 'z', 'pi', 'lam', 't', 'sl', 'su']
+            :returns: stage-major flat array, the values of stage 0 followed by those of stage 1, ...
+
+            .. note:: pi is returned for the stages 0, ..., N-1, all other fields for the stages 0, ..., N.
+        """
+        out_fields = ['x', 'u', 'z', 'pi', 'lam', 't', 'sl', 'su']
+
+        if field_ not in out_fields:
+            raise Exception(f'AcadosOcpSolver.get_all(field={field_}): \'{field_}\' is an invalid argument.\
+                    \n Possible values are {out_fields}.')
+
+        field = field_.encode('utf-8')
+
+        dims = self.__dims_get_all(self.nlp_config, self.nlp_dims, self.nlp_out, field)
+
+        out = np.zeros((dims,), dtype=np.float64)
+        out_data = cast(out.ctypes.data, c_void_p)
+
+        self.__out_get_all(self.nlp_config, self.nlp_dims, self.nlp_out, field, out_data)
+
+        return out
+
+
+    def set_all(self, field_, value_):
+        """
+        Set numerical data inside the solver for all shooting nodes with one call.
+
+            :param field: string in ['x', 'u', 'pi', 'lam', 't', 'sl', 'su', 'p', 'yref',
+                                     'lbx', 'ubx', 'lbu', 'ubu', 'lg', 'ug', 'lh', 'uh']
+            :param value: stage-major flat array, the values of stage 0 followed by those of stage 1, ...
+
+            .. note:: pi is set for the stages 0, ..., N-1, all other fields for the stages 0, ..., N,
+                      i.e. 'p' expects (N+1)*np values.
+        """
+        cost_fields = ['y_ref', 'yref']
+        constraints_fields = ['lbx', 'ubx', 'lbu', 'ubu', 'lg', 'ug', 'lh', 'uh']
+        out_fields = ['x', 'u', 'pi', 'lam', 't', 'sl', 'su']
+
+        value_ = np.ascontiguousarray(value_, dtype=np.float64).ravel()
+
+        if field_ == 'p':
+            value_data = cast(value_.ctypes.data, POINTER(c_double))
+            assert self.__update_params_all(self.capsule, value_data, value_.shape[0]) == 0
+            return
+
+        if field_ not in cost_fields + constraints_fields + out_fields:
+            raise Exception(f"AcadosOcpSolver.set_all(): '{field_}' is not a valid argument.\n"
+                f" Possible values are {cost_fields + constraints_fields + out_fields + ['p']}.")
+
+        field = field_.encode('utf-8')
+
+        dims = self.__dims_get_all(self.nlp_config, self.nlp_dims, self.nlp_out, field)
+
+        if value_.shape[0] != dims:
+            msg = f'AcadosOcpSolver.set_all(): mismatching dimension for field "{field_}" '
+            msg += f'with dimension {dims} (you have {value_.shape[0]})'
+            raise Exception(msg)
+
+        value_data = cast(value_.ctypes.data, c_void_p)
+
+        if field_ in out_fields:
+            self.__out_set_all(self.nlp_config, self.nlp_dims, self.nlp_out, field, value_data)
+        else:
+            self.__in_set_all(self.nlp_config, self.nlp_dims, self.nlp_in, field, value_data)
+        return
+
+
     # Note: this function should not be used anymore, better use cost_set, constraints_set
     def set(self, stage_, field_, value_):
         """
@@ -298,6 +298,32 @@ cdef class AcadosOcpSolverCython:
         return out
 
 
+    def get_all(self, str field_):
+        """
+        Get the last solution of the solver for all shooting nodes with one call.
+
+            :param field: string in ['x', 'u', 'z', 'pi', 'lam', 't', 'sl', 'su']
+            :returns: stage-major flat array, the values of stage 0 followed by those of stage 1, ...
+
+            .. note:: pi is returned for the stages 0, ..., N-1, all other fields for the stages 0, ..., N.
+        """
+        out_fields = ['x', 'u', 'z', 'pi', 'lam', 't', 'sl', 'su']
+        field = field_.encode('utf-8')
+
+        if field_ not in out_fields:
+            raise Exception('AcadosOcpSolverCython.get_all(): {} is an invalid argument.\
+                    \n Possible values are {}.'.format(field_, out_fields))
+
+        cdef int dims = acados_solver_common.ocp_nlp_dims_get_all_from_attr(self.nlp_config,
+            self.nlp_dims, self.nlp_out, field)
+
+        cdef cnp.ndarray[cnp.float64_t, ndim=1] out = np.zeros((dims,))
+        acados_solver_common.ocp_nlp_out_get_all(self.nlp_config, \
+            self.nlp_dims, self.nlp_out, field, <void *> out.data)
+
+        return out
+
+
     def print_statistics(self):
         """
         prints statistics of previous solver run as a table:
@@ -587,6 +613,52 @@ cdef class AcadosOcpSolverCython:
                     self.nlp_solver, stage, field, <void *> value.data)
         return
 
+    def set_all(self, str field_, value_):
+        """
+        Set numerical data inside the solver for all shooting nodes with one call.
+
+            :param field: string in ['x', 'u', 'pi', 'lam', 't', 'sl', 'su', 'p', 'yref',
+                                     'lbx', 'ubx', 'lbu', 'ubu', 'lg', 'ug', 'lh', 'uh']
+            :param value: stage-major flat array, the values of stage 0 followed by those of stage 1, ...
+
+            .. note:: pi is set for the stages 0, ..., N-1, all other fields for the stages 0, ..., N,
+                      i.e. 'p' expects (N+1)*np values.
+        """
+        if not isinstance(value_, np.ndarray):
+            raise Exception(f"set_all: value must be numpy array, got {type(value_)}.")
+        cost_fields = ['y_ref', 'yref']
+        constraints_fields = ['lbx', 'ubx', 'lbu', 'ubu', 'lg', 'ug', 'lh', 'uh']
+        out_fields = ['x', 'u', 'pi', 'lam', 't', 'sl', 'su']
+
+        field = field_.encode('utf-8')
+
+        cdef cnp.ndarray[cnp.float64_t, ndim=1] value = np.ascontiguousarray(value_, dtype=np.float64).ravel()
+
+        if field_ == 'p':
+            assert acados_solver.acados_update_params_all(self.capsule, <double *> value.data, value.shape[0]) == 0
+            return
+
+        if field_ not in constraints_fields + cost_fields + out_fields:
+            raise Exception("AcadosOcpSolverCython.set_all(): {} is not a valid argument.\
+                \nPossible values are {}.".format(field, \
+                constraints_fields + cost_fields + out_fields + ['p']))
+
+        dims = acados_solver_common.ocp_nlp_dims_get_all_from_attr(self.nlp_config,
+            self.nlp_dims, self.nlp_out, field)
+
+        if value.shape[0] != dims:
+            msg = 'AcadosOcpSolverCython.set_all(): mismatching dimension for field "{}" '.format(field_)
+            msg += 'with dimension {} (you have {})'.format(dims, value.shape[0])
+            raise Exception(msg)
+
+        if field_ in out_fields:
+            acados_solver_common.ocp_nlp_out_set_all(self.nlp_config,
+                self.nlp_dims, self.nlp_out, field, <void *> value.data)
+        else:
+            acados_solver_common.ocp_nlp_in_set_all(self.nlp_config,
+                self.nlp_dims, self.nlp_in, field, <void *> value.data)
+        return
+
     def cost_set(self, int stage, str field_, value_):
         """
         Set numerical data in the cost module of the solver.
@@ -80,6 +80,15 @@ cdef extern from "acados_c/ocp_nlp_interface.h":
         int stage, const char *field, void *value)
     int ocp_nlp_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field)
+    # whole horizon
+    void ocp_nlp_out_get_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value)
+    void ocp_nlp_out_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field, void *value)
+    void ocp_nlp_in_set_all(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in_,
+        const char *field, void *value)
+    int ocp_nlp_dims_get_all_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+        const char *field)
     void ocp_nlp_constraint_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
         int stage, const char *field, int *dims_out)
     void ocp_nlp_cost_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
@@ -180,8 +180,14 @@ int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule * cap
     capsule->sim_gnsf_phi_fun = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
     capsule->sim_gnsf_phi_fun_jac_y = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
     capsule->sim_gnsf_phi_jac_y_uhat = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
+  {%- if hessian_approx == "EXACT" %}
+    capsule->sim_gnsf_phi_hess = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
+  {%- endif %}
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
+  {%- if hessian_approx == "EXACT" %}
+    capsule->sim_gnsf_f_lo_hess = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
+  {%- endif %}
   {%- endif %}
   {%- endif %}
     capsule->sim_gnsf_get_matrices_fun = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }}));
@@ -210,6 +216,16 @@ int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule * cap
     capsule->sim_gnsf_phi_jac_y_uhat->casadi_sparsity_out = &{{ model.name }}_gnsf_phi_jac_y_uhat_sparsity_out;
     capsule->sim_gnsf_phi_jac_y_uhat->casadi_work = &{{ model.name }}_gnsf_phi_jac_y_uhat_work;
     external_function_param_{{ model.dyn_ext_fun_type }}_create(capsule->sim_gnsf_phi_jac_y_uhat, np);
+  {%- if hessian_approx == "EXACT" %}
+
+    capsule->sim_gnsf_phi_hess->casadi_fun = &{{ model.name }}_gnsf_phi_hess;
+    capsule->sim_gnsf_phi_hess->casadi_n_in = &{{ model.name }}_gnsf_phi_hess_n_in;
+    capsule->sim_gnsf_phi_hess->casadi_n_out = &{{ model.name }}_gnsf_phi_hess_n_out;
+    capsule->sim_gnsf_phi_hess->casadi_sparsity_in = &{{ model.name }}_gnsf_phi_hess_sparsity_in;
+    capsule->sim_gnsf_phi_hess->casadi_sparsity_out = &{{ model.name }}_gnsf_phi_hess_sparsity_out;
+    capsule->sim_gnsf_phi_hess->casadi_work = &{{ model.name }}_gnsf_phi_hess_work;
+    external_function_param_{{ model.dyn_ext_fun_type }}_create(capsule->sim_gnsf_phi_hess, np);
+  {%- endif %}
 
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z->casadi_fun = &{{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz;
@@ -219,6 +235,16 @@ int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule * cap
     capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z->casadi_sparsity_out = &{{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_sparsity_out;
     capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z->casadi_work = &{{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_work;
     external_function_param_{{ model.dyn_ext_fun_type }}_create(capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z, np);
+  {%- if hessian_approx == "EXACT" %}
+
+    capsule->sim_gnsf_f_lo_hess->casadi_fun = &{{ model.name }}_gnsf_f_lo_hess;
+    capsule->sim_gnsf_f_lo_hess->casadi_n_in = &{{ model.name }}_gnsf_f_lo_hess_n_in;
+    capsule->sim_gnsf_f_lo_hess->casadi_n_out = &{{ model.name }}_gnsf_f_lo_hess_n_out;
+    capsule->sim_gnsf_f_lo_hess->casadi_sparsity_in = &{{ model.name }}_gnsf_f_lo_hess_sparsity_in;
+    capsule->sim_gnsf_f_lo_hess->casadi_sparsity_out = &{{ model.name }}_gnsf_f_lo_hess_sparsity_out;
+    capsule->sim_gnsf_f_lo_hess->casadi_work = &{{ model.name }}_gnsf_f_lo_hess_work;
+    external_function_param_{{ model.dyn_ext_fun_type }}_create(capsule->sim_gnsf_f_lo_hess, np);
+  {%- endif %}
   {%- endif %}
   {%- endif %}
 
@@ -338,9 +364,17 @@ int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule * cap
                  "phi_fun_jac_y", capsule->sim_gnsf_phi_fun_jac_y);
     {{ model.name }}_sim_config->model_set({{ model.name }}_sim_in->model,
                  "phi_jac_y_uhat", capsule->sim_gnsf_phi_jac_y_uhat);
+  {%- if hessian_approx == "EXACT" %}
+    {{ model.name }}_sim_config->model_set({{ model.name }}_sim_in->model,
+                 "phi_hess", capsule->sim_gnsf_phi_hess);
+  {%- endif %}
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     {{ model.name }}_sim_config->model_set({{ model.name }}_sim_in->model,
                  "f_lo_jac_x1_x1dot_u_z", capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z);
+  {%- if hessian_approx == "EXACT" %}
+    {{ model.name }}_sim_config->model_set({{ model.name }}_sim_in->model,
+                 "f_lo_hess", capsule->sim_gnsf_f_lo_hess);
+  {%- endif %}
   {%- endif %}
   {%- endif %}
     {{ model.name }}_sim_config->model_set({{ model.name }}_sim_in->model,
@@ -453,9 +487,17 @@ int {{ model.name }}_acados_sim_free({{ model.name }}_sim_solver_capsule *capsul
     free(capsule->sim_gnsf_phi_fun);
     free(capsule->sim_gnsf_phi_fun_jac_y);
     free(capsule->sim_gnsf_phi_jac_y_uhat);
+  {%- if hessian_approx == "EXACT" %}
+    external_function_param_{{ model.dyn_ext_fun_type }}_free(capsule->sim_gnsf_phi_hess);
+    free(capsule->sim_gnsf_phi_hess);
+  {%- endif %}
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     external_function_param_{{ model.dyn_ext_fun_type }}_free(capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z);
     free(capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z);
+  {%- if hessian_approx == "EXACT" %}
+    external_function_param_{{ model.dyn_ext_fun_type }}_free(capsule->sim_gnsf_f_lo_hess);
+    free(capsule->sim_gnsf_f_lo_hess);
+  {%- endif %}
   {%- endif %}
   {%- endif %}
     external_function_param_{{ model.dyn_ext_fun_type }}_free(capsule->sim_gnsf_get_matrices_fun);
@@ -496,8 +538,14 @@ int {{ model.name }}_acados_sim_update_params({{ model.name }}_sim_solver_capsul
     capsule->sim_gnsf_phi_fun[0].set_param(capsule->sim_gnsf_phi_fun, p);
     capsule->sim_gnsf_phi_fun_jac_y[0].set_param(capsule->sim_gnsf_phi_fun_jac_y, p);
     capsule->sim_gnsf_phi_jac_y_uhat[0].set_param(capsule->sim_gnsf_phi_jac_y_uhat, p);
+  {%- if hessian_approx == "EXACT" %}
+    capsule->sim_gnsf_phi_hess[0].set_param(capsule->sim_gnsf_phi_hess, p);
+  {%- endif %}
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z[0].set_param(capsule->sim_gnsf_f_lo_jac_x1_x1dot_u_z, p);
+  {%- if hessian_approx == "EXACT" %}
+    capsule->sim_gnsf_f_lo_hess[0].set_param(capsule->sim_gnsf_f_lo_hess, p);
+  {%- endif %}
   {%- endif %}
   {%- endif %}
     capsule->sim_gnsf_get_matrices_fun[0].set_param(capsule->sim_gnsf_get_matrices_fun, p);
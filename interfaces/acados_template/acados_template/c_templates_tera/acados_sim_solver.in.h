@@ -74,6 +74,8 @@ typedef struct {{ model.name }}_sim_solver_capsule
     external_function_param_{{ model.dyn_ext_fun_type }} * sim_gnsf_phi_jac_y_uhat;
     external_function_param_{{ model.dyn_ext_fun_type }} * sim_gnsf_f_lo_jac_x1_x1dot_u_z;
     external_function_param_{{ model.dyn_ext_fun_type }} * sim_gnsf_get_matrices_fun;
+    external_function_param_{{ model.dyn_ext_fun_type }} * sim_gnsf_phi_hess;
+    external_function_param_{{ model.dyn_ext_fun_type }} * sim_gnsf_f_lo_hess;
 
 } {{ model.name }}_sim_solver_capsule;
 
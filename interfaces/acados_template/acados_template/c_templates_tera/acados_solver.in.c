@@ -102,6 +102,19 @@
 #define NSGN   {{ model.name | upper }}_NSGN
 #define NSBXN  {{ model.name | upper }}_NSBXN
 
+// sequence numbers of the double-buffered parameters (seqlock, odd while the writer is active)
+#if defined(_MSC_VER)
+#include <windows.h>
+#define PARAMS_EPOCH_LOAD(ptr) ((unsigned int) _InterlockedOr((volatile long *) (ptr), 0))
+#define PARAMS_EPOCH_STORE(ptr, val) _InterlockedExchange((volatile long *) (ptr), (long) (val))
+#define PARAMS_RELEASE_FENCE() MemoryBarrier()
+#define PARAMS_ACQUIRE_FENCE() MemoryBarrier()
+#else
+#define PARAMS_EPOCH_LOAD(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define PARAMS_EPOCH_STORE(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define PARAMS_RELEASE_FENCE() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define PARAMS_ACQUIRE_FENCE() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#endif
 
 
 // ** solver data **
@@ -389,26 +402,28 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     *  external functions
     ************************************************/
 
-#define MAP_CASADI_FNC(__CAPSULE_FNC__, __MODEL_BASE_FNC__) do{ \
+// the functions of a stage share the parameter block p_shared + stage*NP
+#define MAP_CASADI_FNC(__CAPSULE_FNC__, __MODEL_BASE_FNC__, __STAGE__) do{ \
         capsule->__CAPSULE_FNC__.casadi_fun = & __MODEL_BASE_FNC__ ;\
         capsule->__CAPSULE_FNC__.casadi_n_in = & __MODEL_BASE_FNC__ ## _n_in; \
         capsule->__CAPSULE_FNC__.casadi_n_out = & __MODEL_BASE_FNC__ ## _n_out; \
         capsule->__CAPSULE_FNC__.casadi_sparsity_in = & __MODEL_BASE_FNC__ ## _sparsity_in; \
         capsule->__CAPSULE_FNC__.casadi_sparsity_out = & __MODEL_BASE_FNC__ ## _sparsity_out; \
         capsule->__CAPSULE_FNC__.casadi_work = & __MODEL_BASE_FNC__ ## _work; \
-        external_function_param_casadi_create(&capsule->__CAPSULE_FNC__ , {{ dims.np }}); \
+        external_function_param_casadi_create_shared(&capsule->__CAPSULE_FNC__ , {{ dims.np }}, \
+            capsule->p_shared + (__STAGE__)*NP); \
     } while(false)
 
 {%- if constraints.constr_type_0 == "BGH" and dims.nh_0 > 0 %}
-    MAP_CASADI_FNC(nl_constr_h_0_fun_jac, {{ model.name }}_constr_h_0_fun_jac_uxt_zt);
-    MAP_CASADI_FNC(nl_constr_h_0_fun, {{ model.name }}_constr_h_0_fun);
+    MAP_CASADI_FNC(nl_constr_h_0_fun_jac, {{ model.name }}_constr_h_0_fun_jac_uxt_zt, 0);
+    MAP_CASADI_FNC(nl_constr_h_0_fun, {{ model.name }}_constr_h_0_fun, 0);
 
     {%- if solver_options.hessian_approx == "EXACT" %}
-    MAP_CASADI_FNC(nl_constr_h_0_fun_jac_hess, {{ model.name }}_constr_h_0_fun_jac_uxt_zt_hess);
+    MAP_CASADI_FNC(nl_constr_h_0_fun_jac_hess, {{ model.name }}_constr_h_0_fun_jac_uxt_zt_hess, 0);
     {% endif %}
 {%- elif constraints.constr_type_0 == "BGP" %}
     // convex-over-nonlinear constraint
-    MAP_CASADI_FNC(phi_0_constraint, {{ model.name }}_phi_0_constraint);
+    MAP_CASADI_FNC(phi_0_constraint, {{ model.name }}_phi_0_constraint, 0);
 {%- endif %}
 
 
@@ -417,16 +432,16 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     // constraints.constr_type == "BGH" and dims.nh > 0
     capsule->nl_constr_h_fun_jac = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++) {
-        MAP_CASADI_FNC(nl_constr_h_fun_jac[i], {{ model.name }}_constr_h_fun_jac_uxt_zt);
+        MAP_CASADI_FNC(nl_constr_h_fun_jac[i], {{ model.name }}_constr_h_fun_jac_uxt_zt, i+1);
     }
     capsule->nl_constr_h_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++) {
-        MAP_CASADI_FNC(nl_constr_h_fun[i], {{ model.name }}_constr_h_fun);
+        MAP_CASADI_FNC(nl_constr_h_fun[i], {{ model.name }}_constr_h_fun, i+1);
     }
     {% if solver_options.hessian_approx == "EXACT" %}
     capsule->nl_constr_h_fun_jac_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++) {
-        MAP_CASADI_FNC(nl_constr_h_fun_jac_hess[i], {{ model.name }}_constr_h_fun_jac_uxt_zt_hess);
+        MAP_CASADI_FNC(nl_constr_h_fun_jac_hess[i], {{ model.name }}_constr_h_fun_jac_uxt_zt_hess, i+1);
     }
     {% endif %}
 {% elif constraints.constr_type == "BGP" %}
@@ -434,39 +449,39 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N-1; i++)
     {
         // convex-over-nonlinear constraint
-        MAP_CASADI_FNC(phi_constraint[i], {{ model.name }}_phi_constraint);
+        MAP_CASADI_FNC(phi_constraint[i], {{ model.name }}_phi_constraint, i+1);
     }
 {%- endif %}
 
 
 {%- if constraints.constr_type_e == "BGH" and dims.nh_e > 0 %}
-    MAP_CASADI_FNC(nl_constr_h_e_fun_jac, {{ model.name }}_constr_h_e_fun_jac_uxt_zt);
-    MAP_CASADI_FNC(nl_constr_h_e_fun, {{ model.name }}_constr_h_e_fun);
+    MAP_CASADI_FNC(nl_constr_h_e_fun_jac, {{ model.name }}_constr_h_e_fun_jac_uxt_zt, N);
+    MAP_CASADI_FNC(nl_constr_h_e_fun, {{ model.name }}_constr_h_e_fun, N);
 
     {%- if solver_options.hessian_approx == "EXACT" %}
-    MAP_CASADI_FNC(nl_constr_h_e_fun_jac_hess, {{ model.name }}_constr_h_e_fun_jac_uxt_zt_hess);
+    MAP_CASADI_FNC(nl_constr_h_e_fun_jac_hess, {{ model.name }}_constr_h_e_fun_jac_uxt_zt_hess, N);
     {% endif %}
 {%- elif constraints.constr_type_e == "BGP" %}
     // convex-over-nonlinear constraint
-    MAP_CASADI_FNC(phi_e_constraint, {{ model.name }}_phi_e_constraint);
+    MAP_CASADI_FNC(phi_e_constraint, {{ model.name }}_phi_e_constraint, N);
 {%- endif %}
 
 {% if solver_options.integrator_type == "ERK" %}
     // explicit ode
     capsule->forw_vde_casadi = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(forw_vde_casadi[i], {{ model.name }}_expl_vde_forw);
+        MAP_CASADI_FNC(forw_vde_casadi[i], {{ model.name }}_expl_vde_forw, i);
     }
 
     capsule->expl_ode_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(expl_ode_fun[i], {{ model.name }}_expl_ode_fun);
+        MAP_CASADI_FNC(expl_ode_fun[i], {{ model.name }}_expl_ode_fun, i);
     }
 
     {%- if solver_options.hessian_approx == "EXACT" %}
     capsule->hess_vde_casadi = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(hess_vde_casadi[i], {{ model.name }}_expl_ode_hess);
+        MAP_CASADI_FNC(hess_vde_casadi[i], {{ model.name }}_expl_ode_hess, i);
     }
     {%- endif %}
 
@@ -475,78 +490,106 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     capsule->impl_dae_fun = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
     {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(impl_dae_fun[i], {{ model.name }}_impl_dae_fun);
+        MAP_CASADI_FNC(impl_dae_fun[i], {{ model.name }}_impl_dae_fun, i);
     {%- else %}
         capsule->impl_dae_fun[i].fun = &{{ model.dyn_impl_dae_fun }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->impl_dae_fun[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->impl_dae_fun[i], {{ dims.np }}, capsule->p_shared + i*NP);
     {%- endif %}
     }
 
     capsule->impl_dae_fun_jac_x_xdot_z = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
     {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(impl_dae_fun_jac_x_xdot_z[i], {{ model.name }}_impl_dae_fun_jac_x_xdot_z);
+        MAP_CASADI_FNC(impl_dae_fun_jac_x_xdot_z[i], {{ model.name }}_impl_dae_fun_jac_x_xdot_z, i);
     {%- else %}
         capsule->impl_dae_fun_jac_x_xdot_z[i].fun = &{{ model.dyn_impl_dae_fun_jac }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->impl_dae_fun_jac_x_xdot_z[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->impl_dae_fun_jac_x_xdot_z[i], {{ dims.np }}, capsule->p_shared + i*NP);
     {%- endif %}
     }
 
     capsule->impl_dae_jac_x_xdot_u_z = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
     {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(impl_dae_jac_x_xdot_u_z[i], {{ model.name }}_impl_dae_jac_x_xdot_u_z);
+        MAP_CASADI_FNC(impl_dae_jac_x_xdot_u_z[i], {{ model.name }}_impl_dae_jac_x_xdot_u_z, i);
     {%- else %}
         capsule->impl_dae_jac_x_xdot_u_z[i].fun = &{{ model.dyn_impl_dae_jac }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->impl_dae_jac_x_xdot_u_z[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->impl_dae_jac_x_xdot_u_z[i], {{ dims.np }}, capsule->p_shared + i*NP);
     {%- endif %}
     }
 
     {%- if solver_options.hessian_approx == "EXACT" %}
     capsule->impl_dae_hess = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(impl_dae_hess[i], {{ model.name }}_impl_dae_hess);
+        MAP_CASADI_FNC(impl_dae_hess[i], {{ model.name }}_impl_dae_hess, i);
     }
     {%- endif %}
 {% elif solver_options.integrator_type == "LIFTED_IRK" %}
     // external functions (implicit model)
     capsule->impl_dae_fun = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(impl_dae_fun[i], {{ model.name }}_impl_dae_fun);
+        MAP_CASADI_FNC(impl_dae_fun[i], {{ model.name }}_impl_dae_fun, i);
     }
 
     capsule->impl_dae_fun_jac_x_xdot_u = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(impl_dae_fun_jac_x_xdot_u[i], {{ model.name }}_impl_dae_fun_jac_x_xdot_u);
+        MAP_CASADI_FNC(impl_dae_fun_jac_x_xdot_u[i], {{ model.name }}_impl_dae_fun_jac_x_xdot_u, i);
     }
 
+    {%- if dims.nz > 0 %}
+    capsule->impl_dae_jac_x_xdot_u_z = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
+    for (int i = 0; i < N; i++) {
+        MAP_CASADI_FNC(impl_dae_jac_x_xdot_u_z[i], {{ model.name }}_impl_dae_jac_x_xdot_u_z, i);
+    }
+    {%- endif %}
+
+    {%- if solver_options.hessian_approx == "EXACT" %}
+    capsule->impl_dae_hess = (external_function_param_{{ model.dyn_ext_fun_type }} *) malloc(sizeof(external_function_param_{{ model.dyn_ext_fun_type }})*N);
+    for (int i = 0; i < N; i++) {
+        MAP_CASADI_FNC(impl_dae_hess[i], {{ model.name }}_impl_dae_hess, i);
+    }
+    {%- endif %}
+
 {% elif solver_options.integrator_type == "GNSF" %}
     {% if model.gnsf.purely_linear != 1 %}
     capsule->gnsf_phi_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(gnsf_phi_fun[i], {{ model.name }}_gnsf_phi_fun);
+        MAP_CASADI_FNC(gnsf_phi_fun[i], {{ model.name }}_gnsf_phi_fun, i);
     }
 
     capsule->gnsf_phi_fun_jac_y = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(gnsf_phi_fun_jac_y[i], {{ model.name }}_gnsf_phi_fun_jac_y);
+        MAP_CASADI_FNC(gnsf_phi_fun_jac_y[i], {{ model.name }}_gnsf_phi_fun_jac_y, i);
     }
 
     capsule->gnsf_phi_jac_y_uhat = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(gnsf_phi_jac_y_uhat[i], {{ model.name }}_gnsf_phi_jac_y_uhat);
+        MAP_CASADI_FNC(gnsf_phi_jac_y_uhat[i], {{ model.name }}_gnsf_phi_jac_y_uhat, i);
     }
+    {%- if solver_options.hessian_approx == "EXACT" %}
+
+    capsule->gnsf_phi_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
+    for (int i = 0; i < N; i++) {
+        MAP_CASADI_FNC(gnsf_phi_hess[i], {{ model.name }}_gnsf_phi_hess, i);
+    }
+    {%- endif %}
 
     {% if model.gnsf.nontrivial_f_LO == 1 %}
     capsule->gnsf_f_lo_jac_x1_x1dot_u_z = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(gnsf_f_lo_jac_x1_x1dot_u_z[i], {{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz);
+        MAP_CASADI_FNC(gnsf_f_lo_jac_x1_x1dot_u_z[i], {{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz, i);
+    }
+    {%- if solver_options.hessian_approx == "EXACT" %}
+
+    capsule->gnsf_f_lo_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
+    for (int i = 0; i < N; i++) {
+        MAP_CASADI_FNC(gnsf_f_lo_hess[i], {{ model.name }}_gnsf_f_lo_hess, i);
     }
     {%- endif %}
     {%- endif %}
+    {%- endif %}
     capsule->gnsf_get_matrices_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*N);
     for (int i = 0; i < N; i++) {
-        MAP_CASADI_FNC(gnsf_get_matrices_fun[i], {{ model.name }}_gnsf_get_matrices_fun);
+        MAP_CASADI_FNC(gnsf_get_matrices_fun[i], {{ model.name }}_gnsf_get_matrices_fun, i);
     }
 {% elif solver_options.integrator_type == "DISCRETE" %}
     // discrete dynamics
@@ -554,10 +597,10 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N; i++)
     {
         {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(discr_dyn_phi_fun[i], {{ model.name }}_dyn_disc_phi_fun);
+        MAP_CASADI_FNC(discr_dyn_phi_fun[i], {{ model.name }}_dyn_disc_phi_fun, i);
         {%- else %}
         capsule->discr_dyn_phi_fun[i].fun = &{{ model.dyn_disc_fun }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->discr_dyn_phi_fun[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->discr_dyn_phi_fun[i], {{ dims.np }}, capsule->p_shared + i*NP);
         {%- endif %}
     }
 
@@ -565,10 +608,10 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N; i++)
     {
         {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(discr_dyn_phi_fun_jac_ut_xt[i], {{ model.name }}_dyn_disc_phi_fun_jac);
+        MAP_CASADI_FNC(discr_dyn_phi_fun_jac_ut_xt[i], {{ model.name }}_dyn_disc_phi_fun_jac, i);
         {%- else %}
         capsule->discr_dyn_phi_fun_jac_ut_xt[i].fun = &{{ model.dyn_disc_fun_jac }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->discr_dyn_phi_fun_jac_ut_xt[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->discr_dyn_phi_fun_jac_ut_xt[i], {{ dims.np }}, capsule->p_shared + i*NP);
         {%- endif %}
     }
 
@@ -577,10 +620,10 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N; i++)
     {
         {%- if model.dyn_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(discr_dyn_phi_fun_jac_ut_xt_hess[i], {{ model.name }}_dyn_disc_phi_fun_jac_hess);
+        MAP_CASADI_FNC(discr_dyn_phi_fun_jac_ut_xt_hess[i], {{ model.name }}_dyn_disc_phi_fun_jac_hess, i);
         {%- else %}
         capsule->discr_dyn_phi_fun_jac_ut_xt_hess[i].fun = &{{ model.dyn_disc_fun_jac_hess }};
-        external_function_param_{{ model.dyn_ext_fun_type }}_create(&capsule->discr_dyn_phi_fun_jac_ut_xt_hess[i], {{ dims.np }});
+        external_function_param_{{ model.dyn_ext_fun_type }}_create_shared(&capsule->discr_dyn_phi_fun_jac_ut_xt_hess[i], {{ dims.np }}, capsule->p_shared + i*NP);
         {%- endif %}
     }
   {%- endif %}
@@ -589,38 +632,38 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
 
 {%- if cost.cost_type_0 == "NONLINEAR_LS" %}
     // nonlinear least squares function
-    MAP_CASADI_FNC(cost_y_0_fun, {{ model.name }}_cost_y_0_fun);
-    MAP_CASADI_FNC(cost_y_0_fun_jac_ut_xt, {{ model.name }}_cost_y_0_fun_jac_ut_xt);
-    MAP_CASADI_FNC(cost_y_0_hess, {{ model.name }}_cost_y_0_hess);
+    MAP_CASADI_FNC(cost_y_0_fun, {{ model.name }}_cost_y_0_fun, 0);
+    MAP_CASADI_FNC(cost_y_0_fun_jac_ut_xt, {{ model.name }}_cost_y_0_fun_jac_ut_xt, 0);
+    MAP_CASADI_FNC(cost_y_0_hess, {{ model.name }}_cost_y_0_hess, 0);
 
 {%- elif cost.cost_type_0 == "CONVEX_OVER_NONLINEAR" %}
     // convex-over-nonlinear cost
-    MAP_CASADI_FNC(conl_cost_0_fun, {{ model.name }}_conl_cost_0_fun);
-    MAP_CASADI_FNC(conl_cost_0_fun_jac_hess, {{ model.name }}_conl_cost_0_fun_jac_hess);
+    MAP_CASADI_FNC(conl_cost_0_fun, {{ model.name }}_conl_cost_0_fun, 0);
+    MAP_CASADI_FNC(conl_cost_0_fun_jac_hess, {{ model.name }}_conl_cost_0_fun_jac_hess, 0);
 
 {%- elif cost.cost_type_0 == "EXTERNAL" %}
     // external cost
     {%- if cost.cost_ext_fun_type_0 == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_0_fun, {{ model.name }}_cost_ext_cost_0_fun);
+    MAP_CASADI_FNC(ext_cost_0_fun, {{ model.name }}_cost_ext_cost_0_fun, 0);
     {%- else %}
     capsule->ext_cost_0_fun.fun = &{{ cost.cost_function_ext_cost_0 }};
-    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create(&capsule->ext_cost_0_fun, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create_shared(&capsule->ext_cost_0_fun, {{ dims.np }}, capsule->p_shared);
     {%- endif %}
 
     // external cost
     {%- if cost.cost_ext_fun_type_0 == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_0_fun_jac, {{ model.name }}_cost_ext_cost_0_fun_jac);
+    MAP_CASADI_FNC(ext_cost_0_fun_jac, {{ model.name }}_cost_ext_cost_0_fun_jac, 0);
     {%- else %}
     capsule->ext_cost_0_fun_jac.fun = &{{ cost.cost_function_ext_cost_0 }};
-    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create(&capsule->ext_cost_0_fun_jac, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create_shared(&capsule->ext_cost_0_fun_jac, {{ dims.np }}, capsule->p_shared);
     {%- endif %}
 
     // external cost
     {%- if cost.cost_ext_fun_type_0 == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_0_fun_jac_hess, {{ model.name }}_cost_ext_cost_0_fun_jac_hess);
+    MAP_CASADI_FNC(ext_cost_0_fun_jac_hess, {{ model.name }}_cost_ext_cost_0_fun_jac_hess, 0);
     {%- else %}
     capsule->ext_cost_0_fun_jac_hess.fun = &{{ cost.cost_function_ext_cost_0 }};
-    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create(&capsule->ext_cost_0_fun_jac_hess, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_0 }}_create_shared(&capsule->ext_cost_0_fun_jac_hess, {{ dims.np }}, capsule->p_shared);
     {%- endif %}
 {%- endif %}
 
@@ -629,19 +672,19 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     capsule->cost_y_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++)
     {
-        MAP_CASADI_FNC(cost_y_fun[i], {{ model.name }}_cost_y_fun);
+        MAP_CASADI_FNC(cost_y_fun[i], {{ model.name }}_cost_y_fun, i+1);
     }
 
     capsule->cost_y_fun_jac_ut_xt = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++)
     {
-        MAP_CASADI_FNC(cost_y_fun_jac_ut_xt[i], {{ model.name }}_cost_y_fun_jac_ut_xt);
+        MAP_CASADI_FNC(cost_y_fun_jac_ut_xt[i], {{ model.name }}_cost_y_fun_jac_ut_xt, i+1);
     }
 
     capsule->cost_y_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++)
     {
-        MAP_CASADI_FNC(cost_y_hess[i], {{ model.name }}_cost_y_hess);
+        MAP_CASADI_FNC(cost_y_hess[i], {{ model.name }}_cost_y_hess, i+1);
     }
 
 {%- elif cost.cost_type == "CONVEX_OVER_NONLINEAR" %}
@@ -649,12 +692,12 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     capsule->conl_cost_fun = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++)
     {
-        MAP_CASADI_FNC(conl_cost_fun[i], {{ model.name }}_conl_cost_fun);
+        MAP_CASADI_FNC(conl_cost_fun[i], {{ model.name }}_conl_cost_fun, i+1);
     }
     capsule->conl_cost_fun_jac_hess = (external_function_param_casadi *) malloc(sizeof(external_function_param_casadi)*(N-1));
     for (int i = 0; i < N-1; i++)
     {
-        MAP_CASADI_FNC(conl_cost_fun_jac_hess[i], {{ model.name }}_conl_cost_fun_jac_hess);
+        MAP_CASADI_FNC(conl_cost_fun_jac_hess[i], {{ model.name }}_conl_cost_fun_jac_hess, i+1);
     }
 
 {%- elif cost.cost_type == "EXTERNAL" %}
@@ -663,10 +706,10 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N-1; i++)
     {
         {%- if cost.cost_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(ext_cost_fun[i], {{ model.name }}_cost_ext_cost_fun);
+        MAP_CASADI_FNC(ext_cost_fun[i], {{ model.name }}_cost_ext_cost_fun, i+1);
         {%- else %}
         capsule->ext_cost_fun[i].fun = &{{ cost.cost_function_ext_cost }};
-        external_function_param_{{ cost.cost_ext_fun_type }}_create(&capsule->ext_cost_fun[i], {{ dims.np }});
+        external_function_param_{{ cost.cost_ext_fun_type }}_create_shared(&capsule->ext_cost_fun[i], {{ dims.np }}, capsule->p_shared + (i+1)*NP);
         {%- endif %}
     }
 
@@ -674,10 +717,10 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N-1; i++)
     {
         {%- if cost.cost_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(ext_cost_fun_jac[i], {{ model.name }}_cost_ext_cost_fun_jac);
+        MAP_CASADI_FNC(ext_cost_fun_jac[i], {{ model.name }}_cost_ext_cost_fun_jac, i+1);
         {%- else %}
         capsule->ext_cost_fun_jac[i].fun = &{{ cost.cost_function_ext_cost }};
-        external_function_param_{{ cost.cost_ext_fun_type }}_create(&capsule->ext_cost_fun_jac[i], {{ dims.np }});
+        external_function_param_{{ cost.cost_ext_fun_type }}_create_shared(&capsule->ext_cost_fun_jac[i], {{ dims.np }}, capsule->p_shared + (i+1)*NP);
         {%- endif %}
     }
 
@@ -685,48 +728,48 @@ void {{ model.name }}_acados_create_3_create_and_set_functions({{ model.name }}_
     for (int i = 0; i < N-1; i++)
     {
         {%- if cost.cost_ext_fun_type == "casadi" %}
-        MAP_CASADI_FNC(ext_cost_fun_jac_hess[i], {{ model.name }}_cost_ext_cost_fun_jac_hess);
+        MAP_CASADI_FNC(ext_cost_fun_jac_hess[i], {{ model.name }}_cost_ext_cost_fun_jac_hess, i+1);
         {%- else %}
         capsule->ext_cost_fun_jac_hess[i].fun = &{{ cost.cost_function_ext_cost }};
-        external_function_param_{{ cost.cost_ext_fun_type }}_create(&capsule->ext_cost_fun_jac_hess[i], {{ dims.np }});
+        external_function_param_{{ cost.cost_ext_fun_type }}_create_shared(&capsule->ext_cost_fun_jac_hess[i], {{ dims.np }}, capsule->p_shared + (i+1)*NP);
         {%- endif %}
     }
 {%- endif %}
 
 {%- if cost.cost_type_e == "NONLINEAR_LS" %}
     // nonlinear least square function
-    MAP_CASADI_FNC(cost_y_e_fun, {{ model.name }}_cost_y_e_fun);
-    MAP_CASADI_FNC(cost_y_e_fun_jac_ut_xt, {{ model.name }}_cost_y_e_fun_jac_ut_xt);
-    MAP_CASADI_FNC(cost_y_e_hess, {{ model.name }}_cost_y_e_hess);
+    MAP_CASADI_FNC(cost_y_e_fun, {{ model.name }}_cost_y_e_fun, N);
+    MAP_CASADI_FNC(cost_y_e_fun_jac_ut_xt, {{ model.name }}_cost_y_e_fun_jac_ut_xt, N);
+    MAP_CASADI_FNC(cost_y_e_hess, {{ model.name }}_cost_y_e_hess, N);
 
 {%- elif cost.cost_type_e == "CONVEX_OVER_NONLINEAR" %}
     // convex-over-nonlinear cost
-    MAP_CASADI_FNC(conl_cost_e_fun, {{ model.name }}_conl_cost_e_fun);
-    MAP_CASADI_FNC(conl_cost_e_fun_jac_hess, {{ model.name }}_conl_cost_e_fun_jac_hess);
+    MAP_CASADI_FNC(conl_cost_e_fun, {{ model.name }}_conl_cost_e_fun, N);
+    MAP_CASADI_FNC(conl_cost_e_fun_jac_hess, {{ model.name }}_conl_cost_e_fun_jac_hess, N);
 
 {%- elif cost.cost_type_e == "EXTERNAL" %}
     // external cost - function
     {%- if cost.cost_ext_fun_type_e == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_e_fun, {{ model.name }}_cost_ext_cost_e_fun);
+    MAP_CASADI_FNC(ext_cost_e_fun, {{ model.name }}_cost_ext_cost_e_fun, N);
     {%- else %}
     capsule->ext_cost_e_fun.fun = &{{ cost.cost_function_ext_cost_e }};
-    external_function_param_{{ cost.cost_ext_fun_type_e }}_create(&capsule->ext_cost_e_fun, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_e }}_create_shared(&capsule->ext_cost_e_fun, {{ dims.np }}, capsule->p_shared + N*NP);
     {%- endif %}
 
     // external cost - jacobian
     {%- if cost.cost_ext_fun_type_e == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_e_fun_jac, {{ model.name }}_cost_ext_cost_e_fun_jac);
+    MAP_CASADI_FNC(ext_cost_e_fun_jac, {{ model.name }}_cost_ext_cost_e_fun_jac, N);
     {%- else %}
     capsule->ext_cost_e_fun_jac.fun = &{{ cost.cost_function_ext_cost_e }};
-    external_function_param_{{ cost.cost_ext_fun_type_e }}_create(&capsule->ext_cost_e_fun_jac, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_e }}_create_shared(&capsule->ext_cost_e_fun_jac, {{ dims.np }}, capsule->p_shared + N*NP);
     {%- endif %}
 
     // external cost - hessian
     {%- if cost.cost_ext_fun_type_e == "casadi" %}
-    MAP_CASADI_FNC(ext_cost_e_fun_jac_hess, {{ model.name }}_cost_ext_cost_e_fun_jac_hess);
+    MAP_CASADI_FNC(ext_cost_e_fun_jac_hess, {{ model.name }}_cost_ext_cost_e_fun_jac_hess, N);
     {%- else %}
     capsule->ext_cost_e_fun_jac_hess.fun = &{{ cost.cost_function_ext_cost_e }};
-    external_function_param_{{ cost.cost_ext_fun_type_e }}_create(&capsule->ext_cost_e_fun_jac_hess, {{ dims.np }});
+    external_function_param_{{ cost.cost_ext_fun_type_e }}_create_shared(&capsule->ext_cost_e_fun_jac_hess, {{ dims.np }}, capsule->p_shared + N*NP);
     {%- endif %}
 {%- endif %}
 
@@ -829,14 +872,27 @@ void {{ model.name }}_acados_create_5_set_nlp_in({{ model.name }}_solver_capsule
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "impl_dae_fun", &capsule->impl_dae_fun[i]);
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i,
                                    "impl_dae_fun_jac_x_xdot_u", &capsule->impl_dae_fun_jac_x_xdot_u[i]);
+        {%- if dims.nz > 0 %}
+        ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i,
+                                   "impl_dae_jac_x_xdot_u_z", &capsule->impl_dae_jac_x_xdot_u_z[i]);
+        {%- endif %}
+        {%- if solver_options.hessian_approx == "EXACT" %}
+        ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "impl_dae_hess", &capsule->impl_dae_hess[i]);
+        {%- endif %}
     {%- elif solver_options.integrator_type == "GNSF" %}
         {% if model.gnsf.purely_linear != 1 %}
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "phi_fun", &capsule->gnsf_phi_fun[i]);
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "phi_fun_jac_y", &capsule->gnsf_phi_fun_jac_y[i]);
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "phi_jac_y_uhat", &capsule->gnsf_phi_jac_y_uhat[i]);
+            {%- if solver_options.hessian_approx == "EXACT" %}
+        ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "phi_hess", &capsule->gnsf_phi_hess[i]);
+            {%- endif %}
             {% if model.gnsf.nontrivial_f_LO == 1 %}
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "f_lo_jac_x1_x1dot_u_z",
                                    &capsule->gnsf_f_lo_jac_x1_x1dot_u_z[i]);
+                {%- if solver_options.hessian_approx == "EXACT" %}
+        ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "f_lo_hess", &capsule->gnsf_f_lo_hess[i]);
+                {%- endif %}
             {%- endif %}
         {%- endif %}
         ocp_nlp_dynamics_model_set(nlp_config, nlp_dims, nlp_in, i, "gnsf_get_matrices_fun",
@@ -2255,6 +2311,14 @@ int {{ model.name }}_acados_create_with_discretization({{ model.name }}_solver_c
     // number of expected runtime parameters
     capsule->nlp_np = NP;
 
+    // parameter blocks shared by the external functions of each stage
+    capsule->p_shared = calloc((N+1)*NP, sizeof(double));
+
+    // double-buffered runtime parameters
+    capsule->params_buffer = calloc(2*(N+1)*NP, sizeof(double));
+    capsule->params_epoch = calloc(N+1, sizeof(unsigned int));
+    capsule->params_epoch_applied = calloc(N+1, sizeof(unsigned int));
+
     // 1) create and set nlp_solver_plan; create nlp_config
     capsule->nlp_solver_plan = ocp_nlp_plan_create(N);
     {{ model.name }}_acados_create_1_set_plan(capsule->nlp_solver_plan, N);
@@ -2358,6 +2422,7 @@ int {{ model.name }}_acados_reset({{ model.name }}_solver_capsule* capsule, int
             ocp_nlp_set(nlp_config, nlp_solver, i, "z_guess", buffer);
         {%- elif solver_options.integrator_type == "LIFTED_IRK" %}
             ocp_nlp_set(nlp_config, nlp_solver, i, "xdot_guess", buffer);
+            ocp_nlp_set(nlp_config, nlp_solver, i, "z_guess", buffer);
         {%- elif solver_options.integrator_type == "GNSF" %}
             ocp_nlp_set(nlp_config, nlp_solver, i, "gnsf_phi_guess", buffer);
         {%- endif %}
@@ -2393,132 +2458,90 @@ int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule* capsu
         exit(1);
     }
 
+{%- if dims.np > 0 %}
+    // all external functions of the stage share this parameter block
+    double *p_stage = capsule->p_shared + stage*NP;
+    for (int i = 0; i < NP; i++)
+        p_stage[i] = p[i];
+{%- endif %}{# if dims.np #}
+
+    return solver_status;
+}
+
+
+int {{ model.name }}_acados_update_params_all({{ model.name }}_solver_capsule* capsule, double *p, int np_total)
+{
     const int N = capsule->nlp_solver_plan->N;
-    if (stage < N && stage >= 0)
-    {
-    {%- if solver_options.integrator_type == "IRK" %}
-        capsule->impl_dae_fun[stage].set_param(capsule->impl_dae_fun+stage, p);
-        capsule->impl_dae_fun_jac_x_xdot_z[stage].set_param(capsule->impl_dae_fun_jac_x_xdot_z+stage, p);
-        capsule->impl_dae_jac_x_xdot_u_z[stage].set_param(capsule->impl_dae_jac_x_xdot_u_z+stage, p);
+    if ((N+1) * {{ dims.np }} != np_total) {
+        printf("{{ model.name }}_acados_update_params_all: trying to set %i parameters,"
+            " expected (N+1)*np = %i. Exiting.\n", np_total, (N+1) * {{ dims.np }});
+        exit(1);
+    }
 
-        {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->impl_dae_hess[stage].set_param(capsule->impl_dae_hess+stage, p);
-        {%- endif %}
-    {%- elif solver_options.integrator_type == "LIFTED_IRK" %}
-        capsule->impl_dae_fun[stage].set_param(capsule->impl_dae_fun+stage, p);
-        capsule->impl_dae_fun_jac_x_xdot_u[stage].set_param(capsule->impl_dae_fun_jac_x_xdot_u+stage, p);
-    {%- elif solver_options.integrator_type == "ERK" %}
-        capsule->forw_vde_casadi[stage].set_param(capsule->forw_vde_casadi+stage, p);
-        capsule->expl_ode_fun[stage].set_param(capsule->expl_ode_fun+stage, p);
+{%- if dims.np > 0 %}
+    // p is stage-major, the same layout as the shared parameter blocks
+    for (int i = 0; i < np_total; i++)
+        capsule->p_shared[i] = p[i];
+{%- endif %}{# if dims.np #}
 
-        {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->hess_vde_casadi[stage].set_param(capsule->hess_vde_casadi+stage, p);
-        {%- endif %}
-    {%- elif solver_options.integrator_type == "GNSF" %}
-    {% if model.gnsf.purely_linear != 1 %}
-        capsule->gnsf_phi_fun[stage].set_param(capsule->gnsf_phi_fun+stage, p);
-        capsule->gnsf_phi_fun_jac_y[stage].set_param(capsule->gnsf_phi_fun_jac_y+stage, p);
-        capsule->gnsf_phi_jac_y_uhat[stage].set_param(capsule->gnsf_phi_jac_y_uhat+stage, p);
-        {% if model.gnsf.nontrivial_f_LO == 1 %}
-            capsule->gnsf_f_lo_jac_x1_x1dot_u_z[stage].set_param(capsule->gnsf_f_lo_jac_x1_x1dot_u_z+stage, p);
-        {%- endif %}
-    {%- endif %}
-    {% elif solver_options.integrator_type == "DISCRETE" %}
-        capsule->discr_dyn_phi_fun[stage].set_param(capsule->discr_dyn_phi_fun+stage, p);
-        capsule->discr_dyn_phi_fun_jac_ut_xt[stage].set_param(capsule->discr_dyn_phi_fun_jac_ut_xt+stage, p);
-    {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->discr_dyn_phi_fun_jac_ut_xt_hess[stage].set_param(capsule->discr_dyn_phi_fun_jac_ut_xt_hess+stage, p);
-    {%- endif %}
-    {%- endif %}{# integrator_type #}
+    return 0;
+}
 
-        // constraints
-        if (stage == 0)
-        {
-        {%- if constraints.constr_type_0 == "BGP" %}
-            capsule->phi_0_constraint.set_param(&capsule->phi_0_constraint, p);
-        {%- elif constraints.constr_type_0 == "BGH" and dims.nh_0 > 0 %}
-            capsule->nl_constr_h_0_fun_jac.set_param(&capsule->nl_constr_h_0_fun_jac, p);
-            capsule->nl_constr_h_0_fun.set_param(&capsule->nl_constr_h_0_fun, p);
-            {%- if solver_options.hessian_approx == "EXACT" %}
-            capsule->nl_constr_h_0_fun_jac_hess.set_param(&capsule->nl_constr_h_0_fun_jac_hess, p);
-            {%- endif %}
-        {%- endif %}
-        }
-        else
-        {
-        {%- if constraints.constr_type == "BGP" %}
-            capsule->phi_constraint[stage-1].set_param(capsule->phi_constraint+stage-1, p);
-        {%- elif constraints.constr_type == "BGH" and dims.nh > 0 %}
-            capsule->nl_constr_h_fun_jac[stage-1].set_param(capsule->nl_constr_h_fun_jac+stage-1, p);
-            capsule->nl_constr_h_fun[stage-1].set_param(capsule->nl_constr_h_fun+stage-1, p);
-        {%- if solver_options.hessian_approx == "EXACT" %}
-            capsule->nl_constr_h_fun_jac_hess[stage-1].set_param(capsule->nl_constr_h_fun_jac_hess+stage-1, p);
-        {%- endif %}
-        {%- endif %}
-        }
 
-        // cost
-        if (stage == 0)
-        {
-        {%- if cost.cost_type_0 == "NONLINEAR_LS" %}
-            capsule->cost_y_0_fun.set_param(&capsule->cost_y_0_fun, p);
-            capsule->cost_y_0_fun_jac_ut_xt.set_param(&capsule->cost_y_0_fun_jac_ut_xt, p);
-            capsule->cost_y_0_hess.set_param(&capsule->cost_y_0_hess, p);
-        {%- elif cost.cost_type_0 == "CONVEX_OVER_NONLINEAR" %}
-            capsule->conl_cost_0_fun.set_param(&capsule->conl_cost_0_fun, p);
-            capsule->conl_cost_0_fun_jac_hess.set_param(&capsule->conl_cost_0_fun_jac_hess, p);
-        {%- elif cost.cost_type_0 == "EXTERNAL" %}
-            capsule->ext_cost_0_fun.set_param(&capsule->ext_cost_0_fun, p);
-            capsule->ext_cost_0_fun_jac.set_param(&capsule->ext_cost_0_fun_jac, p);
-            capsule->ext_cost_0_fun_jac_hess.set_param(&capsule->ext_cost_0_fun_jac_hess, p);
-        {%- endif %}
-        }
-        else // 0 < stage < N
-        {
-        {%- if cost.cost_type == "NONLINEAR_LS" %}
-            capsule->cost_y_fun[stage-1].set_param(capsule->cost_y_fun+stage-1, p);
-            capsule->cost_y_fun_jac_ut_xt[stage-1].set_param(capsule->cost_y_fun_jac_ut_xt+stage-1, p);
-            capsule->cost_y_hess[stage-1].set_param(capsule->cost_y_hess+stage-1, p);
-        {%- elif cost.cost_type == "CONVEX_OVER_NONLINEAR" %}
-            capsule->conl_cost_fun[stage-1].set_param(capsule->conl_cost_fun+stage-1, p);
-            capsule->conl_cost_fun_jac_hess[stage-1].set_param(capsule->conl_cost_fun_jac_hess+stage-1, p);
-        {%- elif cost.cost_type == "EXTERNAL" %}
-            capsule->ext_cost_fun[stage-1].set_param(capsule->ext_cost_fun+stage-1, p);
-            capsule->ext_cost_fun_jac[stage-1].set_param(capsule->ext_cost_fun_jac+stage-1, p);
-            capsule->ext_cost_fun_jac_hess[stage-1].set_param(capsule->ext_cost_fun_jac_hess+stage-1, p);
-        {%- endif %}
-        }
+int {{ model.name }}_acados_update_params_buffered({{ model.name }}_solver_capsule* capsule, int stage, double *p, int np)
+{
+    int casadi_np = {{ dims.np }};
+    if (casadi_np != np) {
+        printf("{{ model.name }}_acados_update_params_buffered: trying to set %i parameters for external functions."
+            " External function has %i parameters. Exiting.\n", np, casadi_np);
+        exit(1);
     }
 
-    else // stage == N
+{%- if dims.np > 0 %}
+    // the sequence number is odd while the writer is active, epoch = sequence / 2 selects the
+    // published slot; write the other slot, then publish it with the next epoch
+    unsigned int seq = PARAMS_EPOCH_LOAD(capsule->params_epoch + stage);
+    PARAMS_EPOCH_STORE(capsule->params_epoch + stage, seq + 1);
+    PARAMS_RELEASE_FENCE();
+    double *slot = capsule->params_buffer + (2*stage + (((seq >> 1) + 1) & 1)) * NP;
+    for (int i = 0; i < NP; i++)
+        slot[i] = p[i];
+    PARAMS_RELEASE_FENCE();
+    PARAMS_EPOCH_STORE(capsule->params_epoch + stage, seq + 2);
+{%- endif %}
+
+    return 0;
+}
+
+
+int {{ model.name }}_acados_apply_buffered_params({{ model.name }}_solver_capsule* capsule)
+{
+{%- if dims.np > 0 %}
+    const int N = capsule->nlp_solver_plan->N;
+    unsigned int epoch;
+
+    for (int stage = 0; stage <= N; stage++)
     {
-        // terminal shooting node has no dynamics
-        // cost
-    {%- if cost.cost_type_e == "NONLINEAR_LS" %}
-        capsule->cost_y_e_fun.set_param(&capsule->cost_y_e_fun, p);
-        capsule->cost_y_e_fun_jac_ut_xt.set_param(&capsule->cost_y_e_fun_jac_ut_xt, p);
-        capsule->cost_y_e_hess.set_param(&capsule->cost_y_e_hess, p);
-    {%- elif cost.cost_type_e == "CONVEX_OVER_NONLINEAR" %}
-        capsule->conl_cost_e_fun.set_param(&capsule->conl_cost_e_fun, p);
-        capsule->conl_cost_e_fun_jac_hess.set_param(&capsule->conl_cost_e_fun_jac_hess, p);
-    {%- elif cost.cost_type_e == "EXTERNAL" %}
-        capsule->ext_cost_e_fun.set_param(&capsule->ext_cost_e_fun, p);
-        capsule->ext_cost_e_fun_jac.set_param(&capsule->ext_cost_e_fun_jac, p);
-        capsule->ext_cost_e_fun_jac_hess.set_param(&capsule->ext_cost_e_fun_jac_hess, p);
-    {%- endif %}
-        // constraints
-    {%- if constraints.constr_type_e == "BGP" %}
-        capsule->phi_e_constraint.set_param(&capsule->phi_e_constraint, p);
-    {%- elif constraints.constr_type_e == "BGH" and dims.nh_e > 0 %}
-        capsule->nl_constr_h_e_fun_jac.set_param(&capsule->nl_constr_h_e_fun_jac, p);
-        capsule->nl_constr_h_e_fun.set_param(&capsule->nl_constr_h_e_fun, p);
-    {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->nl_constr_h_e_fun_jac_hess.set_param(&capsule->nl_constr_h_e_fun_jac_hess, p);
-    {%- endif %}
-    {%- endif %}
+        if ((PARAMS_EPOCH_LOAD(capsule->params_epoch + stage) >> 1) == capsule->params_epoch_applied[stage])
+            continue;
+
+        // copy the published slot into the parameter block of the stage; an active writer fills
+        // the other slot, retry only if it published meanwhile and may reuse the slot being read
+        double *p_stage = capsule->p_shared + stage*NP;
+        do
+        {
+            epoch = PARAMS_EPOCH_LOAD(capsule->params_epoch + stage) >> 1;
+            double *slot = capsule->params_buffer + (2*stage + (epoch & 1)) * NP;
+            for (int i = 0; i < NP; i++)
+                p_stage[i] = slot[i];
+            PARAMS_ACQUIRE_FENCE();
+        } while (epoch != (PARAMS_EPOCH_LOAD(capsule->params_epoch + stage) >> 1));
+
+        capsule->params_epoch_applied[stage] = epoch;
     }
+{%- endif %}
 
-    return solver_status;
+    return 0;
 }
 
 
@@ -2543,134 +2566,64 @@ int {{ model.name }}_acados_update_params_sparse({{ model.name }}_solver_capsule
     // }
 
 {%- if dims.np > 0 %}
-    const int N = capsule->nlp_solver_plan->N;
-    if (stage < N && stage >= 0)
-    {
-    {%- if solver_options.integrator_type == "IRK" %}
-        capsule->impl_dae_fun[stage].set_param_sparse(capsule->impl_dae_fun+stage, n_update, idx, p);
-        capsule->impl_dae_fun_jac_x_xdot_z[stage].set_param_sparse(capsule->impl_dae_fun_jac_x_xdot_z+stage, n_update, idx, p);
-        capsule->impl_dae_jac_x_xdot_u_z[stage].set_param_sparse(capsule->impl_dae_jac_x_xdot_u_z+stage, n_update, idx, p);
+    // all external functions of the stage share this parameter block
+    double *p_stage = capsule->p_shared + stage*NP;
+    for (int i = 0; i < n_update; i++)
+        p_stage[idx[i]] = p[i];
+{% endif %}{# if dims.np #}
 
-        {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->impl_dae_hess[stage].set_param_sparse(capsule->impl_dae_hess+stage, n_update, idx, p);
-        {%- endif %}
-    {% elif solver_options.integrator_type == "LIFTED_IRK" %}
-        capsule->impl_dae_fun[stage].set_param_sparse(capsule->impl_dae_fun+stage, n_update, idx, p);
-        capsule->impl_dae_fun_jac_x_xdot_u[stage].set_param_sparse(capsule->impl_dae_fun_jac_x_xdot_u+stage, n_update, idx, p);
-    {% elif solver_options.integrator_type == "ERK" %}
-        capsule->forw_vde_casadi[stage].set_param_sparse(capsule->forw_vde_casadi+stage, n_update, idx, p);
-        capsule->expl_ode_fun[stage].set_param_sparse(capsule->expl_ode_fun+stage, n_update, idx, p);
+    return solver_status;
+}
 
-        {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->hess_vde_casadi[stage].set_param_sparse(capsule->hess_vde_casadi+stage, n_update, idx, p);
-        {%- endif %}
-    {% elif solver_options.integrator_type == "GNSF" %}
-    {% if model.gnsf.purely_linear != 1 %}
-        capsule->gnsf_phi_fun[stage].set_param_sparse(capsule->gnsf_phi_fun+stage, n_update, idx, p);
-        capsule->gnsf_phi_fun_jac_y[stage].set_param_sparse(capsule->gnsf_phi_fun_jac_y+stage, n_update, idx, p);
-        capsule->gnsf_phi_jac_y_uhat[stage].set_param_sparse(capsule->gnsf_phi_jac_y_uhat+stage, n_update, idx, p);
-        {% if model.gnsf.nontrivial_f_LO == 1 %}
-            capsule->gnsf_f_lo_jac_x1_x1dot_u_z[stage].set_param_sparse(capsule->gnsf_f_lo_jac_x1_x1dot_u_z+stage, n_update, idx, p);
-        {%- endif %}
-    {%- endif %}
-    {% elif solver_options.integrator_type == "DISCRETE" %}
-        capsule->discr_dyn_phi_fun[stage].set_param_sparse(capsule->discr_dyn_phi_fun+stage, n_update, idx, p);
-        capsule->discr_dyn_phi_fun_jac_ut_xt[stage].set_param_sparse(capsule->discr_dyn_phi_fun_jac_ut_xt+stage, n_update, idx, p);
-    {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->discr_dyn_phi_fun_jac_ut_xt_hess[stage].set_param_sparse(capsule->discr_dyn_phi_fun_jac_ut_xt_hess+stage, n_update, idx, p);
-    {% endif %}
-    {%- endif %}{# integrator_type #}
+int {{ model.name }}_acados_solve({{ model.name }}_solver_capsule* capsule)
+{
+{%- if dims.np > 0 %}
+    // pick up a consistent snapshot of the double-buffered parameters
+    {{ model.name }}_acados_apply_buffered_params(capsule);
 
-        // cost & constraints
-        if (stage == 0)
-        {
-            // cost
-        {%- if cost.cost_type_0 == "NONLINEAR_LS" %}
-            capsule->cost_y_0_fun.set_param_sparse(&capsule->cost_y_0_fun, n_update, idx, p);
-            capsule->cost_y_0_fun_jac_ut_xt.set_param_sparse(&capsule->cost_y_0_fun_jac_ut_xt, n_update, idx, p);
-            capsule->cost_y_0_hess.set_param_sparse(&capsule->cost_y_0_hess, n_update, idx, p);
-        {%- elif cost.cost_type_0 == "CONVEX_OVER_NONLINEAR" %}
-            capsule->conl_cost_0_fun.set_param_sparse(&capsule->conl_cost_0_fun, n_update, idx, p);
-            capsule->conl_cost_0_fun_jac_hess.set_param_sparse(&capsule->conl_cost_0_fun_jac_hess, n_update, idx, p);
-        {%- elif cost.cost_type_0 == "EXTERNAL" %}
-            capsule->ext_cost_0_fun.set_param_sparse(&capsule->ext_cost_0_fun, n_update, idx, p);
-            capsule->ext_cost_0_fun_jac.set_param_sparse(&capsule->ext_cost_0_fun_jac, n_update, idx, p);
-            capsule->ext_cost_0_fun_jac_hess.set_param_sparse(&capsule->ext_cost_0_fun_jac_hess, n_update, idx, p);
-        {% endif %}
-            // constraints
-        {% if constraints.constr_type_0 == "BGP" %}
-            capsule->phi_0_constraint.set_param_sparse(&capsule->phi_0_constraint, n_update, idx, p);
-        {% elif constraints.constr_type_0 == "BGH" and dims.nh_0 > 0 %}
-            capsule->nl_constr_h_0_fun_jac.set_param_sparse(&capsule->nl_constr_h_0_fun_jac, n_update, idx, p);
-            capsule->nl_constr_h_0_fun.set_param_sparse(&capsule->nl_constr_h_0_fun, n_update, idx, p);
-            {%- if solver_options.hessian_approx == "EXACT" %}
-            capsule->nl_constr_h_0_fun_jac_hess.set_param_sparse(&capsule->nl_constr_h_0_fun_jac_hess, n_update, idx, p);
-            {%- endif %}
-        {% endif %}
-        }
-        else // 0 < stage < N
+{%- endif %}
+    // solve NLP
+    int solver_status = ocp_nlp_solve(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out);
+
+    return solver_status;
+}
+
+
+int {{ model.name }}_acados_batch_solve({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch)
+{
+    if (!capsules || !status_out || N_batch < 0)
+    {
+        fprintf(stderr, "{{ model.name }}_acados_batch_solve: invalid arguments.\n");
+        return -1;
+    }
+    for (int i = 0; i < N_batch; i++)
+    {
+        if (!capsules[i])
         {
-        {%- if cost.cost_type == "NONLINEAR_LS" %}
-            capsule->cost_y_fun[stage-1].set_param_sparse(capsule->cost_y_fun+stage-1, n_update, idx, p);
-            capsule->cost_y_fun_jac_ut_xt[stage-1].set_param_sparse(capsule->cost_y_fun_jac_ut_xt+stage-1, n_update, idx, p);
-            capsule->cost_y_hess[stage-1].set_param_sparse(capsule->cost_y_hess+stage-1, n_update, idx, p);
-        {%- elif cost.cost_type == "CONVEX_OVER_NONLINEAR" %}
-            capsule->conl_cost_fun[stage-1].set_param_sparse(capsule->conl_cost_fun+stage-1, n_update, idx, p);
-            capsule->conl_cost_fun_jac_hess[stage-1].set_param_sparse(capsule->conl_cost_fun_jac_hess+stage-1, n_update, idx, p);
-        {%- elif cost.cost_type == "EXTERNAL" %}
-            capsule->ext_cost_fun[stage-1].set_param_sparse(capsule->ext_cost_fun+stage-1, n_update, idx, p);
-            capsule->ext_cost_fun_jac[stage-1].set_param_sparse(capsule->ext_cost_fun_jac+stage-1, n_update, idx, p);
-            capsule->ext_cost_fun_jac_hess[stage-1].set_param_sparse(capsule->ext_cost_fun_jac_hess+stage-1, n_update, idx, p);
-        {%- endif %}
-
-        {% if constraints.constr_type == "BGP" %}
-            capsule->phi_constraint[stage-1].set_param_sparse(capsule->phi_constraint+stage-1, n_update, idx, p);
-        {% elif constraints.constr_type == "BGH" and dims.nh > 0 %}
-            capsule->nl_constr_h_fun_jac[stage-1].set_param_sparse(capsule->nl_constr_h_fun_jac+stage-1, n_update, idx, p);
-            capsule->nl_constr_h_fun[stage-1].set_param_sparse(capsule->nl_constr_h_fun+stage-1, n_update, idx, p);
-            {%- if solver_options.hessian_approx == "EXACT" %}
-            capsule->nl_constr_h_fun_jac_hess[stage-1].set_param_sparse(capsule->nl_constr_h_fun_jac_hess+stage-1, n_update, idx, p);
-            {%- endif %}
-        {%- endif %}
+            fprintf(stderr, "{{ model.name }}_acados_batch_solve: capsule %d is NULL.\n", i);
+            return -1;
         }
     }
 
-    else // stage == N
+    // solve independent NLPs, in parallel if compiled with OpenMP
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (int i = 0; i < N_batch; i++)
     {
-        // terminal shooting node has no dynamics
-        // cost
-    {%- if cost.cost_type_e == "NONLINEAR_LS" %}
-        capsule->cost_y_e_fun.set_param_sparse(&capsule->cost_y_e_fun, n_update, idx, p);
-        capsule->cost_y_e_fun_jac_ut_xt.set_param_sparse(&capsule->cost_y_e_fun_jac_ut_xt, n_update, idx, p);
-        capsule->cost_y_e_hess.set_param_sparse(&capsule->cost_y_e_hess, n_update, idx, p);
-    {%- elif cost.cost_type_e == "CONVEX_OVER_NONLINEAR" %}
-        capsule->conl_cost_e_fun.set_param_sparse(&capsule->conl_cost_e_fun, n_update, idx, p);
-        capsule->conl_cost_e_fun_jac_hess.set_param_sparse(&capsule->conl_cost_e_fun_jac_hess, n_update, idx, p);
-    {%- elif cost.cost_type_e == "EXTERNAL" %}
-        capsule->ext_cost_e_fun.set_param_sparse(&capsule->ext_cost_e_fun, n_update, idx, p);
-        capsule->ext_cost_e_fun_jac.set_param_sparse(&capsule->ext_cost_e_fun_jac, n_update, idx, p);
-        capsule->ext_cost_e_fun_jac_hess.set_param_sparse(&capsule->ext_cost_e_fun_jac_hess, n_update, idx, p);
-    {% endif %}
-        // constraints
-    {% if constraints.constr_type_e == "BGP" %}
-        capsule->phi_e_constraint.set_param_sparse(&capsule->phi_e_constraint, n_update, idx, p);
-    {% elif constraints.constr_type_e == "BGH" and dims.nh_e > 0 %}
-        capsule->nl_constr_h_e_fun_jac.set_param_sparse(&capsule->nl_constr_h_e_fun_jac, n_update, idx, p);
-        capsule->nl_constr_h_e_fun.set_param_sparse(&capsule->nl_constr_h_e_fun, n_update, idx, p);
-    {%- if solver_options.hessian_approx == "EXACT" %}
-        capsule->nl_constr_h_e_fun_jac_hess.set_param_sparse(&capsule->nl_constr_h_e_fun_jac_hess, n_update, idx, p);
-    {%- endif %}
-    {% endif %}
+{%- if dims.np > 0 %}
+        // pick up a consistent snapshot of the double-buffered parameters
+        {{ model.name }}_acados_apply_buffered_params(capsules[i]);
+{%- endif %}
+        status_out[i] = ocp_nlp_solve(capsules[i]->nlp_solver, capsules[i]->nlp_in, capsules[i]->nlp_out);
     }
-{% endif %}{# if dims.np #}
-
-    return solver_status;
-}
 
-int {{ model.name }}_acados_solve({{ model.name }}_solver_capsule* capsule)
-{
-    // solve NLP
-    int solver_status = ocp_nlp_solve(capsule->nlp_solver, capsule->nlp_in, capsule->nlp_out);
+    int solver_status = ACADOS_SUCCESS;
+    for (int i = 0; i < N_batch; i++)
+    {
+        if (solver_status == ACADOS_SUCCESS)
+            solver_status = status_out[i];
+    }
 
     return solver_status;
 }
@@ -2693,6 +2646,11 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     ocp_nlp_config_destroy(capsule->nlp_config);
     ocp_nlp_plan_destroy(capsule->nlp_solver_plan);
 
+    free(capsule->p_shared);
+    free(capsule->params_buffer);
+    free(capsule->params_epoch);
+    free(capsule->params_epoch_applied);
+
     /* free external function */
     // dynamics
 {%- if solver_options.integrator_type == "IRK" %}
@@ -2717,9 +2675,21 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     {
         external_function_param_{{ model.dyn_ext_fun_type }}_free(&capsule->impl_dae_fun[i]);
         external_function_param_{{ model.dyn_ext_fun_type }}_free(&capsule->impl_dae_fun_jac_x_xdot_u[i]);
+    {%- if dims.nz > 0 %}
+        external_function_param_{{ model.dyn_ext_fun_type }}_free(&capsule->impl_dae_jac_x_xdot_u_z[i]);
+    {%- endif %}
+    {%- if solver_options.hessian_approx == "EXACT" %}
+        external_function_param_{{ model.dyn_ext_fun_type }}_free(&capsule->impl_dae_hess[i]);
+    {%- endif %}
     }
     free(capsule->impl_dae_fun);
     free(capsule->impl_dae_fun_jac_x_xdot_u);
+    {%- if dims.nz > 0 %}
+    free(capsule->impl_dae_jac_x_xdot_u_z);
+    {%- endif %}
+    {%- if solver_options.hessian_approx == "EXACT" %}
+    free(capsule->impl_dae_hess);
+    {%- endif %}
 
 {%- elif solver_options.integrator_type == "ERK" %}
     for (int i = 0; i < N; i++)
@@ -2743,8 +2713,14 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
         external_function_param_casadi_free(&capsule->gnsf_phi_fun[i]);
         external_function_param_casadi_free(&capsule->gnsf_phi_fun_jac_y[i]);
         external_function_param_casadi_free(&capsule->gnsf_phi_jac_y_uhat[i]);
+        {%- if solver_options.hessian_approx == "EXACT" %}
+        external_function_param_casadi_free(&capsule->gnsf_phi_hess[i]);
+        {%- endif %}
         {% if model.gnsf.nontrivial_f_LO == 1 %}
         external_function_param_casadi_free(&capsule->gnsf_f_lo_jac_x1_x1dot_u_z[i]);
+        {%- if solver_options.hessian_approx == "EXACT" %}
+        external_function_param_casadi_free(&capsule->gnsf_f_lo_hess[i]);
+        {%- endif %}
         {%- endif %}
         {%- endif %}
         external_function_param_casadi_free(&capsule->gnsf_get_matrices_fun[i]);
@@ -2753,8 +2729,14 @@ int {{ model.name }}_acados_free({{ model.name }}_solver_capsule* capsule)
     free(capsule->gnsf_phi_fun);
     free(capsule->gnsf_phi_fun_jac_y);
     free(capsule->gnsf_phi_jac_y_uhat);
+  {%- if solver_options.hessian_approx == "EXACT" %}
+    free(capsule->gnsf_phi_hess);
+  {%- endif %}
   {% if model.gnsf.nontrivial_f_LO == 1 %}
     free(capsule->gnsf_f_lo_jac_x1_x1dot_u_z);
+  {%- if solver_options.hessian_approx == "EXACT" %}
+    free(capsule->gnsf_f_lo_hess);
+  {%- endif %}
   {%- endif %}
   {%- endif %}
     free(capsule->gnsf_get_matrices_fun);
@@ -98,6 +98,14 @@ typedef struct {{ model.name }}_solver_capsule
     // number of expected runtime parameters
     unsigned int nlp_np;
 
+    // parameters of stage i are stored at p_shared + i*NP, shared by all external functions of the stage
+    double *p_shared;
+
+    // double-buffered runtime parameters, see {{ model.name }}_acados_update_params_buffered
+    double *params_buffer;                // two slots of NP parameters per stage
+    unsigned int *params_epoch;           // per stage sequence number, odd while the writer is active, epoch = sequence / 2
+    unsigned int *params_epoch_applied;   // per stage, epoch applied to the external functions
+
     /* external functions */
     // dynamics
 {% if solver_options.integrator_type == "ERK" %}
@@ -116,12 +124,20 @@ typedef struct {{ model.name }}_solver_capsule
 {% elif solver_options.integrator_type == "LIFTED_IRK" %}
     external_function_param_{{ model.dyn_ext_fun_type }} *impl_dae_fun;
     external_function_param_{{ model.dyn_ext_fun_type }} *impl_dae_fun_jac_x_xdot_u;
+{% if dims.nz > 0 %}
+    external_function_param_{{ model.dyn_ext_fun_type }} *impl_dae_jac_x_xdot_u_z;
+{%- endif %}
+{% if solver_options.hessian_approx == "EXACT" %}
+    external_function_param_{{ model.dyn_ext_fun_type }} *impl_dae_hess;
+{%- endif %}
 {% elif solver_options.integrator_type == "GNSF" %}
     external_function_param_casadi *gnsf_phi_fun;
     external_function_param_casadi *gnsf_phi_fun_jac_y;
     external_function_param_casadi *gnsf_phi_jac_y_uhat;
     external_function_param_casadi *gnsf_f_lo_jac_x1_x1dot_u_z;
     external_function_param_casadi *gnsf_get_matrices_fun;
+    external_function_param_casadi *gnsf_phi_hess;
+    external_function_param_casadi *gnsf_f_lo_hess;
 {% elif solver_options.integrator_type == "DISCRETE" %}
     external_function_param_{{ model.dyn_ext_fun_type }} *discr_dyn_phi_fun;
     external_function_param_{{ model.dyn_ext_fun_type }} *discr_dyn_phi_fun_jac_ut_xt;
@@ -234,8 +250,33 @@ ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_time_steps({{ model.name
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_qp_solver_cond_N({{ model.name }}_solver_capsule * capsule, int qp_solver_cond_N);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_params({{ model.name }}_solver_capsule * capsule, int stage, double *value, int np);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_params_sparse({{ model.name }}_solver_capsule * capsule, int stage, int *idx, double *p, int n_update);
+/**
+ * Sets the parameters of all stages 0, ..., N from one stage-major array of length (N+1)*np.
+ */
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_params_all({{ model.name }}_solver_capsule * capsule, double *value, int np_total);
+/**
+ * Wait-free parameter update from a thread other than the solver thread (one writer thread).
+ * The parameters are written to a double buffer and published with an atomic sequence number
+ * that is odd while the writer is active (seqlock), the solver applies the latest consistent
+ * values at the start of {{ model.name }}_acados_solve, i.e. at the start of each preparation or feedback phase.
+ */
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_update_params_buffered({{ model.name }}_solver_capsule * capsule, int stage, double *value, int np);
+/**
+ * Applies the parameters published by {{ model.name }}_acados_update_params_buffered,
+ * called by {{ model.name }}_acados_solve and {{ model.name }}_acados_batch_solve.
+ */
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_apply_buffered_params({{ model.name }}_solver_capsule * capsule);
 
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_solve({{ model.name }}_solver_capsule * capsule);
+/**
+ * Solves N_batch independent instances of the OCP, each one with its own capsule.
+ * The instances are solved in parallel if the solver is compiled with OpenMP.
+ * The solvers write to their options during the solve, so the capsules must not share them;
+ * every capsule created with {{ model.name }}_acados_create owns its options.
+ * The status of each instance is written to status_out, returns 0 if all instances succeeded,
+ * the first nonzero status otherwise and -1 for invalid arguments.
+ */
+ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_batch_solve({{ model.name }}_solver_capsule ** capsules, int * status_out, int N_batch);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_free({{ model.name }}_solver_capsule * capsule);
 ACADOS_SYMBOL_EXPORT void {{ model.name }}_acados_print_stats({{ model.name }}_solver_capsule * capsule);
 ACADOS_SYMBOL_EXPORT int {{ model.name }}_acados_custom_update({{ model.name }}_solver_capsule* capsule, double* data, int data_len);
@@ -45,7 +45,10 @@ cdef extern from "acados_solver_{{ model.name }}.h":
 
     int acados_update_params "{{ model.name }}_acados_update_params"(nlp_solver_capsule * capsule, int stage, double *value, int np_)
     int acados_update_params_sparse "{{ model.name }}_acados_update_params_sparse"(nlp_solver_capsule * capsule, int stage, int *idx, double *p, int n_update)
+    int acados_update_params_all "{{ model.name }}_acados_update_params_all"(nlp_solver_capsule * capsule, double *value, int np_total)
+    int acados_update_params_buffered "{{ model.name }}_acados_update_params_buffered"(nlp_solver_capsule * capsule, int stage, double *value, int np_)
     int acados_solve "{{ model.name }}_acados_solve"(nlp_solver_capsule * capsule)
+    int acados_batch_solve "{{ model.name }}_acados_batch_solve"(nlp_solver_capsule ** capsules, int * status_out, int N_batch)
     int acados_reset "{{ model.name }}_acados_reset"(nlp_solver_capsule * capsule, int reset_qp_solver_mem)
     int acados_free "{{ model.name }}_acados_free"(nlp_solver_capsule * capsule)
     void acados_print_stats "{{ model.name }}_acados_print_stats"(nlp_solver_capsule * capsule)
@@ -121,6 +121,16 @@ const int *{{ model.name }}_gnsf_phi_jac_y_uhat_sparsity_in(int);
 const int *{{ model.name }}_gnsf_phi_jac_y_uhat_sparsity_out(int);
 int {{ model.name }}_gnsf_phi_jac_y_uhat_n_in(void);
 int {{ model.name }}_gnsf_phi_jac_y_uhat_n_out(void);
+	{%- if hessian_approx == "EXACT" %}
+
+// phi_hess
+int {{ model.name }}_gnsf_phi_hess(const double** arg, double** res, int* iw, double* w, void *mem);
+int {{ model.name }}_gnsf_phi_hess_work(int *, int *, int *, int *);
+const int *{{ model.name }}_gnsf_phi_hess_sparsity_in(int);
+const int *{{ model.name }}_gnsf_phi_hess_sparsity_out(int);
+int {{ model.name }}_gnsf_phi_hess_n_in(void);
+int {{ model.name }}_gnsf_phi_hess_n_out(void);
+	{%- endif %}
 	{% if model.gnsf.nontrivial_f_LO == 1 %}
 // f_lo_fun_jac_x1k1uz
 int {{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz(const double** arg, double** res, int* iw, double* w, void *mem);
@@ -129,6 +139,16 @@ const int *{{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_sparsity_in(int);
 const int *{{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_sparsity_out(int);
 int {{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_n_in(void);
 int {{ model.name }}_gnsf_f_lo_fun_jac_x1k1uz_n_out(void);
+		{%- if hessian_approx == "EXACT" %}
+
+// f_lo_hess
+int {{ model.name }}_gnsf_f_lo_hess(const double** arg, double** res, int* iw, double* w, void *mem);
+int {{ model.name }}_gnsf_f_lo_hess_work(int *, int *, int *, int *);
+const int *{{ model.name }}_gnsf_f_lo_hess_sparsity_in(int);
+const int *{{ model.name }}_gnsf_f_lo_hess_sparsity_out(int);
+int {{ model.name }}_gnsf_f_lo_hess_n_in(void);
+int {{ model.name }}_gnsf_f_lo_hess_n_out(void);
+		{%- endif %}
 	{%- endif %}
 	{%- endif %}
 // used to import model matrices
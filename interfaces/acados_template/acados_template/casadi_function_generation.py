@@ -73,10 +73,10 @@ def ocp_generate_external_functions(ocp: AcadosOcp):
         elif ocp.solver_options.integrator_type == 'IRK':
             generate_c_code_implicit_ode(model, opts)
         elif ocp.solver_options.integrator_type == 'LIFTED_IRK':
-            if model.t != []:
-                raise NotImplementedError("LIFTED_IRK with time-varying dynamics not implemented yet.")
             generate_c_code_implicit_ode(model, opts)
         elif ocp.solver_options.integrator_type == 'GNSF':
+            if model.t != []:
+                raise NotImplementedError("GNSF with time-varying dynamics not supported by the structure detection yet.")
             generate_c_code_gnsf(model, opts)
         elif ocp.solver_options.integrator_type == 'DISCRETE':
             generate_c_code_discrete_dynamics(model, opts)
@@ -180,6 +180,7 @@ def generate_c_code_explicit_ode( model, opts ):
     x = model.x
     u = model.u
     p = model.p
+    t = model.t
     f_expl = model.f_expl_expr
     model_name = model.name
 
@@ -197,19 +198,19 @@ def generate_c_code_explicit_ode( model, opts ):
     fun_name = model_name + '_expl_ode_fun'
 
     ## Set up functions
-    expl_ode_fun = ca.Function(fun_name, [x, u, p], [f_expl])
+    expl_ode_fun = ca.Function(fun_name, [x, u, t, p], [f_expl])
 
     vdeX = ca.jtimes(f_expl,x,Sx)
     vdeP = ca.jacobian(f_expl,u) + ca.jtimes(f_expl,x,Sp)
 
     fun_name = model_name + '_expl_vde_forw'
 
-    expl_vde_forw = ca.Function(fun_name, [x, Sx, Sp, u, p], [f_expl, vdeX, vdeP])
+    expl_vde_forw = ca.Function(fun_name, [x, Sx, Sp, u, t, p], [f_expl, vdeX, vdeP])
 
     adj = ca.jtimes(f_expl, ca.vertcat(x, u), lambdaX, True)
 
     fun_name = model_name + '_expl_vde_adj'
-    expl_vde_adj = ca.Function(fun_name, [x, lambdaX, u, p], [adj])
+    expl_vde_adj = ca.Function(fun_name, [x, lambdaX, u, t, p], [adj])
 
     if generate_hess:
         S_forw = ca.vertcat(ca.horzcat(Sx, Sp), ca.horzcat(ca.DM.zeros(nu,nx), ca.DM.eye(nu)))
@@ -220,7 +221,7 @@ def generate_c_code_explicit_ode( model, opts ):
                 hess2 = ca.vertcat(hess2, hess[i,j])
 
         fun_name = model_name + '_expl_ode_hess'
-        expl_ode_hess = ca.Function(fun_name, [x, Sx, Sp, lambdaX, u, p], [adj, hess2])
+        expl_ode_hess = ca.Function(fun_name, [x, Sx, Sp, lambdaX, u, t, p], [adj, hess2])
 
     # change directory
     cwd = os.getcwd()
@@ -389,6 +390,26 @@ def generate_c_code_gnsf( model, opts ):
                  f_lo_fun_jac_x1k1uz_eval)
     f_lo_fun_jac_x1k1uz_.generate(fun_name, casadi_codegen_opts)
 
+    if opts['generate_hess']:
+        # second order derivatives of the nonlinear GNSF parts, weighted with multipliers
+        fun_name = model_name + '_gnsf_phi_hess'
+        lam_phi = symbol("gnsf_lam_phi", gnsf_nout, 1)
+        phi_hess = ca.hessian(ca.dot(lam_phi, phi_fun(y, uhat, p)), ca.vertcat(y, uhat))[0]
+        phi_hess_ = ca.Function(fun_name, [y, uhat, lam_phi, p], [phi_hess])
+        phi_hess_.generate(fun_name, casadi_codegen_opts)
+
+        fun_name = model_name + '_gnsf_f_lo_hess'
+        x1k1uz = ca.vertcat(x1, x1dot, u, z1)
+        f_lo = f_lo_fun_jac_x1k1uz_eval[0]
+        if is_empty(f_lo):
+            lam_f_lo = symbol("gnsf_lam_f_lo", 0, 1)
+            f_lo_hess = ca.DM.zeros(x1k1uz.shape[0], x1k1uz.shape[0])
+        else:
+            lam_f_lo = symbol("gnsf_lam_f_lo", f_lo.shape[0], 1)
+            f_lo_hess = ca.hessian(ca.dot(lam_f_lo, f_lo), x1k1uz)[0]
+        f_lo_hess_ = ca.Function(fun_name, [x1, x1dot, z1, u, lam_f_lo, p], [f_lo_hess])
+        f_lo_hess_.generate(fun_name, casadi_codegen_opts)
+
     fun_name = model_name + '_gnsf_get_matrices_fun'
     get_matrices_fun_ = ca.Function(fun_name, [dummy], get_matrices_fun(1))
     get_matrices_fun_.generate(fun_name, casadi_codegen_opts)
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+#include <string>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+// std
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+
+// acados
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/ocp_nlp/ocp_nlp_cost_ls.h"
+#include "acados/utils/types.h"
+
+#define NN 6
+#define NX 2
+#define NU 1
+
+
+
+/************************************************
+* TEST CASE: whole horizon setters and getters on mixed cost and constraints modules
+************************************************/
+
+TEST_CASE("get_all and set_all with mixed modules", "[NLP solver]")
+{
+    ocp_nlp_plan_t *plan = ocp_nlp_plan_create(NN);
+    plan->nlp_solver = SQP;
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    for (int i = 0; i <= NN; i++)
+    {
+        plan->nlp_cost[i] = i % 2 == 1 ? EXTERNAL : LINEAR_LS;
+        plan->nlp_constraints[i] = i % 3 == 1 ? BGP : BGH;
+    }
+    for (int i = 0; i < NN; i++)
+        plan->nlp_dynamics[i] = DISCRETE_MODEL;
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    int nx[NN+1], nu[NN+1], nz[NN+1], ns[NN+1];
+    for (int i = 0; i <= NN; i++)
+    {
+        nx[i] = NX;
+        nu[i] = i < NN ? NU : 0;
+        nz[i] = 0;
+        ns[i] = 0;
+    }
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    // stage dimensions of yref and lh, 0 where the module has no such field
+    int ny[NN+1], nh[NN+1];
+    int ny_all = 0, nh_all = 0;
+    int zero = 0, one = 1;
+    for (int i = 0; i <= NN; i++)
+    {
+        ny[i] = 0;
+        if (plan->nlp_cost[i] == LINEAR_LS)
+        {
+            ny[i] = NX + nu[i];
+            ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny[i]);
+        }
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &zero);
+        nh[i] = 0;
+        if (plan->nlp_constraints[i] == BGH)
+        {
+            nh[i] = 1 + i % 2;
+            ocp_nlp_dims_set_constraints(config, dims, i, "nh", &nh[i]);
+        }
+        else
+        {
+            ocp_nlp_dims_set_constraints(config, dims, i, "nphi", &one);
+            ocp_nlp_dims_set_constraints(config, dims, i, "nr", &one);
+        }
+        ny_all += ny[i];
+        nh_all += nh[i];
+    }
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+
+    // lengths of the stage-major arrays
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "x") == (NN+1)*NX);
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "u") == NN*NU);
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "yref") == ny_all);
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "lh") == nh_all);
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "uh") == nh_all);
+    REQUIRE(ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, "lphi") == 2);
+
+    double values[(NN+1)*NX], values_out[(NN+1)*NX], stage_values[NX+NU];
+
+    SECTION("x and u")
+    {
+        for (std::string field_str : std::vector<std::string>{"x", "u"})
+        {
+            const char *field = field_str.c_str();
+            int n = ocp_nlp_dims_get_all_from_attr(config, dims, nlp_out, field);
+            for (int jj = 0; jj < n; jj++)
+                values[jj] = 1.0 + jj;
+            ocp_nlp_out_set_all(config, dims, nlp_out, field, values);
+            ocp_nlp_out_get_all(config, dims, nlp_out, field, values_out);
+            for (int jj = 0; jj < n; jj++)
+                REQUIRE(values_out[jj] == values[jj]);
+
+            // stage-major layout
+            int offset = 0;
+            for (int i = 0; i <= NN; i++)
+            {
+                int n_stage = field[0] == 'x' ? nx[i] : nu[i];
+                ocp_nlp_out_get(config, dims, nlp_out, i, field, stage_values);
+                for (int jj = 0; jj < n_stage; jj++)
+                    REQUIRE(stage_values[jj] == values[offset+jj]);
+                offset += n_stage;
+            }
+        }
+    }
+
+    SECTION("yref, skipping the stages with external cost")
+    {
+        for (int jj = 0; jj < ny_all; jj++)
+            values[jj] = -1.0 - jj;
+        ocp_nlp_in_set_all(config, dims, nlp_in, "yref", values);
+
+        int offset = 0;
+        for (int i = 0; i <= NN; i++)
+        {
+            if (plan->nlp_cost[i] != LINEAR_LS)
+                continue;
+            ocp_nlp_cost_ls_model *model = (ocp_nlp_cost_ls_model *) nlp_in->cost[i];
+            for (int jj = 0; jj < ny[i]; jj++)
+                REQUIRE(blasfeo_dvecex1(&model->y_ref, jj) == values[offset+jj]);
+            offset += ny[i];
+        }
+        REQUIRE(offset == ny_all);
+    }
+
+    SECTION("lh and uh, skipping the stages with BGP constraints")
+    {
+        for (std::string field_str : std::vector<std::string>{"lh", "uh"})
+        {
+            const char *field = field_str.c_str();
+            for (int jj = 0; jj < nh_all; jj++)
+                values[jj] = field[0] == 'l' ? -10.0 - jj : 10.0 + jj;
+            ocp_nlp_in_set_all(config, dims, nlp_in, field, values);
+
+            int offset = 0;
+            for (int i = 0; i <= NN; i++)
+            {
+                if (plan->nlp_constraints[i] != BGH)
+                    continue;
+                ocp_nlp_constraints_model_get(config, dims, nlp_in, i, field, stage_values);
+                for (int jj = 0; jj < nh[i]; jj++)
+                    REQUIRE(stage_values[jj] == values[offset+jj]);
+                offset += nh[i];
+            }
+            REQUIRE(offset == nh_all);
+        }
+    }
+
+    ocp_nlp_in_destroy(nlp_in);
+    ocp_nlp_out_destroy(nlp_out);
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+}
@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+// std
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// blasfeo
+#include "blasfeo/include/blasfeo_d_aux.h"
+
+// acados
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/utils/external_function_generic.h"
+#include "acados/utils/types.h"
+
+#define NN 20
+#define MAX_SQP_ITERS 10
+
+
+
+/************************************************
+* double integrator x+ = A x + B u as discrete model,
+* the NLP is a QP with constant matrices (linear MPC)
+************************************************/
+
+#define DT 0.1
+
+
+
+// in: x, u; out: fun
+static void di_disc_dyn_fun(void *self, ext_fun_arg_t *type_in, void **in,
+                            ext_fun_arg_t *type_out, void **out)
+{
+    struct blasfeo_dvec_args *x = (struct blasfeo_dvec_args *) in[0];
+    struct blasfeo_dvec_args *u = (struct blasfeo_dvec_args *) in[1];
+    struct blasfeo_dvec_args *fun = (struct blasfeo_dvec_args *) out[0];
+
+    double x0 = blasfeo_dvecex1(x->x, x->xi);
+    double x1 = blasfeo_dvecex1(x->x, x->xi+1);
+    double u0 = blasfeo_dvecex1(u->x, u->xi);
+
+    blasfeo_dvecin1(x0 + DT*x1 + 0.5*DT*DT*u0, fun->x, fun->xi);
+    blasfeo_dvecin1(x1 + DT*u0, fun->x, fun->xi+1);
+}
+
+
+
+// in: x, u; out: fun, jac' = [B A]^T
+static void di_disc_dyn_fun_jac(void *self, ext_fun_arg_t *type_in, void **in,
+                                ext_fun_arg_t *type_out, void **out)
+{
+    di_disc_dyn_fun(self, type_in, in, type_out, out);
+
+    struct blasfeo_dmat_args *jac = (struct blasfeo_dmat_args *) out[1];
+    int ai = jac->ai;
+    int aj = jac->aj;
+
+    blasfeo_dgein1(0.5*DT*DT, jac->A, ai, aj);
+    blasfeo_dgein1(DT, jac->A, ai, aj+1);
+    blasfeo_dgein1(1.0, jac->A, ai+1, aj);
+    blasfeo_dgein1(0.0, jac->A, ai+1, aj+1);
+    blasfeo_dgein1(DT, jac->A, ai+2, aj);
+    blasfeo_dgein1(1.0, jac->A, ai+2, aj+1);
+}
+
+
+
+typedef struct
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    ocp_nlp_in *nlp_in;
+    ocp_nlp_out *nlp_out;
+    void *nlp_opts;
+    ocp_nlp_solver *solver;
+} linear_mpc;
+
+
+
+static void linear_mpc_create(linear_mpc *mpc, ocp_nlp_plan_t *plan, external_function_generic *dyn_fun,
+    external_function_generic *dyn_fun_jac, int reuse_qp_lhs)
+{
+    int nx[NN+1], nu[NN+1], nz[NN+1], ns[NN+1];
+    for (int i = 0; i <= NN; i++)
+    {
+        nx[i] = 2;
+        nu[i] = i < NN ? 1 : 0;
+        nz[i] = 0;
+        ns[i] = 0;
+    }
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    int ny = 3, nyN = 2;
+    int nbx0 = 2, nbu = 1, zero = 0;
+    for (int i = 0; i <= NN; i++)
+    {
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", i < NN ? &ny : &nyN);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", i == 0 ? &nbx0 : &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", i < NN ? &nbu : &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &zero);
+    }
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+
+    // cost: y = [x; u], constant weights
+    double Vx[] = {1.0, 0.0, 0.0,  0.0, 1.0, 0.0};
+    double Vu[] = {0.0, 0.0, 1.0};
+    double W[] = {10.0, 0.0, 0.0,  0.0, 1.0, 0.0,  0.0, 0.0, 0.1};
+    double VxN[] = {1.0, 0.0,  0.0, 1.0};
+    double WN[] = {10.0, 0.0,  0.0, 10.0};
+    double yref[] = {0.0, 0.0, 0.0};
+    for (int i = 0; i < NN; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vx", Vx);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Vu", Vu);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", yref);
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "Vx", VxN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, NN, "yref", yref);
+
+    // dynamics
+    for (int i = 0; i < NN; i++)
+    {
+        nlp_in->Ts[i] = DT;
+        REQUIRE(ocp_nlp_dynamics_model_set(config, dims, nlp_in, i, "disc_dyn_fun", dyn_fun) == 0);
+        REQUIRE(ocp_nlp_dynamics_model_set(config, dims, nlp_in, i, "disc_dyn_fun_jac", dyn_fun_jac) == 0);
+    }
+
+    // constraints: initial state, active bounds on the input
+    int idxbx0[] = {0, 1};
+    double x0[] = {2.0, 0.0};
+    int idxbu[] = {0};
+    double lbu[] = {-1.0};
+    double ubu[] = {1.0};
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", x0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", x0);
+    for (int i = 0; i < NN; i++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, i, "ubu", ubu);
+    }
+
+    // opts
+    void *nlp_opts = ocp_nlp_solver_opts_create(config, dims);
+
+    int max_iter = MAX_SQP_ITERS;
+    double tol = 1e-8;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_stat", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "reuse_qp_lhs", &reuse_qp_lhs);
+
+    if (plan->ocp_qp_solver_plan.qp_solver == PARTIAL_CONDENSING_HPIPM)
+    {
+        int cond_N = 5;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "qp_cond_N", &cond_N);
+    }
+
+    config->opts_update(config, dims, nlp_opts);
+
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+    ocp_nlp_solver *solver = ocp_nlp_solver_create(config, dims, nlp_opts);
+    REQUIRE(ocp_nlp_precompute(solver, nlp_in, nlp_out) == 0);
+
+    mpc->config = config;
+    mpc->dims = dims;
+    mpc->nlp_in = nlp_in;
+    mpc->nlp_out = nlp_out;
+    mpc->nlp_opts = nlp_opts;
+    mpc->solver = solver;
+}
+
+
+
+static void linear_mpc_destroy(linear_mpc *mpc)
+{
+    ocp_nlp_solver_opts_destroy(mpc->nlp_opts);
+    ocp_nlp_in_destroy(mpc->nlp_in);
+    ocp_nlp_out_destroy(mpc->nlp_out);
+    ocp_nlp_solver_destroy(mpc->solver);
+    ocp_nlp_dims_destroy(mpc->dims);
+    ocp_nlp_config_destroy(mpc->config);
+}
+
+
+
+/************************************************
+* TEST CASE: linear MPC, reuse of the condensed QP matrices
+************************************************/
+
+TEST_CASE("linear mpc, reuse_qp_lhs", "[NLP solver]")
+{
+    std::vector<std::string> qp_solvers = {"SPARSE_HPIPM", "DENSE_HPIPM"};
+
+    external_function_generic dyn_fun, dyn_fun_jac;
+    dyn_fun.evaluate = &di_disc_dyn_fun;
+    dyn_fun_jac.evaluate = &di_disc_dyn_fun_jac;
+
+    for (std::string qp_solver_str : qp_solvers)
+    {
+        SECTION("QP solver: " + qp_solver_str)
+        {
+            ocp_nlp_plan_t *plan = ocp_nlp_plan_create(NN);
+            plan->nlp_solver = SQP;
+            plan->ocp_qp_solver_plan.qp_solver = qp_solver_str == "SPARSE_HPIPM" ?
+                PARTIAL_CONDENSING_HPIPM : FULL_CONDENSING_HPIPM;
+            for (int i = 0; i <= NN; i++)
+            {
+                plan->nlp_cost[i] = LINEAR_LS;
+                plan->nlp_constraints[i] = BGH;
+            }
+            for (int i = 0; i < NN; i++)
+                plan->nlp_dynamics[i] = DISCRETE_MODEL;
+
+            // reference solver condenses every QP, the other ones reuse the condensed matrices;
+            // late_reuse gets the option only after its solver has been created
+            linear_mpc ref, reuse, late_reuse;
+            linear_mpc_create(&ref, plan, &dyn_fun, &dyn_fun_jac, 0);
+            linear_mpc_create(&reuse, plan, &dyn_fun, &dyn_fun_jac, 1);
+            linear_mpc_create(&late_reuse, plan, &dyn_fun, &dyn_fun_jac, 0);
+            int reuse_qp_lhs = 1;
+            ocp_nlp_solver_opts_set(late_reuse.config, late_reuse.nlp_opts, "reuse_qp_lhs", &reuse_qp_lhs);
+
+            double x0[2] = {2.0, 0.0};
+            double ux_ref[3], ux_reuse[3];
+            int nmpc_problems = 5;
+
+            for (int idx = 0; idx < nmpc_problems; idx++)
+            {
+                for (linear_mpc *mpc : {&ref, &reuse, &late_reuse})
+                {
+                    ocp_nlp_constraints_model_set(mpc->config, mpc->dims, mpc->nlp_in, 0, "lbx", x0);
+                    ocp_nlp_constraints_model_set(mpc->config, mpc->dims, mpc->nlp_in, 0, "ubx", x0);
+                    REQUIRE(ocp_nlp_solve(mpc->solver, mpc->nlp_in, mpc->nlp_out) == 0);
+                }
+
+                int sqp_iter, reuse_count;
+                ocp_nlp_get(ref.config, ref.solver, "qp_lhs_reuse_count", &reuse_count);
+                REQUIRE(reuse_count == 0);
+
+                // the QP matrices never change, only the first QP of the closed loop is condensed
+                ocp_nlp_get(reuse.config, reuse.solver, "sqp_iter", &sqp_iter);
+                ocp_nlp_get(reuse.config, reuse.solver, "qp_lhs_reuse_count", &reuse_count);
+                std::cout << "\nproblem #" << idx << ": sqp_iter " << sqp_iter
+                          << ", qp_lhs_reuse_count " << reuse_count << "\n";
+                REQUIRE(sqp_iter >= 1);
+                REQUIRE(reuse_count == (idx == 0 ? sqp_iter - 1 : sqp_iter));
+                ocp_nlp_get(late_reuse.config, late_reuse.solver, "qp_lhs_reuse_count", &reuse_count);
+                REQUIRE(reuse_count == (idx == 0 ? sqp_iter - 1 : sqp_iter));
+
+                // same solution as with condensing of every QP
+                for (int i = 0; i <= NN; i++)
+                {
+                    ocp_nlp_out_get(ref.config, ref.dims, ref.nlp_out, i, "x", ux_ref);
+                    ocp_nlp_out_get(reuse.config, reuse.dims, reuse.nlp_out, i, "x", ux_reuse);
+                    if (i < NN)
+                    {
+                        ocp_nlp_out_get(ref.config, ref.dims, ref.nlp_out, i, "u", ux_ref+2);
+                        ocp_nlp_out_get(reuse.config, reuse.dims, reuse.nlp_out, i, "u", ux_reuse+2);
+                    }
+                    for (int jj = 0; jj < (i < NN ? 3 : 2); jj++)
+                        REQUIRE(fabs(ux_ref[jj] - ux_reuse[jj]) <= 1e-10);
+                }
+
+                // closed loop
+                ocp_nlp_out_get(ref.config, ref.dims, ref.nlp_out, 1, "x", x0);
+            }
+
+            linear_mpc_destroy(&ref);
+            linear_mpc_destroy(&reuse);
+            linear_mpc_destroy(&late_reuse);
+            ocp_nlp_plan_destroy(plan);
+        }
+    }
+}
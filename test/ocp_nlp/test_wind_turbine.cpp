@@ -261,7 +261,10 @@ void ext_fun_h1(void *fun, ext_fun_arg_t *type_in, void **in, ext_fun_arg_t *typ
 
 
 
-void setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str)
+// as_rti_level < 0: SQP, otherwise SQP_RTI with the given advanced-step level, with separate
+// preparation and feedback calls; returns the total electrical power of the closed loop
+double setup_and_solve_nlp(std::string const& integrator_str, std::string const& qp_solver_str,
+                           int as_rti_level = -1)
 {
     // _MM_SET_EXCEPTION_MASK(_MM_GET_EXCEPTION_MASK() & ~_MM_MASK_INVALID);
     int nx_ = 8;
@@ -567,7 +570,7 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
 
     ocp_nlp_plan_t *plan = ocp_nlp_plan_create(NN);
 
-    plan->nlp_solver = SQP;
+    plan->nlp_solver = as_rti_level < 0 ? SQP : SQP_RTI;
 
     for (int i = 0; i <= NN; i++)
         plan->nlp_cost[i] = LINEAR_LS;
@@ -953,11 +956,18 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
     double tol_ineq = 1e-8;
     double tol_comp = 1e-8;
 
-    ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
-    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_stat", &tol_stat);
-    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
-    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
-    ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+    if (as_rti_level < 0)
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_stat", &tol_stat);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
+        ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+    }
+    else
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "as_rti_level", &as_rti_level);
+    }
 
 
     // partial condensing
@@ -1003,6 +1013,11 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
     // set x0 as box constraint
     ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "lbx", x0_ref);
     ocp_nlp_constraints_model_set(config, dims, nlp_in, 0, "ubx", x0_ref);
+    for (int jj = 0; jj < nx_; jj++)
+        specific_x[jj] = x0_ref[jj];
+
+    double *lbx0_get = (double *) malloc(nx_*sizeof(double));
+    double *ubx0_get = (double *) malloc(nx_*sizeof(double));
 
     double total_power = 0.0; // sum up to get total objective
     double electrical_power = 0.0;
@@ -1045,7 +1060,30 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
         }
 
         // solve NLP
-        status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        if (as_rti_level < 0)
+        {
+            status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        }
+        else
+        {
+            int rti_phase = 1;
+            ocp_nlp_solver_opts_set(config, nlp_opts, "rti_phase", &rti_phase);
+            status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+            REQUIRE(status == 0);
+
+            // the preparation must leave the initial state of the user unchanged
+            ocp_nlp_constraints_model_get(config, dims, nlp_in, 0, "lbx", lbx0_get);
+            ocp_nlp_constraints_model_get(config, dims, nlp_in, 0, "ubx", ubx0_get);
+            for (int jj = 0; jj < nx_; jj++)
+            {
+                REQUIRE(lbx0_get[jj] == specific_x[jj]);
+                REQUIRE(ubx0_get[jj] == specific_x[jj]);
+            }
+
+            rti_phase = 2;
+            ocp_nlp_solver_opts_set(config, nlp_opts, "rti_phase", &rti_phase);
+            status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        }
 
         ocp_nlp_res *residual;
         ocp_nlp_get(config, solver, "nlp_res", &residual);
@@ -1088,7 +1126,8 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
         printf("Max residuals = %e\n", max_res);
 
         REQUIRE((status == 0 || status == 1 && MAX_SQP_ITERS == 1));
-        REQUIRE(max_res <= TOL);
+        if (as_rti_level < 0)
+            REQUIRE(max_res <= TOL);
 
         // shift trajectories
         blasfeo_unpack_dvec(dims->nx[NN], &nlp_out->ux[NN-1], dims->nu[NN-1], x_end, 1);
@@ -1103,7 +1142,8 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
     printf("\n\ntotal time (including printing) = %f ms (time per SQP = %f)\n\n",
         time*1e3, time*1e3/nmpc_problems);
     printf("total electrical power %e\n\n", total_power);
-    REQUIRE(total_power - 5.161e1 > 0); // ensure MPC has a performance close to the known optimum
+    if (as_rti_level < 0)
+        REQUIRE(total_power - 5.161e1 > 0); // ensure MPC has a performance close to the known optimum
 
 
 
@@ -1187,6 +1227,10 @@ void setup_and_solve_nlp(std::string const& integrator_str, std::string const& q
 
     free(x_end);
     free(u_end);
+    free(lbx0_get);
+    free(ubx0_get);
+
+    return total_power;
 }
 
 
@@ -1228,3 +1272,28 @@ TEST_CASE("wind turbine nmpc", "[NLP solver]")
         }
     }
 }
+
+
+
+/************************************************
+* TEST CASE: wind turbine, advanced-step RTI
+************************************************/
+
+TEST_CASE("wind turbine nmpc, advanced-step RTI", "[NLP solver]")
+{
+    std::vector<int> as_rti_levels = {LEVEL_A, LEVEL_B, LEVEL_C, LEVEL_D};
+
+    // closed loop of standard RTI with separate preparation and feedback calls
+    double total_power_rti = setup_and_solve_nlp("ERK", "SPARSE_HPIPM", STANDARD_RTI);
+
+    for (int as_rti_level : as_rti_levels)
+    {
+        SECTION("as_rti_level: " + std::to_string(as_rti_level))
+        {
+            double total_power = setup_and_solve_nlp("ERK", "SPARSE_HPIPM", as_rti_level);
+            std::cout << "\n---> AS-RTI level " << as_rti_level << ": total power " << total_power
+                      << ", standard RTI " << total_power_rti << "\n";
+            REQUIRE(fabs(total_power - total_power_rti) <= 1e-2 * fabs(total_power_rti));
+        }
+    }
+}
@@ -29,6 +29,7 @@
  */
 
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -38,6 +39,8 @@
 
 #include "acados_c/ocp_qp_interface.h"
 
+#include "blasfeo/include/blasfeo_d_blas.h"
+
 extern "C" {
 ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
 ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
@@ -266,3 +269,366 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+#ifdef ACADOS_WITH_OSQP
+TEST_CASE("mass spring example with soft constraints", "[QP solvers]")
+{
+    // OSQP is compared against HPIPM on the same soft constrained problem
+    vector<std::string> solvers = {"SPARSE_HPIPM", "SPARSE_OSQP"};
+
+    int nx_ = 8;
+
+    int nu_ = 3;
+
+    int N = 15;
+
+    int nb_ = 11;
+
+    int ng_ = 0;
+
+    int nbx_ = nb_ - nu_;  // all state bounds after the initial stage are softened
+
+    // without and with softened general constraints on the terminal state
+    vector<int> ngN_values = {0, 2};
+
+    ocp_qp_solver_plan_t plan;
+
+    for (int ngN : ngN_values)
+    {
+        SECTION("soft state bounds, " + std::to_string(ngN) + " soft terminal general constraints")
+        {
+            vector<double> ux_ref;
+
+            for (std::string solver : solvers)
+            {
+                plan.qp_solver = hashit(solver);
+
+                double tol = solver_tolerance(solver);
+
+                ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+                ocp_qp_xcond_solver_dims *qp_dims =
+                    create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+
+                for (int ii = 1; ii <= N; ii++)
+                    config->dims_set(config, qp_dims, ii, "nsbx", &nbx_);
+                config->dims_set(config, qp_dims, N, "nsg", &ngN);
+
+                ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+                int ns_max = nbx_ + ngN;
+                vector<double> Z(ns_max, 1e2);
+                vector<double> z(ns_max, 1e1);
+                vector<double> ls(ns_max, 0.0);
+                vector<int> idxs(ns_max);
+
+                for (int ii = 1; ii <= N; ii++)
+                {
+                    // slacks of the state bounds first, then the ones of the general constraints
+                    int nbu = ii < N ? nu_ : 0;
+                    int nsg = ii < N ? 0 : ngN;
+                    for (int jj = 0; jj < nbx_; jj++)
+                        idxs[jj] = nbu + jj;
+                    for (int jj = 0; jj < nsg; jj++)
+                        idxs[nbx_ + jj] = nbu + nbx_ + jj;
+
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "Zl", Z.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "Zu", Z.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "zl", z.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "zu", z.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "lls", ls.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "lus", ls.data());
+                    ocp_qp_in_set(config, qp_in, ii, (char *) "idxs", idxs.data());
+                }
+
+                ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+                void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+                set_N2(solver, config, opts, N, N);
+
+                ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+                int acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out);
+
+                REQUIRE(acados_return == 0);
+
+                double res[4];
+                ocp_qp_inf_norm_residuals(qp_dims->orig_dims, qp_in, qp_out, res);
+
+                double max_res = 0.0;
+                for (int ii = 0; ii < 4; ii++)
+                {
+                    max_res = (res[ii] > max_res) ? res[ii] : max_res;
+                }
+
+                std::cout << "\n---> soft constrained mass spring, ngN " << ngN << ", " << solver << "\n";
+                printf("\ninf norm res: %e, %e, %e, %e\n", res[0], res[1], res[2], res[3]);
+                REQUIRE(max_res <= tol);
+
+                // compare primal solution including slacks against HPIPM
+                double max_diff = 0.0;
+                int nn = 0;
+                for (int ii = 0; ii <= N; ii++)
+                {
+                    for (int jj = 0; jj < qp_out->ux[ii].m; jj++)
+                    {
+                        if (solver == "SPARSE_HPIPM")
+                        {
+                            ux_ref.push_back(qp_out->ux[ii].pa[jj]);
+                        }
+                        else
+                        {
+                            double diff = fabs(qp_out->ux[ii].pa[jj] - ux_ref[nn]);
+                            max_diff = diff > max_diff ? diff : max_diff;
+                        }
+                        nn++;
+                    }
+                }
+
+                std::cout << "max difference to HPIPM solution: " << max_diff << "\n";
+                REQUIRE(max_diff <= 1e-6);
+
+                free(qp_solver);
+                free(opts);
+                free(qp_out);
+                free(qp_in);
+                free(qp_dims);
+                free(config);
+            }
+        }
+    }
+
+}  // END_TEST_CASE
+#endif
+
+
+
+static double qp_out_max_diff(int N, ocp_qp_out *a, ocp_qp_out *b, double scale_b)
+{
+    double max_diff = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < a->ux[ii].m; jj++)
+        {
+            double diff = fabs(a->ux[ii].pa[jj] - scale_b * b->ux[ii].pa[jj]);
+            max_diff = diff > max_diff ? diff : max_diff;
+        }
+    }
+    return max_diff;
+}
+
+
+
+TEST_CASE("mass spring example, split condensing", "[QP solvers]")
+{
+    vector<std::string> solvers = {"DENSE_HPIPM", "SPARSE_HPIPM"};
+
+    int nx_ = 8;
+
+    int nu_ = 3;
+
+    int N = 15;
+
+    int nb_ = 11;
+
+    int ng_ = 0;
+
+    int ngN = 0;
+
+    int N2 = 5;
+
+    double x0_0 = 2.5;  // first initial state in the mass spring QP
+
+    double delta = 1e-3;  // perturbation of the initial state for finite differences
+
+    ocp_qp_solver_plan_t plan;
+
+    for (std::string solver : solvers)
+    {
+        SECTION(solver)
+        {
+            plan.qp_solver = hashit(solver);
+
+            double tol = solver_tolerance(solver);
+
+            ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+            ocp_qp_xcond_solver_dims *qp_dims =
+                create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+            ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+            ocp_qp_out *qp_out_split = ocp_qp_out_create(qp_dims->orig_dims);
+
+            void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+            set_N2(solver, config, opts, N2, N);
+
+            // reference: condensing of matrices and vectors in one call
+            ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+            int acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out);
+            REQUIRE(acados_return == 0);
+
+            // feedback phase only on a fresh solver: no condensed matrices available yet
+            ocp_qp_solver *qp_solver_split = ocp_qp_create(config, qp_dims, opts);
+            acados_return = config->condense_rhs_and_solve(config, qp_solver_split->dims, qp_in,
+                    qp_out_split, qp_solver_split->opts, qp_solver_split->mem, qp_solver_split->work);
+            REQUIRE(acados_return == 0);
+
+            double max_diff = qp_out_max_diff(N, qp_out, qp_out_split, 1.0);
+            std::cout << "\n---> " << solver << ", feedback without preparation: max difference "
+                      << max_diff << "\n";
+            REQUIRE(max_diff <= tol);
+
+            // sensitivity w.r.t. the first initial state after a solve
+            ocp_qp_in *param_qp_in = ocp_qp_in_create(qp_dims->orig_dims);
+            ocp_qp_out *sens_qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+            ocp_qp_out *sens_qp_out_split = ocp_qp_out_create(qp_dims->orig_dims);
+
+            double one = 1.0;
+            d_ocp_qp_copy_all(qp_in, param_qp_in);
+            d_ocp_qp_set_rhs_zero(param_qp_in);
+            d_ocp_qp_set_el((char *) "lbx", 0, 0, &one, param_qp_in);
+            d_ocp_qp_set_el((char *) "ubx", 0, 0, &one, param_qp_in);
+
+            config->eval_sens(config, qp_solver->dims, param_qp_in, sens_qp_out,
+                    qp_solver->opts, qp_solver->mem, qp_solver->work);
+            config->eval_sens(config, qp_solver_split->dims, param_qp_in, sens_qp_out_split,
+                    qp_solver_split->opts, qp_solver_split->mem, qp_solver_split->work);
+
+            max_diff = qp_out_max_diff(N, sens_qp_out, sens_qp_out_split, 1.0);
+            std::cout << "---> " << solver << ", sensitivities after split solve: max difference "
+                      << max_diff << "\n";
+            REQUIRE(max_diff <= tol);
+
+            // finite differences, the active set does not change for the small perturbation
+            double x0_pert = x0_0 + delta;
+            ocp_qp_out *qp_out_pert = ocp_qp_out_create(qp_dims->orig_dims);
+            d_ocp_qp_set_el((char *) "lbx", 0, 0, &x0_pert, qp_in);
+            d_ocp_qp_set_el((char *) "ubx", 0, 0, &x0_pert, qp_in);
+            acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out_pert);
+            REQUIRE(acados_return == 0);
+
+            for (int ii = 0; ii <= N; ii++)
+                blasfeo_daxpy(qp_out->ux[ii].m, -1.0, &qp_out->ux[ii], 0, &qp_out_pert->ux[ii], 0,
+                              &qp_out_pert->ux[ii], 0);
+
+            max_diff = qp_out_max_diff(N, sens_qp_out, qp_out_pert, 1.0 / delta);
+            std::cout << "---> " << solver << ", sensitivities vs finite differences: max difference "
+                      << max_diff << "\n";
+            REQUIRE(max_diff <= 1e-4);
+
+            free(qp_out_pert);
+            free(sens_qp_out_split);
+            free(sens_qp_out);
+            free(param_qp_in);
+            free(qp_solver_split);
+            free(qp_solver);
+            free(opts);
+            free(qp_out_split);
+            free(qp_out);
+            free(qp_in);
+            free(qp_dims);
+            free(config);
+        }
+    }
+
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example, threaded partial condensing", "[QP solvers]")
+{
+    vector<std::string> solvers = {"DENSE_HPIPM", "SPARSE_HPIPM"};
+    vector<int> num_threads_values = {2, 4};
+
+    int nx_ = 8;
+
+    int nu_ = 3;
+
+    int N = 15;
+
+    int nb_ = 11;
+
+    int ng_ = 0;
+
+    int ngN = 0;
+
+    int N2 = 5;
+
+    ocp_qp_solver_plan_t plan;
+
+    for (std::string solver : solvers)
+    {
+        for (int num_threads : num_threads_values)
+        {
+            SECTION(solver + ", cond_num_threads " + std::to_string(num_threads))
+            {
+                plan.qp_solver = hashit(solver);
+
+                ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+                ocp_qp_xcond_solver_dims *qp_dims =
+                    create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+
+                ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+
+                ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+                ocp_qp_out *qp_out_threads = ocp_qp_out_create(qp_dims->orig_dims);
+
+                // reference: one thread
+                void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+                set_N2(solver, config, opts, N2, N);
+                int one_thread = 1;
+                config->opts_set(config, opts, "cond_num_threads", &one_thread);
+
+                // the option has no effect with full condensing, but is accepted
+                void *opts_threads = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+                set_N2(solver, config, opts_threads, N2, N);
+                config->opts_set(config, opts_threads, "cond_num_threads", &num_threads);
+
+                ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+                ocp_qp_solver *qp_solver_threads = ocp_qp_create(config, qp_dims, opts_threads);
+
+                // condensing of matrices and vectors in one call
+                int acados_return = ocp_qp_solve(qp_solver, qp_in, qp_out);
+                REQUIRE(acados_return == 0);
+                acados_return = ocp_qp_solve(qp_solver_threads, qp_in, qp_out_threads);
+                REQUIRE(acados_return == 0);
+
+                double max_diff = qp_out_max_diff(N, qp_out, qp_out_threads, 1.0);
+                std::cout << "\n---> " << solver << ", " << num_threads << " threads, solve: max difference "
+                          << max_diff << "\n";
+                REQUIRE(max_diff == 0.0);
+
+                // condensing of the matrices in a separate call
+                config->condense_lhs(config, qp_solver_threads->dims, qp_in, qp_out_threads,
+                        qp_solver_threads->opts, qp_solver_threads->mem, qp_solver_threads->work);
+                acados_return = config->condense_rhs_and_solve(config, qp_solver_threads->dims, qp_in,
+                        qp_out_threads, qp_solver_threads->opts, qp_solver_threads->mem,
+                        qp_solver_threads->work);
+                REQUIRE(acados_return == 0);
+
+                max_diff = qp_out_max_diff(N, qp_out, qp_out_threads, 1.0);
+                std::cout << "---> " << solver << ", " << num_threads
+                          << " threads, condense_lhs + condense_rhs_and_solve: max difference " << max_diff << "\n";
+                REQUIRE(max_diff == 0.0);
+
+                free(qp_solver_threads);
+                free(qp_solver);
+                free(opts_threads);
+                free(opts);
+                free(qp_out_threads);
+                free(qp_out);
+                free(qp_in);
+                free(qp_dims);
+                free(config);
+            }
+        }
+    }
+
+}  // END_TEST_CASE
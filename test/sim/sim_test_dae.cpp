@@ -707,3 +707,170 @@ TEST_CASE("crane_dae_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+// creates the external casadi function <name> of the crane dae model
+#define CRANE_CASADI_CREATE(fun, name)                                \
+    do                                                                \
+    {                                                                 \
+        (fun).casadi_fun = &name;                                     \
+        (fun).casadi_work = &name##_work;                             \
+        (fun).casadi_sparsity_in = &name##_sparsity_in;               \
+        (fun).casadi_sparsity_out = &name##_sparsity_out;             \
+        (fun).casadi_n_in = &name##_n_in;                             \
+        (fun).casadi_n_out = &name##_n_out;                           \
+        external_function_casadi_create(&(fun));                      \
+    } while (0)
+
+
+
+// simulates the crane dae with ns stages and num_steps steps and returns the final state,
+// the algebraic variables at the start and the forward and adjoint sensitivities of the last
+// of num_calls calls at the same point; z_guess (if not NULL) initializes the algebraic
+// variables of the lifted integrator
+static void crane_dae_simulate(sim_solver_t solver, int ns, int num_steps,
+                               bool jac_reuse_across_calls, int num_calls, const double *z_guess,
+                               double *xn, double *zn, double *S_forw, double *S_adj)
+{
+    int nx = 9;
+    int nu = 2;
+    int nz = 2;
+    int NF = nx + nu;
+    double T = 0.01;
+
+    external_function_casadi impl_ode_fun, impl_ode_fun_jac_x_xdot, impl_ode_jac_x_xdot_u;
+    external_function_casadi impl_ode_fun_jac_x_xdot_u;
+    CRANE_CASADI_CREATE(impl_ode_fun, crane_dae_impl_ode_fun);
+    CRANE_CASADI_CREATE(impl_ode_fun_jac_x_xdot, crane_dae_impl_ode_fun_jac_x_xdot);
+    CRANE_CASADI_CREATE(impl_ode_jac_x_xdot_u, crane_dae_impl_ode_jac_x_xdot_u);
+    CRANE_CASADI_CREATE(impl_ode_fun_jac_x_xdot_u, crane_dae_impl_ode_fun_jac_x_xdot_u);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+    config->opts_initialize_default(config, dims, opts);
+
+    opts->ns = ns;
+    opts->num_steps = num_steps;
+    opts->newton_iter = 10;
+    opts->sens_forw = true;
+    opts->sens_adj = true;
+    opts->output_z = true;
+    opts->jac_reuse_across_calls = jac_reuse_across_calls;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    sim_in_set(config, dims, in, "T", &T);
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    if (solver == LIFTED_IRK)
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot_u", &impl_ode_fun_jac_x_xdot_u);
+    else
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    in->identity_seed = true;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = nx; ii < nx + nu; ii++)
+        in->S_adj[ii] = 0.0;
+
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = 0.0;
+    in->x[0] = 0.8;  // value for xL
+    in->u[0] = 40.108149413030752;
+    in->u[1] = -50.446662212534974;
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts);
+    if (z_guess)
+        sim_solver_set(sim_solver, "z", (void *) z_guess);
+
+    for (int kk = 0; kk < num_calls; kk++)
+    {
+        int status = sim_solve(sim_solver, in, out);
+        REQUIRE(status == 0);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        xn[ii] = out->xn[ii];
+    for (int ii = 0; ii < nz; ii++)
+        zn[ii] = out->zn[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        S_forw[ii] = out->S_forw[ii];
+    for (int ii = 0; ii < NF; ii++)
+        S_adj[ii] = out->S_adj[ii];
+
+    sim_solver_destroy(sim_solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot_u);
+}
+
+
+
+TEST_CASE("crane_dae_lifted_irk", "[integrators]")
+{
+    const int nx = 9;
+    const int nz = 2;
+    const int NF = nx + 2;
+    int ns = 3;
+    int num_steps = 3;
+
+    double x_ref[nx], z_ref[nz], S_forw_ref[nx * NF], S_adj_ref[NF];
+    crane_dae_simulate(IRK, ns, num_steps, false, 1, NULL, x_ref, z_ref, S_forw_ref, S_adj_ref);
+
+    for (int jac_reuse_across_calls = 0; jac_reuse_across_calls < 2; jac_reuse_across_calls++)
+    {
+    SECTION("jac_reuse_across_calls = " + std::to_string((bool) jac_reuse_across_calls))
+    {
+        // the lifted Newton iterations converge over repeated calls at the same point
+        int num_calls = 30;
+        double xn[nx], zn[nz], S_forw[nx * NF], S_adj[NF];
+        crane_dae_simulate(LIFTED_IRK, ns, num_steps, (bool) jac_reuse_across_calls,
+                           num_calls, z_ref, xn, zn, S_forw, S_adj);
+
+        double error_x[nx], error_z[nz], error_S_forw[nx * NF], error_S_adj[NF];
+        for (int jj = 0; jj < nx; jj++)
+            error_x[jj] = fabs(xn[jj] - x_ref[jj]);
+        for (int jj = 0; jj < nz; jj++)
+            error_z[jj] = fabs(zn[jj] - z_ref[jj]);
+        for (int jj = 0; jj < nx * NF; jj++)
+            error_S_forw[jj] = fabs(S_forw[jj] - S_forw_ref[jj]);
+        for (int jj = 0; jj < NF; jj++)
+            error_S_adj[jj] = fabs(S_adj[jj] - S_adj_ref[jj]);
+
+        double rel_error_forw = onenorm(nx, NF, error_S_forw) / onenorm(nx, NF, S_forw_ref);
+        double rel_error_adj = onenorm(1, NF, error_S_adj) / onenorm(1, NF, S_adj_ref);
+        double rel_error_z = onenorm(nz, 1, error_z) / onenorm(nz, 1, z_ref);
+
+        std::cout << "\n---> testing lifted IRK on dae: error_sim = " << onenorm(nx, 1, error_x)
+                  << ", rel_error_z = " << rel_error_z << ", rel_error_forw = "
+                  << rel_error_forw << ", rel_error_adj = " << rel_error_adj << "\n";
+
+        REQUIRE(onenorm(nx, 1, error_x) <= 1e-9);
+        REQUIRE(rel_error_z <= 1e-8);
+        REQUIRE(rel_error_forw <= 1e-8);
+        REQUIRE(rel_error_adj <= 1e-8);
+    }  // end SECTION
+    }  // end for jac_reuse_across_calls
+}  // END_TEST_CASE
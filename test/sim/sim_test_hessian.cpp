@@ -52,6 +52,8 @@
 
 // pendulum_model
 #include "examples/c/pendulum_model/pendulum_model.h"
+// pendulum dae model, with gnsf structure
+#include "examples/c/pendulum_dae_model/pendulum_dae_model.h"
 
 
 extern "C"
@@ -858,3 +860,429 @@ TEST_CASE("pendulum model hessians - Finite Differences", "compare against finit
     free(out);
     free(sim_solver);
 }
+
+
+
+// creates the external casadi function <name> of the pendulum model
+#define PENDULUM_CASADI_CREATE(fun, name)                             \
+    do                                                                \
+    {                                                                 \
+        (fun).casadi_fun = &name;                                     \
+        (fun).casadi_work = &name##_work;                             \
+        (fun).casadi_sparsity_in = &name##_sparsity_in;               \
+        (fun).casadi_sparsity_out = &name##_sparsity_out;             \
+        (fun).casadi_n_in = &name##_n_in;                             \
+        (fun).casadi_n_out = &name##_n_out;                           \
+        external_function_casadi_create(&(fun));                      \
+    } while (0)
+
+
+
+// simulates the pendulum over T from x0_pendulum, u_sim_pendulum with ns stages and num_steps
+// steps, returns the final state, the forward and adjoint sensitivities and the hessian of the
+// last of num_calls calls at the same point. With sens_after_create the solver is created
+// without adjoints and hessians, which are switched on in the options afterwards.
+static void pendulum_simulate_hess(sim_solver_t solver, int ns, int num_steps,
+                                   bool jac_reuse_across_calls, bool sens_after_create,
+                                   int num_calls, double *xn, double *S_forw, double *S_adj,
+                                   double *S_hess)
+{
+    double T = 0.1;
+
+    external_function_casadi impl_ode_fun, impl_ode_fun_jac_x_xdot, impl_ode_jac_x_xdot_u;
+    external_function_casadi impl_ode_fun_jac_x_xdot_u, impl_ode_hess;
+    PENDULUM_CASADI_CREATE(impl_ode_fun, pendulum_ode_impl_ode_fun);
+    PENDULUM_CASADI_CREATE(impl_ode_fun_jac_x_xdot, pendulum_ode_impl_ode_fun_jac_x_xdot_z);
+    PENDULUM_CASADI_CREATE(impl_ode_jac_x_xdot_u, pendulum_ode_impl_ode_jac_x_xdot_u_z);
+    PENDULUM_CASADI_CREATE(impl_ode_fun_jac_x_xdot_u, pendulum_ode_impl_ode_fun_jac_x_xdot_u);
+    PENDULUM_CASADI_CREATE(impl_ode_hess, pendulum_ode_impl_ode_hess);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+    config->opts_initialize_default(config, dims, opts);
+
+    opts->ns = ns;
+    opts->num_steps = num_steps;
+    opts->newton_iter = 8;
+    opts->sens_forw = true;
+    opts->sens_adj = !sens_after_create;
+    opts->sens_hess = !sens_after_create;
+    opts->jac_reuse_across_calls = jac_reuse_across_calls;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    in->T = T;
+    if (solver == LIFTED_IRK)
+    {
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot_u", &impl_ode_fun_jac_x_xdot_u);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    }
+    else
+    {
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    }
+    sim_in_set(config, dims, in, "impl_ode_hess", &impl_ode_hess);
+
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    in->identity_seed = true;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = nx; ii < nx + nu; ii++)
+        in->S_adj[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0_pendulum[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim_pendulum[ii];
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts);
+
+    if (sens_after_create)
+    {
+        bool sens_on = true;
+        sim_opts_set(config, opts, "sens_adj", &sens_on);
+        sim_opts_set(config, opts, "sens_hess", &sens_on);
+    }
+
+    for (int kk = 0; kk < num_calls; kk++)
+    {
+        int status = sim_solve(sim_solver, in, out);
+        REQUIRE(status == 0);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        xn[ii] = out->xn[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        S_forw[ii] = out->S_forw[ii];
+    for (int ii = 0; ii < NF; ii++)
+        S_adj[ii] = out->S_adj[ii];
+    for (int ii = 0; ii < NF * NF; ii++)
+        S_hess[ii] = out->S_hess[ii];
+
+    sim_solver_destroy(sim_solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot_u);
+    external_function_casadi_free(&impl_ode_hess);
+}
+
+
+
+TEST_CASE("pendulum_hessians_lifted_irk", "[integrators]")
+{
+    for (int ii = 0; ii < nx; ii++)
+        x0_pendulum[ii] = 0.0;
+    u_sim_pendulum[0] = 0.1;
+
+    int ns = 4;
+    int num_steps = 5;
+
+    double x_ref[nx], S_forw_ref[nx * NF], S_adj_ref[NF], S_hess_ref[NF * NF];
+    pendulum_simulate_hess(IRK, ns, num_steps, false, false, 1,
+                           x_ref, S_forw_ref, S_adj_ref, S_hess_ref);
+
+    double norm_S_hess = onenorm(NF, NF, S_hess_ref);
+    double norm_S_adj = onenorm(1, NF, S_adj_ref);
+
+    for (int jac_reuse_across_calls = 0; jac_reuse_across_calls < 2; jac_reuse_across_calls++)
+    {
+    SECTION("jac_reuse_across_calls = " + std::to_string((bool) jac_reuse_across_calls))
+    {
+        for (int sens_after_create = 0; sens_after_create < 2; sens_after_create++)
+        {
+        SECTION("sens_after_create = " + std::to_string((bool) sens_after_create))
+        {
+            // the lifted Newton iterations converge over repeated calls at the same point
+            int num_calls = 30;
+            double xn[nx], S_forw[nx * NF], S_adj[NF], S_hess[NF * NF];
+            pendulum_simulate_hess(LIFTED_IRK, ns, num_steps, (bool) jac_reuse_across_calls,
+                                   (bool) sens_after_create, num_calls, xn, S_forw, S_adj, S_hess);
+
+            for (int jj = 0; jj < nx; jj++)
+                error[jj] = fabs(xn[jj] - x_ref[jj]);
+            for (int jj = 0; jj < nx * NF; jj++)
+                error_S_forw[jj] = fabs(S_forw[jj] - S_forw_ref[jj]);
+            for (int jj = 0; jj < NF; jj++)
+                error_S_adj[jj] = fabs(S_adj[jj] - S_adj_ref[jj]);
+            for (int jj = 0; jj < NF * NF; jj++)
+            {
+                REQUIRE(std::isnan(S_hess[jj]) == 0);
+                error_S_hess[jj] = fabs(S_hess[jj] - S_hess_ref[jj]);
+            }
+
+            rel_error_adj = onenorm(1, NF, error_S_adj) / norm_S_adj;
+            rel_error_hess = onenorm(NF, NF, error_S_hess) / norm_S_hess;
+
+            std::cout << "\n---> testing lifted IRK hessians: error_sim = "
+                      << onenorm(nx, 1, error) << ", error_forw = "
+                      << onenorm(nx, NF, error_S_forw) << ", rel_error_adj = "
+                      << rel_error_adj << ", rel_error_hess = " << rel_error_hess << "\n";
+
+            REQUIRE(onenorm(nx, 1, error) <= 1e-9);
+            REQUIRE(onenorm(nx, NF, error_S_forw) <= 1e-8);
+            REQUIRE(rel_error_adj <= 1e-8);
+            REQUIRE(rel_error_hess <= 1e-8);
+        }  // end SECTION
+        }  // end for sens_after_create
+    }  // end SECTION
+    }  // end for jac_reuse_across_calls
+}  // END_TEST_CASE
+
+
+
+// creates the parametric external casadi function <name> of the pendulum dae model
+#define PENDULUM_DAE_CASADI_CREATE(fun, name)                         \
+    do                                                                \
+    {                                                                 \
+        (fun).casadi_fun = &name;                                     \
+        (fun).casadi_work = &name##_work;                             \
+        (fun).casadi_sparsity_in = &name##_sparsity_in;               \
+        (fun).casadi_sparsity_out = &name##_sparsity_out;             \
+        (fun).casadi_n_in = &name##_n_in;                             \
+        (fun).casadi_n_out = &name##_n_out;                           \
+        external_function_param_casadi_create(&(fun), 0);             \
+    } while (0)
+
+
+
+// hessian of mult' * phi w.r.t. (y, uhat) of the gnsf pendulum dae, where
+//     phi = [y7*y0 - y6*y1; y3*y4 + y1*y5; -(y2*y4 + y0*y5)]
+// inputs: y, uhat, mult, t; output: (ny+nuhat) x (ny+nuhat) matrix
+static void pendulum_dae_gnsf_phi_hess(void *self, ext_fun_arg_t *type_in, void **in,
+                                       ext_fun_arg_t *type_out, void **out)
+{
+    struct blasfeo_dvec_args *mult = (struct blasfeo_dvec_args *) in[2];
+    struct blasfeo_dmat *hess = (struct blasfeo_dmat *) out[0];
+
+    double m0 = blasfeo_dvecex1(mult->x, mult->xi);
+    double m1 = blasfeo_dvecex1(mult->x, mult->xi + 1);
+    double m2 = blasfeo_dvecex1(mult->x, mult->xi + 2);
+
+    int idx[6][2] = {{7, 0}, {6, 1}, {3, 4}, {1, 5}, {2, 4}, {0, 5}};
+    double val[6] = {m0, -m0, m1, m1, -m2, -m2};
+
+    blasfeo_dgese(hess->m, hess->n, 0.0, hess, 0, 0);
+    for (int ii = 0; ii < 6; ii++)
+    {
+        blasfeo_dgein1(val[ii], hess, idx[ii][0], idx[ii][1]);
+        blasfeo_dgein1(val[ii], hess, idx[ii][1], idx[ii][0]);
+    }
+}
+
+
+
+// f_lo of the gnsf pendulum dae is linear
+static void pendulum_dae_gnsf_f_lo_hess(void *self, ext_fun_arg_t *type_in, void **in,
+                                        ext_fun_arg_t *type_out, void **out)
+{
+    struct blasfeo_dmat *hess = (struct blasfeo_dmat *) out[0];
+    blasfeo_dgese(hess->m, hess->n, 0.0, hess, 0, 0);
+}
+
+
+
+// simulates the pendulum dae from a slightly deflected position with IRK or GNSF,
+// both with the same collocation method, and returns xn and all sensitivities
+static void pendulum_dae_simulate_hess(sim_solver_t solver, double *xn, double *S_forw,
+                                       double *S_adj, double *S_hess)
+{
+    int nx_dae = 6;
+    int nu_dae = 1;
+    int nz_dae = 5;
+    int NF_dae = nx_dae + nu_dae;
+
+    int nx1 = 5;  // gnsf split
+    int nz1 = 5;
+    int nout = 3;
+    int ny = 8;
+    int nuhat = 1;
+
+    double T = 0.1;
+
+    external_function_param_casadi impl_ode_fun, impl_ode_fun_jac_x_xdot, impl_ode_jac_x_xdot_u;
+    external_function_param_casadi impl_ode_hess;
+    PENDULUM_DAE_CASADI_CREATE(impl_ode_fun, pendulum_dae_dyn_impl_ode_fun);
+    PENDULUM_DAE_CASADI_CREATE(impl_ode_fun_jac_x_xdot, pendulum_dae_dyn_impl_ode_fun_jac_x_xdot);
+    PENDULUM_DAE_CASADI_CREATE(impl_ode_jac_x_xdot_u, pendulum_dae_dyn_impl_ode_jac_x_xdot_u);
+    PENDULUM_DAE_CASADI_CREATE(impl_ode_hess, pendulum_dae_dyn_impl_ode_hess);
+
+    external_function_param_casadi phi_fun, phi_fun_jac_y, phi_jac_y_uhat;
+    external_function_param_casadi f_lo_fun_jac_x1k1uz, get_matrices_fun;
+    PENDULUM_DAE_CASADI_CREATE(phi_fun, pendulum_dae_dyn_gnsf_phi_fun);
+    PENDULUM_DAE_CASADI_CREATE(phi_fun_jac_y, pendulum_dae_dyn_gnsf_phi_fun_jac_y);
+    PENDULUM_DAE_CASADI_CREATE(phi_jac_y_uhat, pendulum_dae_dyn_gnsf_phi_jac_y_uhat);
+    PENDULUM_DAE_CASADI_CREATE(f_lo_fun_jac_x1k1uz, pendulum_dae_dyn_gnsf_f_lo_fun_jac_x1k1uz);
+    PENDULUM_DAE_CASADI_CREATE(get_matrices_fun, pendulum_dae_dyn_gnsf_get_matrices_fun);
+
+    external_function_generic phi_hess, f_lo_hess;
+    phi_hess.evaluate = &pendulum_dae_gnsf_phi_hess;
+    f_lo_hess.evaluate = &pendulum_dae_gnsf_f_lo_hess;
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx_dae);
+    sim_dims_set(config, dims, "nu", &nu_dae);
+    sim_dims_set(config, dims, "nz", &nz_dae);
+    if (solver == GNSF)
+    {
+        sim_dims_set(config, dims, "nx1", &nx1);
+        sim_dims_set(config, dims, "nz1", &nz1);
+        sim_dims_set(config, dims, "nout", &nout);
+        sim_dims_set(config, dims, "ny", &ny);
+        sim_dims_set(config, dims, "nuhat", &nuhat);
+    }
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+    config->opts_initialize_default(config, dims, opts);
+
+    opts->ns = 3;
+    opts->num_steps = 4;
+    opts->newton_iter = 10;
+    opts->jac_reuse = false;
+    opts->sens_forw = true;
+    opts->sens_adj = true;
+    opts->sens_hess = true;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    sim_in_set(config, dims, in, "T", &T);
+    if (solver == GNSF)
+    {
+        sim_in_set(config, dims, in, "phi_fun", &phi_fun);
+        sim_in_set(config, dims, in, "phi_fun_jac_y", &phi_fun_jac_y);
+        sim_in_set(config, dims, in, "phi_jac_y_uhat", &phi_jac_y_uhat);
+        sim_in_set(config, dims, in, "f_lo_jac_x1_x1dot_u_z", &f_lo_fun_jac_x1k1uz);
+        sim_in_set(config, dims, in, "get_gnsf_matrices", &get_matrices_fun);
+        sim_in_set(config, dims, in, "phi_hess", &phi_hess);
+        sim_in_set(config, dims, in, "f_lo_hess", &f_lo_hess);
+    }
+    else
+    {
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+        sim_in_set(config, dims, in, "impl_ode_hess", &impl_ode_hess);
+    }
+
+    for (int ii = 0; ii < nx_dae * NF_dae; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx_dae; ii++)
+        in->S_forw[ii * (nx_dae + 1)] = 1.0;
+    in->identity_seed = true;
+    for (int ii = 0; ii < nx_dae; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = nx_dae; ii < NF_dae; ii++)
+        in->S_adj[ii] = 0.0;
+
+    in->x[0] =  0.049999166670833;  // xpos
+    in->x[1] = -4.999750002083326;  // ypos
+    in->x[2] =  0.010000000000000;  // alpha
+    in->x[3] =  0.0;  // vx
+    in->x[4] =  0.0;  // vy
+    in->x[5] =  0.0;  // valpha
+    in->u[0] = 3.5;
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts);
+    sim_precompute(sim_solver, in, out);
+
+    int status = sim_solve(sim_solver, in, out);
+    REQUIRE(status == 0);
+
+    for (int ii = 0; ii < nx_dae; ii++)
+        xn[ii] = out->xn[ii];
+    for (int ii = 0; ii < nx_dae * NF_dae; ii++)
+        S_forw[ii] = out->S_forw[ii];
+    for (int ii = 0; ii < NF_dae; ii++)
+        S_adj[ii] = out->S_adj[ii];
+    for (int ii = 0; ii < NF_dae * NF_dae; ii++)
+        S_hess[ii] = out->S_hess[ii];
+
+    sim_solver_destroy(sim_solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_param_casadi_free(&impl_ode_fun);
+    external_function_param_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_param_casadi_free(&impl_ode_jac_x_xdot_u);
+    external_function_param_casadi_free(&impl_ode_hess);
+    external_function_param_casadi_free(&phi_fun);
+    external_function_param_casadi_free(&phi_fun_jac_y);
+    external_function_param_casadi_free(&phi_jac_y_uhat);
+    external_function_param_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_param_casadi_free(&get_matrices_fun);
+}
+
+
+
+TEST_CASE("pendulum_dae_hessians_gnsf", "[integrators]")
+{
+    const int nx_dae = 6;
+    const int NF_dae = nx_dae + 1;
+
+    double x_ref[nx_dae], S_forw_ref[nx_dae * NF_dae], S_adj_ref[NF_dae];
+    double S_hess_ref[NF_dae * NF_dae];
+    pendulum_dae_simulate_hess(IRK, x_ref, S_forw_ref, S_adj_ref, S_hess_ref);
+
+    double xn[nx_dae], S_forw_gnsf[nx_dae * NF_dae], S_adj_gnsf[NF_dae];
+    double S_hess_gnsf[NF_dae * NF_dae];
+    pendulum_dae_simulate_hess(GNSF, xn, S_forw_gnsf, S_adj_gnsf, S_hess_gnsf);
+
+    // same collocation method on the same model: equal up to the Newton tolerance
+    double err_x[nx_dae], err_forw[nx_dae * NF_dae], err_adj[NF_dae];
+    double err_hess[NF_dae * NF_dae];
+    for (int jj = 0; jj < nx_dae; jj++)
+        err_x[jj] = fabs(xn[jj] - x_ref[jj]);
+    for (int jj = 0; jj < nx_dae * NF_dae; jj++)
+        err_forw[jj] = fabs(S_forw_gnsf[jj] - S_forw_ref[jj]);
+    for (int jj = 0; jj < NF_dae; jj++)
+        err_adj[jj] = fabs(S_adj_gnsf[jj] - S_adj_ref[jj]);
+    for (int jj = 0; jj < NF_dae * NF_dae; jj++)
+    {
+        REQUIRE(std::isnan(S_hess_gnsf[jj]) == 0);
+        err_hess[jj] = fabs(S_hess_gnsf[jj] - S_hess_ref[jj]);
+    }
+
+    double rel_err_forw = onenorm(nx_dae, NF_dae, err_forw) / onenorm(nx_dae, NF_dae, S_forw_ref);
+    double rel_err_adj = onenorm(1, NF_dae, err_adj) / onenorm(1, NF_dae, S_adj_ref);
+    double rel_err_hess = onenorm(NF_dae, NF_dae, err_hess) / onenorm(NF_dae, NF_dae, S_hess_ref);
+
+    std::cout << "\n---> testing GNSF hessians vs IRK: error_sim = "
+              << onenorm(nx_dae, 1, err_x) << ", rel_error_forw = " << rel_err_forw
+              << ", rel_error_adj = " << rel_err_adj << ", rel_error_hess = " << rel_err_hess
+              << "\n";
+
+    REQUIRE(onenorm(nx_dae, 1, err_x) <= 1e-9);
+    REQUIRE(rel_err_forw <= 1e-8);
+    REQUIRE(rel_err_adj <= 1e-8);
+    REQUIRE(rel_err_hess <= 1e-7);
+}  // END_TEST_CASE
@@ -50,6 +50,8 @@
 #include "acados_c/external_function_interface.h"
 #include "acados_c/sim_interface.h"
 
+#include "blasfeo/include/blasfeo_d_aux.h"
+
 // wt model
 #include "examples/c/wt_model_nx3/wt_model.h"
 
@@ -367,10 +369,7 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                 void *opts_ = sim_opts_create(config, dims);
                 sim_opts *opts = (sim_opts *) opts_;
 
-                if (plan.sim_solver != LIFTED_IRK)
-                    opts->sens_adj = true;
-                else
-                    opts->sens_adj = false;
+                opts->sens_adj = true;
 
                 opts->jac_reuse = true;  // jacobian reuse
                 opts->newton_iter = 1;  // number of newton iterations per integration step
@@ -555,12 +554,8 @@ TEST_CASE("wt_nx3_example", "[integrators]")
                 REQUIRE(max_error <= tol);
                 REQUIRE(max_error_forw <= tol);
 
-                // TODO(FreyJo): implement adjoint sensitivites for these integrators!!!
-                if ((plan.sim_solver != LIFTED_IRK))
-                {
-                    std::cout  << "error_adj   = " << max_error_adj  << "\n";
-                    REQUIRE(max_error_adj <= tol);
-                }
+                std::cout  << "error_adj   = " << max_error_adj  << "\n";
+                REQUIRE(max_error_adj <= tol);
 
                 // test getters
                 double time_tot, time_ad, time_la;
@@ -601,3 +596,595 @@ TEST_CASE("wt_nx3_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+// creates the external casadi function casadi_<name> of the wt model
+#define WT_CASADI_CREATE(fun, name)                                   \
+    do                                                                \
+    {                                                                 \
+        (fun).casadi_fun = &casadi_##name;                            \
+        (fun).casadi_work = &casadi_##name##_work;                    \
+        (fun).casadi_sparsity_in = &casadi_##name##_sparsity_in;      \
+        (fun).casadi_sparsity_out = &casadi_##name##_sparsity_out;    \
+        (fun).casadi_n_in = &casadi_##name##_n_in;                    \
+        (fun).casadi_n_out = &casadi_##name##_n_out;                  \
+        external_function_casadi_create(&(fun));                      \
+    } while (0)
+
+
+
+// wraps an external function and counts its evaluations
+typedef struct
+{
+    // public members (have to be the same as in the prototype, and before the private ones)
+    void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    // private members
+    external_function_generic *fun;
+    int num_evals;
+} wt_counting_function;
+
+
+
+static void wt_counting_function_evaluate(void *self, ext_fun_arg_t *type_in, void **in,
+                                          ext_fun_arg_t *type_out, void **out)
+{
+    wt_counting_function *counter = (wt_counting_function *) self;
+    counter->num_evals++;
+    counter->fun->evaluate(counter->fun, type_in, in, type_out, out);
+}
+
+
+
+// simulates the wt model over T from x0, u_sim with the given integrator and options,
+// returns the final state and the forward sensitivities; set_opts adapts the options.
+// The simulation is repeated num_calls times with the same solver, jac_evals and lu_fact
+// (if not NULL) receive the number of evaluations of the implicit ode jacobian and the
+// number of LU factorizations reported in sim_info of each call.
+static void wt_simulate(sim_solver_t solver, double T, void (*set_opts)(sim_config *, void *),
+                        double *xn, double *S_forw, int num_calls = 1, int *jac_evals = NULL,
+                        int *lu_fact = NULL)
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;
+
+    external_function_casadi expl_ode_fun, expl_vde_for, expl_vde_adj;
+    external_function_casadi impl_ode_fun, impl_ode_fun_jac_x_xdot, impl_ode_jac_x_xdot_u;
+    WT_CASADI_CREATE(expl_ode_fun, expl_ode_fun);
+    WT_CASADI_CREATE(expl_vde_for, expl_vde_for);
+    WT_CASADI_CREATE(expl_vde_adj, expl_vde_adj);
+    WT_CASADI_CREATE(impl_ode_fun, impl_ode_fun);
+    WT_CASADI_CREATE(impl_ode_fun_jac_x_xdot, impl_ode_fun_jac_x_xdot);
+    WT_CASADI_CREATE(impl_ode_jac_x_xdot_u, impl_ode_jac_x_xdot_u);
+
+    wt_counting_function impl_ode_fun_jac_x_xdot_counter;
+    impl_ode_fun_jac_x_xdot_counter.evaluate = &wt_counting_function_evaluate;
+    impl_ode_fun_jac_x_xdot_counter.fun = (external_function_generic *) &impl_ode_fun_jac_x_xdot;
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    void *opts = sim_opts_create(config, dims);
+    bool sens_forw = true;
+    sim_opts_set(config, opts, "sens_forw", &sens_forw);
+    set_opts(config, opts);
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+
+    in->T = T;
+    if (solver == ERK)
+    {
+        sim_in_set(config, dims, in, "expl_ode_fun", &expl_ode_fun);
+        sim_in_set(config, dims, in, "expl_vde_for", &expl_vde_for);
+        sim_in_set(config, dims, in, "expl_vde_adj", &expl_vde_adj);
+    }
+    else
+    {
+        sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot_counter);
+        sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    }
+
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+
+    sim_solver *sim_solver = sim_solver_create(config, dims, opts);
+
+    for (int kk = 0; kk < num_calls; kk++)
+    {
+        impl_ode_fun_jac_x_xdot_counter.num_evals = 0;
+        int acados_return = sim_solve(sim_solver, in, out);
+        REQUIRE(acados_return == 0);
+        if (jac_evals)
+            jac_evals[kk] = impl_ode_fun_jac_x_xdot_counter.num_evals;
+        if (lu_fact)
+            sim_out_get(config, dims, out, "lu_fact", lu_fact + kk);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        xn[ii] = out->xn[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        S_forw[ii] = out->S_forw[ii];
+
+    sim_solver_destroy(sim_solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&expl_ode_fun);
+    external_function_casadi_free(&expl_vde_for);
+    external_function_casadi_free(&expl_vde_adj);
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}
+
+
+
+static double max_abs_diff(int n, const double *a, const double *b)
+{
+    double err = 0.0;
+    for (int ii = 0; ii < n; ii++)
+        err = fabs(a[ii] - b[ii]) > err ? fabs(a[ii] - b[ii]) : err;
+    return err;
+}
+
+
+
+static void wt_opts_reference(sim_config *config, void *opts)
+{
+    int ns = 5;
+    int num_steps = 20;
+    int newton_iter = 5;
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    sim_opts_set(config, opts, "newton_iter", &newton_iter);
+}
+
+
+
+static void wt_opts_erk_adaptive(sim_config *config, void *opts)
+{
+    bool step_size_adaptive = true;
+    int num_steps = 100;  // maximum number of steps
+    double tol = 1e-10;
+    sim_opts_set(config, opts, "step_size_adaptive", &step_size_adaptive);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    sim_opts_set(config, opts, "step_size_atol", &tol);
+    sim_opts_set(config, opts, "step_size_rtol", &tol);
+}
+
+
+
+TEST_CASE("wt_nx3_erk_adaptive", "[integrators]")
+{
+    const int nx = 3;
+    const int NF = nx + 4;
+    double T = 0.05;
+
+    double x_ref[nx], S_ref[nx*NF];
+    wt_simulate(IRK, T, &wt_opts_reference, x_ref, S_ref);
+
+    double xn[nx], S_forw[nx*NF];
+    wt_simulate(ERK, T, &wt_opts_erk_adaptive, xn, S_forw);
+
+    std::cout << "\n---> testing adaptive ERK: error_sim = " << max_abs_diff(nx, xn, x_ref)
+              << ", error_forw = " << max_abs_diff(nx*NF, S_forw, S_ref) << "\n";
+    REQUIRE(max_abs_diff(nx, xn, x_ref) <= 1e-7);
+    REQUIRE(max_abs_diff(nx*NF, S_forw, S_ref) <= 1e-7);
+
+    // the embedded tableau must not overwrite the number of stages chosen by the user
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+    void *dims = sim_dims_create(config);
+    int nx_ = nx, nu_ = 4;
+    sim_dims_set(config, dims, "nx", &nx_);
+    sim_dims_set(config, dims, "nu", &nu_);
+    void *opts = sim_opts_create(config, dims);
+
+    int ns = 3;
+    sim_opts_set(config, opts, "ns", &ns);
+    wt_opts_erk_adaptive(config, opts);
+    config->opts_update(config, dims, opts);
+
+    int ns_get;
+    sim_opts_get(config, opts, "ns", &ns_get);
+    REQUIRE(ns_get == 3);
+
+    // switching the adaptive step size off again restores the fixed step integrator
+    bool step_size_adaptive = false;
+    sim_opts_set(config, opts, "step_size_adaptive", &step_size_adaptive);
+    config->opts_update(config, dims, opts);
+    sim_opts_get(config, opts, "ns", &ns_get);
+    REQUIRE(ns_get == 3);
+
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+}
+
+
+
+static void wt_opts_irk_lu_reuse(sim_config *config, void *opts)
+{
+    bool sens_forw = false;
+    bool jac_reuse_across_calls = true;
+    int ns = 3;
+    int num_steps = 4;
+    int newton_iter = 10;
+    double newton_tol = 1e-12;
+    sim_opts_set(config, opts, "sens_forw", &sens_forw);
+    sim_opts_set(config, opts, "jac_reuse_across_calls", &jac_reuse_across_calls);
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    sim_opts_set(config, opts, "newton_iter", &newton_iter);
+    sim_opts_set(config, opts, "newton_tol", &newton_tol);
+}
+
+
+
+TEST_CASE("wt_nx3_irk_lu_reuse", "[integrators]")
+{
+    const int nx = 3;
+    const int NF = nx + 4;
+    double T = 0.05;
+
+    double x_ref[nx], S_ref[nx*NF];
+    wt_simulate(IRK, T, &wt_opts_reference, x_ref, S_ref);
+
+    // repeated calls at the same point: the factorization of the first call is reused,
+    // so the later calls evaluate the jacobian less often
+    int num_calls = 3;
+    int jac_evals[3];
+    int lu_fact[3];
+    double xn[nx], S_forw[nx*NF];
+    wt_simulate(IRK, T, &wt_opts_irk_lu_reuse, xn, S_forw, num_calls, jac_evals, lu_fact);
+
+    std::cout << "\n---> testing IRK LU reuse: jac_evals = " << jac_evals[0] << ", " << jac_evals[1]
+              << ", " << jac_evals[2] << ", lu_fact = " << lu_fact[0] << ", " << lu_fact[1]
+              << ", " << lu_fact[2] << ", error_sim = " << max_abs_diff(nx, xn, x_ref) << "\n";
+    REQUIRE(jac_evals[0] >= 1);
+    REQUIRE(jac_evals[1] < jac_evals[0]);
+    REQUIRE(jac_evals[2] < jac_evals[0]);
+    // the sim_info counter agrees with the skipped jacobian evaluations
+    REQUIRE(lu_fact[0] >= 1);
+    REQUIRE(lu_fact[1] < lu_fact[0]);
+    REQUIRE(lu_fact[2] < lu_fact[0]);
+    REQUIRE(max_abs_diff(nx, xn, x_ref) <= 1e-7);
+}
+
+
+
+static void wt_opts_irk_coupled(sim_config *config, void *opts)
+{
+    int ns = 4;
+    int num_steps = 4;
+    int newton_iter = 10;
+    double newton_tol = 1e-12;
+    sim_opts_set(config, opts, "ns", &ns);
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+    sim_opts_set(config, opts, "newton_iter", &newton_iter);
+    sim_opts_set(config, opts, "newton_tol", &newton_tol);
+}
+
+
+
+static void wt_opts_irk_decoupled(sim_config *config, void *opts)
+{
+    wt_opts_irk_coupled(config, opts);
+    bool newton_decoupled = true;
+    sim_opts_set(config, opts, "newton_decoupled", &newton_decoupled);
+}
+
+
+
+TEST_CASE("wt_nx3_irk_newton_decoupled", "[integrators]")
+{
+    const int nx = 3;
+    const int NF = nx + 4;
+    double T = 0.05;
+
+    // same collocation scheme, only the Newton matrix differs:
+    // states and forward sensitivities have to agree up to the Newton tolerance
+    double x_ref[nx], S_ref[nx*NF];
+    wt_simulate(IRK, T, &wt_opts_irk_coupled, x_ref, S_ref);
+
+    double xn[nx], S_forw[nx*NF];
+    wt_simulate(IRK, T, &wt_opts_irk_decoupled, xn, S_forw);
+
+    std::cout << "\n---> testing decoupled IRK: error_sim = " << max_abs_diff(nx, xn, x_ref)
+              << ", error_forw = " << max_abs_diff(nx*NF, S_forw, S_ref) << "\n";
+    REQUIRE(max_abs_diff(nx, xn, x_ref) <= 1e-9);
+    REQUIRE(max_abs_diff(nx*NF, S_forw, S_ref) <= 1e-9);
+}
+
+
+
+static void wt_opts_erk_unsegmented(sim_config *config, void *opts)
+{
+    int num_steps = 8;
+    sim_opts_set(config, opts, "num_steps", &num_steps);
+}
+
+
+
+static void wt_opts_erk_segmented(sim_config *config, void *opts)
+{
+    wt_opts_erk_unsegmented(config, opts);
+    int num_segments = 4;
+    sim_opts_set(config, opts, "num_segments", &num_segments);
+}
+
+
+
+static void wt_opts_erk_segmented_one_iter(sim_config *config, void *opts)
+{
+    wt_opts_erk_segmented(config, opts);
+    int segment_iter = 1;
+    sim_opts_set(config, opts, "segment_iter", &segment_iter);
+}
+
+
+
+TEST_CASE("wt_nx3_erk_segmented", "[integrators]")
+{
+    const int nx = 3;
+    const int NF = nx + 4;
+    double T = 0.05;
+
+    double x_ref[nx], S_ref[nx*NF];
+    wt_simulate(ERK, T, &wt_opts_erk_unsegmented, x_ref, S_ref);
+
+    // the same steps split into segments: equal up to the segment tolerance
+    double xn[nx], S_forw[nx*NF];
+    wt_simulate(ERK, T, &wt_opts_erk_segmented, xn, S_forw);
+
+    std::cout << "\n---> testing segmented ERK: error_sim = " << max_abs_diff(nx, xn, x_ref)
+              << ", error_forw = " << max_abs_diff(nx*NF, S_forw, S_ref) << "\n";
+    REQUIRE(max_abs_diff(nx, xn, x_ref) <= 1e-10);
+    REQUIRE(max_abs_diff(nx*NF, S_forw, S_ref) <= 1e-10);
+
+    // a single correction: inexact, but the state is the end of the segments the
+    // sensitivities were computed on, so both have the error of the start states
+    wt_simulate(ERK, T, &wt_opts_erk_segmented_one_iter, xn, S_forw);
+    std::cout << "---> testing segmented ERK, one correction: error_sim = "
+              << max_abs_diff(nx, xn, x_ref) << ", error_forw = "
+              << max_abs_diff(nx*NF, S_forw, S_ref) << "\n";
+    REQUIRE(max_abs_diff(nx, xn, x_ref) <= 1e-4);
+    REQUIRE(max_abs_diff(nx*NF, S_forw, S_ref) <= 1e-4);
+}
+
+
+
+/************************************************
+* scalar time-dependent model x' = t*u with quadrature q' = x + t*u,
+* integrated exactly by RK4 and the 2-stage Gauss method
+************************************************/
+
+static double tv_arg_get(ext_fun_arg_t type, void *arg)
+{
+    if (type == BLASFEO_DVEC)
+        return blasfeo_dvecex1((struct blasfeo_dvec *) arg, 0);
+    if (type == BLASFEO_DVEC_ARGS)
+    {
+        struct blasfeo_dvec_args *args = (struct blasfeo_dvec_args *) arg;
+        return blasfeo_dvecex1(args->x, args->xi);
+    }
+    return *((double *) arg);  // COLMAJ
+}
+
+
+
+static void tv_arg_set(ext_fun_arg_t type, void *arg, double value)
+{
+    if (type == BLASFEO_DVEC)
+        blasfeo_dvecin1(value, (struct blasfeo_dvec *) arg, 0);
+    else if (type == BLASFEO_DVEC_ARGS)
+    {
+        struct blasfeo_dvec_args *args = (struct blasfeo_dvec_args *) arg;
+        blasfeo_dvecin1(value, args->x, args->xi);
+    }
+    else if (type == BLASFEO_DMAT)
+        blasfeo_dgein1(value, (struct blasfeo_dmat *) arg, 0, 0);
+    else
+        *((double *) arg) = value;  // COLMAJ
+}
+
+
+
+// in: x, u, t
+static void tv_expl_ode_fun(void *self, ext_fun_arg_t *type_in, void **in,
+                            ext_fun_arg_t *type_out, void **out)
+{
+    double u = tv_arg_get(type_in[1], in[1]);
+    double t = tv_arg_get(type_in[2], in[2]);
+    tv_arg_set(type_out[0], out[0], t * u);
+}
+
+
+
+// in: x, Sx, Su, u, t; out: f, df/dx*Sx, df/dx*Su + df/du
+static void tv_expl_vde_for(void *self, ext_fun_arg_t *type_in, void **in,
+                            ext_fun_arg_t *type_out, void **out)
+{
+    double u = tv_arg_get(type_in[3], in[3]);
+    double t = tv_arg_get(type_in[4], in[4]);
+    tv_arg_set(type_out[0], out[0], t * u);
+    tv_arg_set(type_out[1], out[1], 0.0);
+    tv_arg_set(type_out[2], out[2], t);
+}
+
+
+
+// in: x, xdot, u, z, t; out: xdot - t*u
+static void tv_impl_ode_fun(void *self, ext_fun_arg_t *type_in, void **in,
+                            ext_fun_arg_t *type_out, void **out)
+{
+    double xdot = tv_arg_get(type_in[1], in[1]);
+    double u = tv_arg_get(type_in[2], in[2]);
+    double t = tv_arg_get(type_in[4], in[4]);
+    tv_arg_set(type_out[0], out[0], xdot - t * u);
+}
+
+
+
+// out: fun, jac_x, jac_xdot (jac_z is empty)
+static void tv_impl_ode_fun_jac_x_xdot(void *self, ext_fun_arg_t *type_in, void **in,
+                                       ext_fun_arg_t *type_out, void **out)
+{
+    tv_impl_ode_fun(self, type_in, in, type_out, out);
+    tv_arg_set(type_out[1], out[1], 0.0);
+    tv_arg_set(type_out[2], out[2], 1.0);
+}
+
+
+
+// out: jac_x, jac_xdot, jac_u (jac_z is empty)
+static void tv_impl_ode_jac_x_xdot_u(void *self, ext_fun_arg_t *type_in, void **in,
+                                     ext_fun_arg_t *type_out, void **out)
+{
+    double t = tv_arg_get(type_in[4], in[4]);
+    tv_arg_set(type_out[0], out[0], 0.0);
+    tv_arg_set(type_out[1], out[1], 1.0);
+    tv_arg_set(type_out[2], out[2], -t);
+}
+
+
+
+// in: x, u, z, t; out: fun, jac_x, jac_u (jac_z is empty)
+static void tv_quad_fun_jac(void *self, ext_fun_arg_t *type_in, void **in,
+                            ext_fun_arg_t *type_out, void **out)
+{
+    double x = tv_arg_get(type_in[0], in[0]);
+    double u = tv_arg_get(type_in[1], in[1]);
+    double t = tv_arg_get(type_in[3], in[3]);
+    tv_arg_set(type_out[0], out[0], x + t * u);
+    tv_arg_set(type_out[1], out[1], 1.0);
+    tv_arg_set(type_out[2], out[2], t);
+}
+
+
+
+TEST_CASE("time_dependent_quadrature", "[integrators]")
+{
+    vector<std::string> solvers = {"ERK", "IRK"};
+
+    const int nx = 1;
+    const int nu = 1;
+    const int nq = 1;
+    const int NF = nx + nu;
+
+    double T = 0.1;
+    double t0 = 0.5;
+    double x_init = 0.3;
+    double u = 2.0;
+
+    // x(t0+s) = x0 + u*(t0*s + s^2/2), q(T) = int_0^T x(t0+s) + (t0+s)*u ds
+    double x_exact = x_init + u * (t0 * T + T * T / 2);
+    double dx_du = t0 * T + T * T / 2;
+    double q_exact = x_init * T + u * (t0 * T * T / 2 + T * T * T / 6) + u * dx_du;
+    double S_q_exact[NF] = {T, t0 * T * T / 2 + T * T * T / 6 + dx_du};
+
+    external_function_generic expl_ode_fun, expl_vde_for, impl_ode_fun;
+    external_function_generic impl_ode_fun_jac_x_xdot, impl_ode_jac_x_xdot_u, quad_fun_jac;
+    expl_ode_fun.evaluate = &tv_expl_ode_fun;
+    expl_vde_for.evaluate = &tv_expl_vde_for;
+    impl_ode_fun.evaluate = &tv_impl_ode_fun;
+    impl_ode_fun_jac_x_xdot.evaluate = &tv_impl_ode_fun_jac_x_xdot;
+    impl_ode_jac_x_xdot_u.evaluate = &tv_impl_ode_jac_x_xdot_u;
+    quad_fun_jac.evaluate = &tv_quad_fun_jac;
+
+    for (std::string solver : solvers)
+    {
+        for (int sens = 0; sens < 2; sens++)
+        {
+            SECTION(solver + (sens ? " with" : " without") + " sensitivities")
+            {
+                sim_solver_plan_t plan;
+                plan.sim_solver = hashitsim(solver);
+                sim_config *config = sim_config_create(plan);
+
+                void *dims = sim_dims_create(config);
+                sim_dims_set(config, dims, "nx", &nx);
+                sim_dims_set(config, dims, "nu", &nu);
+                sim_dims_set(config, dims, "nq", &nq);
+
+                void *opts = sim_opts_create(config, dims);
+                bool sens_forw = sens;
+                int ns = plan.sim_solver == ERK ? 4 : 2;
+                int num_steps = 2;
+                sim_opts_set(config, opts, "sens_forw", &sens_forw);
+                sim_opts_set(config, opts, "ns", &ns);
+                sim_opts_set(config, opts, "num_steps", &num_steps);
+
+                sim_in *in = sim_in_create(config, dims);
+                sim_out *out = sim_out_create(config, dims);
+
+                in->T = T;
+                sim_in_set(config, dims, in, "t0", &t0);
+                if (plan.sim_solver == ERK)
+                {
+                    sim_in_set(config, dims, in, "expl_ode_fun", &expl_ode_fun);
+                    sim_in_set(config, dims, in, "expl_vde_for", &expl_vde_for);
+                }
+                else
+                {
+                    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+                    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot",
+                               &impl_ode_fun_jac_x_xdot);
+                    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+                }
+                sim_in_set(config, dims, in, "quad_fun_jac", &quad_fun_jac);
+
+                in->x[0] = x_init;
+                in->u[0] = u;
+                in->S_forw[0] = 1.0;
+                in->S_forw[1] = 0.0;
+
+                sim_solver *sim_solver = sim_solver_create(config, dims, opts);
+                int acados_return = sim_solve(sim_solver, in, out);
+                REQUIRE(acados_return == 0);
+
+                double qn[nq], S_q[nq*NF];
+                sim_out_get(config, dims, out, "qn", qn);
+
+                std::cout << "\n---> testing " << solver << " time input and quadrature: error_x = "
+                          << fabs(out->xn[0] - x_exact) << ", error_q = "
+                          << fabs(qn[0] - q_exact) << "\n";
+                REQUIRE(fabs(out->xn[0] - x_exact) <= 1e-12);
+                REQUIRE(fabs(qn[0] - q_exact) <= 1e-12);
+
+                if (sens)
+                {
+                    sim_out_get(config, dims, out, "S_q", S_q);
+                    REQUIRE(fabs(out->S_forw[0] - 1.0) <= 1e-12);
+                    REQUIRE(fabs(out->S_forw[1] - dx_du) <= 1e-12);
+                    REQUIRE(max_abs_diff(nq*NF, S_q, S_q_exact) <= 1e-12);
+                }
+
+                sim_solver_destroy(sim_solver);
+                sim_in_destroy(in);
+                sim_out_destroy(out);
+                sim_opts_destroy(opts);
+                sim_dims_destroy(dims);
+                sim_config_destroy(config);
+            }
+        }
+    }
+}